@@ -1,18 +1,31 @@
 #pragma once
 
+#include "Rui/Asset/AssetSystem.h"
+
 #include "Rui/Core/Application.h"
 #include "Rui/Core/Core.h"
 #include "Rui/Core/Device.h"
+#include "Rui/Core/Input.h"
 #include "Rui/Core/Log.h"
 #include "Rui/Core/Scene.h"
 #include "Rui/Core/Timestep.h"
 #include "Rui/Core/Window.h"
 
 #include "Rui/Events/Event.h"
+#include "Rui/Events/EventBus.h"
 #include "Rui/Events/Listener.h"
 #include "Rui/Events/KeyEvent.h"
 #include "Rui/Events/MouseEvent.h"
 #include "Rui/Events/TickEvent.h"
 #include "Rui/Events/WindowEvent.h"
 
+#include "Rui/Physics/PhysicsWorld.h"
+
+#include "Rui/Render/Mesh.h"
+#include "Rui/Render/Texture.h"
+#include "Rui/Render/TextureSystem.h"
+
+#include "Rui/Scene/SpatialIndex.h"
+#include "Rui/Scene/Transform.h"
+
 #include "Rui/Core/EntryPoint.h"
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+// Kept free of engine headers so the offline packer can share it
+
+namespace Rui {
+	// Layout of a Rui asset archive (.rpak), little endian:
+	//
+	//     ArchiveHeader
+	//     payloads, each aligned to ARCHIVE_ALIGNMENT
+	//     ArchiveEntry[EntryCount], sorted by PathHash
+	//     path strings, not null terminated
+	//
+	// Once the file is mapped the table of contents is used in place.
+	static constexpr char ARCHIVE_MAGIC[4] = { 'R', 'P', 'A', 'K' };
+	static constexpr uint32_t ARCHIVE_VERSION = 1;
+	// Payloads can be handed to the GPU or SIMD code without copying
+	static constexpr uint64_t ARCHIVE_ALIGNMENT = 16;
+	// Compressed payloads are split into blocks compressed independently
+	static constexpr uint32_t ARCHIVE_BLOCK_SIZE = 64 * 1024;
+
+	enum class ArchiveCompression : uint32_t {
+		None = 0,
+		// Payload starts with a uint32_t stored size per block, followed by
+		// the blocks. A block stored at full size is uncompressed.
+		LZ = 1
+	};
+
+	struct ArchiveHeader {
+		char Magic[4];
+		uint32_t Version;
+		uint32_t EntryCount;
+		uint32_t Reserved;
+		uint64_t TocOffset;
+		uint64_t NamesOffset;
+		uint64_t NamesSize;
+	};
+
+	struct ArchiveEntry {
+		uint64_t PathHash;
+		uint64_t Offset;
+		uint64_t StoredSize;
+		uint64_t Size;
+		uint32_t NameOffset;
+		uint32_t NameLength;
+		ArchiveCompression Compression;
+		uint32_t BlockCount;
+	};
+
+	static_assert(sizeof(ArchiveHeader) == 40, "Archive header layout changed");
+	static_assert(sizeof(ArchiveEntry) == 48, "Archive entry layout changed");
+
+	// FNV-1a over the normalised, '/' separated path
+	inline uint64_t HashAssetPath(std::string_view path) {
+		uint64_t hash = 14695981039346656037ull;
+		for(char c : path) {
+			hash ^= static_cast<uint8_t>(c);
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+}
@@ -0,0 +1,130 @@
+#include "AssetArchive.h"
+
+#include "Compression.h"
+#include "Rui/Core/Log.h"
+
+#include <cstring>
+
+namespace Rui {
+	Ref<AssetArchive> AssetArchive::Open(const std::string& path) {
+		auto file = std::make_unique<MappedFile>(path);
+		if(!file->IsOpen()) {
+			RUI_CORE_ERROR("Could not open archive: {0}", path);
+			return nullptr;
+		}
+
+		if(file->GetSize() < sizeof(ArchiveHeader)) {
+			RUI_CORE_ERROR("Archive {0} is truncated", path);
+			return nullptr;
+		}
+
+		const ArchiveHeader* header = reinterpret_cast<const ArchiveHeader*>(file->GetData());
+		if(std::memcmp(header->Magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0 || header->Version != ARCHIVE_VERSION) {
+			RUI_CORE_ERROR("{0} is not a version {1} Rui archive", path, ARCHIVE_VERSION);
+			return nullptr;
+		}
+
+		auto archive = CreateRef<AssetArchive>(path, std::move(file));
+		if(!archive->Validate()) {
+			RUI_CORE_ERROR("Archive {0} is corrupt", path);
+			return nullptr;
+		}
+
+		RUI_CORE_INFO("Mounted archive {0} with {1} entries", path, archive->GetEntryCount());
+		return archive;
+	}
+
+	AssetArchive::AssetArchive(const std::string& path, std::unique_ptr<MappedFile> file)
+		: m_Path(path), m_File(std::move(file)) {
+		const ArchiveHeader* header = reinterpret_cast<const ArchiveHeader*>(m_File->GetData());
+		m_EntryCount = header->EntryCount;
+		m_NamesSize = header->NamesSize;
+		m_Entries = reinterpret_cast<const ArchiveEntry*>(m_File->GetData() + header->TocOffset);
+		m_Names = reinterpret_cast<const char*>(m_File->GetData() + header->NamesOffset);
+	}
+
+	const ArchiveEntry* AssetArchive::Find(std::string_view key) const {
+		uint64_t hash = HashAssetPath(key);
+
+		const ArchiveEntry* end = m_Entries + m_EntryCount;
+		const ArchiveEntry* it = std::lower_bound(m_Entries, end, hash, [](const ArchiveEntry& entry, uint64_t value) {
+			return entry.PathHash < value;
+		});
+
+		// Colliding hashes sit next to each other
+		for(; it != end && it->PathHash == hash; it++) {
+			if(GetName(*it) == key) return it;
+		}
+
+		return nullptr;
+	}
+
+	std::string_view AssetArchive::GetName(const ArchiveEntry& entry) const {
+		return std::string_view(m_Names + entry.NameOffset, entry.NameLength);
+	}
+
+	bool AssetArchive::Decompress(const ArchiveEntry& entry, std::byte* dst) const {
+		const std::byte* payload = GetPayload(entry);
+
+		if(entry.Compression == ArchiveCompression::None) {
+			std::memcpy(dst, payload, entry.Size);
+			return true;
+		}
+
+		// Block sizes come first, the blocks follow
+		const std::byte* block = payload + entry.BlockCount * sizeof(uint32_t);
+		const std::byte* payloadEnd = payload + entry.StoredSize;
+		uint64_t remaining = entry.Size;
+
+		for(uint32_t i = 0; i < entry.BlockCount; i++) {
+			uint32_t storedSize;
+			std::memcpy(&storedSize, payload + i * sizeof(uint32_t), sizeof(storedSize));
+
+			size_t size = static_cast<size_t>(std::min<uint64_t>(remaining, ARCHIVE_BLOCK_SIZE));
+			if(storedSize > static_cast<size_t>(payloadEnd - block)) return false;
+
+			if(storedSize == size) {
+				std::memcpy(dst, block, size);
+			} else if(!LZDecompress(block, storedSize, dst, size)) {
+				return false;
+			}
+
+			block += storedSize;
+			dst += size;
+			remaining -= size;
+		}
+
+		return remaining == 0;
+	}
+
+	bool AssetArchive::Validate() const {
+		const ArchiveHeader* header = reinterpret_cast<const ArchiveHeader*>(m_File->GetData());
+		uint64_t fileSize = m_File->GetSize();
+
+		if(header->TocOffset % alignof(ArchiveEntry) != 0) return false;
+		if(header->TocOffset > fileSize || (fileSize - header->TocOffset) / sizeof(ArchiveEntry) < m_EntryCount) return false;
+		if(header->NamesOffset > fileSize || fileSize - header->NamesOffset < m_NamesSize) return false;
+
+		for(uint32_t i = 0; i < m_EntryCount; i++) {
+			const ArchiveEntry& entry = m_Entries[i];
+
+			if(entry.Offset > fileSize || fileSize - entry.Offset < entry.StoredSize) return false;
+			if(static_cast<uint64_t>(entry.NameOffset) + entry.NameLength > m_NamesSize) return false;
+			if(i > 0 && m_Entries[i - 1].PathHash > entry.PathHash) return false;
+
+			switch(entry.Compression) {
+				case ArchiveCompression::None:
+					if(entry.StoredSize != entry.Size) return false;
+					break;
+				case ArchiveCompression::LZ:
+					if(entry.BlockCount != (entry.Size + ARCHIVE_BLOCK_SIZE - 1) / ARCHIVE_BLOCK_SIZE) return false;
+					if(entry.StoredSize < entry.BlockCount * sizeof(uint32_t)) return false;
+					break;
+				default:
+					return false;
+			}
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "ArchiveFormat.h"
+#include "MappedFile.h"
+
+namespace Rui {
+	// Read-only view of a mapped .rpak archive. Opening it validates the
+	// whole table of contents against the file size once, which touches every
+	// entry but no payload; lookups then binary search the table in place.
+	class AssetArchive {
+	public:
+		// Returns nullptr if the file is missing or not a valid archive
+		static Ref<AssetArchive> Open(const std::string& path);
+
+		AssetArchive(const std::string& path, std::unique_ptr<MappedFile> file);
+
+		// `key` is a normalised, '/' separated path
+		const ArchiveEntry* Find(std::string_view key) const;
+		std::string_view GetName(const ArchiveEntry& entry) const;
+
+		// Stored bytes of an entry, the data itself if it is uncompressed
+		inline const std::byte* GetPayload(const ArchiveEntry& entry) const { return m_File->GetData() + entry.Offset; }
+		// Writes the uncompressed entry, entry.Size bytes, to `dst`
+		bool Decompress(const ArchiveEntry& entry, std::byte* dst) const;
+
+		inline const std::string& GetPath() const { return m_Path; }
+		inline uint32_t GetEntryCount() const { return m_EntryCount; }
+		inline const ArchiveEntry* GetEntries() const { return m_Entries; }
+	private:
+		bool Validate() const;
+
+		std::string m_Path;
+		std::unique_ptr<MappedFile> m_File;
+
+		const ArchiveEntry* m_Entries = nullptr;
+		uint32_t m_EntryCount = 0;
+		const char* m_Names = nullptr;
+		uint64_t m_NamesSize = 0;
+	};
+}
@@ -0,0 +1,55 @@
+#include "AssetBlob.h"
+
+#include <filesystem>
+
+namespace Rui {
+	Ref<AssetBlob> AssetBlob::Read(const std::string& path) {
+		std::error_code error;
+		uintmax_t size = std::filesystem::file_size(path, error);
+		if(error) return nullptr;
+
+		auto blob = CreateRef<AssetBlob>();
+		blob->m_Path = path;
+
+		if(size >= MAP_THRESHOLD) {
+			blob->m_Mapped = std::make_unique<MappedFile>(path);
+			if(blob->m_Mapped->IsOpen()) {
+				blob->m_Data = blob->m_Mapped->GetData();
+				blob->m_Size = blob->m_Mapped->GetSize();
+				return blob;
+			}
+
+			// Fall back to a plain read, e.g. on file systems that cannot map
+			blob->m_Mapped.reset();
+		}
+
+		std::ifstream file(path, std::ios::binary);
+		if(!file.is_open()) return nullptr;
+
+		blob->m_Buffer.resize(static_cast<size_t>(size));
+		if(!file.read(reinterpret_cast<char*>(blob->m_Buffer.data()), static_cast<std::streamsize>(size))) return nullptr;
+
+		blob->m_Data = blob->m_Buffer.data();
+		blob->m_Size = blob->m_Buffer.size();
+		return blob;
+	}
+
+	Ref<AssetBlob> AssetBlob::Read(const Ref<const AssetArchive>& archive, const ArchiveEntry& entry) {
+		auto blob = CreateRef<AssetBlob>();
+		blob->m_Path = std::string(archive->GetName(entry));
+
+		if(entry.Compression == ArchiveCompression::None) {
+			blob->m_Archive = archive;
+			blob->m_Data = archive->GetPayload(entry);
+			blob->m_Size = static_cast<size_t>(entry.Size);
+			return blob;
+		}
+
+		blob->m_Buffer.resize(static_cast<size_t>(entry.Size));
+		if(!archive->Decompress(entry, blob->m_Buffer.data())) return nullptr;
+
+		blob->m_Data = blob->m_Buffer.data();
+		blob->m_Size = blob->m_Buffer.size();
+		return blob;
+	}
+}
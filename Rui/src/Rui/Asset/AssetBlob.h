@@ -0,0 +1,38 @@
+#pragma once
+
+#include "AssetArchive.h"
+
+namespace Rui {
+	// Immutable contents of an asset file. Large files are memory mapped and
+	// read without copying; small ones are read into a buffer, which is
+	// cheaper than setting up a mapping. Uncompressed archive entries point
+	// straight into the archive's mapping. Either way the data is at least 16
+	// byte aligned.
+	class AssetBlob {
+	public:
+		// Files at least this large are mapped
+		static constexpr size_t MAP_THRESHOLD = 64 * 1024;
+
+		// Returns nullptr if the file cannot be read
+		static Ref<AssetBlob> Read(const std::string& path);
+		// Keeps the archive alive for as long as the blob; decompresses
+		// compressed entries. Returns nullptr if the entry is corrupt.
+		static Ref<AssetBlob> Read(const Ref<const AssetArchive>& archive, const ArchiveEntry& entry);
+
+		inline const std::byte* GetData() const { return m_Data; }
+		inline size_t GetSize() const { return m_Size; }
+		inline const std::string& GetPath() const { return m_Path; }
+		inline bool IsMapped() const { return m_Mapped != nullptr || m_Archive != nullptr; }
+	private:
+		std::string m_Path;
+		const std::byte* m_Data = nullptr;
+		size_t m_Size = 0;
+
+		std::unique_ptr<MappedFile> m_Mapped;
+		Ref<const AssetArchive> m_Archive;
+		std::vector<std::byte> m_Buffer;
+	};
+
+	// Shared, read-only reference to loaded asset data
+	using AssetHandle = Ref<const AssetBlob>;
+}
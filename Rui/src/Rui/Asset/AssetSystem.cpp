@@ -0,0 +1,268 @@
+#include "AssetSystem.h"
+
+#include <condition_variable>
+#include <filesystem>
+
+namespace Rui {
+	namespace {
+		struct CacheEntry {
+			std::weak_ptr<const AssetBlob> Blob;
+			bool Loading = false;
+			std::vector<AssetSystem::LoadAwaiter*> Waiters;
+		};
+
+		struct AssetSystemData {
+			std::unique_ptr<ThreadPool> Pool;
+
+			std::mutex Mutex;
+			std::condition_variable Loaded;
+			std::unordered_map<std::string, CacheEntry> Cache;
+			// Size at which expired entries are swept out next
+			size_t PruneThreshold = 64;
+			std::vector<AssetHandle> Prefetched;
+
+			std::mutex ArchiveMutex;
+			std::vector<Ref<const AssetArchive>> Archives;
+
+			std::mutex MainThreadMutex;
+			std::vector<std::coroutine_handle<>> MainThreadQueue;
+		};
+	}
+
+	static AssetSystemData s_Data;
+
+	// Called with the lock held; returns the cached blob if it is still alive
+	static AssetHandle FindLoaded(const std::string& key) {
+		auto it = s_Data.Cache.find(key);
+		if(it == s_Data.Cache.end()) return nullptr;
+		return it->second.Blob.lock();
+	}
+
+	// Called with the lock held. Sweeps once the cache has doubled since the
+	// last sweep, so loads pay amortized constant time for it.
+	static void PruneExpired() {
+		if(s_Data.Cache.size() < s_Data.PruneThreshold) return;
+
+		for(auto it = s_Data.Cache.begin(); it != s_Data.Cache.end();) {
+			const CacheEntry& entry = it->second;
+			if(!entry.Loading && entry.Waiters.empty() && entry.Blob.expired()) {
+				it = s_Data.Cache.erase(it);
+			} else {
+				it++;
+			}
+		}
+
+		s_Data.PruneThreshold = std::max<size_t>(64, s_Data.Cache.size() * 2);
+	}
+
+	static AssetHandle ReadBlob(const std::string& key) {
+		Ref<const AssetArchive> archive;
+		const ArchiveEntry* entry = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(s_Data.ArchiveMutex);
+			for(auto it = s_Data.Archives.rbegin(); it != s_Data.Archives.rend() && !entry; it++) {
+				entry = (*it)->Find(key);
+				archive = *it;
+			}
+		}
+
+		if(entry) return AssetBlob::Read(archive, *entry);
+		return AssetBlob::Read(key);
+	}
+
+	static Task<> PrefetchTask(std::string path) {
+		AssetHandle blob = co_await LoadAsset(path);
+		if(!blob) co_return;
+
+		std::lock_guard<std::mutex> lock(s_Data.Mutex);
+		s_Data.Prefetched.push_back(std::move(blob));
+	}
+
+	AssetSystem::LoadAwaiter::LoadAwaiter(std::string path)
+		: m_Key(MakeKey(path)) {
+	}
+
+	bool AssetSystem::LoadAwaiter::await_suspend(std::coroutine_handle<> handle) {
+		m_Handle = handle;
+		std::string key = m_Key;
+
+		{
+			std::lock_guard<std::mutex> lock(s_Data.Mutex);
+			if(AssetHandle blob = FindLoaded(key)) {
+				m_Result = std::move(blob);
+				return false;
+			}
+
+			CacheEntry& entry = s_Data.Cache[key];
+			entry.Waiters.push_back(this);
+			if(entry.Loading) return true;
+
+			entry.Loading = true;
+		}
+
+		// Once unlocked the read may complete and resume us on another thread,
+		// so `this` must not be touched from here on
+		StartRead(key);
+		return true;
+	}
+
+	void AssetSystem::MainThreadAwaiter::await_suspend(std::coroutine_handle<> handle) {
+		std::lock_guard<std::mutex> lock(s_Data.MainThreadMutex);
+		s_Data.MainThreadQueue.push_back(handle);
+	}
+
+	void AssetSystem::WorkerAwaiter::await_suspend(std::coroutine_handle<> handle) {
+		if(!s_Data.Pool) {
+			handle.resume();
+			return;
+		}
+
+		s_Data.Pool->Submit([handle]() { handle.resume(); });
+	}
+
+	void AssetSystem::Init(uint32_t ioThreads) {
+		s_Data.Pool = std::make_unique<ThreadPool>(ioThreads);
+	}
+
+	void AssetSystem::Shutdown() {
+		// Finishes the queued reads; their coroutines may still queue up for
+		// the main thread, and from there go back to a worker
+		if(s_Data.Pool) {
+			s_Data.Pool->WaitIdle();
+			ProcessMainThread();
+			s_Data.Pool->WaitIdle();
+			s_Data.Pool.reset();
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(s_Data.Mutex);
+			s_Data.Prefetched.clear();
+			s_Data.Cache.clear();
+		}
+
+		std::lock_guard<std::mutex> lock(s_Data.ArchiveMutex);
+		s_Data.Archives.clear();
+	}
+
+	bool AssetSystem::Mount(const std::string& archivePath) {
+		Ref<const AssetArchive> archive = AssetArchive::Open(archivePath);
+		if(!archive) return false;
+
+		std::lock_guard<std::mutex> lock(s_Data.ArchiveMutex);
+		s_Data.Archives.push_back(std::move(archive));
+		return true;
+	}
+
+	AssetHandle AssetSystem::Load(const std::string& path) {
+		std::string key = MakeKey(path);
+
+		{
+			std::unique_lock<std::mutex> lock(s_Data.Mutex);
+			for(;;) {
+				if(AssetHandle blob = FindLoaded(key)) return blob;
+
+				CacheEntry& entry = s_Data.Cache[key];
+				if(!entry.Loading) {
+					entry.Loading = true;
+					break;
+				}
+
+				s_Data.Loaded.wait(lock);
+			}
+		}
+
+		AssetHandle blob = ReadBlob(key);
+		Complete(key, blob);
+		return blob;
+	}
+
+	void AssetSystem::Prefetch(const std::string& path) {
+		Spawn(PrefetchTask(path));
+	}
+
+	void AssetSystem::ReleasePrefetched() {
+		std::lock_guard<std::mutex> lock(s_Data.Mutex);
+		s_Data.Prefetched.clear();
+	}
+
+	void AssetSystem::ProcessMainThread() {
+		std::vector<std::coroutine_handle<>> handles;
+		{
+			std::lock_guard<std::mutex> lock(s_Data.MainThreadMutex);
+			handles.swap(s_Data.MainThreadQueue);
+		}
+
+		for(std::coroutine_handle<> handle : handles) {
+			handle.resume();
+		}
+	}
+
+	bool AssetSystem::IsLoaded(const std::string& path) {
+		std::string key = MakeKey(path);
+
+		std::lock_guard<std::mutex> lock(s_Data.Mutex);
+		return FindLoaded(key) != nullptr;
+	}
+
+	std::string AssetSystem::MakeKey(const std::string& path) {
+		return std::filesystem::path(path).lexically_normal().generic_string();
+	}
+
+	void AssetSystem::StartRead(const std::string& key) {
+		if(!s_Data.Pool) {
+			Complete(key, ReadBlob(key));
+			return;
+		}
+
+		s_Data.Pool->Submit([key]() {
+			Complete(key, ReadBlob(key));
+		});
+	}
+
+	void AssetSystem::Complete(const std::string& key, AssetHandle blob) {
+		std::vector<LoadAwaiter*> waiters;
+		{
+			std::lock_guard<std::mutex> lock(s_Data.Mutex);
+			CacheEntry& entry = s_Data.Cache[key];
+			waiters.swap(entry.Waiters);
+
+			if(blob) {
+				entry.Blob = blob;
+				entry.Loading = false;
+			} else {
+				s_Data.Cache.erase(key);
+			}
+
+			PruneExpired();
+		}
+
+		s_Data.Loaded.notify_all();
+
+		if(!blob) {
+			RUI_CORE_ERROR("Could not read asset: {0}", key);
+		}
+
+		// Every result is set before anyone is resumed, as a resumed coroutine
+		// may destroy its own awaiter
+		std::vector<std::coroutine_handle<>> handles;
+		handles.reserve(waiters.size());
+		for(LoadAwaiter* waiter : waiters) {
+			waiter->m_Result = blob;
+			handles.push_back(waiter->m_Handle);
+		}
+
+		if(handles.empty()) return;
+
+		// The first waiter continues on this thread, the others in parallel
+		for(size_t i = 1; i < handles.size(); i++) {
+			std::coroutine_handle<> handle = handles[i];
+			if(s_Data.Pool) {
+				s_Data.Pool->Submit([handle]() { handle.resume(); });
+			} else {
+				handle.resume();
+			}
+		}
+
+		handles[0].resume();
+	}
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "AssetBlob.h"
+#include "Task.h"
+#include "Rui/Core/Log.h"
+#include "Rui/Core/ThreadPool.h"
+
+#include <mutex>
+
+namespace Rui {
+	// Reads asset files on a pool of I/O threads. Loads are deduplicated by
+	// path: while a blob is alive, or still being read, every request for the
+	// same file shares it. Mounted archives are searched before loose files.
+	// Coroutines await loads with `co_await LoadAsset(path)` and hop between
+	// workers and the main thread to overlap reading, decoding and GPU upload:
+	//
+	//     Task<> LoadLevel() {
+	//         AssetSystem::Prefetch("level.rmesh");
+	//         AssetHandle texture = co_await LoadAsset("level.ktx2");
+	//         AssetHandle mesh = co_await LoadAsset("level.rmesh");
+	//         auto decoded = Decode(mesh);                 // on an I/O worker
+	//         co_await AssetSystem::ResumeOnMainThread();
+	//         Upload(decoded, texture);                   // on the main thread
+	//     }
+	class AssetSystem {
+	public:
+		class LoadAwaiter {
+		public:
+			LoadAwaiter(std::string path);
+
+			bool await_ready() const noexcept { return false; }
+			bool await_suspend(std::coroutine_handle<> handle);
+			// nullptr if the file could not be read
+			AssetHandle await_resume() { return std::move(m_Result); }
+		private:
+			std::string m_Key;
+			std::coroutine_handle<> m_Handle;
+			AssetHandle m_Result;
+
+			friend class AssetSystem;
+		};
+
+		class MainThreadAwaiter {
+		public:
+			bool await_ready() const noexcept { return false; }
+			void await_suspend(std::coroutine_handle<> handle);
+			void await_resume() const noexcept {}
+		};
+
+		class WorkerAwaiter {
+		public:
+			bool await_ready() const noexcept { return false; }
+			void await_suspend(std::coroutine_handle<> handle);
+			void await_resume() const noexcept {}
+		};
+
+		static void Init(uint32_t ioThreads = 2);
+		// Waits for outstanding reads; coroutines still waiting for the main
+		// thread are resumed one last time
+		static void Shutdown();
+
+		// Later mounts take precedence. Blobs already loaded are not affected.
+		static bool Mount(const std::string& archivePath);
+
+		// Blocking load, shares the blob with any load already in flight
+		static AssetHandle Load(const std::string& path);
+		static LoadAwaiter LoadAsync(const std::string& path) { return LoadAwaiter(path); }
+		// Starts reading a file without waiting for it, so that a later load
+		// finds it cached or in flight. The blob is kept alive until released
+		// with ReleasePrefetched.
+		static void Prefetch(const std::string& path);
+		static void ReleasePrefetched();
+
+		static MainThreadAwaiter ResumeOnMainThread() { return {}; }
+		static WorkerAwaiter ResumeOnWorker() { return {}; }
+
+		// Resumes the coroutines that asked for the main thread. Called once a
+		// frame by the application.
+		static void ProcessMainThread();
+
+		static bool IsLoaded(const std::string& path);
+	private:
+		static std::string MakeKey(const std::string& path);
+		static void StartRead(const std::string& key);
+		static void Complete(const std::string& key, AssetHandle blob);
+	};
+
+	inline AssetSystem::LoadAwaiter LoadAsset(const std::string& path) {
+		return AssetSystem::LoadAsync(path);
+	}
+}
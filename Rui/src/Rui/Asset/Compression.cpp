@@ -0,0 +1,166 @@
+#include "Compression.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace Rui {
+	static constexpr size_t MIN_MATCH = 4;
+	static constexpr size_t MAX_OFFSET = 65535;
+	static constexpr uint32_t HASH_BITS = 14;
+
+	static inline uint32_t Read32(const uint8_t* p) {
+		uint32_t value;
+		std::memcpy(&value, p, sizeof(value));
+		return value;
+	}
+
+	static inline uint32_t Hash(uint32_t sequence) {
+		return (sequence * 2654435761u) >> (32 - HASH_BITS);
+	}
+
+	namespace {
+		class Output {
+		public:
+			Output(uint8_t* dst, size_t capacity) : m_Dst(dst), m_Capacity(capacity) {}
+
+			bool Byte(uint8_t value) {
+				if(m_Size >= m_Capacity) return false;
+				m_Dst[m_Size++] = value;
+				return true;
+			}
+
+			bool Bytes(const uint8_t* src, size_t count) {
+				if(m_Capacity - m_Size < count) return false;
+				if(count == 0) return true;
+				std::memcpy(m_Dst + m_Size, src, count);
+				m_Size += count;
+				return true;
+			}
+
+			// Lengths of 15 and up continue in bytes of 255 plus a remainder
+			bool Length(size_t length) {
+				for(; length >= 255; length -= 255) {
+					if(!Byte(255)) return false;
+				}
+				return Byte(static_cast<uint8_t>(length));
+			}
+
+			inline size_t Size() const { return m_Size; }
+		private:
+			uint8_t* m_Dst;
+			size_t m_Capacity;
+			size_t m_Size = 0;
+		};
+	}
+
+	static bool WriteSequence(Output& out, const uint8_t* literals, size_t literalCount, size_t offset, size_t matchLength) {
+		size_t matchCode = matchLength ? matchLength - MIN_MATCH : 0;
+		uint8_t token = static_cast<uint8_t>((std::min<size_t>(literalCount, 15) << 4) | std::min<size_t>(matchCode, 15));
+
+		if(!out.Byte(token)) return false;
+		if(literalCount >= 15 && !out.Length(literalCount - 15)) return false;
+		if(!out.Bytes(literals, literalCount)) return false;
+
+		// The last sequence carries only literals
+		if(!matchLength) return true;
+
+		if(!out.Byte(static_cast<uint8_t>(offset)) || !out.Byte(static_cast<uint8_t>(offset >> 8))) return false;
+		if(matchCode >= 15 && !out.Length(matchCode - 15)) return false;
+		return true;
+	}
+
+	size_t LZCompressBound(size_t size) {
+		return size + size / 255 + 16;
+	}
+
+	size_t LZCompress(const std::byte* source, size_t size, std::byte* destination, size_t capacity) {
+		const uint8_t* src = reinterpret_cast<const uint8_t*>(source);
+		Output out(reinterpret_cast<uint8_t*>(destination), capacity);
+
+		// Entries start out pointing at 0; stale candidates are rejected by
+		// comparing the bytes, so the table never needs clearing
+		auto table = std::make_unique<uint32_t[]>(size_t(1) << HASH_BITS);
+
+		size_t anchor = 0;
+		size_t pos = 0;
+		while(pos + MIN_MATCH <= size) {
+			uint32_t sequence = Read32(src + pos);
+			uint32_t hash = Hash(sequence);
+			size_t candidate = table[hash];
+			table[hash] = static_cast<uint32_t>(pos);
+
+			if(candidate >= pos || pos - candidate > MAX_OFFSET || Read32(src + candidate) != sequence) {
+				pos++;
+				continue;
+			}
+
+			size_t length = MIN_MATCH;
+			while(pos + length < size && src[candidate + length] == src[pos + length]) {
+				length++;
+			}
+
+			if(!WriteSequence(out, src + anchor, pos - anchor, pos - candidate, length)) return 0;
+
+			pos += length;
+			anchor = pos;
+		}
+
+		if(!WriteSequence(out, src + anchor, size - anchor, 0, 0)) return 0;
+		return out.Size();
+	}
+
+	bool LZDecompress(const std::byte* source, size_t size, std::byte* destination, size_t dstSize) {
+		const uint8_t* src = reinterpret_cast<const uint8_t*>(source);
+		uint8_t* dst = reinterpret_cast<uint8_t*>(destination);
+
+		size_t in = 0;
+		size_t out = 0;
+
+		auto readLength = [&](size_t& length) {
+			uint8_t value;
+			do {
+				if(in >= size) return false;
+				value = src[in++];
+				length += value;
+			} while(value == 255);
+			return true;
+		};
+
+		while(in < size) {
+			uint8_t token = src[in++];
+
+			size_t literalCount = token >> 4;
+			if(literalCount == 15 && !readLength(literalCount)) return false;
+			if(size - in < literalCount || dstSize - out < literalCount) return false;
+
+			if(literalCount > 0) std::memcpy(dst + out, src + in, literalCount);
+			in += literalCount;
+			out += literalCount;
+
+			if(in == size) break;
+
+			if(size - in < 2) return false;
+			size_t offset = src[in] | (static_cast<size_t>(src[in + 1]) << 8);
+			in += 2;
+			if(offset == 0 || offset > out) return false;
+
+			size_t length = token & 15;
+			if(length == 15 && !readLength(length)) return false;
+			length += MIN_MATCH;
+			if(dstSize - out < length) return false;
+
+			const uint8_t* match = dst + out - offset;
+			if(offset >= length) {
+				std::memcpy(dst + out, match, length);
+			} else {
+				// Overlapping copy repeats the last `offset` bytes
+				for(size_t i = 0; i < length; i++) dst[out + i] = match[i];
+			}
+			out += length;
+		}
+
+		return out == dstSize;
+	}
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Rui {
+	// Byte oriented LZ77 in the spirit of LZ4: sequences of literals followed
+	// by a back reference of at least 4 bytes within the last 64 KiB. Fast to
+	// decode, meant for assets compressed once offline.
+
+	// Largest possible output for `size` input bytes
+	size_t LZCompressBound(size_t size);
+	// Returns the compressed size, or 0 if it does not fit in `capacity`
+	size_t LZCompress(const std::byte* src, size_t size, std::byte* dst, size_t capacity);
+	// Fails on malformed input or if the output is not exactly `dstSize` bytes
+	bool LZDecompress(const std::byte* src, size_t size, std::byte* dst, size_t dstSize);
+}
@@ -0,0 +1,66 @@
+#include "MappedFile.h"
+
+#ifndef RUI_PLATFORM_WINDOWS
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace Rui {
+#ifdef RUI_PLATFORM_WINDOWS
+	MappedFile::MappedFile(const std::string& path) {
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if(file == INVALID_HANDLE_VALUE) return;
+		m_File = file;
+
+		LARGE_INTEGER size;
+		if(!GetFileSizeEx(file, &size)) return;
+		m_Size = static_cast<size_t>(size.QuadPart);
+
+		// Empty files cannot be mapped, but are valid
+		if(m_Size == 0) {
+			m_Open = true;
+			return;
+		}
+
+		m_Mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if(!m_Mapping) return;
+
+		m_Data = static_cast<const std::byte*>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0));
+		m_Open = m_Data != nullptr;
+	}
+
+	MappedFile::~MappedFile() {
+		if(m_Data) UnmapViewOfFile(m_Data);
+		if(m_Mapping) CloseHandle(m_Mapping);
+		if(m_File) CloseHandle(m_File);
+	}
+#else
+	MappedFile::MappedFile(const std::string& path) {
+		m_File = open(path.c_str(), O_RDONLY);
+		if(m_File < 0) return;
+
+		struct stat info;
+		if(fstat(m_File, &info) != 0) return;
+		m_Size = static_cast<size_t>(info.st_size);
+
+		if(m_Size == 0) {
+			m_Open = true;
+			return;
+		}
+
+		void* data = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, m_File, 0);
+		if(data == MAP_FAILED) return;
+
+		madvise(data, m_Size, MADV_SEQUENTIAL);
+		m_Data = static_cast<const std::byte*>(data);
+		m_Open = true;
+	}
+
+	MappedFile::~MappedFile() {
+		if(m_Data) munmap(const_cast<std::byte*>(m_Data), m_Size);
+		if(m_File >= 0) close(m_File);
+	}
+#endif
+}
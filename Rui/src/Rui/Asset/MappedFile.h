@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Rui/Core/Core.h"
+
+#include <cstddef>
+
+namespace Rui {
+	// Read-only memory mapping of a whole file
+	class MappedFile {
+	public:
+		MappedFile(const std::string& path);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		inline bool IsOpen() const { return m_Open; }
+		inline const std::byte* GetData() const { return m_Data; }
+		inline size_t GetSize() const { return m_Size; }
+	private:
+#ifdef RUI_PLATFORM_WINDOWS
+		void* m_File = nullptr;
+		void* m_Mapping = nullptr;
+#else
+		int m_File = -1;
+#endif
+		const std::byte* m_Data = nullptr;
+		size_t m_Size = 0;
+		bool m_Open = false;
+	};
+}
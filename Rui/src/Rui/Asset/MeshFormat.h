@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+
+// Kept free of engine headers so the offline mesh importer can share it
+
+namespace Rui {
+	// Layout of a Rui mesh (.rmesh), little endian:
+	//
+	//     MeshHeader
+	//     MeshLod[LodCount]
+	//     MeshVertex[VertexCount]    at VertexOffset
+	//     indices[IndexCount]        at IndexOffset, uint16_t or uint32_t
+	//
+	// Vertices and indices are one block of DataSize bytes starting at
+	// VertexOffset, stored exactly as the GPU reads them, so loading is a
+	// single copy into a buffer used for both. Indices are ordered for the
+	// post-transform cache and overdraw, vertices by first use.
+	//
+	// Every level of detail is a range of the indices into the same
+	// vertices, level 0 being the full mesh, so switching levels only
+	// changes the draw.
+	static constexpr char MESH_MAGIC[4] = { 'R', 'M', 'S', 'H' };
+	static constexpr uint32_t MESH_VERSION = 2;
+	static constexpr uint32_t MESH_MAX_LODS = 8;
+	// Of VertexOffset and IndexOffset
+	static constexpr uint64_t MESH_ALIGNMENT = 16;
+
+	enum class MeshIndexType : uint32_t {
+		Uint16 = 0,
+		Uint32 = 1
+	};
+
+	struct MeshHeader {
+		char Magic[4];
+		uint32_t Version;
+		uint32_t VertexCount;
+		uint32_t IndexCount;
+		MeshIndexType IndexType;
+		uint32_t LodCount;
+		// Quantized positions span this box
+		float BoundsMin[3];
+		float BoundsMax[3];
+		uint64_t VertexOffset;
+		uint64_t IndexOffset;
+		uint64_t DataSize;
+	};
+
+	struct MeshLod {
+		// Range of the indices, in indices
+		uint32_t FirstIndex;
+		uint32_t IndexCount;
+		// Quadric error of the simplification, about how far the surface
+		// moved from the full mesh, in the units of the positions
+		float Error;
+		uint32_t Reserved;
+	};
+
+	// 16 bytes against 32 for float position, normal and texture coordinate
+	struct MeshVertex {
+		// snorm16 within the bounds, -1 at BoundsMin and 1 at BoundsMax; w is 0
+		int16_t Position[4];
+		// Unit normal in snorm16 octahedral encoding
+		int16_t Normal[2];
+		// Half floats
+		uint16_t TexCoord[2];
+	};
+
+	static_assert(sizeof(MeshHeader) == 72, "Mesh header layout changed");
+	static_assert(sizeof(MeshLod) == 16, "Mesh LOD layout changed");
+	static_assert(sizeof(MeshVertex) == 16, "Mesh vertex layout changed");
+}
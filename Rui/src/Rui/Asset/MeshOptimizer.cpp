@@ -0,0 +1,615 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace Rui {
+	// Forsyth's scoring: vertices recently used score high, the three of the
+	// last triangle a little less so strips are not favoured over fans, and
+	// vertices with few triangles left get a boost so they are finished off
+	// instead of being left behind as isolated triangles
+	static constexpr uint32_t CACHE_SIZE = 32;
+	static constexpr float CACHE_DECAY_POWER = 1.5f;
+	static constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+	static constexpr float VALENCE_BOOST_SCALE = 2.0f;
+	static constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+	static float VertexScore(int32_t cachePosition, uint32_t remaining) {
+		if(remaining == 0) return -1.0f;
+
+		float score = 0.0f;
+		if(cachePosition >= 0) {
+			if(cachePosition < 3) {
+				score = LAST_TRIANGLE_SCORE;
+			} else {
+				float scale = 1.0f / (CACHE_SIZE - 3);
+				score = std::pow(1.0f - (cachePosition - 3) * scale, CACHE_DECAY_POWER);
+			}
+		}
+
+		return score + VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remaining), -VALENCE_BOOST_POWER);
+	}
+
+	void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount) {
+		size_t triangleCount = indexCount / 3;
+		if(triangleCount == 0) return;
+
+		// Triangles of every vertex; the first `remaining` are not emitted yet
+		std::vector<uint32_t> offsets(vertexCount + 1, 0);
+		for(size_t i = 0; i < indexCount; i++) offsets[indices[i] + 1]++;
+		for(size_t v = 0; v < vertexCount; v++) offsets[v + 1] += offsets[v];
+
+		std::vector<uint32_t> remaining(vertexCount, 0);
+		std::vector<uint32_t> adjacency(indexCount);
+		for(size_t i = 0; i < indexCount; i++) {
+			uint32_t v = indices[i];
+			adjacency[offsets[v] + remaining[v]++] = static_cast<uint32_t>(i / 3);
+		}
+
+		std::vector<int32_t> cachePosition(vertexCount, -1);
+		std::vector<float> vertexScore(vertexCount);
+		for(size_t v = 0; v < vertexCount; v++) vertexScore[v] = VertexScore(-1, remaining[v]);
+
+		std::vector<bool> emitted(triangleCount, false);
+		std::vector<uint32_t> output;
+		output.reserve(indexCount);
+
+		std::vector<uint32_t> cache;
+		std::vector<uint32_t> newCache;
+		cache.reserve(CACHE_SIZE + 3);
+		newCache.reserve(CACHE_SIZE + 3);
+
+		size_t scanCursor = 0;
+		int64_t best = -1;
+
+		for(size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++) {
+			// Dead end: no triangle touches the cache, take the next one left
+			if(best < 0) {
+				while(emitted[scanCursor]) scanCursor++;
+				best = static_cast<int64_t>(scanCursor);
+			}
+
+			uint32_t triangle = static_cast<uint32_t>(best);
+			const uint32_t* corners = &indices[triangle * 3];
+			emitted[triangle] = true;
+			output.insert(output.end(), corners, corners + 3);
+
+			for(uint32_t c = 0; c < 3; c++) {
+				uint32_t v = corners[c];
+				uint32_t* list = &adjacency[offsets[v]];
+				uint32_t* end = list + remaining[v];
+				std::iter_swap(std::find(list, end, triangle), end - 1);
+				remaining[v]--;
+			}
+
+			// Most recent first; vertices pushed past the end are evicted
+			newCache.assign(corners, corners + 3);
+			for(uint32_t v : cache) {
+				if(v != corners[0] && v != corners[1] && v != corners[2]) newCache.push_back(v);
+			}
+			for(size_t i = CACHE_SIZE; i < newCache.size(); i++) {
+				cachePosition[newCache[i]] = -1;
+				vertexScore[newCache[i]] = VertexScore(-1, remaining[newCache[i]]);
+			}
+			if(newCache.size() > CACHE_SIZE) newCache.resize(CACHE_SIZE);
+			std::swap(cache, newCache);
+
+			for(size_t i = 0; i < cache.size(); i++) {
+				cachePosition[cache[i]] = static_cast<int32_t>(i);
+				vertexScore[cache[i]] = VertexScore(static_cast<int32_t>(i), remaining[cache[i]]);
+			}
+
+			// Only triangles around cached vertices changed score
+			best = -1;
+			float bestScore = -1.0f;
+			for(uint32_t v : cache) {
+				for(uint32_t i = 0; i < remaining[v]; i++) {
+					uint32_t t = adjacency[offsets[v] + i];
+					float score = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+					if(score > bestScore) {
+						bestScore = score;
+						best = t;
+					}
+				}
+			}
+		}
+
+		std::memcpy(indices, output.data(), indexCount * sizeof(uint32_t));
+	}
+
+	// FIFO cache misses of every triangle, starting with an empty cache
+	static void SimulateCacheMisses(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize, std::vector<uint8_t>& misses) {
+		// A vertex is cached while it was inserted within the last cacheSize insertions
+		std::vector<uint64_t> insertedAt(vertexCount, 0);
+		uint64_t clock = cacheSize + 1;
+
+		misses.assign(indexCount / 3, 0);
+		for(size_t i = 0; i < indexCount; i++) {
+			uint32_t v = indices[i];
+			if(clock - insertedAt[v] > cacheSize) {
+				insertedAt[v] = clock++;
+				misses[i / 3]++;
+			}
+		}
+	}
+
+	float ComputeVertexCacheAcmr(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize) {
+		if(indexCount < 3) return 0.0f;
+
+		std::vector<uint8_t> misses;
+		SimulateCacheMisses(indices, indexCount, vertexCount, cacheSize, misses);
+
+		size_t total = 0;
+		for(uint8_t m : misses) total += m;
+		return static_cast<float>(total) / misses.size();
+	}
+
+	void OptimizeOverdraw(uint32_t* indices, size_t indexCount, const float* positions, size_t vertexCount, size_t positionStride, float threshold) {
+		static constexpr uint32_t SIMULATED_CACHE_SIZE = 16;
+
+		size_t triangleCount = indexCount / 3;
+		if(triangleCount < 2) return;
+
+		auto position = [&](uint32_t v) {
+			return reinterpret_cast<const float*>(reinterpret_cast<const std::byte*>(positions) + v * positionStride);
+		};
+
+		// Hard boundaries: triangles missing all three vertices start over
+		// with a cold cache anyway, so moving what follows costs nothing
+		std::vector<uint8_t> misses;
+		SimulateCacheMisses(indices, indexCount, vertexCount, SIMULATED_CACHE_SIZE, misses);
+
+		std::vector<size_t> hard;
+		for(size_t t = 0; t < triangleCount; t++) {
+			if(t == 0 || misses[t] == 3) hard.push_back(t);
+		}
+		hard.push_back(triangleCount);
+
+		// Soft boundaries: within each hard cluster, cut as soon as the misses
+		// of the part since the last cut, from a cold cache, are within the
+		// threshold of the whole cluster's rate
+		std::vector<size_t> clusters;
+		std::vector<uint64_t> insertedAt(vertexCount, 0);
+		uint64_t clock = SIMULATED_CACHE_SIZE + 1;
+
+		for(size_t h = 0; h + 1 < hard.size(); h++) {
+			size_t begin = hard[h];
+			size_t end = hard[h + 1];
+
+			size_t total = 0;
+			for(size_t t = begin; t < end; t++) total += misses[t];
+			float limit = threshold * static_cast<float>(total) / (end - begin);
+
+			size_t start = begin;
+			size_t count = 0;
+			clusters.push_back(start);
+
+			for(size_t t = begin; t < end; t++) {
+				for(size_t i = t * 3; i < t * 3 + 3; i++) {
+					if(clock - insertedAt[indices[i]] > SIMULATED_CACHE_SIZE) {
+						insertedAt[indices[i]] = clock++;
+						count++;
+					}
+				}
+
+				if(t + 1 < end && static_cast<float>(count) / (t - start + 1) <= limit) {
+					start = t + 1;
+					count = 0;
+					clusters.push_back(start);
+					// Flush, every vertex now counts as inserted too long ago
+					clock += SIMULATED_CACHE_SIZE + 1;
+				}
+			}
+
+			clock += SIMULATED_CACHE_SIZE + 1;
+		}
+		clusters.push_back(triangleCount);
+
+		// Area weighted centroids and normals
+		struct Cluster {
+			size_t Begin;
+			size_t End;
+			float Key;
+		};
+
+		double meshCentroid[3] = {};
+		double meshArea = 0.0;
+		std::vector<Cluster> sorted;
+		std::vector<float> data((clusters.size() - 1) * 7, 0.0f);
+
+		for(size_t c = 0; c + 1 < clusters.size(); c++) {
+			float* centroid = &data[c * 7];
+			float* normal = centroid + 3;
+			float& area = centroid[6];
+
+			for(size_t t = clusters[c]; t < clusters[c + 1]; t++) {
+				const float* a = position(indices[t * 3]);
+				const float* b = position(indices[t * 3 + 1]);
+				const float* d = position(indices[t * 3 + 2]);
+
+				float e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+				float e2[3] = { d[0] - a[0], d[1] - a[1], d[2] - a[2] };
+				float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+				float weight = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]) * 0.5f;
+
+				for(int k = 0; k < 3; k++) {
+					float center = (a[k] + b[k] + d[k]) / 3.0f;
+					centroid[k] += center * weight;
+					normal[k] += n[k];
+					meshCentroid[k] += center * weight;
+				}
+				area += weight;
+				meshArea += weight;
+			}
+
+			if(area > 0.0f) {
+				for(int k = 0; k < 3; k++) centroid[k] /= area;
+			}
+		}
+
+		if(meshArea > 0.0) {
+			for(int k = 0; k < 3; k++) meshCentroid[k] /= meshArea;
+		}
+
+		for(size_t c = 0; c + 1 < clusters.size(); c++) {
+			const float* centroid = &data[c * 7];
+			const float* normal = centroid + 3;
+
+			float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+			float key = 0.0f;
+			if(length > 0.0f) {
+				for(int k = 0; k < 3; k++) key += (centroid[k] - static_cast<float>(meshCentroid[k])) * normal[k] / length;
+			}
+
+			sorted.push_back({ clusters[c], clusters[c + 1], key });
+		}
+
+		std::stable_sort(sorted.begin(), sorted.end(), [](const Cluster& a, const Cluster& b) { return a.Key > b.Key; });
+
+		std::vector<uint32_t> output;
+		output.reserve(indexCount);
+		for(const Cluster& cluster : sorted) {
+			output.insert(output.end(), indices + cluster.Begin * 3, indices + cluster.End * 3);
+		}
+
+		std::memcpy(indices, output.data(), triangleCount * 3 * sizeof(uint32_t));
+	}
+
+	size_t OptimizeVertexFetch(uint32_t* indices, size_t indexCount, size_t vertexCount, std::vector<uint32_t>& remap) {
+		remap.assign(vertexCount, UINT32_MAX);
+
+		uint32_t next = 0;
+		for(size_t i = 0; i < indexCount; i++) {
+			uint32_t& target = remap[indices[i]];
+			if(target == UINT32_MAX) target = next++;
+			indices[i] = target;
+		}
+
+		return next;
+	}
+
+	// Area weighted sum of squared distances to triangle planes, so the
+	// error of a position is Evaluate(p) / Weight
+	struct Quadric {
+		double A00 = 0, A01 = 0, A02 = 0, A11 = 0, A12 = 0, A22 = 0;
+		double B0 = 0, B1 = 0, B2 = 0;
+		double C = 0;
+		double Weight = 0;
+
+		void AddPlane(const double n[3], double d, double weight) {
+			A00 += weight * n[0] * n[0]; A01 += weight * n[0] * n[1]; A02 += weight * n[0] * n[2];
+			A11 += weight * n[1] * n[1]; A12 += weight * n[1] * n[2]; A22 += weight * n[2] * n[2];
+			B0 += weight * n[0] * d; B1 += weight * n[1] * d; B2 += weight * n[2] * d;
+			C += weight * d * d;
+			Weight += weight;
+		}
+
+		void Add(const Quadric& other) {
+			A00 += other.A00; A01 += other.A01; A02 += other.A02;
+			A11 += other.A11; A12 += other.A12; A22 += other.A22;
+			B0 += other.B0; B1 += other.B1; B2 += other.B2;
+			C += other.C;
+			Weight += other.Weight;
+		}
+
+		double Evaluate(const float* p) const {
+			double x = p[0], y = p[1], z = p[2];
+			double result = A00 * x * x + A11 * y * y + A22 * z * z
+				+ 2.0 * (A01 * x * y + A02 * x * z + A12 * y * z)
+				+ 2.0 * (B0 * x + B1 * y + B2 * z) + C;
+			return std::max(result, 0.0);
+		}
+	};
+
+	size_t SimplifyMesh(uint32_t* destination, const uint32_t* indices, size_t indexCount, const float* positions, size_t vertexCount, size_t positionStride,
+						size_t targetIndexCount, float targetError, float* resultError) {
+		auto position = [&](uint32_t v) {
+			return reinterpret_cast<const float*>(reinterpret_cast<const std::byte*>(positions) + v * positionStride);
+		};
+
+		std::vector<uint32_t> current(indices, indices + indexCount);
+		float reached = 0.0f;
+
+		// Vertices at the same position, split by seams, share one canonical
+		// vertex, which is what collapses and carries the quadric
+		std::vector<uint32_t> canonical(vertexCount);
+		std::vector<uint32_t> wedges(vertexCount, 0);
+		{
+			struct PositionHash {
+				size_t operator()(const std::array<float, 3>& p) const {
+					uint32_t bits[3];
+					std::memcpy(bits, p.data(), sizeof(bits));
+					return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+				}
+			};
+
+			std::unordered_map<std::array<float, 3>, uint32_t, PositionHash> first;
+			for(uint32_t v = 0; v < vertexCount; v++) {
+				const float* p = position(v);
+				canonical[v] = first.try_emplace({ p[0], p[1], p[2] }, v).first->second;
+			}
+
+			std::vector<bool> used(vertexCount, false);
+			for(uint32_t index : current) {
+				if(!used[index]) {
+					used[index] = true;
+					wedges[canonical[index]]++;
+				}
+			}
+		}
+
+		// Vertices on open borders or non-manifold edges stay where they are
+		std::vector<bool> locked(vertexCount, false);
+		{
+			std::unordered_map<uint64_t, uint32_t> edges;
+			for(size_t i = 0; i < current.size(); i += 3) {
+				for(int e = 0; e < 3; e++) {
+					uint32_t a = canonical[current[i + e]];
+					uint32_t b = canonical[current[i + (e + 1) % 3]];
+					edges[(uint64_t(std::min(a, b)) << 32) | std::max(a, b)]++;
+				}
+			}
+			for(const auto& [edge, count] : edges) {
+				if(count != 2) {
+					locked[edge >> 32] = true;
+					locked[edge & 0xFFFFFFFF] = true;
+				}
+			}
+		}
+
+		std::vector<Quadric> quadrics(vertexCount);
+		for(size_t i = 0; i < current.size(); i += 3) {
+			const float* p0 = position(canonical[current[i]]);
+			const float* p1 = position(canonical[current[i + 1]]);
+			const float* p2 = position(canonical[current[i + 2]]);
+
+			double e1[3] = { double(p1[0]) - p0[0], double(p1[1]) - p0[1], double(p1[2]) - p0[2] };
+			double e2[3] = { double(p2[0]) - p0[0], double(p2[1]) - p0[1], double(p2[2]) - p0[2] };
+			double n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+			double length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+			if(length == 0.0) continue;
+
+			for(double& component : n) component /= length;
+			double d = -(n[0] * p0[0] + n[1] * p0[1] + n[2] * p0[2]);
+			double area = length * 0.5;
+
+			for(int c = 0; c < 3; c++) quadrics[canonical[current[i + c]]].AddPlane(n, d, area);
+		}
+
+		struct Collapse {
+			uint32_t From;
+			uint32_t To;
+			double Cost;
+		};
+
+		std::vector<uint32_t> offsets(vertexCount + 1);
+		std::vector<uint32_t> adjacency;
+		std::vector<Collapse> candidates;
+		std::vector<uint32_t> remap(vertexCount);
+		std::vector<bool> touched(vertexCount);
+		double limit = double(targetError) * targetError;
+
+		auto flips = [&](uint32_t from, const float* target) {
+			for(uint32_t k = offsets[from]; k < offsets[from + 1]; k++) {
+				const uint32_t* triangle = &current[adjacency[k] * 3];
+				const float* corners[3];
+				bool moved = false;
+				for(int c = 0; c < 3; c++) corners[c] = position(canonical[triangle[c]]);
+
+				float before[3], after[3];
+				auto normal = [](const float* const* p, float* n) {
+					float e1[3] = { p[1][0] - p[0][0], p[1][1] - p[0][1], p[1][2] - p[0][2] };
+					float e2[3] = { p[2][0] - p[0][0], p[2][1] - p[0][1], p[2][2] - p[0][2] };
+					n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+					n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+					n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+				};
+
+				normal(corners, before);
+				for(int c = 0; c < 3; c++) {
+					if(canonical[triangle[c]] == from) {
+						corners[c] = target;
+						moved = true;
+					}
+				}
+				// Triangles on the collapsing edge degenerate, which is fine
+				if(!moved || corners[0] == corners[1] || corners[1] == corners[2] || corners[0] == corners[2]) continue;
+
+				normal(corners, after);
+				if(before[0] * after[0] + before[1] * after[1] + before[2] * after[2] <= 0.0f) return true;
+			}
+			return false;
+		};
+
+		while(current.size() > targetIndexCount) {
+			// Triangles around every canonical vertex
+			std::fill(offsets.begin(), offsets.end(), 0);
+			for(uint32_t index : current) offsets[canonical[index] + 1]++;
+			for(size_t v = 0; v < vertexCount; v++) offsets[v + 1] += offsets[v];
+			adjacency.resize(current.size());
+			{
+				std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+				for(size_t i = 0; i < current.size(); i++) adjacency[fill[canonical[current[i]]]++] = static_cast<uint32_t>(i / 3);
+			}
+
+			// Half edge collapses, `From` moving onto `To`. Only vertices with a
+			// single wedge move, so no seam is torn open.
+			candidates.clear();
+			for(size_t i = 0; i < current.size(); i += 3) {
+				for(int e = 0; e < 3; e++) {
+					uint32_t a = canonical[current[i + e]];
+					uint32_t b = canonical[current[i + (e + 1) % 3]];
+
+					for(int direction = 0; direction < 2; direction++) {
+						if(!locked[a] && wedges[a] == 1) {
+							Quadric combined = quadrics[a];
+							combined.Add(quadrics[b]);
+							double cost = combined.Weight > 0.0 ? combined.Evaluate(position(b)) / combined.Weight : 0.0;
+							candidates.push_back({ a, b, cost });
+						}
+						std::swap(a, b);
+					}
+				}
+			}
+
+			std::sort(candidates.begin(), candidates.end(), [](const Collapse& x, const Collapse& y) { return x.Cost < y.Cost; });
+
+			for(uint32_t v = 0; v < vertexCount; v++) remap[v] = v;
+			std::fill(touched.begin(), touched.end(), false);
+
+			size_t triangles = current.size() / 3;
+			size_t targetTriangles = targetIndexCount / 3;
+			size_t collapses = 0;
+
+			for(const Collapse& collapse : candidates) {
+				if(triangles <= targetTriangles || collapse.Cost > limit) break;
+				if(touched[collapse.From] || touched[collapse.To]) continue;
+
+				// The wedge of `To` on the side of `From`: the one the triangles of
+				// the edge use, which must agree when `To` lies on a seam
+				uint32_t target = UINT32_MAX;
+				size_t removed = 0;
+				bool ambiguous = false;
+				for(uint32_t k = offsets[collapse.From]; k < offsets[collapse.From + 1]; k++) {
+					const uint32_t* triangle = &current[adjacency[k] * 3];
+					for(int c = 0; c < 3; c++) {
+						if(canonical[triangle[c]] != collapse.To) continue;
+						if(target != UINT32_MAX && target != triangle[c]) ambiguous = true;
+						target = triangle[c];
+						removed++;
+					}
+				}
+				if(target == UINT32_MAX || ambiguous || flips(collapse.From, position(collapse.To))) continue;
+
+				// `From` has a single wedge, which is itself
+				remap[collapse.From] = target;
+				quadrics[collapse.To].Add(quadrics[collapse.From]);
+				reached = std::max(reached, static_cast<float>(std::sqrt(collapse.Cost)));
+
+				// The triangles around `From` change, so its whole ring waits for
+				// the next pass
+				for(uint32_t k = offsets[collapse.From]; k < offsets[collapse.From + 1]; k++) {
+					const uint32_t* triangle = &current[adjacency[k] * 3];
+					for(int c = 0; c < 3; c++) touched[canonical[triangle[c]]] = true;
+				}
+
+				wedges[collapse.From] = 0;
+				triangles -= removed;
+				collapses++;
+			}
+
+			if(collapses == 0) break;
+
+			size_t write = 0;
+			for(size_t i = 0; i < current.size(); i += 3) {
+				uint32_t a = remap[current[i]], b = remap[current[i + 1]], c = remap[current[i + 2]];
+				if(canonical[a] == canonical[b] || canonical[b] == canonical[c] || canonical[a] == canonical[c]) continue;
+
+				current[write++] = a;
+				current[write++] = b;
+				current[write++] = c;
+			}
+			current.resize(write);
+		}
+
+		std::memcpy(destination, current.data(), current.size() * sizeof(uint32_t));
+		if(resultError) *resultError = reached;
+		return current.size();
+	}
+
+	uint16_t FloatToHalf(float value) {
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+
+		uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+		uint32_t magnitude = bits & 0x7FFFFFFF;
+
+		// Infinity and NaN
+		if(magnitude >= 0x7F800000) return sign | 0x7C00 | (magnitude > 0x7F800000 ? 0x0200 : 0);
+		// Rounds to infinity
+		if(magnitude >= 0x477FF000) return sign | 0x7C00;
+
+		// Subnormal halves, in steps of 2^-24
+		if(magnitude < 0x38800000) {
+			float f;
+			std::memcpy(&f, &magnitude, sizeof(f));
+			return sign | static_cast<uint16_t>(std::lrint(f * 16777216.0f));
+		}
+
+		// Rebias the exponent and round the mantissa to nearest even
+		uint32_t half = (magnitude - 0x38000000) >> 13;
+		uint32_t rest = magnitude & 0x1FFF;
+		if(rest > 0x1000 || (rest == 0x1000 && (half & 1))) half++;
+
+		return sign | static_cast<uint16_t>(half);
+	}
+
+	float HalfToFloat(uint16_t value) {
+		uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+		uint32_t exponent = (value >> 10) & 0x1F;
+		uint32_t mantissa = value & 0x3FF;
+
+		float result;
+		if(exponent == 0) {
+			result = std::ldexp(static_cast<float>(mantissa), -24);
+			return sign ? -result : result;
+		}
+
+		uint32_t bits = exponent == 0x1F
+			? sign | 0x7F800000 | (mantissa << 13)
+			: sign | ((exponent + 112) << 23) | (mantissa << 13);
+		std::memcpy(&result, &bits, sizeof(result));
+		return result;
+	}
+
+	int16_t QuantizeSnorm16(float value) {
+		value = std::clamp(value, -1.0f, 1.0f);
+		return static_cast<int16_t>(std::lrint(value * 32767.0f));
+	}
+
+	void EncodeOctahedral(const float normal[3], int16_t encoded[2]) {
+		float length = std::abs(normal[0]) + std::abs(normal[1]) + std::abs(normal[2]);
+		if(length == 0.0f) {
+			encoded[0] = 0;
+			encoded[1] = 0;
+			return;
+		}
+
+		float u = normal[0] / length;
+		float v = normal[1] / length;
+
+		// The lower hemisphere folds over the diagonals
+		if(normal[2] < 0.0f) {
+			float foldedU = (1.0f - std::abs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+			float foldedV = (1.0f - std::abs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+			u = foldedU;
+			v = foldedV;
+		}
+
+		encoded[0] = QuantizeSnorm16(u);
+		encoded[1] = QuantizeSnorm16(v);
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Kept free of engine headers so the offline mesh importer can share it
+
+namespace Rui {
+	// Index buffer optimizations for triangle lists. Positions are read as
+	// three floats at the start of every `positionStride` bytes.
+
+	// Reorders triangles for the post-transform vertex cache, after Forsyth,
+	// "Linear-Speed Vertex Cache Optimisation". Works for any cache size.
+	void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount);
+
+	// Reorders the output of OptimizeVertexCache to reduce overdraw, after
+	// Sander, Nehab and Barczak, "Fast Triangle Reordering for Vertex
+	// Locality and Reduced Overdraw". The triangles are cut into clusters
+	// wherever the cache misses would stay within `threshold` times the
+	// current rate, and clusters facing away from the mesh centre are drawn
+	// first, since they are the most likely to occlude the rest.
+	void OptimizeOverdraw(uint32_t* indices, size_t indexCount, const float* positions, size_t vertexCount, size_t positionStride, float threshold = 1.05f);
+
+	// Renumbers vertices in the order the indices first use them, so vertex
+	// fetch streams through memory. Rewrites the indices and returns the new
+	// vertex count; remap[old] is the new index, or UINT32_MAX for vertices
+	// no triangle uses.
+	size_t OptimizeVertexFetch(uint32_t* indices, size_t indexCount, size_t vertexCount, std::vector<uint32_t>& remap);
+
+	// Simplifies the triangles by collapsing edges in the order of their
+	// quadric error, after Garland and Heckbert, "Surface Simplification
+	// Using Quadric Error Metrics". Vertices only ever collapse onto others,
+	// so the result indexes the same vertex buffer. Vertices sharing a
+	// position are treated as one; open borders and texture seams are kept.
+	// Stops at `targetIndexCount` indices or once the next collapse would
+	// move the surface by more than `targetError`, in position units. Writes
+	// to `destination`, which may be `indices`, returns the new index count
+	// and stores the largest error reached in `resultError` if given.
+	size_t SimplifyMesh(uint32_t* destination, const uint32_t* indices, size_t indexCount, const float* positions, size_t vertexCount, size_t positionStride,
+						size_t targetIndexCount, float targetError, float* resultError = nullptr);
+
+	// Average transformed vertices per triangle with a FIFO cache of
+	// `cacheSize` entries: 3 at worst, about 0.5 for a regular grid at best
+	float ComputeVertexCacheAcmr(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize = 16);
+
+	// Attribute quantization
+	uint16_t FloatToHalf(float value);
+	float HalfToFloat(uint16_t value);
+	int16_t QuantizeSnorm16(float value);
+	// Unit vector to two snorm16 in octahedral encoding
+	void EncodeOctahedral(const float normal[3], int16_t encoded[2]);
+}
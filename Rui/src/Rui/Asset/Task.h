@@ -0,0 +1,130 @@
+#pragma once
+
+#include "Rui/Core/Core.h"
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+
+namespace Rui {
+	template<typename T>
+	class Task;
+
+	namespace Detail {
+		struct TaskPromiseBase {
+			std::coroutine_handle<> Continuation;
+			std::exception_ptr Exception;
+
+			struct FinalAwaiter {
+				bool await_ready() noexcept { return false; }
+
+				// Symmetric transfer back to whoever awaited us, so long chains of
+				// tasks do not grow the stack
+				template<typename Promise>
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+					std::coroutine_handle<> continuation = handle.promise().Continuation;
+					return continuation ? continuation : std::noop_coroutine();
+				}
+
+				void await_resume() noexcept {}
+			};
+
+			std::suspend_always initial_suspend() noexcept { return {}; }
+			FinalAwaiter final_suspend() noexcept { return {}; }
+
+			void unhandled_exception() { Exception = std::current_exception(); }
+		};
+
+		template<typename T>
+		struct TaskPromise : TaskPromiseBase {
+			std::optional<T> Value;
+
+			Task<T> get_return_object();
+
+			template<typename U>
+			void return_value(U&& value) { Value.emplace(std::forward<U>(value)); }
+
+			T Result() {
+				if(Exception) std::rethrow_exception(Exception);
+				return std::move(*Value);
+			}
+		};
+
+		template<>
+		struct TaskPromise<void> : TaskPromiseBase {
+			Task<void> get_return_object();
+
+			void return_void() {}
+
+			void Result() {
+				if(Exception) std::rethrow_exception(Exception);
+			}
+		};
+	}
+
+	// Lazily started coroutine. It runs once awaited and resumes the awaiting
+	// coroutine on whichever thread it finishes on.
+	template<typename T = void>
+	class Task {
+	public:
+		using promise_type = Detail::TaskPromise<T>;
+
+		Task() = default;
+		explicit Task(std::coroutine_handle<promise_type> handle) : m_Handle(handle) {}
+		Task(Task&& other) noexcept : m_Handle(std::exchange(other.m_Handle, nullptr)) {}
+		~Task() { if(m_Handle) m_Handle.destroy(); }
+
+		Task(const Task&) = delete;
+		Task& operator=(const Task&) = delete;
+		Task& operator=(Task&& other) noexcept {
+			if(this != &other) {
+				if(m_Handle) m_Handle.destroy();
+				m_Handle = std::exchange(other.m_Handle, nullptr);
+			}
+			return *this;
+		}
+
+		bool await_ready() const noexcept { return !m_Handle || m_Handle.done(); }
+
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+			m_Handle.promise().Continuation = awaiting;
+			return m_Handle;
+		}
+
+		T await_resume() { return m_Handle.promise().Result(); }
+	private:
+		std::coroutine_handle<promise_type> m_Handle;
+	};
+
+	namespace Detail {
+		template<typename T>
+		Task<T> TaskPromise<T>::get_return_object() {
+			return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+		}
+
+		inline Task<void> TaskPromise<void>::get_return_object() {
+			return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+		}
+
+		// Eagerly started and self destroying, used to run a task without
+		// anyone awaiting it
+		struct DetachedTask {
+			struct promise_type {
+				DetachedTask get_return_object() noexcept { return {}; }
+				std::suspend_never initial_suspend() noexcept { return {}; }
+				std::suspend_never final_suspend() noexcept { return {}; }
+				void return_void() noexcept {}
+				void unhandled_exception() noexcept { std::terminate(); }
+			};
+		};
+
+		inline DetachedTask RunDetached(Task<void> task) {
+			co_await task;
+		}
+	}
+
+	// Starts a task that nobody awaits. It keeps itself alive until done.
+	inline void Spawn(Task<void> task) {
+		Detail::RunDetached(std::move(task));
+	}
+}
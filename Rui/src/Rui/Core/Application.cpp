@@ -1,5 +1,11 @@
 #include "Application.h"
 
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <filesystem>
+#include <limits>
+
 using Clock = std::chrono::steady_clock;
 using namespace std::literals;
 
@@ -7,27 +13,162 @@ namespace Rui {
 
 	Application* Application::Instance = nullptr;
 
-	Application::Application(const std::string& title, int w, int h) {
-		Rui::Log::Init(title);
+	static constexpr int TICKS_PER_SECOND = 75;
+	// While waiting for a frame slot, input is sampled this often, in ns
+	static constexpr uint64_t INPUT_SAMPLE_INTERVAL = 500'000;
+
+	ApplicationOptions ApplicationOptions::Parse(ApplicationCommandLineArgs args) {
+		ApplicationOptions options;
+
+		for(int i = 1; i < args.Count; i++) {
+			std::string arg = args[i];
+			bool hasValue = i + 1 < args.Count;
+
+			if(arg == "--record" && hasValue) {
+				options.RecordPath = args[++i];
+			} else if(arg == "--replay" && hasValue) {
+				options.ReplayPath = args[++i];
+				options.Headless = true;
+			} else if(arg == "--timings" && hasValue) {
+				options.TimingsPath = args[++i];
+			} else if(arg == "--log" && hasValue) {
+				options.LogPath = args[++i];
+			} else if(arg == "--sync-log") {
+				options.SyncLog = true;
+			} else if(arg == "--loose") {
+				options.LooseFiles = true;
+			} else if(arg == "--headless") {
+				options.Headless = true;
+			} else if(arg == "--gpu" && hasValue) {
+				options.Gpu = args[++i];
+			} else if(arg == "--capture" && hasValue) {
+				options.CapturePath = args[++i];
+			} else if(arg == "--capture-frames" && hasValue) {
+				// strtoul alone would wrap negatives and stop at typos
+				const char* value = args[++i];
+				char* end = nullptr;
+				errno = 0;
+				unsigned long frames = std::strtoul(value, &end, 10);
+				if(!std::isdigit(static_cast<unsigned char>(value[0])) || *end != '\0' || errno == ERANGE || frames > std::numeric_limits<uint32_t>::max()) {
+					options.Errors.push_back("Invalid frame count for --capture-frames: " + std::string(value));
+				} else {
+					options.CaptureFrames = static_cast<uint32_t>(frames);
+				}
+			}
+		}
+
+		return options;
+	}
+
+	Application::Application(const std::string& title, int w, int h, ApplicationCommandLineArgs args) {
+		m_Options = ApplicationOptions::Parse(args);
+
+		LogSettings logSettings;
+		logSettings.Async = !m_Options.SyncLog;
+		if(!m_Options.LogPath.empty()) {
+			logSettings.File = LogFileMode::Rotating;
+			logSettings.FilePath = m_Options.LogPath;
+		}
+
+		Rui::Log::Init(title, logSettings);
 		RUI_CORE_INFO("Creating Logger!");
 
+		for(const std::string& error : m_Options.Errors) {
+			RUI_CORE_ERROR("{0}", error);
+		}
+		if(!m_Options.Errors.empty()) {
+			Close(2);
+		}
+
 		Instance = this;
-		m_Window = Window::Create(title, w, h);
-		m_Window->SetEventCallback(std::bind(&Application::OnEvent, this, std::placeholders::_1));
 
+		if(!m_Options.ReplayPath.empty()) {
+			m_Player = ReplayPlayer::Create(m_Options.ReplayPath);
+			if(m_Player->IsOpen()) {
+				// Replay at the recorded size so the workload is identical
+				w = static_cast<int>(m_Player->GetHeader().Width);
+				h = static_cast<int>(m_Player->GetHeader().Height);
+			} else {
+				m_Running = false;
+			}
+		}
+
+		m_Window = Window::Create(title, w, h, !m_Options.Headless);
+		m_Window->SetEventBus(&m_EventBus);
+		// Ahead of every other subscriber
+		m_Input = std::make_unique<Input>(m_EventBus);
+		m_Window->SetInput(m_Input.get());
+		// Live input would make the replay diverge from the recording
+		m_Window->SetInputEnabled(!m_Player);
+
+		AssetSystem::Init();
+		if(!m_Options.LooseFiles) {
+			MountArchives("res");
+		}
 		RenderSystem::Init();
+
+		if(!m_Options.CapturePath.empty()) {
+			CaptureSettings capture;
+			capture.Path = m_Options.CapturePath;
+			capture.Format = std::filesystem::path(capture.Path).extension() == ".y4m" ? CaptureFormat::Y4m : CaptureFormat::Png;
+			capture.FrameCount = m_Options.CaptureFrames;
+			RenderSystem::StartCapture(capture);
+		}
+
+		if(m_Player) {
+			// The controller reacts to GPU timings, which differ between runs
+			DynamicResolutionSettings settings = RenderSystem::GetDynamicResolution().GetSettings();
+			settings.Enabled = false;
+			RenderSystem::SetDynamicResolution(settings);
+		} else if(!m_Options.RecordPath.empty()) {
+			m_Recorder = ReplayRecorder::Create(m_Options.RecordPath, TICKS_PER_SECOND, w, h);
+			// Recorded as delivered, so a replay posting them at the start of
+			// the frame hands them to the same tick
+			m_EventBus.SubscribeAny<&Application::RecordEvent>(this);
+		}
+
+		m_EventBus.SubscribeAny<&Application::OnEvent>(this);
 	}
 
 	Application::~Application() {
 		RUI_CORE_INFO("Destroying Application!");
+		RenderSystem::Dispose();
+		AssetSystem::Shutdown();
+	}
+
+	void Application::MountArchives(const std::string& directory) {
+		std::vector<std::string> archives;
+		std::error_code error;
+		for(const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+			if(entry.path().extension() == ".rpak") {
+				archives.push_back(entry.path().generic_string());
+			}
+		}
+
+		// Directory order is unspecified, sort so precedence is stable
+		std::sort(archives.begin(), archives.end());
+		for(const std::string& archive : archives) {
+			AssetSystem::Mount(archive);
+		}
 	}
 
 	void Application::Run() {
-		const int tps = 75;
+		if(m_Player) {
+			RunReplay();
+		} else {
+			RunLive();
+		}
+
+		RenderSystem::GetDevice().GetDevice().waitIdle();
+	}
+
+	void Application::RunLive() {
+		const int tps = TICKS_PER_SECOND;
 		auto constexpr dt = std::chrono::duration<long long, std::ratio<1, tps>>{ 1 };
 		using duration = decltype(Clock::duration{} + dt);
 		using time_point = std::chrono::time_point<Clock, duration>;
 
+		// Simulated time, advanced by whole ticks
 		time_point t{};
 
 		time_point currentTime = Clock::now();
@@ -36,9 +177,13 @@ namespace Rui {
 		duration accumulator = 0s;
 
 		int fpsCount = 0;
+		uint64_t reportedRejects = 0;
 
 		while(m_Running) {
 			m_Window->OnUpdate();
+			// Events from other threads are delivered after this frame's input
+			m_ThreadEvents.DrainInto(m_EventBus);
+			AssetSystem::ProcessMainThread();
 			time_point newTime = Clock::now();
 			auto frameTime = newTime - currentTime;
 			if(frameTime > 250ms)
@@ -47,31 +192,115 @@ namespace Rui {
 
 			accumulator += frameTime;
 
-			Timestep ts((double) newTime.time_since_epoch().count(), 1.0f / tps, 0.0);
-
+			uint32_t ticks = 0;
 			while(accumulator >= dt) {
-				m_Scene->OnUpdate(ts);
+				// Pumped again between ticks only so input arriving during a
+				// long one is stamped when it came. It came after newTime, past
+				// every cutoff of this frame, so it goes to the next frame's ticks.
+				if(ticks > 0) m_Window->OnUpdate();
+
+				// Input that had arrived by the wall clock time the end of this
+				// tick stands for; the rest waits for later ticks
+				m_Input->BeginTick();
+				m_Input->Consume(std::chrono::time_point_cast<Clock::duration>(newTime - accumulator + dt));
+				if(m_Recorder) m_Recorder->BeginTick(ticks);
+				m_EventBus.Drain();
+
+				Timestep ts(std::chrono::duration<double>{ t.time_since_epoch() }.count(), 1.0 / tps, 0.0);
+				m_Scene->Update(ts);
 
 				t += dt;
 				accumulator -= dt;
+				ticks++;
 			}
 
 			const double alpha = std::chrono::duration<double>{ accumulator } / dt;
 
+			if(m_Recorder) {
+				m_Recorder->EndFrame(std::chrono::duration<double>{ frameTime }.count(), alpha, ticks);
+			}
+
 			//State state = currentState * alpha + previousState * (1 - alpha);
 			fpsCount++;
 			if (newTime - fpsTime >= 1000ms) {
 				RUI_CORE_INFO("FPS: {0}", fpsCount);
 				fpsCount = 0;
 				fpsTime = newTime;
+
+				uint64_t rejects = m_ThreadEvents.GetStats().Rejected;
+				if(rejects != reportedRejects) {
+					RUI_CORE_WARN("Thread event queue full, {0} events dropped", rejects - reportedRejects);
+					reportedRejects = rejects;
+				}
+
+				InputLatencyStats latency = m_Input->TakeLatencyStats();
+				if(latency.Count > 0) {
+					RUI_CORE_INFO("Input to submit: {0:.2f} ms average, {1:.2f} ms worst over {2} inputs", latency.AverageMs, latency.MaxMs, latency.Count);
+				}
 			}
-			ts.m_Interpolation = alpha;
-			m_Scene->OnRender(ts);
+
+			// Rendering would wait for the GPU to free the frame slot; the
+			// window keeps sampling input meanwhile
+			vk::Result ready;
+			while((ready = RenderSystem::GetSwapChain().WaitForFrame(INPUT_SAMPLE_INTERVAL)) == vk::Result::eTimeout) {
+				m_Window->OnUpdate();
+			}
+			if(ready != vk::Result::eSuccess) {
+				RUI_CORE_FATAL("The GPU stopped responding, exiting");
+				Close(1);
+				break;
+			}
+
+			Timestep ts(std::chrono::duration<double>{ t.time_since_epoch() }.count(), 1.0 / tps, alpha);
+			m_Scene->Render(ts);
 		}
+	}
 
-		RenderSystem::GetDevice().GetDevice().waitIdle();
+	void Application::RunReplay() {
+		const double dt = 1.0 / m_Player->GetHeader().TicksPerSecond;
+		double time = 0.0;
+
+		RUI_CORE_INFO("Replaying {0}", m_Options.ReplayPath);
+
+		ReplayFrame frame;
+		while(m_Running && m_Player->NextFrame(frame)) {
+			auto frameStart = Clock::now();
+
+			// Still pumped so the window can be closed, input is dropped
+			m_Window->OnUpdate();
+			m_ThreadEvents.DrainInto(m_EventBus);
+			AssetSystem::ProcessMainThread();
+
+			for(uint32_t i = 0; i < frame.Ticks; i++) {
+				m_Input->BeginTick();
+				m_Player->PostEvents(m_EventBus, i);
+				m_EventBus.Drain();
+
+				Timestep ts(time, dt, 0.0);
+				m_Scene->Update(ts);
+
+				time += dt;
+			}
+
+			Timestep ts(time, dt, frame.Interpolation);
+			m_Scene->Render(ts);
+
+			double frameMs = std::chrono::duration<double, std::milli>{ Clock::now() - frameStart }.count();
+			m_Player->AddTiming(frameMs, RenderSystem::GetGpuTimings().TotalMs);
+		}
+
+		m_Player->Report(m_Options.TimingsPath);
 	}
-	void Application::OnEvent(Event& e) {
+
+	bool Application::RecordEvent(Event& e) {
+		if(e.IsInCategory(EventCategoryInput)) {
+			m_Recorder->RecordEvent(e);
+		}
+
+		return false;
+	}
+
+	bool Application::OnEvent(Event& e) {
 		EventDispatcher dispatcher(e);
 		dispatcher.Dispatch<WindowClosedEvent>(std::bind(&Application::OnWindowClose, this, std::placeholders::_1));
 		dispatcher.Dispatch<WindowResizedEvent>([&](WindowResizedEvent& ev) -> bool {
@@ -95,6 +324,12 @@ namespace Rui {
 			break;
 		}
 		}
+
+		if(!e.Handled && m_Scene) {
+			m_Scene->OnEvent(e);
+		}
+
+		return e.Handled;
 	}
 
 	bool Application::OnWindowClose(WindowClosedEvent& e) {
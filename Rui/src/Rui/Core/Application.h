@@ -1,28 +1,86 @@
 #pragma once
 #include "Core.h"
 #include "Device.h"
+#include "Input.h"
 #include "Log.h"
 #include "Scene.h"
 #include "SwapChain.h"
 #include "Window.h"
 #include "Timestep.h"
+#include "Replay.h"
 
+#include "Rui/Asset/AssetSystem.h"
+
+#include "Rui/Events/ConcurrentEventQueue.h"
+#include "Rui/Events/EventBus.h"
 #include "Rui/Events/WindowEvent.h"
 #include "Rui/Events/KeyEvent.h"
 
 #include "Rui/Render/RenderSystem.h"
 
 namespace Rui {
+	struct ApplicationCommandLineArgs {
+		int Count = 0;
+		char** Args = nullptr;
+
+		const char* operator[](int index) const {
+			RUI_CORE_ASSERT(index < Count, "Command line argument out of range");
+			return Args[index];
+		}
+	};
+
+	// Parsed from the command line:
+	//   --record <file>   record input and timesteps of this run
+	//   --replay <file>   replay a recording headless and unthrottled
+	//   --timings <file>  write per frame timings of a replay as CSV
+	//   --log <file>      also log to a rotating file
+	//   --sync-log        format and write log messages on the calling thread
+	//   --headless        no visible window and no vsync
+	//   --gpu <name>      first device whose name contains `name`, e.g. a software driver
+	//   --capture <file>  write the presented frames as a Y4M stream for a .y4m
+	//                     file, else as PNGs named file_000001.png and on
+	//   --capture-frames <n>  stop capturing after `n` frames
+	struct ApplicationOptions {
+		std::string RecordPath;
+		std::string ReplayPath;
+		std::string TimingsPath;
+		std::string LogPath;
+		bool SyncLog = false;
+		// Skip the archives in res/ and read loose files only
+		bool LooseFiles = false;
+		// Empty picks the first device
+		std::string Gpu;
+		std::string CapturePath;
+		// 0 captures until exit
+		uint32_t CaptureFrames = 0;
+
+		// No visible window and no vsync; also set when replaying
+		bool Headless = false;
+
+		// Invalid values, logged and exited on once the logger is up
+		std::vector<std::string> Errors;
+
+		static ApplicationOptions Parse(ApplicationCommandLineArgs args);
+	};
+
 	class Application {
 	public:
-		Application(const std::string& title, int w, int h);
+		Application(const std::string& title, int w, int h, ApplicationCommandLineArgs args = ApplicationCommandLineArgs());
 		virtual ~Application();
 
 		void Run();
+		// Leaves Run after the current frame
+		inline void Close(int exitCode = 0) { m_Running = false; m_ExitCode = exitCode; }
+		inline int GetExitCode() const { return m_ExitCode; }
 
-		void OnEvent(Event& e);
+		bool OnEvent(Event& e);
 
 		inline Window& GetDisplay() { return *m_Window; }
+		inline Input& GetInput() { return *m_Input; }
+		inline EventBus& GetEventBus() { return m_EventBus; }
+		// For posting events from other threads
+		inline ConcurrentEventQueue& GetThreadEvents() { return m_ThreadEvents; }
+		inline const ApplicationOptions& GetOptions() const { return m_Options; }
 		inline static Application& Get() { return *Instance; }
 		inline void LoadScene(Scene* scene) {
 			if(m_Scene) m_Scene->OnUnload();
@@ -32,11 +90,26 @@ namespace Rui {
 		}
 
 	private:
+		void RunLive();
+		void RunReplay();
+		// Mounts every .rpak archive in the directory
+		void MountArchives(const std::string& directory);
+
+		bool RecordEvent(Event& e);
+
+		ApplicationOptions m_Options;
+		EventBus m_EventBus;
+		ConcurrentEventQueue m_ThreadEvents;
+
 		std::unique_ptr<Window> m_Window;
+		std::unique_ptr<Input> m_Input;
+		std::unique_ptr<ReplayRecorder> m_Recorder;
+		std::unique_ptr<ReplayPlayer> m_Player;
 
 		Scene* m_Scene = nullptr;
 
 		bool m_Running = true;
+		int m_ExitCode = 0;
 
 		bool OnWindowClose(WindowClosedEvent& e);
 
@@ -44,6 +117,6 @@ namespace Rui {
 		friend int ::main(int argc, char* argv[]);
 	};
 
-	Application* CreateApplication();
+	Application* CreateApplication(ApplicationCommandLineArgs args);
 }
 
@@ -0,0 +1,158 @@
+#include "AsyncLogSink.h"
+
+#include <chrono>
+#include <cstring>
+
+namespace Rui {
+	AsyncLogSink::AsyncLogSink(std::vector<spdlog::sink_ptr> targets, size_t capacity)
+		: m_Targets(std::move(targets)), m_Queue(capacity) {
+		m_Thread = std::thread(&AsyncLogSink::Run, this);
+	}
+
+	AsyncLogSink::~AsyncLogSink() {
+		Stop();
+	}
+
+	void AsyncLogSink::log(const spdlog::details::log_msg& msg) {
+		// Counted in before checking, so Stop can wait for every producer
+		// that still saw the sink running. Sequentially consistent, pairing
+		// with the store and load in Stop.
+		m_Producers.fetch_add(1);
+		if(!m_Running.load()) {
+			m_Producers.fetch_sub(1, std::memory_order_release);
+			Write(msg);
+			return;
+		}
+
+		bool queued = m_Queue.TryEmplace([&](Entry& entry) {
+			entry.Time = msg.time;
+			entry.ThreadId = msg.thread_id;
+			entry.Level = msg.level;
+
+			entry.NameLength = static_cast<uint16_t>(std::min(msg.logger_name.size(), sizeof(entry.Name)));
+			std::memcpy(entry.Name, msg.logger_name.data(), entry.NameLength);
+
+			entry.Length = static_cast<uint16_t>(std::min(msg.payload.size(), sizeof(entry.Payload)));
+			std::memcpy(entry.Payload, msg.payload.data(), entry.Length);
+		});
+		m_Producers.fetch_sub(1, std::memory_order_release);
+
+		if(!queued) {
+			m_Dropped.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	void AsyncLogSink::flush() {
+		if(!m_Running.load(std::memory_order_acquire)) {
+			FlushTargets();
+			return;
+		}
+
+		m_FlushRequested.fetch_add(1, std::memory_order_release);
+	}
+
+	void AsyncLogSink::set_pattern(const std::string& pattern) {
+		for(auto& target : m_Targets) {
+			target->set_pattern(pattern);
+		}
+	}
+
+	void AsyncLogSink::set_formatter(std::unique_ptr<spdlog::formatter> formatter) {
+		for(auto& target : m_Targets) {
+			target->set_formatter(formatter->clone());
+		}
+	}
+
+	void AsyncLogSink::Drain() {
+		if(!m_Running.load(std::memory_order_acquire)) {
+			FlushTargets();
+			return;
+		}
+
+		uint64_t request = m_FlushRequested.fetch_add(1, std::memory_order_release) + 1;
+		while(m_FlushCompleted.load(std::memory_order_acquire) < request) {
+			std::this_thread::yield();
+		}
+	}
+
+	void AsyncLogSink::Stop() {
+		if(!m_Thread.joinable()) return;
+
+		m_Running.store(false);
+		m_Thread.join();
+
+		// Messages queued by producers that saw the sink running but lost
+		// the race with the worker's last drain; this thread is the only
+		// consumer now
+		while(m_Producers.load() > 0) {
+			std::this_thread::yield();
+		}
+		WriteQueued();
+		ReportDropped();
+		FlushTargets();
+	}
+
+	void AsyncLogSink::Run() {
+		using namespace std::chrono_literals;
+
+		for(;;) {
+			// Read before draining: whatever was logged before the request is
+			// then guaranteed to be written before we acknowledge it
+			uint64_t requested = m_FlushRequested.load(std::memory_order_acquire);
+
+			if(WriteQueued() > 0) continue;
+
+			ReportDropped();
+
+			if(requested != m_FlushCompleted.load(std::memory_order_relaxed)) {
+				FlushTargets();
+				m_FlushCompleted.store(requested, std::memory_order_release);
+			}
+
+			// Producers never block on us, so poll rather than have them signal
+			if(!m_Running.load(std::memory_order_acquire) && m_Queue.Size() == 0) break;
+			std::this_thread::sleep_for(1ms);
+		}
+
+		FlushTargets();
+		m_FlushCompleted.store(m_FlushRequested.load(std::memory_order_acquire), std::memory_order_release);
+	}
+
+	size_t AsyncLogSink::WriteQueued() {
+		return m_Queue.Consume([&](Entry& entry) {
+			spdlog::details::log_msg msg(
+				entry.Time,
+				spdlog::source_loc{},
+				spdlog::string_view_t(entry.Name, entry.NameLength),
+				entry.Level,
+				spdlog::string_view_t(entry.Payload, entry.Length));
+			msg.thread_id = entry.ThreadId;
+
+			Write(msg);
+		});
+	}
+
+	void AsyncLogSink::Write(const spdlog::details::log_msg& msg) {
+		for(auto& target : m_Targets) {
+			if(target->should_log(msg.level)) {
+				target->log(msg);
+			}
+		}
+	}
+
+	void AsyncLogSink::FlushTargets() {
+		for(auto& target : m_Targets) {
+			target->flush();
+		}
+	}
+
+	void AsyncLogSink::ReportDropped() {
+		uint64_t dropped = m_Dropped.load(std::memory_order_relaxed);
+		if(dropped == m_ReportedDropped) return;
+
+		std::string text = "Log queue full, dropped " + std::to_string(dropped - m_ReportedDropped) + " messages";
+		Write(spdlog::details::log_msg("RUI", spdlog::level::warn, text));
+
+		m_ReportedDropped = dropped;
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "MPSCQueue.h"
+
+#include "spdlog/sinks/sink.h"
+
+#include <atomic>
+#include <thread>
+
+namespace Rui {
+	// spdlog sink that moves log formatting and I/O off the calling thread.
+	// Messages are copied into a preallocated lock-free ring and written to
+	// the target sinks by a background thread. A full ring drops messages
+	// rather than stalling the caller; drops are counted and reported.
+	class AsyncLogSink : public spdlog::sinks::sink {
+	public:
+		// Longer messages are truncated
+		static constexpr size_t MAX_MESSAGE_SIZE = 256;
+
+		// Targets are also written from the calling thread once the sink has
+		// been stopped, so they must be thread safe (the _mt sinks)
+		AsyncLogSink(std::vector<spdlog::sink_ptr> targets, size_t capacity);
+		~AsyncLogSink() override;
+
+		void log(const spdlog::details::log_msg& msg) override;
+		// Asks the background thread to flush, does not wait for it
+		void flush() override;
+		void set_pattern(const std::string& pattern) override;
+		void set_formatter(std::unique_ptr<spdlog::formatter> formatter) override;
+
+		// Blocks until everything logged before the call has been written
+		void Drain();
+		// Drains and joins the background thread; later messages are written
+		// synchronously
+		void Stop();
+
+		inline uint64_t GetDroppedCount() const { return m_Dropped.load(std::memory_order_relaxed); }
+	private:
+		struct Entry {
+			spdlog::log_clock::time_point Time;
+			size_t ThreadId;
+			spdlog::level::level_enum Level;
+			uint16_t NameLength;
+			uint16_t Length;
+			char Name[32];
+			char Payload[MAX_MESSAGE_SIZE];
+		};
+
+		void Run();
+		// Writes and removes what is queued, returns how many messages
+		size_t WriteQueued();
+		void Write(const spdlog::details::log_msg& msg);
+		void FlushTargets();
+		void ReportDropped();
+
+		std::vector<spdlog::sink_ptr> m_Targets;
+		MPSCQueue<Entry> m_Queue;
+
+		std::thread m_Thread;
+		std::atomic<bool> m_Running = true;
+		// Inside log() on the queued path
+		std::atomic<uint32_t> m_Producers = 0;
+
+		std::atomic<uint64_t> m_FlushRequested = 0;
+		std::atomic<uint64_t> m_FlushCompleted = 0;
+
+		std::atomic<uint64_t> m_Dropped = 0;
+		uint64_t m_ReportedDropped = 0;
+	};
+}
@@ -40,12 +40,14 @@ namespace Rui {
 		CreateLogicalDevice();
 		CreateCommandPool();
 
-		vma::AllocatorCreateInfo create_info({}, m_PhysicalDevice, m_Device);
-		vma::createAllocator(&create_info, &m_Allocator);
+		m_Allocator = std::make_unique<GpuAllocator>(m_Instance, m_PhysicalDevice, m_Device, m_SupportsMemoryBudget, SwapChain::MAX_FRAMES_IN_FLIGHT);
 	}
 
 	Device::~Device() {
 		//m_Device.waitIdle();
+		m_Allocator.reset();
+		m_GraphicsTimeline.reset();
+
 		if(enableValidationLayers) {
 			DestroyDebugUtilsMessengerEXT(m_Instance, m_DebugMessenger, nullptr);
 		}
@@ -109,7 +111,25 @@ namespace Rui {
 		}
 
 		m_PhysicalDevice = devices[0];
+
+		const std::string& wanted = Application::Get().GetOptions().Gpu;
+		if(!wanted.empty()) {
+			auto it = std::find_if(devices.begin(), devices.end(), [&](const vk::PhysicalDevice& device) {
+				return std::string(device.getProperties().deviceName).find(wanted) != std::string::npos;
+			});
+
+			if(it != devices.end()) {
+				m_PhysicalDevice = *it;
+			} else {
+				RUI_CORE_WARN("No device matches {0}, using the first one", wanted);
+			}
+		}
+
 		RUI_CORE_TRACE("Chosen Device: {0} - {1}", m_PhysicalDevice.getProperties().deviceID, m_PhysicalDevice.getProperties().deviceName);
+
+		vk::PhysicalDeviceLimits limits = m_PhysicalDevice.getProperties().limits;
+		m_TimestampPeriod = limits.timestampPeriod;
+		m_SupportsTimestamps = limits.timestampComputeAndGraphics;
 	}
 
 	void Device::CreateLogicalDevice() {
@@ -126,14 +146,56 @@ namespace Rui {
 
 		vk::PhysicalDeviceFeatures device_features;
 		device_features.samplerAnisotropy = true;
+		device_features.fragmentStoresAndAtomics = true; // raymarch step counters
+
+		// Block compressed textures, where the hardware has them
+		vk::PhysicalDeviceFeatures supported_features = m_PhysicalDevice.getFeatures();
+		device_features.textureCompressionBC = supported_features.textureCompressionBC;
+		device_features.textureCompressionASTC_LDR = supported_features.textureCompressionASTC_LDR;
+
+		// Real heap budgets from the driver instead of VMA's estimate
+		std::vector<const char*> extensions = deviceExtensions;
+		bool has_synchronization2 = false;
+		for(const auto& extension : m_PhysicalDevice.enumerateDeviceExtensionProperties().value) {
+			if(std::strcmp(extension.extensionName, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) == 0) {
+				extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+				m_SupportsMemoryBudget = true;
+			}
+			if(std::strcmp(extension.extensionName, VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME) == 0) {
+				has_synchronization2 = true;
+			}
+		}
+
+		// Frames are paced by one timeline semaphore per queue, core since 1.2
+		vk::PhysicalDeviceSynchronization2FeaturesKHR supported_synchronization2;
+		vk::PhysicalDeviceVulkan12Features supported_features12;
+		if(has_synchronization2) supported_features12.pNext = &supported_synchronization2;
+		vk::PhysicalDeviceFeatures2 supported_features2;
+		supported_features2.pNext = &supported_features12;
+		m_PhysicalDevice.getFeatures2(&supported_features2);
+
+		RUI_CORE_ASSERT(supported_features12.timelineSemaphore, "Timeline semaphores are not supported!");
+
+		vk::PhysicalDeviceVulkan12Features features12;
+		features12.timelineSemaphore = true;
+
+		vk::PhysicalDeviceSynchronization2FeaturesKHR synchronization2;
+		if(has_synchronization2 && supported_synchronization2.synchronization2) {
+			extensions.push_back(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+			synchronization2.synchronization2 = true;
+			features12.pNext = &synchronization2;
+			m_SupportsSynchronization2 = true;
+		}
+		RUI_CORE_TRACE("Synchronization2: {0}", m_SupportsSynchronization2 ? "yes" : "no");
 
 		vk::DeviceCreateInfo create_info;
+		create_info.pNext					= &features12;
 		create_info.queueCreateInfoCount	= static_cast<uint32_t>(queue_create_info.size());
 		create_info.pQueueCreateInfos		= queue_create_info.data();
 
 		create_info.pEnabledFeatures	    = &device_features;
-		create_info.enabledExtensionCount   = static_cast<uint32_t>(deviceExtensions.size());
-		create_info.ppEnabledExtensionNames = deviceExtensions.data();
+		create_info.enabledExtensionCount   = static_cast<uint32_t>(extensions.size());
+		create_info.ppEnabledExtensionNames = extensions.data();
 
 		if(enableValidationLayers) {
 			create_info.enabledLayerCount	= static_cast<uint32_t>(validationLayers.size());
@@ -146,6 +208,87 @@ namespace Rui {
 
 		m_Device.getQueue(indices.GraphicsFamily, 0, &m_GraphicsQueue);
 		m_Device.getQueue(indices.PresentFamily,  0, &m_PresentQueue);
+		m_Dispatch = vk::DispatchLoaderDynamic(m_Instance, vkGetInstanceProcAddr, m_Device);
+
+		m_GraphicsTimeline = std::make_unique<QueueTimeline>(m_Device, m_GraphicsQueue, indices.GraphicsFamily);
+	}
+
+	uint64_t Device::Submit(QueueTimeline& timeline, const std::vector<vk::CommandBuffer>& commandBuffers,
+							const std::vector<SemaphoreSubmit>& waits, const std::vector<SemaphoreSubmit>& signals) {
+		uint64_t value = timeline.Advance();
+
+		std::vector<SemaphoreSubmit> allSignals = signals;
+		allSignals.push_back({ timeline.GetSemaphore(), value, vk::PipelineStageFlagBits2KHR::eAllCommands });
+
+		vk::Result result;
+		if(m_SupportsSynchronization2) {
+			std::vector<vk::SemaphoreSubmitInfoKHR> waitInfos;
+			for(const SemaphoreSubmit& wait : waits) {
+				waitInfos.emplace_back(wait.Semaphore, wait.Value, wait.Stages);
+			}
+
+			std::vector<vk::SemaphoreSubmitInfoKHR> signalInfos;
+			for(const SemaphoreSubmit& signal : allSignals) {
+				signalInfos.emplace_back(signal.Semaphore, signal.Value, signal.Stages);
+			}
+
+			std::vector<vk::CommandBufferSubmitInfoKHR> commandBufferInfos;
+			for(vk::CommandBuffer commandBuffer : commandBuffers) {
+				commandBufferInfos.emplace_back(commandBuffer);
+			}
+
+			vk::SubmitInfo2KHR submitInfo;
+			submitInfo.waitSemaphoreInfoCount = static_cast<uint32_t>(waitInfos.size());
+			submitInfo.pWaitSemaphoreInfos = waitInfos.data();
+			submitInfo.commandBufferInfoCount = static_cast<uint32_t>(commandBufferInfos.size());
+			submitInfo.pCommandBufferInfos = commandBufferInfos.data();
+			submitInfo.signalSemaphoreInfoCount = static_cast<uint32_t>(signalInfos.size());
+			submitInfo.pSignalSemaphoreInfos = signalInfos.data();
+
+			result = timeline.GetQueue().submit2KHR(1, &submitInfo, nullptr, m_Dispatch);
+		} else {
+			// The legacy stage bits are the low bits of their 2KHR counterparts.
+			// Signal operations of vkQueueSubmit always cover all commands.
+			std::vector<vk::Semaphore> waitSemaphores;
+			std::vector<uint64_t> waitValues;
+			std::vector<vk::PipelineStageFlags> waitStages;
+			for(const SemaphoreSubmit& wait : waits) {
+				waitSemaphores.push_back(wait.Semaphore);
+				waitValues.push_back(wait.Value);
+				waitStages.push_back(vk::PipelineStageFlags(static_cast<VkPipelineStageFlags>(static_cast<VkPipelineStageFlags2KHR>(wait.Stages))));
+			}
+
+			std::vector<vk::Semaphore> signalSemaphores;
+			std::vector<uint64_t> signalValues;
+			for(const SemaphoreSubmit& signal : allSignals) {
+				signalSemaphores.push_back(signal.Semaphore);
+				signalValues.push_back(signal.Value);
+			}
+
+			vk::TimelineSemaphoreSubmitInfo timelineInfo;
+			timelineInfo.waitSemaphoreValueCount = static_cast<uint32_t>(waitValues.size());
+			timelineInfo.pWaitSemaphoreValues = waitValues.data();
+			timelineInfo.signalSemaphoreValueCount = static_cast<uint32_t>(signalValues.size());
+			timelineInfo.pSignalSemaphoreValues = signalValues.data();
+
+			vk::SubmitInfo submitInfo;
+			submitInfo.pNext = &timelineInfo;
+			submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+			submitInfo.pWaitSemaphores = waitSemaphores.data();
+			submitInfo.pWaitDstStageMask = waitStages.data();
+			submitInfo.commandBufferCount = static_cast<uint32_t>(commandBuffers.size());
+			submitInfo.pCommandBuffers = commandBuffers.data();
+			submitInfo.signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
+			submitInfo.pSignalSemaphores = signalSemaphores.data();
+
+			result = timeline.GetQueue().submit(1, &submitInfo, nullptr);
+		}
+
+		if(result != vk::Result::eSuccess) {
+			RUI_CORE_ERROR("Failed to submit to queue family {0}!", timeline.GetFamily());
+		}
+
+		return value;
 	}
 
 	void Device::CreateCommandPool() {
@@ -181,27 +324,18 @@ namespace Rui {
 
 		int i = 0;
 		for(const auto& queue_family : queue_families) {
-			if(queue_family.queueCount > 0 && queue_family.queueFlags & vk::QueueFlagBits::eGraphics) {
+			if(!indices.GraphicsFamilyHasValue && queue_family.queueCount > 0 && queue_family.queueFlags & vk::QueueFlagBits::eGraphics) {
 				indices.GraphicsFamily = i;
 				indices.GraphicsFamilyHasValue = true;
 			}
 			//bool presentSupport = false;
 			vk::Bool32 presentSupport;
 			device.getSurfaceSupportKHR(i, m_Surface, &presentSupport);
-			if(queue_family.queueCount > 0 && presentSupport) {
+			if(!indices.PresentFamilyHasValue && queue_family.queueCount > 0 && presentSupport) {
 				indices.PresentFamily = i;
 				indices.PresentFamilyHasValue = true;
 			}
 
-			if(queue_family.queueCount > 0 && queue_family.queueFlags & vk::QueueFlagBits::eCompute) {
-				indices.ComputeFamily = i;
-				indices.ComputeFamilyHasValue = true;
-			}
-
-			if(indices.IsComplete()) {
-				break;
-			}
-
 			i++;
 		}
 
@@ -234,6 +368,12 @@ namespace Rui {
 		return details;
 	}
 
+	bool Device::IsFormatSupported(vk::Format format, vk::FormatFeatureFlags features) {
+		vk::FormatProperties props;
+		m_PhysicalDevice.getFormatProperties(format, &props);
+		return (props.optimalTilingFeatures & features) == features;
+	}
+
 	vk::Format Device::FindSupportedFormat(const std::vector<vk::Format>& candidates, vk::ImageTiling tiling, vk::FormatFeatureFlags features) {
 		for(vk::Format format : candidates) {
 			vk::FormatProperties props;
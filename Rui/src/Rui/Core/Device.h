@@ -9,7 +9,8 @@
 #define VULKAN_HPP_NO_EXCEPTIONS
 #include <vulkan/vulkan.hpp>
 
-#include "vk_mem_alloc.hpp"
+#include "GpuAllocator.h"
+#include "Timeline.h"
 #include "Window.h"
 
 namespace Rui {
@@ -22,15 +23,22 @@ namespace Rui {
 	struct QueueFamilyIndices {
 		uint32_t GraphicsFamily;
 		uint32_t PresentFamily;
-		uint32_t ComputeFamily;
 
 		bool GraphicsFamilyHasValue = false;
 		bool PresentFamilyHasValue = false;
-		bool ComputeFamilyHasValue = false;
 
 		bool IsComplete() { return GraphicsFamilyHasValue && PresentFamilyHasValue; }
 	};
 
+	// Semaphore a submission waits on or signals
+	struct SemaphoreSubmit {
+		vk::Semaphore Semaphore;
+		// Ignored for binary semaphores
+		uint64_t Value = 0;
+		// Stages waiting for, or signaling, the semaphore
+		vk::PipelineStageFlags2KHR Stages = vk::PipelineStageFlagBits2KHR::eAllCommands;
+	};
+
 	class Device {
 	public:
 #ifdef NDEBUG
@@ -47,14 +55,28 @@ namespace Rui {
 		inline vk::Queue& GraphicsQueue() { return m_GraphicsQueue; }
 		inline vk::Queue& PresentQueue() { return m_PresentQueue; }
 
+		inline QueueTimeline& GetGraphicsTimeline() { return *m_GraphicsTimeline; }
+		inline bool SupportsSynchronization2() const { return m_SupportsSynchronization2; }
+
+		// Submits to the timeline's queue, signaling its next value on top of
+		// `signals`, and returns that value. Goes through vkQueueSubmit2 where
+		// VK_KHR_synchronization2 is available.
+		uint64_t Submit(QueueTimeline& timeline, const std::vector<vk::CommandBuffer>& commandBuffers,
+						const std::vector<SemaphoreSubmit>& waits = {}, const std::vector<SemaphoreSubmit>& signals = {});
+
+		inline vk::PhysicalDevice GetPhysicalDevice() const { return m_PhysicalDevice; }
+		inline GpuAllocator& GetAllocator() { return *m_Allocator; }
+		inline float GetTimestampPeriod() const { return m_TimestampPeriod; }
+		inline bool SupportsTimestamps() const { return m_SupportsTimestamps; }
+
 		inline QueueFamilyIndices FindPhysicalQueueFamilies() { return FindQueueFamilies(m_PhysicalDevice); }
 		inline SwapChainSupportDetails GetSwapChainSupport() { return QuerySwapChainSupport(m_PhysicalDevice); }
 
+		// Optimal tiling
+		bool IsFormatSupported(vk::Format format, vk::FormatFeatureFlags features);
 		vk::Format FindSupportedFormat(const std::vector<vk::Format>& candidates, vk::ImageTiling tiling, vk::FormatFeatureFlags features);
 		uint32_t FindMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties);
 
-		vma::Allocator m_Allocator;
-
 		static std::unique_ptr<Device> Create();
 	private:
 
@@ -62,13 +84,22 @@ namespace Rui {
 		vk::DebugUtilsMessengerEXT m_DebugMessenger;
 		vk::PhysicalDevice m_PhysicalDevice = nullptr;
 		vk::CommandPool m_CommandPool;
-		//vk::DispatchLoaderDynamic dldy;
+		// Extension entry points the loader does not export
+		vk::DispatchLoaderDynamic m_Dispatch;
 		
 		vk::Device m_Device;
 		vk::SurfaceKHR m_Surface;
 		vk::Queue m_GraphicsQueue;
 		vk::Queue m_PresentQueue;
 
+		std::unique_ptr<GpuAllocator> m_Allocator;
+		std::unique_ptr<QueueTimeline> m_GraphicsTimeline;
+
+		float m_TimestampPeriod = 1.0f;
+		bool m_SupportsTimestamps = false;
+		bool m_SupportsMemoryBudget = false;
+		bool m_SupportsSynchronization2 = false;
+
 		void CreateInstance();
 		void SetupDebugMessenger();
 		void CreateSurface();
@@ -1,12 +1,14 @@
 #pragma once
 
-extern Rui::Application* Rui::CreateApplication();
+extern Rui::Application* Rui::CreateApplication(Rui::ApplicationCommandLineArgs args);
 
 int main(int argc, char** argv) {
-	auto app = Rui::CreateApplication();
+	auto app = Rui::CreateApplication({ argc, argv });
 	app->Run();
+	int exitCode = app->GetExitCode();
 
 	delete app;
+	Rui::Log::Shutdown();
 	
-	return 0;
+	return exitCode;
 }
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Core.h"
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+namespace Rui {
+    // Linear allocator over a buffer allocated once. Allocations are only
+    // released together by Reset, so only trivially destructible objects
+    // may be placed in it.
+    class FrameArena {
+    public:
+        explicit FrameArena(size_t capacity)
+            : m_Buffer(std::make_unique<std::byte[]>(capacity)), m_Capacity(capacity) {
+        }
+
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        // Returns nullptr when the arena is full
+        void* Allocate(size_t size, size_t alignment) {
+            size_t offset = (m_Offset + alignment - 1) & ~(alignment - 1);
+            if(offset + size > m_Capacity) return nullptr;
+
+            m_Offset = offset + size;
+            return m_Buffer.get() + offset;
+        }
+
+        template<typename T, typename ... Args>
+        T* New(Args&& ... args) {
+            static_assert(std::is_trivially_destructible_v<T>, "Arena objects are never destroyed");
+            static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned types are not supported");
+
+            void* memory = Allocate(sizeof(T), alignof(T));
+            return memory ? new(memory) T(std::forward<Args>(args)...) : nullptr;
+        }
+
+        inline void Reset() { m_Offset = 0; }
+
+        inline size_t GetUsed() const { return m_Offset; }
+        inline size_t GetCapacity() const { return m_Capacity; }
+    private:
+        std::unique_ptr<std::byte[]> m_Buffer;
+        size_t m_Capacity;
+        size_t m_Offset = 0;
+    };
+}
@@ -0,0 +1,367 @@
+#include "GpuAllocator.h"
+
+namespace Rui {
+	static inline void* ToUserData(MemoryCategory category) {
+		return reinterpret_cast<void*>(static_cast<uintptr_t>(category));
+	}
+
+	static inline MemoryCategory FromUserData(void* userData) {
+		return static_cast<MemoryCategory>(reinterpret_cast<uintptr_t>(userData));
+	}
+
+	const char* ToString(MemoryCategory category) {
+		switch(category) {
+			case MemoryCategory::Geometry:    return "Geometry";
+			case MemoryCategory::Textures:    return "Textures";
+			case MemoryCategory::Attachments: return "Attachments";
+			case MemoryCategory::Staging:     return "Staging";
+			case MemoryCategory::Uniforms:    return "Uniforms";
+			default:                          return "Unknown";
+		}
+	}
+
+	GpuAllocator::GpuAllocator(vk::Instance instance, vk::PhysicalDevice physicalDevice, vk::Device device, bool memoryBudget, uint32_t framesInFlight)
+		: m_Device(device), m_FramesInFlight(framesInFlight) {
+		VmaAllocatorCreateInfo createInfo = {};
+		createInfo.instance = instance;
+		createInfo.physicalDevice = physicalDevice;
+		createInfo.device = device;
+		createInfo.vulkanApiVersion = VK_API_VERSION_1_2;
+		if(memoryBudget) {
+			createInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+		}
+
+		if(vmaCreateAllocator(&createInfo, &m_Allocator) != VK_SUCCESS) {
+			RUI_CORE_ERROR("Failed to create GPU memory allocator!");
+		}
+
+		RUI_CORE_INFO("GPU memory budget: {0}", memoryBudget ? "VK_EXT_memory_budget" : "estimated");
+		UpdateBudget();
+	}
+
+	GpuAllocator::~GpuAllocator() {
+		if(m_Defragmentation) {
+			if(m_PassPending) EndPass();
+			EndDefragmentation();
+		}
+
+		uint32_t leaked = 0;
+		for(size_t i = 0; i < MEMORY_CATEGORY_COUNT; i++) {
+			const MemoryCategoryStats& category = m_Stats.Categories[i];
+			if(category.Allocations > 0) {
+				RUI_CORE_ERROR("GPU memory leak: {0} {1} allocations, {2} bytes", category.Allocations, ToString(static_cast<MemoryCategory>(i)), category.Bytes);
+				leaked += category.Allocations;
+			}
+		}
+
+		// VMA asserts on outstanding allocations; the leak is reported above
+		if(leaked == 0) {
+			vmaDestroyAllocator(m_Allocator);
+		}
+	}
+
+	vk::Result GpuAllocator::CreateBuffer(const vk::BufferCreateInfo& bufferInfo, vk::MemoryPropertyFlags properties, MemoryCategory category,
+										  vk::Buffer* buffer, vma::Allocation* allocation, void** mapped) {
+		VmaAllocationCreateInfo createInfo = {};
+		createInfo.requiredFlags = static_cast<VkMemoryPropertyFlags>(properties);
+		createInfo.pUserData = ToUserData(category);
+		if(mapped) createInfo.flags |= VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+		VkBuffer vkBuffer;
+		VmaAllocation vmaAllocation;
+		VmaAllocationInfo info;
+		VkResult result = vmaCreateBuffer(m_Allocator, &static_cast<const VkBufferCreateInfo&>(bufferInfo), &createInfo, &vkBuffer, &vmaAllocation, &info);
+		if(result != VK_SUCCESS) {
+			RUI_CORE_ERROR("Failed to allocate {0} bytes of {1} memory: {2}", bufferInfo.size, ToString(category), vk::to_string(static_cast<vk::Result>(result)));
+			return static_cast<vk::Result>(result);
+		}
+
+		*buffer = vkBuffer;
+		*allocation = vma::Allocation(vmaAllocation);
+		if(mapped) *mapped = info.pMappedData;
+
+		Track(*allocation, category);
+		return vk::Result::eSuccess;
+	}
+
+	vk::Result GpuAllocator::CreateImage(const vk::ImageCreateInfo& imageInfo, vk::MemoryPropertyFlags properties, MemoryCategory category,
+										 vk::Image* image, vma::Allocation* allocation) {
+		VmaAllocationCreateInfo createInfo = {};
+		createInfo.requiredFlags = static_cast<VkMemoryPropertyFlags>(properties);
+		createInfo.pUserData = ToUserData(category);
+
+		// Streamed textures can always fall back to coarser mips, so they
+		// never push the device into paging
+		if(category == MemoryCategory::Textures) {
+			createInfo.flags |= VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT;
+		}
+
+		// Attachments are reallocated on every resize and rarely share well
+		if(category == MemoryCategory::Attachments) {
+			createInfo.flags |= VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+		}
+
+		VkImage vkImage;
+		VmaAllocation vmaAllocation;
+		VkResult result = vmaCreateImage(m_Allocator, &static_cast<const VkImageCreateInfo&>(imageInfo), &createInfo, &vkImage, &vmaAllocation, nullptr);
+		if(result != VK_SUCCESS) {
+			if(result != VK_ERROR_OUT_OF_DEVICE_MEMORY || category != MemoryCategory::Textures) {
+				RUI_CORE_ERROR("Failed to allocate {0}x{1} {2} image: {3}", imageInfo.extent.width, imageInfo.extent.height, ToString(category), vk::to_string(static_cast<vk::Result>(result)));
+			}
+			return static_cast<vk::Result>(result);
+		}
+
+		*image = vkImage;
+		*allocation = vma::Allocation(vmaAllocation);
+
+		Track(*allocation, category);
+		return vk::Result::eSuccess;
+	}
+
+	void GpuAllocator::DestroyBuffer(vk::Buffer buffer, vma::Allocation allocation) {
+		if(!allocation) return;
+
+		Untrack(allocation);
+		if(ReleaseMoving(allocation)) {
+			m_Device.destroyBuffer(buffer, nullptr);
+			return;
+		}
+
+		vmaDestroyBuffer(m_Allocator, static_cast<VkBuffer>(buffer), static_cast<VmaAllocation>(allocation));
+	}
+
+	void GpuAllocator::DestroyImage(vk::Image image, vma::Allocation allocation) {
+		if(!allocation) return;
+
+		Untrack(allocation);
+		if(ReleaseMoving(allocation)) {
+			m_Device.destroyImage(image, nullptr);
+			return;
+		}
+
+		vmaDestroyImage(m_Allocator, static_cast<VkImage>(image), static_cast<VmaAllocation>(allocation));
+	}
+
+	vk::Result GpuAllocator::AllocateMemory(const vk::MemoryRequirements& requirements, vk::MemoryPropertyFlags properties, MemoryCategory category,
+											vma::Allocation* allocation) {
+		VmaAllocationCreateInfo createInfo = {};
+		createInfo.requiredFlags = static_cast<VkMemoryPropertyFlags>(properties);
+		createInfo.pUserData = ToUserData(category);
+
+		VmaAllocation vmaAllocation;
+		VkResult result = vmaAllocateMemory(m_Allocator, &static_cast<const VkMemoryRequirements&>(requirements), &createInfo, &vmaAllocation, nullptr);
+		if(result != VK_SUCCESS) {
+			RUI_CORE_ERROR("Failed to allocate {0} bytes of {1} memory: {2}", requirements.size, ToString(category), vk::to_string(static_cast<vk::Result>(result)));
+			return static_cast<vk::Result>(result);
+		}
+
+		*allocation = vma::Allocation(vmaAllocation);
+
+		Track(*allocation, category);
+		return vk::Result::eSuccess;
+	}
+
+	void GpuAllocator::FreeMemory(vma::Allocation allocation) {
+		if(!allocation) return;
+
+		Untrack(allocation);
+		if(ReleaseMoving(allocation)) return;
+
+		vmaFreeMemory(m_Allocator, static_cast<VmaAllocation>(allocation));
+	}
+
+	void* GpuAllocator::Map(vma::Allocation allocation) {
+		void* data = nullptr;
+		if(vmaMapMemory(m_Allocator, static_cast<VmaAllocation>(allocation), &data) != VK_SUCCESS) {
+			RUI_CORE_ERROR("Failed to map GPU memory!");
+		}
+
+		return data;
+	}
+
+	void GpuAllocator::Unmap(vma::Allocation allocation) {
+		vmaUnmapMemory(m_Allocator, static_cast<VmaAllocation>(allocation));
+	}
+
+	vk::Result GpuAllocator::BindBuffer(vma::Allocation allocation, vk::Buffer buffer) {
+		return static_cast<vk::Result>(vmaBindBufferMemory(m_Allocator, static_cast<VmaAllocation>(allocation), static_cast<VkBuffer>(buffer)));
+	}
+
+	vk::Result GpuAllocator::BindImage(vma::Allocation allocation, vk::Image image, vk::DeviceSize offset) {
+		return static_cast<vk::Result>(vmaBindImageMemory2(m_Allocator, static_cast<VmaAllocation>(allocation), offset, static_cast<VkImage>(image), nullptr));
+	}
+
+	void GpuAllocator::SetRelocator(vma::Allocation allocation, Relocator relocator) {
+		if(relocator) {
+			m_Relocators[static_cast<VmaAllocation>(allocation)] = std::move(relocator);
+		} else {
+			m_Relocators.erase(static_cast<VmaAllocation>(allocation));
+		}
+	}
+
+	void GpuAllocator::Update(vk::CommandBuffer commandBuffer, bool idle) {
+		m_Frame++;
+		vmaSetCurrentFrameIndex(m_Allocator, static_cast<uint32_t>(m_Frame));
+		UpdateBudget();
+
+		// The pass's copies were recorded a full round of frames ago, so they
+		// have completed
+		if(m_PassPending && m_Frame - m_PassFrame >= m_FramesInFlight) {
+			EndPass();
+		}
+
+		if(m_PassPending || !idle || !m_DefragSettings.Enabled) return;
+
+		if(!m_Defragmentation) {
+			if(m_Frame < m_NextCheck) return;
+			m_NextCheck = m_Frame + m_DefragSettings.CheckInterval;
+
+			if(!IsFragmented()) return;
+
+			VmaDefragmentationInfo info = {};
+			info.flags = VMA_DEFRAGMENTATION_FLAG_ALGORITHM_BALANCED_BIT;
+			info.maxBytesPerPass = m_DefragSettings.MaxBytesPerPass;
+			info.maxAllocationsPerPass = m_DefragSettings.MaxMovesPerPass;
+
+			if(vmaBeginDefragmentation(m_Allocator, &info, &m_Defragmentation) != VK_SUCCESS) {
+				RUI_CORE_ERROR("Failed to begin GPU memory defragmentation!");
+				m_Defragmentation = nullptr;
+				return;
+			}
+
+			RUI_CORE_INFO("Defragmenting GPU memory: {0} of {1} bytes unused", m_Stats.UnusedBytes, m_Stats.BlockBytes);
+		}
+
+		BeginPass(commandBuffer);
+	}
+
+	void GpuAllocator::RequestDefragmentation() {
+		m_NextCheck = m_Frame;
+	}
+
+	uint64_t GpuAllocator::GetDeviceHeadroom() const {
+		return m_Stats.DeviceBudget > m_Stats.DeviceUsage ? m_Stats.DeviceBudget - m_Stats.DeviceUsage : 0;
+	}
+
+	void GpuAllocator::Track(vma::Allocation allocation, MemoryCategory category) {
+		VmaAllocationInfo info;
+		vmaGetAllocationInfo(m_Allocator, static_cast<VmaAllocation>(allocation), &info);
+
+		MemoryCategoryStats& stats = m_Stats.Categories[static_cast<size_t>(category)];
+		stats.Bytes += info.size;
+		stats.PeakBytes = std::max(stats.PeakBytes, stats.Bytes);
+		stats.Allocations++;
+
+		m_Stats.Bytes += info.size;
+		m_Stats.PeakBytes = std::max(m_Stats.PeakBytes, m_Stats.Bytes);
+	}
+
+	void GpuAllocator::Untrack(vma::Allocation allocation) {
+		VmaAllocationInfo info;
+		vmaGetAllocationInfo(m_Allocator, static_cast<VmaAllocation>(allocation), &info);
+
+		MemoryCategoryStats& stats = m_Stats.Categories[static_cast<size_t>(FromUserData(info.pUserData))];
+		stats.Bytes -= info.size;
+		stats.Allocations--;
+
+		m_Stats.Bytes -= info.size;
+		m_Relocators.erase(static_cast<VmaAllocation>(allocation));
+	}
+
+	bool GpuAllocator::ReleaseMoving(vma::Allocation allocation) {
+		if(!m_PassPending) return false;
+
+		for(uint32_t i = 0; i < m_Pass.moveCount; i++) {
+			VmaDefragmentationMove& move = m_Pass.pMoves[i];
+			if(move.srcAllocation == static_cast<VmaAllocation>(allocation)) {
+				// Allocations in a pass must not be freed directly; VMA frees
+				// both places when the pass ends
+				move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_DESTROY;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void GpuAllocator::UpdateBudget() {
+		const VkPhysicalDeviceMemoryProperties* properties;
+		vmaGetMemoryProperties(m_Allocator, &properties);
+
+		std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets;
+		vmaGetHeapBudgets(m_Allocator, budgets.data());
+
+		m_Stats.DeviceBudget = 0;
+		m_Stats.DeviceUsage = 0;
+		for(uint32_t heap = 0; heap < properties->memoryHeapCount; heap++) {
+			if(properties->memoryHeaps[heap].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) {
+				m_Stats.DeviceBudget += budgets[heap].budget;
+				m_Stats.DeviceUsage += budgets[heap].usage;
+			}
+		}
+	}
+
+	bool GpuAllocator::IsFragmented() {
+		// Walks every block, hence only every CheckInterval frames
+		VmaTotalStatistics statistics;
+		vmaCalculateStatistics(m_Allocator, &statistics);
+
+		m_Stats.BlockBytes = statistics.total.statistics.blockBytes;
+		m_Stats.UnusedBytes = m_Stats.BlockBytes - statistics.total.statistics.allocationBytes;
+
+		return m_Stats.UnusedBytes >= m_DefragSettings.MinUnusedBytes
+			&& m_Stats.UnusedBytes >= static_cast<uint64_t>(m_Stats.BlockBytes * m_DefragSettings.MinUnusedFraction);
+	}
+
+	void GpuAllocator::BeginPass(vk::CommandBuffer commandBuffer) {
+		VkResult result = vmaBeginDefragmentationPass(m_Allocator, m_Defragmentation, &m_Pass);
+		if(result == VK_SUCCESS) {
+			EndDefragmentation();
+			return;
+		}
+
+		for(uint32_t i = 0; i < m_Pass.moveCount; i++) {
+			VmaDefragmentationMove& move = m_Pass.pMoves[i];
+
+			auto relocator = m_Relocators.find(move.srcAllocation);
+			std::function<void()> retire;
+			if(relocator != m_Relocators.end()) {
+				retire = relocator->second(commandBuffer, vma::Allocation(move.dstTmpAllocation));
+			}
+
+			if(retire) {
+				m_PassRetirements.push_back(std::move(retire));
+			} else {
+				move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+			}
+		}
+
+		m_PassPending = true;
+		m_PassFrame = m_Frame;
+	}
+
+	void GpuAllocator::EndPass() {
+		for(auto& retire : m_PassRetirements) {
+			retire();
+		}
+		m_PassRetirements.clear();
+		m_PassPending = false;
+
+		if(vmaEndDefragmentationPass(m_Allocator, m_Defragmentation, &m_Pass) == VK_SUCCESS) {
+			EndDefragmentation();
+		}
+	}
+
+	void GpuAllocator::EndDefragmentation() {
+		VmaDefragmentationStats stats;
+		vmaEndDefragmentation(m_Allocator, m_Defragmentation, &stats);
+		m_Defragmentation = nullptr;
+
+		m_Stats.DefragmentationRuns++;
+		m_Stats.DefragmentationMoves += stats.allocationsMoved;
+		m_Stats.DefragmentationBytesMoved += stats.bytesMoved;
+		m_Stats.DefragmentationBytesFreed += stats.bytesFreed;
+
+		RUI_CORE_INFO("GPU memory defragmented: {0} allocations moved, {1} bytes freed", stats.allocationsMoved, stats.bytesFreed);
+	}
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "Log.h"
+
+#define VULKAN_HPP_NO_EXCEPTIONS
+#include <vulkan/vulkan.hpp>
+
+#include "vk_mem_alloc.hpp"
+
+namespace Rui {
+	enum class MemoryCategory : uint8_t {
+		Geometry = 0,
+		Textures,
+		Attachments,
+		Staging,
+		Uniforms,
+		Count
+	};
+
+	static constexpr size_t MEMORY_CATEGORY_COUNT = static_cast<size_t>(MemoryCategory::Count);
+
+	const char* ToString(MemoryCategory category);
+
+	struct MemoryCategoryStats {
+		uint64_t Bytes = 0;
+		uint64_t PeakBytes = 0;
+		uint32_t Allocations = 0;
+	};
+
+	struct GpuMemoryStats {
+		std::array<MemoryCategoryStats, MEMORY_CATEGORY_COUNT> Categories;
+		uint64_t Bytes = 0;
+		uint64_t PeakBytes = 0;
+
+		// Device local heaps, from VK_EXT_memory_budget where available and
+		// estimated by VMA otherwise. Usage includes other processes.
+		uint64_t DeviceBudget = 0;
+		uint64_t DeviceUsage = 0;
+
+		// Device memory blocks and the part of them not holding allocations,
+		// as of the last fragmentation check
+		uint64_t BlockBytes = 0;
+		uint64_t UnusedBytes = 0;
+
+		uint32_t DefragmentationRuns = 0;
+		uint32_t DefragmentationMoves = 0;
+		uint64_t DefragmentationBytesMoved = 0;
+		uint64_t DefragmentationBytesFreed = 0;
+	};
+
+	struct DefragmentationSettings {
+		bool Enabled = true;
+		// Frames between fragmentation checks
+		uint32_t CheckInterval = 600;
+		// A run starts once this much of the allocated block memory is unused
+		float MinUnusedFraction = 0.25f;
+		uint64_t MinUnusedBytes = 32ull << 20;
+		// Limits of a single pass; one pass runs per idle frame
+		uint64_t MaxBytesPerPass = 16ull << 20;
+		uint32_t MaxMovesPerPass = 32;
+	};
+
+	// Wraps the VMA allocator so every GPU allocation is accounted to a
+	// category, with current and peak usage, and the device memory budget is
+	// queried every frame.
+	//
+	// Fragmentation is compacted incrementally in idle frames. Allocations
+	// only move if their owner registered a Relocator; everything else stays
+	// in place. All calls are made from the main thread.
+	class GpuAllocator {
+	public:
+		// Creates a replacement for the resource in `target`, records the copy
+		// into `commandBuffer` and switches the owner over to it. Returns what
+		// to run once the GPU no longer uses the old resource, which must then
+		// be destroyed with the plain Vulkan call, or nothing to stay in place.
+		using Relocator = std::function<std::function<void()>(vk::CommandBuffer commandBuffer, vma::Allocation target)>;
+
+		GpuAllocator(vk::Instance instance, vk::PhysicalDevice physicalDevice, vk::Device device, bool memoryBudget, uint32_t framesInFlight);
+		~GpuAllocator();
+
+		GpuAllocator(const GpuAllocator&) = delete;
+		GpuAllocator& operator=(const GpuAllocator&) = delete;
+
+		// Host visible allocations are persistently mapped when `mapped` is
+		// given. Textures are never allowed to exceed the device budget.
+		vk::Result CreateBuffer(const vk::BufferCreateInfo& bufferInfo, vk::MemoryPropertyFlags properties, MemoryCategory category,
+								vk::Buffer* buffer, vma::Allocation* allocation, void** mapped = nullptr);
+		vk::Result CreateImage(const vk::ImageCreateInfo& imageInfo, vk::MemoryPropertyFlags properties, MemoryCategory category,
+							   vk::Image* image, vma::Allocation* allocation);
+		void DestroyBuffer(vk::Buffer buffer, vma::Allocation allocation);
+		void DestroyImage(vk::Image image, vma::Allocation allocation);
+
+		// Memory not tied to a resource, for binding several of them into it
+		// at once, e.g. aliased attachments. Never moved by defragmentation.
+		vk::Result AllocateMemory(const vk::MemoryRequirements& requirements, vk::MemoryPropertyFlags properties, MemoryCategory category,
+								  vma::Allocation* allocation);
+		void FreeMemory(vma::Allocation allocation);
+
+		void* Map(vma::Allocation allocation);
+		void Unmap(vma::Allocation allocation);
+
+		// For relocators to bind the replacement resource, and for resources
+		// placed into memory from AllocateMemory
+		vk::Result BindBuffer(vma::Allocation allocation, vk::Buffer buffer);
+		vk::Result BindImage(vma::Allocation allocation, vk::Image image, vk::DeviceSize offset = 0);
+
+		// Pass nullptr to pin the allocation again
+		void SetRelocator(vma::Allocation allocation, Relocator relocator);
+
+		// Once per frame, after the frame slot's timeline value was reached and
+		// outside of a render pass. Defragmentation only advances when `idle`.
+		void Update(vk::CommandBuffer commandBuffer, bool idle);
+		// Checks fragmentation on the next idle frame instead of waiting for
+		// the check interval
+		void RequestDefragmentation();
+
+		// Device local memory that can still be allocated without going over budget
+		uint64_t GetDeviceHeadroom() const;
+
+		inline const GpuMemoryStats& GetStats() const { return m_Stats; }
+		inline const DefragmentationSettings& GetDefragmentationSettings() const { return m_DefragSettings; }
+		inline void SetDefragmentationSettings(const DefragmentationSettings& settings) { m_DefragSettings = settings; }
+	private:
+		void Track(vma::Allocation allocation, MemoryCategory category);
+		void Untrack(vma::Allocation allocation);
+		// Returns true when the destruction has been handed to a pending move
+		bool ReleaseMoving(vma::Allocation allocation);
+
+		void UpdateBudget();
+		bool IsFragmented();
+		void BeginPass(vk::CommandBuffer commandBuffer);
+		void EndPass();
+		void EndDefragmentation();
+
+		VmaAllocator m_Allocator = nullptr;
+		vk::Device m_Device;
+		uint32_t m_FramesInFlight;
+
+		GpuMemoryStats m_Stats;
+		DefragmentationSettings m_DefragSettings;
+
+		std::unordered_map<VmaAllocation, Relocator> m_Relocators;
+
+		VmaDefragmentationContext m_Defragmentation = nullptr;
+		VmaDefragmentationPassMoveInfo m_Pass = {};
+		bool m_PassPending = false;
+		uint64_t m_PassFrame = 0;
+		std::vector<std::function<void()>> m_PassRetirements;
+
+		uint64_t m_Frame = 0;
+		uint64_t m_NextCheck = 0;
+	};
+}
@@ -0,0 +1,216 @@
+#include "Input.h"
+
+#include "Rui/Events/KeyEvent.h"
+#include "Rui/Events/MouseEvent.h"
+
+namespace Rui {
+	bool EncodeInputEvent(const Event& e, int32_t data[3]) {
+		data[0] = data[1] = data[2] = 0;
+
+		switch(e.GetEventType()) {
+			case EventType::KeyPressed: {
+				const KeyPressedEvent& key = static_cast<const KeyPressedEvent&>(e);
+				data[0] = key.GetKeyCode();
+				data[1] = key.GetRepeatCount();
+				return true;
+			}
+
+			case EventType::KeyReleased:
+			case EventType::KeyTyped: {
+				data[0] = static_cast<const KeyEvent&>(e).GetKeyCode();
+				return true;
+			}
+
+			case EventType::MouseButtonPressed: {
+				const MousePressEvent& mouse = static_cast<const MousePressEvent&>(e);
+				data[0] = mouse.GetButton();
+				data[1] = mouse.GetX();
+				data[2] = mouse.GetY();
+				return true;
+			}
+
+			case EventType::MouseButtonReleased: {
+				const MouseReleaseEvent& mouse = static_cast<const MouseReleaseEvent&>(e);
+				data[0] = mouse.GetButton();
+				data[1] = mouse.GetX();
+				data[2] = mouse.GetY();
+				return true;
+			}
+
+			case EventType::MouseMoved: {
+				const MouseMoveEvent& mouse = static_cast<const MouseMoveEvent&>(e);
+				data[0] = mouse.GetX();
+				data[1] = mouse.GetY();
+				return true;
+			}
+
+			case EventType::MouseScrolled: {
+				const MouseScrollEvent& mouse = static_cast<const MouseScrollEvent&>(e);
+				data[0] = mouse.GetX();
+				data[1] = mouse.GetY();
+				return true;
+			}
+
+			default:
+				return false;
+		}
+	}
+
+	void PostInputEvent(EventBus& bus, EventType type, const int32_t data[3]) {
+		switch(type) {
+			case EventType::KeyPressed: {
+				bus.Post<KeyPressedEvent>(data[0], data[1]);
+				break;
+			}
+
+			case EventType::KeyReleased: {
+				bus.Post<KeyReleasedEvent>(data[0]);
+				break;
+			}
+
+			case EventType::KeyTyped: {
+				bus.Post<KeyTypedEvent>(data[0]);
+				break;
+			}
+
+			case EventType::MouseButtonPressed: {
+				bus.Post<MousePressEvent>(data[0], data[1], data[2]);
+				break;
+			}
+
+			case EventType::MouseButtonReleased: {
+				bus.Post<MouseReleaseEvent>(data[0], data[1], data[2]);
+				break;
+			}
+
+			case EventType::MouseMoved: {
+				bus.Post<MouseMoveEvent>(data[0], data[1]);
+				break;
+			}
+
+			case EventType::MouseScrolled: {
+				bus.Post<MouseScrollEvent>(data[0], data[1]);
+				break;
+			}
+
+			default:
+				break;
+		}
+	}
+
+	Input::Input(EventBus& bus)
+		: m_Bus(bus) {
+		// Subscribed ahead of the application, so state is kept even for
+		// events a handler consumes
+		m_Bus.SubscribeAny<&Input::OnEvent>(this);
+	}
+
+	Input::~Input() {
+		m_Bus.UnsubscribeAny<&Input::OnEvent>(this);
+	}
+
+	void Input::Push(InputDevice device, const InputSample& sample) {
+		Ring& ring = m_Rings[static_cast<size_t>(device)];
+
+		// Ticks have stalled; deliver the oldest with the next one rather
+		// than lose a release
+		if(ring.Count == RING_SIZE) {
+			Post(ring.Front());
+			ring.Pop();
+			m_Overflows++;
+		}
+
+		ring.Samples[(ring.Head + ring.Count) % RING_SIZE] = sample;
+		ring.Count++;
+	}
+
+	void Input::BeginTick() {
+		m_Mouse.MotionX = m_Mouse.MotionY = 0;
+		m_Mouse.WheelX = m_Mouse.WheelY = 0;
+	}
+
+	void Input::Consume(Clock::time_point time) {
+		while(true) {
+			// Oldest sample across the devices
+			Ring* next = nullptr;
+			for(Ring& ring : m_Rings) {
+				if(ring.Count == 0 || ring.Front().Time > time) continue;
+				if(!next || ring.Front().Time < next->Front().Time) next = &ring;
+			}
+			if(!next) break;
+
+			Post(next->Front());
+			next->Pop();
+		}
+	}
+
+	void Input::OnSubmit() {
+		if(m_Consumed.empty()) return;
+
+		Clock::time_point now = Clock::now();
+		for(Clock::time_point time : m_Consumed) {
+			double ms = std::chrono::duration<double, std::milli>{ now - time }.count();
+			m_LatencyTotalMs += ms;
+			m_Latency.MaxMs = std::max(m_Latency.MaxMs, ms);
+			m_Latency.Count++;
+		}
+		m_Consumed.clear();
+	}
+
+	InputLatencyStats Input::TakeLatencyStats() {
+		InputLatencyStats stats = m_Latency;
+		if(stats.Count > 0) stats.AverageMs = m_LatencyTotalMs / stats.Count;
+
+		m_Latency = {};
+		m_LatencyTotalMs = 0.0;
+		return stats;
+	}
+
+	bool Input::OnEvent(Event& e) {
+		switch(e.GetEventType()) {
+			case EventType::KeyPressed: {
+				m_KeysDown.insert(static_cast<KeyEvent&>(e).GetKeyCode());
+				break;
+			}
+
+			case EventType::KeyReleased: {
+				m_KeysDown.erase(static_cast<KeyEvent&>(e).GetKeyCode());
+				break;
+			}
+
+			case EventType::MouseButtonPressed: {
+				m_Mouse.Buttons |= 1u << (static_cast<MousePressEvent&>(e).GetButton() - 1);
+				break;
+			}
+
+			case EventType::MouseButtonReleased: {
+				m_Mouse.Buttons &= ~(1u << (static_cast<MouseReleaseEvent&>(e).GetButton() - 1));
+				break;
+			}
+
+			case EventType::MouseMoved: {
+				MouseMoveEvent& mouse = static_cast<MouseMoveEvent&>(e);
+				m_Mouse.MotionX += mouse.GetX();
+				m_Mouse.MotionY += mouse.GetY();
+				break;
+			}
+
+			case EventType::MouseScrolled: {
+				MouseScrollEvent& mouse = static_cast<MouseScrollEvent&>(e);
+				m_Mouse.WheelX += mouse.GetX();
+				m_Mouse.WheelY += mouse.GetY();
+				break;
+			}
+
+			default:
+				break;
+		}
+
+		return false;
+	}
+
+	void Input::Post(const InputSample& sample) {
+		PostInputEvent(m_Bus, sample.Type, sample.Data);
+		m_Consumed.push_back(sample.Time);
+	}
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "Core.h"
+
+#include "Rui/Events/EventBus.h"
+
+#include <array>
+#include <chrono>
+#include <unordered_set>
+
+namespace Rui {
+	enum class InputDevice : uint8_t {
+		Keyboard = 0,
+		Mouse,
+		Count
+	};
+
+	// Payload of an input event: the constructor arguments of its class, as
+	// sampled and as stored in replays
+	struct InputSample {
+		// SDL's millisecond event stamp re-based onto steady_clock, so input
+		// latency stats are quantized to 1 ms
+		std::chrono::steady_clock::time_point Time;
+		EventType Type = EventType::None;
+		int32_t Data[3] = {};
+	};
+
+	// Fills `data` from an input event. Returns false for other events.
+	bool EncodeInputEvent(const Event& e, int32_t data[3]);
+	void PostInputEvent(EventBus& bus, EventType type, const int32_t data[3]);
+
+	struct MouseState {
+		// Bit `button - 1` for each button held, SDL_BUTTON_LEFT is 1
+		uint32_t Buttons = 0;
+		// Accumulated over the current tick
+		int32_t MotionX = 0;
+		int32_t MotionY = 0;
+		int32_t WheelX = 0;
+		int32_t WheelY = 0;
+	};
+
+	// Time from input being sampled to the submission of the first frame
+	// simulated with it
+	struct InputLatencyStats {
+		uint32_t Count = 0;
+		double AverageMs = 0.0;
+		double MaxMs = 0.0;
+	};
+
+	// Decouples input from the frame loop. The window samples input whenever
+	// it is pumped, at the start of the frame, between ticks and while the
+	// frame thread waits for the GPU, and queues each sample with the time it
+	// arrived in a ring per device. Every fixed step tick then takes the
+	// samples that arrived before the wall clock time the tick stands for, in
+	// order across devices, and posts their events for the tick's drain. A
+	// frame covering several ticks thus spreads its input over them as it
+	// came in, rather than handing all of it to the first.
+	//
+	// Key and button state follows the events as they are delivered, so it
+	// matches what handlers saw and replays restore it too.
+	class Input {
+	public:
+		using Clock = std::chrono::steady_clock;
+		// Samples a device may queue; beyond that the oldest is posted early
+		static constexpr size_t RING_SIZE = 256;
+
+		explicit Input(EventBus& bus);
+		~Input();
+
+		Input(const Input&) = delete;
+		Input& operator=(const Input&) = delete;
+
+		void Push(InputDevice device, const InputSample& sample);
+
+		// Starts a tick: clears the per tick mouse motion
+		void BeginTick();
+		// Posts the samples that arrived up to `time`
+		void Consume(Clock::time_point time);
+		// Just before the frame's command buffers are submitted
+		void OnSubmit();
+
+		inline bool IsKeyDown(int keycode) const { return m_KeysDown.count(keycode) > 0; }
+		inline bool IsMouseButtonDown(int button) const { return (m_Mouse.Buttons & (1u << (button - 1))) != 0; }
+		inline const MouseState& GetMouse() const { return m_Mouse; }
+
+		// Since the last call
+		InputLatencyStats TakeLatencyStats();
+		// Samples posted early because their device's ring was full
+		inline uint64_t GetOverflowCount() const { return m_Overflows; }
+	private:
+		struct Ring {
+			std::array<InputSample, RING_SIZE> Samples;
+			size_t Head = 0;
+			size_t Count = 0;
+
+			inline const InputSample& Front() const { return Samples[Head]; }
+			inline void Pop() {
+				Head = (Head + 1) % RING_SIZE;
+				Count--;
+			}
+		};
+
+		bool OnEvent(Event& e);
+		void Post(const InputSample& sample);
+
+		EventBus& m_Bus;
+		std::array<Ring, static_cast<size_t>(InputDevice::Count)> m_Rings;
+
+		std::unordered_set<int> m_KeysDown;
+		MouseState m_Mouse;
+
+		// Posted since the last submission
+		std::vector<Clock::time_point> m_Consumed;
+		InputLatencyStats m_Latency;
+		double m_LatencyTotalMs = 0.0;
+
+		uint64_t m_Overflows = 0;
+	};
+}
@@ -1,16 +1,102 @@
 #include "Log.h"
 
+#include "AsyncLogSink.h"
+
+#include "spdlog/sinks/basic_file_sink.h"
+#include "spdlog/sinks/ringbuffer_sink.h"
+#include "spdlog/sinks/rotating_file_sink.h"
+
+#include <exception>
+
 namespace Rui {
 	std::shared_ptr<spdlog::logger> Log::s_CoreLogger;
 	std::shared_ptr<spdlog::logger> Log::s_ClientLogger;
 
-	void Log::Init(const std::string& title) {
+	std::shared_ptr<AsyncLogSink> Log::s_AsyncSink;
+	std::shared_ptr<spdlog::sinks::sink> Log::s_CrashDumpSink;
+	std::string Log::s_CrashDumpPath;
+
+	static bool WriteRecentMessages(spdlog::sinks::sink* sink, const std::string& path) {
+		auto ringbuffer = static_cast<spdlog::sinks::ringbuffer_sink_mt*>(sink);
+
+		std::ofstream file(path, std::ios::trunc);
+		if(!file.is_open()) return false;
+
+		for(const std::string& line : ringbuffer->last_formatted()) {
+			file << line;
+		}
+
+		return true;
+	}
+
+	void Log::Init(const std::string& title, const LogSettings& settings) {
+		std::vector<spdlog::sink_ptr> sinks;
+
+		if(settings.Console) {
+			sinks.push_back(std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
+		}
+
+		switch(settings.File) {
+			case LogFileMode::Basic:
+				sinks.push_back(std::make_shared<spdlog::sinks::basic_file_sink_mt>(settings.FilePath, true));
+				break;
+			case LogFileMode::Rotating:
+				sinks.push_back(std::make_shared<spdlog::sinks::rotating_file_sink_mt>(settings.FilePath, settings.MaxFileSize, settings.MaxFiles));
+				break;
+			default:
+				break;
+		}
+
+		if(settings.CrashDumpMessages > 0) {
+			s_CrashDumpSink = std::make_shared<spdlog::sinks::ringbuffer_sink_mt>(settings.CrashDumpMessages);
+			sinks.push_back(s_CrashDumpSink);
+
+			// Messages still queued for the background thread are lost here,
+			// waiting for it from a terminate handler is not safe
+			s_CrashDumpPath = title + "-crash.log";
+			std::set_terminate([]() {
+				WriteRecentMessages(s_CrashDumpSink.get(), s_CrashDumpPath);
+				std::abort();
+			});
+		}
+
+		std::vector<spdlog::sink_ptr> loggerSinks = sinks;
+		if(settings.Async) {
+			s_AsyncSink = std::make_shared<AsyncLogSink>(sinks, settings.QueueCapacity);
+			loggerSinks = { s_AsyncSink };
+		}
+
+		s_CoreLogger = std::make_shared<spdlog::logger>("RUI", loggerSinks.begin(), loggerSinks.end());
+		s_ClientLogger = std::make_shared<spdlog::logger>(title, loggerSinks.begin(), loggerSinks.end());
+
+		for(auto& logger : { s_CoreLogger, s_ClientLogger }) {
+			logger->set_level(static_cast<spdlog::level::level_enum>(RUI_LOG_ACTIVE_LEVEL));
+			logger->flush_on(spdlog::level::err);
+			spdlog::register_logger(logger);
+		}
+
 		spdlog::set_pattern("%^[%T] %n: %v%$");
+	}
+
+	void Log::Shutdown() {
+		if(s_AsyncSink) {
+			s_AsyncSink->Stop();
+		}
+	}
+
+	void Log::Flush() {
+		if(s_AsyncSink) {
+			s_AsyncSink->Drain();
+		} else {
+			s_CoreLogger->flush();
+			s_ClientLogger->flush();
+		}
+	}
 
-		s_CoreLogger = spdlog::stdout_color_mt("RUI");
-		s_CoreLogger->set_level(spdlog::level::trace);
+	bool Log::WriteCrashDump(const std::string& path) {
+		if(!s_CrashDumpSink) return false;
 
-		s_ClientLogger = spdlog::stdout_color_mt(title);
-		s_ClientLogger->set_level(spdlog::level::trace);
+		Flush();
+		return WriteRecentMessages(s_CrashDumpSink.get(), path);
 	}
-}
\ No newline at end of file
+}
@@ -5,27 +5,109 @@
 #include "spdlog/sinks/stdout_color_sinks.h"
 #include "spdlog/fmt/ostr.h"
 
+// Log calls below RUI_LOG_ACTIVE_LEVEL are compiled out entirely
+#define RUI_LOG_LEVEL_TRACE    0
+#define RUI_LOG_LEVEL_DEBUG    1
+#define RUI_LOG_LEVEL_INFO     2
+#define RUI_LOG_LEVEL_WARN     3
+#define RUI_LOG_LEVEL_ERROR    4
+#define RUI_LOG_LEVEL_CRITICAL 5
+#define RUI_LOG_LEVEL_OFF      6
+
+#ifndef RUI_LOG_ACTIVE_LEVEL
+	#ifdef NDEBUG
+		#define RUI_LOG_ACTIVE_LEVEL RUI_LOG_LEVEL_INFO
+	#else
+		#define RUI_LOG_ACTIVE_LEVEL RUI_LOG_LEVEL_TRACE
+	#endif
+#endif
+
 namespace Rui {
+	class AsyncLogSink;
+
+	enum class LogFileMode {
+		None = 0,
+		Basic,
+		// Rolls over to a new file once MaxFileSize is reached
+		Rotating
+	};
+
+	struct LogSettings {
+		// Format and write messages on a background thread
+		bool Async = true;
+		// Preallocated message slots of the async ring
+		size_t QueueCapacity = 8192;
+
+		bool Console = true;
+
+		LogFileMode File = LogFileMode::None;
+		std::string FilePath = "logs/Rui.log";
+		size_t MaxFileSize = 5 * 1024 * 1024;
+		size_t MaxFiles = 3;
+
+		// Most recent messages kept in memory for WriteCrashDump, 0 disables it
+		size_t CrashDumpMessages = 256;
+	};
+
 	class Log {
 	public:
-		static void Init(const std::string& title);
+		static void Init(const std::string& title, const LogSettings& settings = LogSettings());
+		// Writes out pending messages and stops the background thread
+		static void Shutdown();
+
+		// Blocks until everything logged so far has been written
+		static void Flush();
+		// Writes the in-memory backlog of recent messages to `path`
+		static bool WriteCrashDump(const std::string& path);
 
 		inline static std::shared_ptr<spdlog::logger>& GetCoreLogger() { return s_CoreLogger; }
 		inline static std::shared_ptr<spdlog::logger>& GetClientLogger() { return s_ClientLogger; }
 	private:
 		static std::shared_ptr<spdlog::logger> s_CoreLogger;
 		static std::shared_ptr<spdlog::logger> s_ClientLogger;
+
+		static std::shared_ptr<AsyncLogSink> s_AsyncSink;
+		static std::shared_ptr<spdlog::sinks::sink> s_CrashDumpSink;
+		static std::string s_CrashDumpPath;
 	};
 }
 
-#define RUI_CORE_TRACE(...) ::Rui::Log::GetCoreLogger()->trace(__VA_ARGS__)
-#define RUI_CORE_INFO(...)  ::Rui::Log::GetCoreLogger()->info(__VA_ARGS__)
-#define RUI_CORE_WARN(...)  ::Rui::Log::GetCoreLogger()->warn(__VA_ARGS__)
-#define RUI_CORE_ERROR(...) ::Rui::Log::GetCoreLogger()->error(__VA_ARGS__)
-#define RUI_CORE_FATAL(...) ::Rui::Log::GetCoreLogger()->critical(__VA_ARGS__)
-
-#define RUI_TRACE(...) ::Rui::Log::GetClientLogger()->trace(__VA_ARGS__)
-#define RUI_INFO(...)  ::Rui::Log::GetClientLogger()->info(__VA_ARGS__)
-#define RUI_WARN(...)  ::Rui::Log::GetClientLogger()->warn(__VA_ARGS__)
-#define RUI_ERROR(...) ::Rui::Log::GetClientLogger()->error(__VA_ARGS__)
-#define RUI_FATAL(...) ::Rui::Log::GetClientLogger()->critical(__VA_ARGS__)
+#if RUI_LOG_ACTIVE_LEVEL <= RUI_LOG_LEVEL_TRACE
+	#define RUI_CORE_TRACE(...) ::Rui::Log::GetCoreLogger()->trace(__VA_ARGS__)
+	#define RUI_TRACE(...)      ::Rui::Log::GetClientLogger()->trace(__VA_ARGS__)
+#else
+	#define RUI_CORE_TRACE(...) (void)0
+	#define RUI_TRACE(...)      (void)0
+#endif
+
+#if RUI_LOG_ACTIVE_LEVEL <= RUI_LOG_LEVEL_INFO
+	#define RUI_CORE_INFO(...) ::Rui::Log::GetCoreLogger()->info(__VA_ARGS__)
+	#define RUI_INFO(...)      ::Rui::Log::GetClientLogger()->info(__VA_ARGS__)
+#else
+	#define RUI_CORE_INFO(...) (void)0
+	#define RUI_INFO(...)      (void)0
+#endif
+
+#if RUI_LOG_ACTIVE_LEVEL <= RUI_LOG_LEVEL_WARN
+	#define RUI_CORE_WARN(...) ::Rui::Log::GetCoreLogger()->warn(__VA_ARGS__)
+	#define RUI_WARN(...)      ::Rui::Log::GetClientLogger()->warn(__VA_ARGS__)
+#else
+	#define RUI_CORE_WARN(...) (void)0
+	#define RUI_WARN(...)      (void)0
+#endif
+
+#if RUI_LOG_ACTIVE_LEVEL <= RUI_LOG_LEVEL_ERROR
+	#define RUI_CORE_ERROR(...) ::Rui::Log::GetCoreLogger()->error(__VA_ARGS__)
+	#define RUI_ERROR(...)      ::Rui::Log::GetClientLogger()->error(__VA_ARGS__)
+#else
+	#define RUI_CORE_ERROR(...) (void)0
+	#define RUI_ERROR(...)      (void)0
+#endif
+
+#if RUI_LOG_ACTIVE_LEVEL <= RUI_LOG_LEVEL_CRITICAL
+	#define RUI_CORE_FATAL(...) ::Rui::Log::GetCoreLogger()->critical(__VA_ARGS__)
+	#define RUI_FATAL(...)      ::Rui::Log::GetClientLogger()->critical(__VA_ARGS__)
+#else
+	#define RUI_CORE_FATAL(...) (void)0
+	#define RUI_FATAL(...)      (void)0
+#endif
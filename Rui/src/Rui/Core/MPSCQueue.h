@@ -0,0 +1,121 @@
+#pragma once
+
+#include "Core.h"
+
+#include <atomic>
+#include <cstddef>
+
+namespace Rui {
+    // Bounded lock-free queue for many producers and a single consumer,
+    // after Dmitry Vyukov's bounded MPMC queue. Every cell carries a
+    // sequence number telling producers and the consumer whose turn it is,
+    // so a push is one CAS on the enqueue position and a pop is lock free.
+    // Storage is allocated once; a full queue rejects pushes instead of
+    // growing.
+    template<typename T>
+    class MPSCQueue {
+    public:
+        // Capacity is rounded up to a power of two
+        explicit MPSCQueue(size_t capacity)
+            : m_Capacity(RoundUp(capacity)), m_Mask(m_Capacity - 1), m_Cells(std::make_unique<Cell[]>(m_Capacity)) {
+            for(size_t i = 0; i < m_Capacity; i++) {
+                m_Cells[i].Sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        MPSCQueue(const MPSCQueue&) = delete;
+        MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+        // Safe from any thread. `fill` is called with the claimed slot and
+        // must not block. Returns false if the queue is full.
+        template<typename F>
+        bool TryEmplace(F&& fill) {
+            Cell* cell;
+            size_t pos = m_EnqueuePos.load(std::memory_order_relaxed);
+
+            for(;;) {
+                cell = &m_Cells[pos & m_Mask];
+                size_t sequence = cell->Sequence.load(std::memory_order_acquire);
+                intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+                if(diff == 0) {
+                    if(m_EnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+                } else if(diff < 0) {
+                    // The consumer has not freed this cell yet
+                    return false;
+                } else {
+                    pos = m_EnqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+
+            fill(cell->Data);
+            cell->Sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool TryPush(const T& value) {
+            return TryEmplace([&](T& slot) { slot = value; });
+        }
+
+        // Consumer thread only
+        bool TryPop(T& value) {
+            Cell& cell = m_Cells[m_DequeuePos & m_Mask];
+            size_t sequence = cell.Sequence.load(std::memory_order_acquire);
+
+            if(static_cast<intptr_t>(sequence) - static_cast<intptr_t>(m_DequeuePos + 1) < 0) return false;
+
+            value = std::move(cell.Data);
+            cell.Sequence.store(m_DequeuePos + m_Capacity, std::memory_order_release);
+            m_DequeuePos++;
+            return true;
+        }
+
+        // Consumer thread only. Pops at most `maxCount` items into `consume`
+        // without copying them out first; returns how many were consumed.
+        template<typename F>
+        size_t Consume(F&& consume, size_t maxCount = SIZE_MAX) {
+            size_t count = 0;
+            while(count < maxCount) {
+                Cell& cell = m_Cells[m_DequeuePos & m_Mask];
+                size_t sequence = cell.Sequence.load(std::memory_order_acquire);
+
+                if(static_cast<intptr_t>(sequence) - static_cast<intptr_t>(m_DequeuePos + 1) < 0) break;
+
+                consume(cell.Data);
+                cell.Sequence.store(m_DequeuePos + m_Capacity, std::memory_order_release);
+                m_DequeuePos++;
+                count++;
+            }
+
+            return count;
+        }
+
+        // Consumer thread only, approximate while producers are active
+        size_t Size() const {
+            return m_EnqueuePos.load(std::memory_order_relaxed) - m_DequeuePos;
+        }
+
+        inline size_t Capacity() const { return m_Capacity; }
+    private:
+        struct Cell {
+            std::atomic<size_t> Sequence;
+            T Data;
+        };
+
+        static size_t RoundUp(size_t value) {
+            size_t capacity = 2;
+            while(capacity < value) capacity <<= 1;
+            return capacity;
+        }
+
+        static constexpr size_t CACHE_LINE_SIZE = 64;
+
+        const size_t m_Capacity;
+        const size_t m_Mask;
+        std::unique_ptr<Cell[]> m_Cells;
+
+        // Producers and the consumer each get their own cache line
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_EnqueuePos = 0;
+        alignas(CACHE_LINE_SIZE) size_t m_DequeuePos = 0;
+    };
+}
@@ -0,0 +1,153 @@
+#include "Replay.h"
+
+#include "Log.h"
+
+#include "Input.h"
+
+#include <cstring>
+
+namespace Rui {
+	ReplayRecorder::ReplayRecorder(const std::string& path, uint32_t ticksPerSecond, uint32_t width, uint32_t height)
+		: m_File(path, std::ios::binary | std::ios::trunc) {
+		if(!m_File.is_open()) {
+			RUI_CORE_ERROR("Failed to open replay file {0} for writing!", path);
+			return;
+		}
+
+		ReplayHeader header;
+		header.TicksPerSecond = ticksPerSecond;
+		header.Width = width;
+		header.Height = height;
+		m_File.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		RUI_CORE_INFO("Recording replay to {0}", path);
+	}
+
+	ReplayRecorder::~ReplayRecorder() {
+		if(m_File.is_open()) {
+			RUI_CORE_INFO("Recorded {0} frames", m_FrameCount);
+		}
+	}
+
+	void ReplayRecorder::RecordEvent(const Event& e) {
+		ReplayEvent event;
+		event.Type = static_cast<uint32_t>(e.GetEventType());
+		event.Tick = m_Tick;
+
+		// Window events depend on the machine, not on the workload
+		if(!EncodeInputEvent(e, event.Data)) return;
+
+		m_Pending.push_back(event);
+	}
+
+	void ReplayRecorder::EndFrame(double frameTime, double interpolation, uint32_t ticks) {
+		if(!m_File.is_open()) return;
+
+		ReplayFrame frame;
+		frame.FrameTime = frameTime;
+		frame.Interpolation = interpolation;
+		frame.Ticks = ticks;
+		frame.EventCount = static_cast<uint32_t>(m_Pending.size());
+
+		m_File.write(reinterpret_cast<const char*>(&frame), sizeof(frame));
+		if(!m_Pending.empty()) {
+			m_File.write(reinterpret_cast<const char*>(m_Pending.data()), m_Pending.size() * sizeof(ReplayEvent));
+		}
+
+		m_Pending.clear();
+		m_FrameCount++;
+	}
+
+	std::unique_ptr<ReplayRecorder> ReplayRecorder::Create(const std::string& path, uint32_t ticksPerSecond, uint32_t width, uint32_t height) {
+		return std::make_unique<ReplayRecorder>(path, ticksPerSecond, width, height);
+	}
+
+	ReplayPlayer::ReplayPlayer(const std::string& path)
+		: m_File(path, std::ios::binary) {
+		if(!m_File.is_open()) {
+			RUI_CORE_ERROR("Failed to open replay file {0}!", path);
+			return;
+		}
+
+		ReplayHeader expected;
+		m_File.read(reinterpret_cast<char*>(&m_Header), sizeof(m_Header));
+
+		if(!m_File || std::memcmp(m_Header.Magic, expected.Magic, sizeof(expected.Magic)) != 0 || m_Header.Version != expected.Version) {
+			RUI_CORE_ERROR("{0} is not a version {1} replay file!", path, expected.Version);
+			m_File.close();
+		}
+	}
+
+	bool ReplayPlayer::NextFrame(ReplayFrame& frame) {
+		if(!m_File.is_open()) return false;
+
+		if(!m_File.read(reinterpret_cast<char*>(&frame), sizeof(frame))) return false;
+
+		m_Events.resize(frame.EventCount);
+		if(frame.EventCount > 0 && !m_File.read(reinterpret_cast<char*>(m_Events.data()), frame.EventCount * sizeof(ReplayEvent))) {
+			RUI_CORE_WARN("Replay file is truncated, stopping");
+			return false;
+		}
+
+		return true;
+	}
+
+	void ReplayPlayer::PostEvents(EventBus& bus, uint32_t tick) const {
+		for(const ReplayEvent& e : m_Events) {
+			if(e.Tick == tick) PostInputEvent(bus, static_cast<EventType>(e.Type), e.Data);
+		}
+	}
+
+	void ReplayPlayer::AddTiming(double frameMs, double gpuMs) {
+		m_Timings.push_back({ frameMs, gpuMs });
+	}
+
+	void ReplayPlayer::Report(const std::string& csvPath) const {
+		if(m_Timings.empty()) {
+			RUI_CORE_WARN("Replay finished without rendering a frame");
+			return;
+		}
+
+		std::vector<double> frameMs;
+		frameMs.reserve(m_Timings.size());
+
+		double totalMs = 0.0;
+		double totalGpuMs = 0.0;
+		for(const FrameTiming& timing : m_Timings) {
+			frameMs.push_back(timing.FrameMs);
+			totalMs += timing.FrameMs;
+			totalGpuMs += timing.GpuMs;
+		}
+
+		std::sort(frameMs.begin(), frameMs.end());
+		auto percentile = [&](double p) {
+			size_t index = static_cast<size_t>(p * (frameMs.size() - 1) + 0.5);
+			return frameMs[index];
+		};
+
+		double frames = static_cast<double>(m_Timings.size());
+		RUI_CORE_INFO("Replay: {0} frames in {1:.3f}s ({2:.1f} FPS)", m_Timings.size(), totalMs / 1000.0, frames * 1000.0 / totalMs);
+		RUI_CORE_INFO("Replay frame ms: mean {0:.3f}, p50 {1:.3f}, p95 {2:.3f}, p99 {3:.3f}, max {4:.3f}",
+			totalMs / frames, percentile(0.5), percentile(0.95), percentile(0.99), frameMs.back());
+		RUI_CORE_INFO("Replay GPU ms: mean {0:.3f}", totalGpuMs / frames);
+
+		if(csvPath.empty()) return;
+
+		std::ofstream csv(csvPath, std::ios::trunc);
+		if(!csv.is_open()) {
+			RUI_CORE_ERROR("Failed to open {0} for writing!", csvPath);
+			return;
+		}
+
+		csv << "frame,frame_ms,gpu_ms\n";
+		for(size_t i = 0; i < m_Timings.size(); i++) {
+			csv << i << ',' << m_Timings[i].FrameMs << ',' << m_Timings[i].GpuMs << '\n';
+		}
+
+		RUI_CORE_INFO("Wrote replay timings to {0}", csvPath);
+	}
+
+	std::unique_ptr<ReplayPlayer> ReplayPlayer::Create(const std::string& path) {
+		return std::make_unique<ReplayPlayer>(path);
+	}
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Core.h"
+#include "Rui/Events/EventBus.h"
+
+namespace Rui {
+	// Replay files are a small header followed by one frame record per
+	// rendered frame, each directly followed by the input events that were
+	// dispatched during that frame, with the tick of the frame they went to.
+	// Everything is little endian.
+	struct ReplayHeader {
+		char Magic[4] = { 'R', 'U', 'I', 'R' };
+		uint32_t Version = 2;
+		uint32_t TicksPerSecond = 0;
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+	};
+
+	struct ReplayFrame {
+		// Clamped wall clock delta of the recorded frame, in seconds
+		double FrameTime = 0.0;
+		// Interpolation factor handed to OnRender
+		double Interpolation = 0.0;
+		// Fixed step updates run before rendering this frame
+		uint32_t Ticks = 0;
+		uint32_t EventCount = 0;
+	};
+
+	struct ReplayEvent {
+		uint32_t Type = 0;
+		int32_t Data[3] = {};
+		// Index of the tick within the frame
+		uint32_t Tick = 0;
+	};
+
+	class ReplayRecorder {
+	public:
+		ReplayRecorder(const std::string& path, uint32_t ticksPerSecond, uint32_t width, uint32_t height);
+		~ReplayRecorder();
+
+		ReplayRecorder(const ReplayRecorder&) = delete;
+		ReplayRecorder& operator=(const ReplayRecorder&) = delete;
+
+		inline bool IsOpen() const { return m_File.is_open(); }
+
+		// Events recorded from now on went to tick `tick` of the frame
+		inline void BeginTick(uint32_t tick) { m_Tick = tick; }
+		// Input events are buffered until the frame they belong to is written
+		void RecordEvent(const Event& e);
+		void EndFrame(double frameTime, double interpolation, uint32_t ticks);
+
+		static std::unique_ptr<ReplayRecorder> Create(const std::string& path, uint32_t ticksPerSecond, uint32_t width, uint32_t height);
+	private:
+		std::ofstream m_File;
+		std::vector<ReplayEvent> m_Pending;
+		uint32_t m_Tick = 0;
+
+		uint64_t m_FrameCount = 0;
+	};
+
+	class ReplayPlayer {
+	public:
+		ReplayPlayer(const std::string& path);
+
+		ReplayPlayer(const ReplayPlayer&) = delete;
+		ReplayPlayer& operator=(const ReplayPlayer&) = delete;
+
+		inline bool IsOpen() const { return m_File.is_open(); }
+		inline const ReplayHeader& GetHeader() const { return m_Header; }
+
+		// Reads the next frame. Returns false at the end of the recording.
+		bool NextFrame(ReplayFrame& frame);
+		// Posts the events of tick `tick` of the frame last returned by NextFrame
+		void PostEvents(EventBus& bus, uint32_t tick) const;
+
+		void AddTiming(double frameMs, double gpuMs);
+		// Logs a summary and, if `csvPath` is set, writes every frame to it
+		void Report(const std::string& csvPath) const;
+
+		static std::unique_ptr<ReplayPlayer> Create(const std::string& path);
+	private:
+		std::ifstream m_File;
+		ReplayHeader m_Header;
+
+		std::vector<ReplayEvent> m_Events;
+
+		struct FrameTiming {
+			double FrameMs;
+			double GpuMs;
+		};
+		std::vector<FrameTiming> m_Timings;
+	};
+}
@@ -1 +1,33 @@
-#include "Scene.h"
\ No newline at end of file
+#include "Scene.h"
+
+#include "Rui/Render/RenderSystem.h"
+
+namespace Rui {
+	void Scene::Update(const Timestep& ts) {
+		OnUpdate(ts);
+
+		// Added before the view is walked, which adding would invalidate
+		m_Unbounded.clear();
+		for(entt::entity entity : m_Registry.view<const MeshComponent>(entt::exclude<BoundsComponent>)) m_Unbounded.push_back(entity);
+		for(entt::entity entity : m_Unbounded) {
+			const Ref<Mesh>& mesh = m_Registry.get<const MeshComponent>(entity).Geometry;
+			if(mesh) m_Registry.emplace<BoundsComponent>(entity, mesh->GetBoundsMin(), mesh->GetBoundsMax());
+		}
+
+		m_Transforms.Update(m_Registry);
+		m_SpatialIndex.Update();
+	}
+
+	void Scene::Render(const Timestep& ts) {
+		// Whole subtrees out of view are skipped; SubmitMesh tests the
+		// meshes found against the same frustum again
+		m_SpatialIndex.GetBvh().Query(RenderSystem::GetCameraFrustum(), [&](uint32_t item) {
+			entt::entity entity = SpatialIndex::ToEntity(item);
+			MeshComponent* mesh = m_Registry.try_get<MeshComponent>(entity);
+			const WorldTransformComponent* world = m_Registry.try_get<const WorldTransformComponent>(entity);
+			if(mesh && world) RenderSystem::SubmitMesh(mesh->Geometry, world->Transform, &mesh->Lod, mesh->Albedo);
+		});
+
+		OnRender(ts);
+	}
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include "Timestep.h"
 #include "Rui/Events/Event.h"
+#include "Rui/Scene/SpatialIndex.h"
 
 #include <entt/entt.hpp>
 
@@ -17,8 +18,20 @@ namespace Rui {
 		virtual void OnRender(const Timestep& ts) = 0;
 		virtual void OnEvent(Event& event) = 0;
 
+		// Each tick: OnUpdate, then the world transforms and bounds and the
+		// spatial index for rendering and queries
+		void Update(const Timestep& ts);
+		// Each frame: submits the MeshComponents in view, then OnRender,
+		// which draws the frame
+		void Render(const Timestep& ts);
+
+		inline entt::registry& GetRegistry() { return m_Registry; }
+		inline SpatialIndex& GetSpatialIndex() { return m_SpatialIndex; }
 	private:
 		entt::registry m_Registry;
+		TransformSystem m_Transforms;
+		SpatialIndex m_SpatialIndex{ m_Registry };
+		std::vector<entt::entity> m_Unbounded;
 	};
 }
 
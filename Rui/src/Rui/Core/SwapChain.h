@@ -5,7 +5,6 @@
 #include <vulkan/vulkan.h>
 
 namespace Rui {
-
     class SwapChain {
     public:
         static constexpr int MAX_FRAMES_IN_FLIGHT = 2;
@@ -16,12 +15,14 @@ namespace Rui {
         SwapChain(const SwapChain&) = delete;
         void operator=(const SwapChain&) = delete;
 
-        vk::Framebuffer GetFrameBuffer(int index) { return swapChainFramebuffers[index]; }
-        vk::RenderPass GetRenderPass() { return renderPass; }
+        vk::Image GetImage(int index) { return swapChainImages[index]; }
         vk::ImageView GetImageView(int index) { return swapChainImageViews[index]; }
         size_t ImageCount() { return swapChainImages.size(); }
+        size_t CurrentFrame() { return currentFrame; }
         vk::Format GetSwapChainImageFormat() { return swapChainImageFormat; }
         vk::Extent2D GetSwapChainExtent() { return swapChainExtent; }
+        // Whether images can be copied out of, for frame capture
+        bool IsReadable() { return readable; }
 
         void ReCreateSwapChain();
 
@@ -33,16 +34,20 @@ namespace Rui {
         }
         vk::Format FindDepthFormat();
 
+        // Waits up to `timeout` ns for the GPU to finish the current frame
+        // slot's last submission; eSuccess, eTimeout or the error of the wait
+        vk::Result WaitForFrame(uint64_t timeout = 0);
+        // Waits until the GPU finished the current frame slot's last submission
         vk::Result AcquireNextImage(uint32_t* imageIndex);
+        // Signals the next graphics timeline value, then presents
         vk::Result SubmitCommandBuffers(const vk::CommandBuffer* buffers, uint32_t* imageIndex);
+        // Graphics timeline value the last SubmitCommandBuffers signals
+        uint64_t GetSubmittedValue() { return submittedValue; }
 
 		static std::unique_ptr<SwapChain> Create(vk::Extent2D windowExtent);
     private:
         void CreateSwapChain();
         void CreateImageViews();
-        void CreateDepthResources();
-        void CreateRenderPass();
-        void CreateFramebuffers();
         void CreateSyncObjects();
 
         // Helper functions
@@ -54,13 +59,8 @@ namespace Rui {
 
         vk::Format swapChainImageFormat;
         vk::Extent2D swapChainExtent;
+        bool readable = false;
 
-        std::vector<vk::Framebuffer> swapChainFramebuffers;
-        vk::RenderPass renderPass;
-
-        std::vector<vk::Image> depthImages;
-        std::vector<vk::DeviceMemory> depthImageMemorys;
-        std::vector<vk::ImageView> depthImageViews;
         std::vector<vk::Image> swapChainImages;
         std::vector<vk::ImageView> swapChainImageViews;
 
@@ -70,8 +70,9 @@ namespace Rui {
 
         std::vector<vk::Semaphore> imageAvailableSemaphores;
         std::vector<vk::Semaphore> renderFinishedSemaphores;
-        std::vector<vk::Fence> inFlightFences;
-        std::vector<vk::Fence> imagesInFlight;
+        // Graphics timeline value each frame slot's last submission signals
+        std::array<uint64_t, MAX_FRAMES_IN_FLIGHT> frameValues{};
+        uint64_t submittedValue = 0;
         size_t currentFrame = 0;
     };
 
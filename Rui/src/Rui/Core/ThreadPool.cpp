@@ -0,0 +1,79 @@
+#include "ThreadPool.h"
+
+namespace Rui {
+	static thread_local const ThreadPool* t_CurrentPool = nullptr;
+
+	ThreadPool::ThreadPool(uint32_t threadCount, size_t maxQueued)
+		: m_MaxQueued(maxQueued) {
+		threadCount = std::max(threadCount, 1u);
+
+		m_Threads.reserve(threadCount);
+		for(uint32_t i = 0; i < threadCount; i++) {
+			m_Threads.emplace_back(&ThreadPool::WorkerLoop, this);
+		}
+	}
+
+	ThreadPool::~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Stopping = true;
+		}
+
+		m_JobAvailable.notify_all();
+		for(std::thread& thread : m_Threads) {
+			thread.join();
+		}
+	}
+
+	void ThreadPool::Submit(Job job) {
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			if(!IsWorkerThread()) {
+				m_SpaceAvailable.wait(lock, [this]() { return m_Jobs.size() < m_MaxQueued; });
+			}
+
+			m_Jobs.push_back(std::move(job));
+		}
+
+		m_JobAvailable.notify_one();
+	}
+
+	void ThreadPool::WaitIdle() {
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		m_Idle.wait(lock, [this]() { return m_Jobs.empty() && m_Running == 0; });
+	}
+
+	bool ThreadPool::IsWorkerThread() const {
+		return t_CurrentPool == this;
+	}
+
+	void ThreadPool::WorkerLoop() {
+		t_CurrentPool = this;
+
+		for(;;) {
+			Job job;
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_JobAvailable.wait(lock, [this]() { return m_Stopping || !m_Jobs.empty(); });
+
+				if(m_Jobs.empty()) return;
+
+				job = std::move(m_Jobs.front());
+				m_Jobs.pop_front();
+				m_Running++;
+			}
+
+			m_SpaceAvailable.notify_one();
+			job();
+
+			bool idle;
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				m_Running--;
+				idle = m_Jobs.empty() && m_Running == 0;
+			}
+
+			if(idle) m_Idle.notify_all();
+		}
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Core.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace Rui {
+	// Fixed set of worker threads with a bounded job queue
+	class ThreadPool {
+	public:
+		using Job = std::function<void()>;
+
+		ThreadPool(uint32_t threadCount, size_t maxQueued = 1024);
+		// Runs the jobs still queued, then joins the workers
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		// Blocks while the queue is full, unless called from one of the
+		// workers, which could otherwise deadlock the pool
+		void Submit(Job job);
+		// Blocks until the queue is empty and no job is running. Jobs may keep
+		// submitting more work, which is waited for as well.
+		void WaitIdle();
+
+		inline uint32_t GetThreadCount() const { return static_cast<uint32_t>(m_Threads.size()); }
+		bool IsWorkerThread() const;
+	private:
+		void WorkerLoop();
+
+		std::vector<std::thread> m_Threads;
+
+		std::deque<Job> m_Jobs;
+		size_t m_MaxQueued;
+
+		std::mutex m_Mutex;
+		std::condition_variable m_JobAvailable;
+		std::condition_variable m_SpaceAvailable;
+		std::condition_variable m_Idle;
+		uint32_t m_Running = 0;
+		bool m_Stopping = false;
+	};
+}
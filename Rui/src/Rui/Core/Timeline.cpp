@@ -0,0 +1,48 @@
+#include "Timeline.h"
+
+namespace Rui {
+	QueueTimeline::QueueTimeline(vk::Device device, vk::Queue queue, uint32_t family)
+		: m_Device(device), m_Queue(queue), m_Family(family) {
+		vk::SemaphoreTypeCreateInfo typeInfo(vk::SemaphoreType::eTimeline, 0);
+		vk::SemaphoreCreateInfo semaphoreInfo;
+		semaphoreInfo.pNext = &typeInfo;
+
+		if(m_Device.createSemaphore(&semaphoreInfo, nullptr, &m_Semaphore) != vk::Result::eSuccess) {
+			RUI_CORE_ERROR("Failed to create timeline semaphore!");
+		}
+	}
+
+	QueueTimeline::~QueueTimeline() {
+		m_Device.destroySemaphore(m_Semaphore, nullptr);
+	}
+
+	uint64_t QueueTimeline::GetCompletedValue() {
+		uint64_t value = 0;
+		if(m_Device.getSemaphoreCounterValue(m_Semaphore, &value) == vk::Result::eSuccess) {
+			m_Completed = std::max(m_Completed, value);
+		}
+
+		return m_Completed;
+	}
+
+	bool QueueTimeline::IsComplete(uint64_t value) {
+		if(value <= m_Completed) return true;
+		return value <= GetCompletedValue();
+	}
+
+	vk::Result QueueTimeline::Wait(uint64_t value, uint64_t timeout) {
+		if(value <= m_Completed) return vk::Result::eSuccess;
+
+		vk::SemaphoreWaitInfo waitInfo({}, 1, &m_Semaphore, &value);
+		vk::Result result = m_Device.waitSemaphores(&waitInfo, timeout);
+		if(result == vk::Result::eTimeout) return result;
+
+		if(result != vk::Result::eSuccess) {
+			RUI_CORE_ERROR("Failed to wait for timeline semaphore: {0}", vk::to_string(result));
+			return result;
+		}
+
+		m_Completed = std::max(m_Completed, value);
+		return result;
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Log.h"
+
+#define VULKAN_HPP_NO_EXCEPTIONS
+#include <vulkan/vulkan.hpp>
+
+namespace Rui {
+	// Timeline semaphore counting the submissions to one queue. Every submit
+	// signals the next value, so "this work has finished" is a single number
+	// that other queues can wait on and the CPU can poll.
+	class QueueTimeline {
+	public:
+		QueueTimeline(vk::Device device, vk::Queue queue, uint32_t family);
+		~QueueTimeline();
+
+		QueueTimeline(const QueueTimeline&) = delete;
+		QueueTimeline& operator=(const QueueTimeline&) = delete;
+
+		inline vk::Queue GetQueue() const { return m_Queue; }
+		inline uint32_t GetFamily() const { return m_Family; }
+		inline vk::Semaphore GetSemaphore() const { return m_Semaphore; }
+
+		// Value signaled by the next submission; work recorded now is done
+		// once it completed
+		inline uint64_t GetPendingValue() const { return m_Submitted + 1; }
+		// Value signaled by the last submission
+		inline uint64_t GetSubmittedValue() const { return m_Submitted; }
+		// Claims the next value for a submission
+		inline uint64_t Advance() { return ++m_Submitted; }
+
+		// Queries the semaphore without blocking
+		uint64_t GetCompletedValue();
+		bool IsComplete(uint64_t value);
+		// eSuccess once the value is reached, eTimeout, or the error the wait
+		// failed with, such as eErrorDeviceLost
+		vk::Result Wait(uint64_t value, uint64_t timeout = UINT64_MAX);
+	private:
+		vk::Device m_Device;
+		vk::Queue m_Queue;
+		uint32_t m_Family;
+		vk::Semaphore m_Semaphore;
+
+		uint64_t m_Submitted = 0;
+		// Last value read back, so most IsComplete calls skip the query
+		uint64_t m_Completed = 0;
+	};
+}
@@ -1,7 +1,25 @@
 #include "Window.h"
 
 namespace Rui {
-	Window::Window(const std::string& title, int w, int h) {
+	// Next code point of a UTF-8 string, advancing `text` past it. Malformed
+	// bytes are skipped and yield 0.
+	static int32_t DecodeUtf8(const char*& text) {
+		uint8_t lead = static_cast<uint8_t>(*text++);
+		int extra = lead >= 0xF0 ? 3 : lead >= 0xE0 ? 2 : lead >= 0xC0 ? 1 : 0;
+		if((lead >= 0x80 && extra == 0) || lead >= 0xF8) return 0;
+
+		int32_t codePoint = extra ? lead & (0x3F >> extra) : lead;
+		for(int i = 0; i < extra; i++) {
+			uint8_t next = static_cast<uint8_t>(*text);
+			if((next & 0xC0) != 0x80) return 0;
+			codePoint = (codePoint << 6) | (next & 0x3F);
+			text++;
+		}
+		return codePoint;
+	}
+
+	Window::Window(const std::string& title, int w, int h, bool visible)
+		: m_Width(w), m_Height(h), m_Title(title) {
 		SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS);
 		m_Window = SDL_CreateWindow(
 		title.c_str(), 
@@ -9,7 +27,7 @@ namespace Rui {
 		SDL_WINDOWPOS_CENTERED, 
 		w, 
 		h, 
-		SDL_WINDOW_VULKAN | SDL_WINDOW_RESIZABLE);
+		SDL_WINDOW_VULKAN | (visible ? SDL_WINDOW_RESIZABLE : SDL_WINDOW_HIDDEN));
 
 		RUI_CORE_INFO("Creating Window {0} {1} {2}!", title, w, h);
 	}
@@ -24,11 +42,29 @@ namespace Rui {
 	void Window::OnUpdate() {
 		SDL_Event e;
 
+		// SDL stamps events in milliseconds of its own clock as it queues them.
+		// Events queued by the pumps within SDL_PollEvent are younger than
+		// `ticks` and taken as arriving now.
+		SDL_PumpEvents();
+		const Input::Clock::time_point now = Input::Clock::now();
+		const uint32_t ticks = SDL_GetTicks();
+		auto sample = [&](InputDevice device, EventType type, int32_t a, int32_t b = 0, int32_t c = 0) {
+			if(!m_InputEnabled || !m_Input) return;
+
+			int32_t age = std::clamp(static_cast<int32_t>(ticks - e.common.timestamp), 0, 1000);
+			InputSample input;
+			input.Time = now - std::chrono::milliseconds(age);
+			input.Type = type;
+			input.Data[0] = a;
+			input.Data[1] = b;
+			input.Data[2] = c;
+			m_Input->Push(device, input);
+		};
+
 		while(SDL_PollEvent(&e)) {
 			switch(e.type) {
 				case SDL_QUIT: {
-					WindowClosedEvent event;
-					EventCallback(event);
+					m_EventBus->Post<WindowClosedEvent>();
 					break;
 				}
 
@@ -37,13 +73,12 @@ namespace Rui {
 						case SDL_WINDOWEVENT_SIZE_CHANGED: {
 							int w = e.window.data1;
 							int h = e.window.data2;
-							RUI_CORE_ERROR("1 # Window Resized: {0} {1}", w, h);
+							RUI_CORE_TRACE("SDL window resized: {0} {1}", w, h);
 
 							m_Width = w;
 							m_Height = h;
 
-							WindowResizedEvent event(w, h);
-							EventCallback(event);
+							m_EventBus->Post<WindowResizedEvent>(w, h);
 							break;
 						}
 
@@ -52,17 +87,47 @@ namespace Rui {
 							break;
 						}
 					}
+					break;
 				}
 
 				case SDL_KEYDOWN: {
-					KeyPressedEvent event(e.key.keysym.sym, 1);
-					EventCallback(event);
+					sample(InputDevice::Keyboard, EventType::KeyPressed, e.key.keysym.sym, e.key.repeat);
+					break;
+				}
+
+				// One KeyTyped per character, carrying its code point
+				case SDL_TEXTINPUT: {
+					for(const char* text = e.text.text; *text;) {
+						if(int32_t codePoint = DecodeUtf8(text)) {
+							sample(InputDevice::Keyboard, EventType::KeyTyped, codePoint);
+						}
+					}
 					break;
 				}
 
 				case SDL_KEYUP: {
-					KeyReleasedEvent event(e.key.keysym.sym);
-					EventCallback(event);
+					sample(InputDevice::Keyboard, EventType::KeyReleased, e.key.keysym.sym);
+					break;
+				}
+
+				case SDL_MOUSEMOTION: {
+					sample(InputDevice::Mouse, EventType::MouseMoved, e.motion.xrel, e.motion.yrel);
+					break;
+				}
+
+				case SDL_MOUSEBUTTONDOWN: {
+					sample(InputDevice::Mouse, EventType::MouseButtonPressed, e.button.button, e.button.x, e.button.y);
+					break;
+				}
+
+				case SDL_MOUSEBUTTONUP: {
+					sample(InputDevice::Mouse, EventType::MouseButtonReleased, e.button.button, e.button.x, e.button.y);
+					break;
+				}
+
+				case SDL_MOUSEWHEEL: {
+					int32_t direction = e.wheel.direction == SDL_MOUSEWHEEL_FLIPPED ? -1 : 1;
+					sample(InputDevice::Mouse, EventType::MouseScrolled, e.wheel.x * direction, e.wheel.y * direction);
 					break;
 				}
 			}
@@ -79,7 +144,7 @@ namespace Rui {
 		RUI_CORE_FATAL("Failed to create surface!");
 	}
 
-	std::unique_ptr<Window> Window::Create(const std::string& title, int w, int h) {
-		return std::make_unique<Window>(title, w, h);
+	std::unique_ptr<Window> Window::Create(const std::string& title, int w, int h, bool visible) {
+		return std::make_unique<Window>(title, w, h, visible);
 	}
 }
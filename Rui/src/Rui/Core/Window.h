@@ -1,8 +1,11 @@
 #pragma once
 
 #include "Rui/Events/Event.h"
+#include "Rui/Events/EventBus.h"
 #include "Rui/Events/WindowEvent.h"
 #include "Rui/Events/KeyEvent.h"
+#include "Rui/Events/MouseEvent.h"
+#include "Input.h"
 #include "Log.h"
 
 #include <SDL.h>
@@ -14,14 +17,15 @@
 namespace Rui {
     class Window {
     public:
-        using EventCallbackFn = std::function<void(Event&)>;
-
-        Window(const std::string& title, int w, int h);
+        Window(const std::string& title, int w, int h, bool visible = true);
         ~Window();
 
         Window(const Window&) = delete;
         Window& operator=(const Window&) = delete;
 
+        // Pumps SDL: posts window events and hands input to the Input set
+        // with SetInput. Cheap enough to call several times a frame, which
+        // keeps input timestamps close to when it arrived.
         void OnUpdate();
 
         inline std::string GetTitle() const { return m_Title; }
@@ -32,10 +36,13 @@ namespace Rui {
         	return { static_cast<uint32_t>(m_Width), static_cast<uint32_t>(m_Height) };
         }
 
-        inline void SetEventCallback(const EventCallbackFn& callback) { EventCallback = callback; }
+        inline void SetEventBus(EventBus* bus) { m_EventBus = bus; }
+        inline void SetInput(Input* input) { m_Input = input; }
+        // Input is discarded while disabled, window events still get posted
+        inline void SetInputEnabled(bool enabled) { m_InputEnabled = enabled; }
 
         void CreateSurface(vk::Instance instance, vk::SurfaceKHR* surface);
-        static std::unique_ptr<Window> Create(const std::string& title, int w, int h);
+        static std::unique_ptr<Window> Create(const std::string& title, int w, int h, bool visible = true);
     private:
         SDL_Window* m_Window;
 
@@ -44,6 +51,8 @@ namespace Rui {
 
         std::string m_Title;
 
-        EventCallbackFn EventCallback;
+        EventBus* m_EventBus = nullptr;
+        Input* m_Input = nullptr;
+        bool m_InputEnabled = true;
     };
 }
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "EventBus.h"
+#include "Rui/Core/MPSCQueue.h"
+
+namespace Rui {
+    // Lets any thread hand events to the main thread. Producers copy the
+    // event into a fixed size slot of a lock-free queue; the main thread
+    // moves them onto the EventBus at a defined point of the frame, after
+    // which they are delivered like any other event.
+    class ConcurrentEventQueue {
+        public:
+        // Largest event that can be posted from another thread
+        static constexpr size_t MAX_EVENT_SIZE = 64;
+
+        struct Stats {
+            uint64_t Posted = 0;
+            // Posts refused because the queue was full
+            uint64_t Rejected = 0;
+            uint64_t Drained = 0;
+            // Most events moved to the bus by a single drain
+            size_t PeakDrained = 0;
+        };
+
+        explicit ConcurrentEventQueue(size_t capacity = 1024)
+            : m_Queue(capacity) {
+        }
+
+        // Safe from any thread. Returns false if the queue is full, in which
+        // case the event is dropped and counted as rejected.
+        template<typename T, typename ... Args>
+        bool Post(Args&& ... args) {
+            static_assert(std::is_base_of_v<Event, T>, "Only events can be posted");
+            static_assert(sizeof(T) <= MAX_EVENT_SIZE, "Event is too large to be posted across threads");
+            static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned events are not supported");
+            static_assert(std::is_trivially_destructible_v<T>, "Posted events are never destroyed");
+
+            bool posted = m_Queue.TryEmplace([&](Slot& slot) {
+                new(slot.Storage) T(std::forward<Args>(args)...);
+                slot.Forward = &ForwardThunk<T>;
+            });
+
+            if(posted) {
+                m_Posted.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                m_Rejected.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            return posted;
+        }
+
+        // Main thread only. Moves at most one queue's worth of events onto the
+        // bus, so producers that keep posting cannot stall the frame.
+        size_t DrainInto(EventBus& bus) {
+            size_t count = m_Queue.Consume([&](Slot& slot) {
+                slot.Forward(bus, slot.Storage);
+            }, m_Queue.Capacity());
+
+            m_Drained += count;
+            m_PeakDrained = std::max(m_PeakDrained, count);
+            return count;
+        }
+
+        // Main thread only
+        Stats GetStats() const {
+            Stats stats;
+            stats.Posted = m_Posted.load(std::memory_order_relaxed);
+            stats.Rejected = m_Rejected.load(std::memory_order_relaxed);
+            stats.Drained = m_Drained;
+            stats.PeakDrained = m_PeakDrained;
+            return stats;
+        }
+
+        inline size_t GetCapacity() const { return m_Queue.Capacity(); }
+        private:
+        using ForwardFn = void (*)(EventBus& bus, const void* event);
+
+        struct Slot {
+            ForwardFn Forward = nullptr;
+            alignas(std::max_align_t) std::byte Storage[MAX_EVENT_SIZE];
+        };
+
+        template<typename T>
+        static void ForwardThunk(EventBus& bus, const void* event) {
+            bus.Post<T>(*static_cast<const T*>(event));
+        }
+
+        MPSCQueue<Slot> m_Queue;
+
+        // Written by producers, kept apart from the queue's own positions
+        alignas(64) std::atomic<uint64_t> m_Posted = 0;
+        std::atomic<uint64_t> m_Rejected = 0;
+
+        uint64_t m_Drained = 0;
+        size_t m_PeakDrained = 0;
+    };
+}
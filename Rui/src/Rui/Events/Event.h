@@ -9,7 +9,8 @@ namespace Rui {
         TickEvent,
         KeyPressed, KeyReleased, KeyTyped,
         MouseButtonPressed, MouseButtonReleased, MouseMoved, MouseScrolled,
-        WindowClosed, WindowResized
+        WindowClosed, WindowResized,
+        Count
     };
 
     enum EventCategory {
@@ -21,7 +22,8 @@ namespace Rui {
         EventCategoryMouseButton = BIT(4)
     };
 
-#define EVENT_CLASS_TYPE(type) static EventType GetStaticType() { return EventType::##type; }\
+#define EVENT_CLASS_TYPE(type) static constexpr EventType StaticType = EventType::type;\
+									static EventType GetStaticType() { return EventType::type; }\
 									virtual EventType GetEventType() const override { return GetStaticType(); }\
 									virtual const char* GetName() const override { return #type; }
 
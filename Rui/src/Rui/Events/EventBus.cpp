@@ -0,0 +1,82 @@
+#include "EventBus.h"
+
+namespace Rui {
+    EventBus::EventBus(size_t arenaSize, size_t maxQueued)
+        : m_Arena(arenaSize) {
+        m_Queue.reserve(maxQueued);
+    }
+
+    void EventBus::Drain() {
+        if(m_Draining) return;
+        m_Draining = true;
+
+        m_Stats.PeakArenaBytes = std::max(m_Stats.PeakArenaBytes, m_Arena.GetUsed());
+
+        // Handlers may post more events, which land at the end of the queue
+        for(size_t i = 0; i < m_Queue.size(); i++) {
+            Dispatch(m_Queue[i].Type, *m_Queue[i].Data);
+        }
+
+        m_Stats.PeakQueued = std::max(m_Stats.PeakQueued, m_Queue.size());
+        m_Stats.PeakArenaBytes = std::max(m_Stats.PeakArenaBytes, m_Arena.GetUsed());
+
+        m_Queue.clear();
+        m_Arena.Reset();
+
+        m_Draining = false;
+    }
+
+    void EventBus::Dispatch(EventType type, Event& event) {
+        m_Stats.Dispatched++;
+        m_DispatchDepth++;
+
+        for(size_t i = 0; i < m_AnySubscribers.size() && !event.Handled; i++) {
+            const Handler& handler = m_AnySubscribers[i];
+            if(handler.Function && handler.Function(handler.Instance, event)) {
+                event.Handled = true;
+            }
+        }
+
+        std::vector<Handler>& handlers = m_Subscribers[Index(type)];
+        for(size_t i = 0; i < handlers.size() && !event.Handled; i++) {
+            const Handler& handler = handlers[i];
+            if(handler.Function && handler.Function(handler.Instance, event)) {
+                event.Handled = true;
+            }
+        }
+
+        m_DispatchDepth--;
+        if(m_DispatchDepth == 0 && m_NeedsCompaction) {
+            CompactHandlers();
+        }
+    }
+
+    void EventBus::AddHandler(std::vector<Handler>& handlers, void* instance, HandlerFn function) {
+        handlers.push_back({ instance, function });
+    }
+
+    void EventBus::RemoveHandler(std::vector<Handler>& handlers, void* instance, HandlerFn function) {
+        for(Handler& handler : handlers) {
+            if(handler.Instance == instance && handler.Function == function) {
+                // Removing while dispatching would shift the handlers being iterated
+                handler.Function = nullptr;
+                m_NeedsCompaction = true;
+            }
+        }
+
+        if(m_DispatchDepth == 0 && m_NeedsCompaction) {
+            CompactHandlers();
+        }
+    }
+
+    void EventBus::CompactHandlers() {
+        auto isRemoved = [](const Handler& handler) { return handler.Function == nullptr; };
+
+        m_AnySubscribers.erase(std::remove_if(m_AnySubscribers.begin(), m_AnySubscribers.end(), isRemoved), m_AnySubscribers.end());
+        for(std::vector<Handler>& handlers : m_Subscribers) {
+            handlers.erase(std::remove_if(handlers.begin(), handlers.end(), isRemoved), handlers.end());
+        }
+
+        m_NeedsCompaction = false;
+    }
+}
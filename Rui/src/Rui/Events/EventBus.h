@@ -0,0 +1,153 @@
+#pragma once
+
+#include "Event.h"
+#include "Rui/Core/FrameArena.h"
+
+#include <array>
+
+namespace Rui {
+    // Typed publish/subscribe with a deferred queue. Posted events are
+    // constructed in place in a frame arena and delivered in one batch by
+    // Drain; subscribers are plain function pointers looked up by the
+    // event's compile time type, so dispatch neither allocates nor goes
+    // through std::function.
+    //
+    // Subscribers to any event run first, in subscription order, then the
+    // subscribers of the event's type. Dispatch stops once one of them
+    // returns true, which also marks the event as handled.
+    class EventBus {
+        public:
+        using HandlerFn = bool (*)(void* instance, Event& event);
+
+        struct Stats {
+            uint64_t Posted = 0;
+            uint64_t Dispatched = 0;
+            // Posts that found the queue full and forced an early drain
+            uint64_t EarlyDrains = 0;
+            // Posts delivered immediately because the queue was full mid-drain
+            uint64_t Overflows = 0;
+            size_t PeakQueued = 0;
+            size_t PeakArenaBytes = 0;
+        };
+
+        EventBus(size_t arenaSize = 64 * 1024, size_t maxQueued = 4096);
+
+        EventBus(const EventBus&) = delete;
+        EventBus& operator=(const EventBus&) = delete;
+
+        // bus.Subscribe<KeyPressedEvent, &GameScene::OnKeyPressed>(this);
+        template<typename T, auto Method, typename C>
+        void Subscribe(C* instance) {
+            AddHandler(m_Subscribers[Index(T::StaticType)], instance, &MethodThunk<T, Method, C>);
+        }
+
+        template<typename T, bool (*Function)(T&)>
+        void Subscribe() {
+            AddHandler(m_Subscribers[Index(T::StaticType)], nullptr, &FunctionThunk<T, Function>);
+        }
+
+        template<typename T, auto Method, typename C>
+        void Unsubscribe(C* instance) {
+            RemoveHandler(m_Subscribers[Index(T::StaticType)], instance, &MethodThunk<T, Method, C>);
+        }
+
+        template<typename T, bool (*Function)(T&)>
+        void Unsubscribe() {
+            RemoveHandler(m_Subscribers[Index(T::StaticType)], nullptr, &FunctionThunk<T, Function>);
+        }
+
+        // bus.SubscribeAny<&Application::OnEvent>(this);
+        template<auto Method, typename C>
+        void SubscribeAny(C* instance) {
+            AddHandler(m_AnySubscribers, instance, &MethodThunk<Event, Method, C>);
+        }
+
+        template<auto Method, typename C>
+        void UnsubscribeAny(C* instance) {
+            RemoveHandler(m_AnySubscribers, instance, &MethodThunk<Event, Method, C>);
+        }
+
+        // Queues an event for the next Drain. Events posted while draining
+        // are delivered by that same drain.
+        template<typename T, typename ... Args>
+        void Post(const Args& ... args) {
+            static_assert(std::is_base_of_v<Event, T>, "Only events can be posted");
+
+            m_Stats.Posted++;
+
+            T* event = TryQueue<T>(args...);
+            if(!event && !m_Draining) {
+                // Deliver what is queued so ordering is preserved
+                m_Stats.EarlyDrains++;
+                Drain();
+                event = TryQueue<T>(args...);
+            }
+
+            if(!event) {
+                m_Stats.Overflows++;
+                T immediate(args...);
+                Dispatch(T::StaticType, immediate);
+            }
+        }
+
+        // Delivers every queued event in posting order and resets the arena
+        void Drain();
+
+        // Delivers an event right away, bypassing the queue
+        void Dispatch(EventType type, Event& event);
+
+        inline size_t GetQueuedCount() const { return m_Queue.size(); }
+        inline const Stats& GetStats() const { return m_Stats; }
+        private:
+        struct Handler {
+            void* Instance;
+            HandlerFn Function;
+        };
+
+        struct QueuedEvent {
+            EventType Type;
+            Event* Data;
+        };
+
+        static constexpr size_t EVENT_TYPE_COUNT = static_cast<size_t>(EventType::Count);
+
+        static constexpr size_t Index(EventType type) { return static_cast<size_t>(type); }
+
+        template<typename T, auto Method, typename C>
+        static bool MethodThunk(void* instance, Event& event) {
+            return (static_cast<C*>(instance)->*Method)(static_cast<T&>(event));
+        }
+
+        template<typename T, bool (*Function)(T&)>
+        static bool FunctionThunk(void*, Event& event) {
+            return Function(static_cast<T&>(event));
+        }
+
+        template<typename T, typename ... Args>
+        T* TryQueue(const Args& ... args) {
+            if(m_Queue.size() == m_Queue.capacity()) return nullptr;
+
+            T* event = m_Arena.New<T>(args...);
+            if(!event) return nullptr;
+
+            m_Queue.push_back({ T::StaticType, event });
+            return event;
+        }
+
+        void AddHandler(std::vector<Handler>& handlers, void* instance, HandlerFn function);
+        void RemoveHandler(std::vector<Handler>& handlers, void* instance, HandlerFn function);
+        void CompactHandlers();
+
+        FrameArena m_Arena;
+        std::vector<QueuedEvent> m_Queue;
+
+        std::array<std::vector<Handler>, EVENT_TYPE_COUNT> m_Subscribers;
+        std::vector<Handler> m_AnySubscribers;
+
+        bool m_Draining = false;
+        uint32_t m_DispatchDepth = 0;
+        bool m_NeedsCompaction = false;
+
+        Stats m_Stats;
+    };
+}
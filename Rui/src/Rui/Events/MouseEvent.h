@@ -77,4 +77,25 @@ namespace Rui {
         int x;
         int y;
     };
+
+    class MouseScrollEvent : public MouseEvent {
+        public:
+        MouseScrollEvent(int x, int y)
+                : MouseEvent(), x(x), y(y) {
+        }
+
+        inline int GetX() const { return x; }
+        inline int GetY() const { return y; }
+
+        std::string ToString() const override {
+            std::stringstream ss;
+            ss << "MouseScrollEvent: " << x << ", " << y;
+            return ss.str();
+        }
+
+        EVENT_CLASS_TYPE(MouseScrolled)
+        private:
+        int x;
+        int y;
+    };
 }
\ No newline at end of file
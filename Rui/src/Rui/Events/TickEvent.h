@@ -6,7 +6,7 @@ namespace Rui {
     class TickEvent : public Event {
         public:
         TickEvent() {};
-        ~TickEvent() {};
+        ~TickEvent() = default;
 
         EVENT_CLASS_TYPE(TickEvent);
         EVENT_CLASS_CATEGORY(EventCategoryApplication)
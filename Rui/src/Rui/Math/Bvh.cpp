@@ -0,0 +1,475 @@
+#include "Bvh.h"
+
+#include "Rui/Core/Log.h"
+#include "Rui/Core/ThreadPool.h"
+
+#include <atomic>
+#include <latch>
+
+namespace Rui {
+	static constexpr uint32_t BIN_COUNT = 12;
+	// Queries per job in batches
+	static constexpr size_t BATCH_CHUNK = 64;
+
+	static inline bool SameBounds(const Aabb& a, const Aabb& b) {
+		return a.Min == b.Min && a.Max == b.Max;
+	}
+
+	// Runs body(chunk) for every chunk, on the pool's threads and the calling
+	// one, which pulls chunks as well rather than waiting idle
+	template<typename F>
+	static void ForEachChunk(size_t chunkCount, ThreadPool* pool, F&& body) {
+		if(!pool || pool->IsWorkerThread() || chunkCount <= 1) {
+			for(size_t chunk = 0; chunk < chunkCount; chunk++) body(chunk);
+			return;
+		}
+
+		std::atomic<size_t> next = 0;
+		auto work = [&]() {
+			for(size_t chunk = next++; chunk < chunkCount; chunk = next++) body(chunk);
+		};
+
+		size_t helpers = std::min<size_t>(pool->GetThreadCount(), chunkCount - 1);
+		std::latch done(static_cast<ptrdiff_t>(helpers));
+		for(size_t i = 0; i < helpers; i++) {
+			pool->Submit([&]() {
+				work();
+				done.count_down();
+			});
+		}
+
+		work();
+		done.wait();
+	}
+
+	template<typename Shape>
+	static void QueryBatch(const Bvh& bvh, const Shape* shapes, size_t count, BvhBatchResult& result, ThreadPool* pool) {
+		size_t chunkCount = (count + BATCH_CHUNK - 1) / BATCH_CHUNK;
+		std::vector<std::vector<uint32_t>> chunkItems(chunkCount);
+
+		// Counts first, each chunk owning its queries' slots
+		result.Offsets.assign(count + 1, 0);
+		ForEachChunk(chunkCount, pool, [&](size_t chunk) {
+			std::vector<uint32_t>& items = chunkItems[chunk];
+			size_t end = std::min(count, (chunk + 1) * BATCH_CHUNK);
+			for(size_t i = chunk * BATCH_CHUNK; i < end; i++) {
+				size_t before = items.size();
+				bvh.Query(shapes[i], [&](uint32_t item) { items.push_back(item); });
+				result.Offsets[i + 1] = static_cast<uint32_t>(items.size() - before);
+			}
+		});
+
+		for(size_t i = 0; i < count; i++) result.Offsets[i + 1] += result.Offsets[i];
+
+		result.Items.resize(result.Offsets[count]);
+		for(size_t chunk = 0; chunk < chunkCount; chunk++) {
+			std::copy(chunkItems[chunk].begin(), chunkItems[chunk].end(), result.Items.begin() + result.Offsets[chunk * BATCH_CHUNK]);
+		}
+	}
+
+	Bvh::Bvh(float rebuildRatio)
+		: m_RebuildRatio(rebuildRatio) {}
+
+	uint32_t Bvh::Insert(const Aabb& bounds, uint32_t item) {
+		uint32_t leaf = AllocateNode();
+		Node& node = m_Nodes[leaf];
+		node.Bounds = bounds;
+		node.Item = item;
+
+		InsertLeaf(leaf);
+		m_ProxyCount++;
+		return leaf;
+	}
+
+	void Bvh::Remove(uint32_t proxy) {
+		RUI_CORE_ASSERT(m_Nodes[proxy].IsLeaf(), "Not a proxy");
+
+		RemoveLeaf(proxy);
+		FreeNode(proxy);
+		m_ProxyCount--;
+	}
+
+	void Bvh::Move(uint32_t proxy, const Aabb& bounds) {
+		Node& node = m_Nodes[proxy];
+		node.Bounds = bounds;
+		if(!node.Moved) {
+			node.Moved = true;
+			m_Moved.push_back(proxy);
+		}
+	}
+
+	void Bvh::Clear() {
+		m_Nodes.clear();
+		m_Moved.clear();
+		m_Refit.clear();
+		m_Degraded.clear();
+		m_Root = NULL_NODE;
+		m_FreeList = NULL_NODE;
+		m_ProxyCount = 0;
+	}
+
+	void Bvh::Update() {
+		// Queues the ancestors of the moved proxies, each once
+		m_Refit.clear();
+		for(uint32_t leaf : m_Moved) {
+			// Removed since it moved
+			if(!m_Nodes[leaf].Moved) continue;
+			m_Nodes[leaf].Moved = false;
+
+			for(uint32_t index = m_Nodes[leaf].Parent; index != NULL_NODE && !m_Nodes[index].Refit; index = m_Nodes[index].Parent) {
+				m_Nodes[index].Refit = true;
+				m_Refit.push_back(index);
+			}
+		}
+		m_Moved.clear();
+
+		// Nodes are taller than their children, so refitting in order of
+		// height sees every child before its parent
+		uint32_t height = GetHeight();
+		m_RefitOffsets.assign(height + 2, 0);
+		for(uint32_t index : m_Refit) m_RefitOffsets[m_Nodes[index].Height + 1]++;
+		for(uint32_t i = 1; i < m_RefitOffsets.size(); i++) m_RefitOffsets[i] += m_RefitOffsets[i - 1];
+		m_RefitOrder.resize(m_Refit.size());
+		for(uint32_t index : m_Refit) m_RefitOrder[m_RefitOffsets[m_Nodes[index].Height]++] = index;
+
+		for(uint32_t index : m_RefitOrder) {
+			Node& node = m_Nodes[index];
+			node.Refit = false;
+			node.Bounds = Aabb::Union(m_Nodes[node.Left].Bounds, m_Nodes[node.Right].Bounds);
+			if(!node.Degraded && node.Bounds.GetSurfaceArea() > m_RebuildRatio * node.BuiltArea) {
+				node.Degraded = true;
+				m_Degraded.push_back(index);
+			}
+		}
+
+		// Only the topmost degraded node of a path is rebuilt, which takes
+		// the ones below with it
+		for(uint32_t index : m_Degraded) {
+			if(!m_Nodes[index].Degraded) continue;
+
+			uint32_t top = index;
+			for(uint32_t parent = m_Nodes[index].Parent; parent != NULL_NODE; parent = m_Nodes[parent].Parent) {
+				if(m_Nodes[parent].Degraded) top = parent;
+			}
+			RebuildSubtree(top);
+		}
+		m_Degraded.clear();
+	}
+
+	void Bvh::Rebuild() {
+		if(m_Root != NULL_NODE && !m_Nodes[m_Root].IsLeaf()) RebuildSubtree(m_Root);
+	}
+
+	void Bvh::Query(const Aabb* boxes, size_t count, BvhBatchResult& result, ThreadPool* pool) const {
+		QueryBatch(*this, boxes, count, result, pool);
+	}
+
+	void Bvh::Query(const Sphere* spheres, size_t count, BvhBatchResult& result, ThreadPool* pool) const {
+		QueryBatch(*this, spheres, count, result, pool);
+	}
+
+	void Bvh::Query(const Frustum* frustums, size_t count, BvhBatchResult& result, ThreadPool* pool) const {
+		QueryBatch(*this, frustums, count, result, pool);
+	}
+
+	RayHit Bvh::Raycast(const Ray& ray) const {
+		return Raycast(ray, [](uint32_t, float distance) { return distance; });
+	}
+
+	void Bvh::Raycast(const Ray* rays, size_t count, RayHit* hits, ThreadPool* pool) const {
+		size_t chunkCount = (count + BATCH_CHUNK - 1) / BATCH_CHUNK;
+		ForEachChunk(chunkCount, pool, [&](size_t chunk) {
+			size_t end = std::min(count, (chunk + 1) * BATCH_CHUNK);
+			for(size_t i = chunk * BATCH_CHUNK; i < end; i++) hits[i] = Raycast(rays[i]);
+		});
+	}
+
+	uint32_t Bvh::AllocateNode() {
+		if(m_FreeList == NULL_NODE) {
+			m_Nodes.emplace_back();
+			return static_cast<uint32_t>(m_Nodes.size() - 1);
+		}
+
+		// Free nodes are linked through Parent
+		uint32_t index = m_FreeList;
+		m_FreeList = m_Nodes[index].Parent;
+		m_Nodes[index] = Node();
+		return index;
+	}
+
+	void Bvh::FreeNode(uint32_t index) {
+		Node& node = m_Nodes[index];
+		node = Node();
+		node.Parent = m_FreeList;
+		m_FreeList = index;
+	}
+
+	void Bvh::InsertLeaf(uint32_t leaf) {
+		if(m_Root == NULL_NODE) {
+			m_Root = leaf;
+			m_Nodes[leaf].Parent = NULL_NODE;
+			return;
+		}
+
+		// Walks down towards the sibling that adds the least surface area,
+		// counting what the new node adds to every ancestor on the way
+		const Aabb bounds = m_Nodes[leaf].Bounds;
+		uint32_t index = m_Root;
+		while(!m_Nodes[index].IsLeaf()) {
+			const Node& node = m_Nodes[index];
+			float area = node.Bounds.GetSurfaceArea();
+			float combinedArea = Aabb::Union(node.Bounds, bounds).GetSurfaceArea();
+
+			// A new parent of this node and the leaf here
+			float cost = 2.0f * combinedArea;
+			// Pushing the leaf further down still grows this node
+			float inheritanceCost = 2.0f * (combinedArea - area);
+
+			auto descendCost = [&](uint32_t child) {
+				const Aabb& childBounds = m_Nodes[child].Bounds;
+				float childCost = Aabb::Union(childBounds, bounds).GetSurfaceArea();
+				if(!m_Nodes[child].IsLeaf()) childCost -= childBounds.GetSurfaceArea();
+				return childCost + inheritanceCost;
+			};
+			float leftCost = descendCost(node.Left);
+			float rightCost = descendCost(node.Right);
+
+			if(cost < leftCost && cost < rightCost) break;
+			index = leftCost < rightCost ? node.Left : node.Right;
+		}
+
+		uint32_t sibling = index;
+		uint32_t oldParent = m_Nodes[sibling].Parent;
+		uint32_t newParent = AllocateNode();
+
+		Node& parent = m_Nodes[newParent];
+		parent.Parent = oldParent;
+		parent.Left = sibling;
+		parent.Right = leaf;
+		m_Nodes[sibling].Parent = newParent;
+		m_Nodes[leaf].Parent = newParent;
+
+		if(oldParent == NULL_NODE) {
+			m_Root = newParent;
+		} else if(m_Nodes[oldParent].Left == sibling) {
+			m_Nodes[oldParent].Left = newParent;
+		} else {
+			m_Nodes[oldParent].Right = newParent;
+		}
+
+		FixUpwards(newParent);
+	}
+
+	void Bvh::RemoveLeaf(uint32_t leaf) {
+		if(leaf == m_Root) {
+			m_Root = NULL_NODE;
+			return;
+		}
+
+		uint32_t parent = m_Nodes[leaf].Parent;
+		uint32_t grandParent = m_Nodes[parent].Parent;
+		uint32_t sibling = m_Nodes[parent].Left == leaf ? m_Nodes[parent].Right : m_Nodes[parent].Left;
+
+		// The sibling takes the parent's place
+		m_Nodes[sibling].Parent = grandParent;
+		FreeNode(parent);
+
+		if(grandParent == NULL_NODE) {
+			m_Root = sibling;
+			return;
+		}
+
+		if(m_Nodes[grandParent].Left == parent) m_Nodes[grandParent].Left = sibling;
+		else m_Nodes[grandParent].Right = sibling;
+		FixUpwards(grandParent);
+	}
+
+	// One tree rotation if the children's heights differ by more than one,
+	// as in an AVL tree. Returns the node now in `index`'s place.
+	uint32_t Bvh::Balance(uint32_t indexA) {
+		Node& a = m_Nodes[indexA];
+		if(a.IsLeaf() || a.Height < 2) return indexA;
+
+		uint32_t indexB = a.Left;
+		uint32_t indexC = a.Right;
+		int32_t balance = static_cast<int32_t>(m_Nodes[indexC].Height) - static_cast<int32_t>(m_Nodes[indexB].Height);
+		if(balance >= -1 && balance <= 1) return indexA;
+
+		// The taller child is raised into A's place and A takes the place of
+		// its shorter grandchild
+		bool raiseRight = balance > 1;
+		uint32_t indexUp = raiseRight ? indexC : indexB;
+		uint32_t indexStay = raiseRight ? indexB : indexC;
+		Node& up = m_Nodes[indexUp];
+
+		uint32_t indexF = up.Left;
+		uint32_t indexG = up.Right;
+		Node& f = m_Nodes[indexF];
+		Node& g = m_Nodes[indexG];
+
+		up.Parent = a.Parent;
+		a.Parent = indexUp;
+		if(up.Parent == NULL_NODE) {
+			m_Root = indexUp;
+		} else if(m_Nodes[up.Parent].Left == indexA) {
+			m_Nodes[up.Parent].Left = indexUp;
+		} else {
+			m_Nodes[up.Parent].Right = indexUp;
+		}
+
+		// The taller grandchild stays with the raised node
+		bool keepF = f.Height > g.Height;
+		uint32_t indexKeep = keepF ? indexF : indexG;
+		uint32_t indexMove = keepF ? indexG : indexF;
+		Node& keep = m_Nodes[indexKeep];
+		Node& moved = m_Nodes[indexMove];
+
+		up.Left = indexA;
+		up.Right = indexKeep;
+		if(raiseRight) a.Right = indexMove;
+		else a.Left = indexMove;
+		moved.Parent = indexA;
+
+		const Node& stay = m_Nodes[indexStay];
+		a.Bounds = Aabb::Union(stay.Bounds, moved.Bounds);
+		a.Height = 1 + std::max(stay.Height, moved.Height);
+		a.BuiltArea = a.Bounds.GetSurfaceArea();
+		up.Bounds = Aabb::Union(a.Bounds, keep.Bounds);
+		up.Height = 1 + std::max(a.Height, keep.Height);
+		up.BuiltArea = up.Bounds.GetSurfaceArea();
+
+		return indexUp;
+	}
+
+	void Bvh::FixUpwards(uint32_t index) {
+		while(index != NULL_NODE) {
+			index = Balance(index);
+
+			Node& node = m_Nodes[index];
+			const Node& left = m_Nodes[node.Left];
+			const Node& right = m_Nodes[node.Right];
+			node.Bounds = Aabb::Union(left.Bounds, right.Bounds);
+			node.Height = 1 + std::max(left.Height, right.Height);
+			node.BuiltArea = node.Bounds.GetSurfaceArea();
+
+			index = node.Parent;
+		}
+	}
+
+	void Bvh::RebuildSubtree(uint32_t index) {
+		// Gathers the leaves and frees the nodes between them, except for
+		// the subtree's root, which keeps its place in the parent
+		m_BuildLeaves.clear();
+		TraversalStack stack;
+		stack.Push(index);
+		while(!stack.IsEmpty()) {
+			uint32_t current = stack.Pop();
+			const Node& node = m_Nodes[current];
+			if(node.IsLeaf()) {
+				m_BuildLeaves.push_back(current);
+				continue;
+			}
+
+			stack.Push(node.Left);
+			stack.Push(node.Right);
+			if(current != index) FreeNode(current);
+		}
+
+		uint32_t parent = m_Nodes[index].Parent;
+		BuildRange(m_BuildLeaves.data(), static_cast<uint32_t>(m_BuildLeaves.size()), parent, index);
+
+		// Same leaves, so only the heights above can have changed
+		for(uint32_t ancestor = parent; ancestor != NULL_NODE; ancestor = m_Nodes[ancestor].Parent) {
+			Node& node = m_Nodes[ancestor];
+			node.Height = 1 + std::max(m_Nodes[node.Left].Height, m_Nodes[node.Right].Height);
+		}
+	}
+
+	// Top down build with binned surface area heuristic, after Wald, "On
+	// fast Construction of SAH-based Bounding Volume Hierarchies"
+	uint32_t Bvh::BuildRange(uint32_t* leaves, uint32_t count, uint32_t parent, uint32_t reuse) {
+		if(count == 1) {
+			m_Nodes[leaves[0]].Parent = parent;
+			return leaves[0];
+		}
+
+		uint32_t index = reuse != NULL_NODE ? reuse : AllocateNode();
+
+		Aabb centroids{ m_Nodes[leaves[0]].Bounds.GetCenter(), m_Nodes[leaves[0]].Bounds.GetCenter() };
+		for(uint32_t i = 1; i < count; i++) {
+			glm::vec3 center = m_Nodes[leaves[i]].Bounds.GetCenter();
+			centroids.Min = glm::min(centroids.Min, center);
+			centroids.Max = glm::max(centroids.Max, center);
+		}
+
+		glm::vec3 extent = centroids.Max - centroids.Min;
+		int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+
+		uint32_t split = count / 2;
+		if(extent[axis] > 0.0f) {
+			float scale = BIN_COUNT / extent[axis];
+			auto binOf = [&](uint32_t leaf) {
+				float offset = (m_Nodes[leaf].Bounds.GetCenter()[axis] - centroids.Min[axis]) * scale;
+				return std::min(static_cast<uint32_t>(offset), BIN_COUNT - 1);
+			};
+
+			Aabb binBounds[BIN_COUNT];
+			uint32_t binCounts[BIN_COUNT] = {};
+			for(uint32_t i = 0; i < count; i++) {
+				uint32_t bin = binOf(leaves[i]);
+				const Aabb& bounds = m_Nodes[leaves[i]].Bounds;
+				binBounds[bin] = binCounts[bin]++ ? Aabb::Union(binBounds[bin], bounds) : bounds;
+			}
+
+			// Cost of splitting after bin i, from a sweep each way
+			float rightCosts[BIN_COUNT] = {};
+			Aabb accumulated;
+			uint32_t accumulatedCount = 0;
+			for(uint32_t bin = BIN_COUNT - 1; bin > 0; bin--) {
+				if(binCounts[bin]) {
+					accumulated = accumulatedCount ? Aabb::Union(accumulated, binBounds[bin]) : binBounds[bin];
+					accumulatedCount += binCounts[bin];
+				}
+				rightCosts[bin - 1] = accumulatedCount ? accumulated.GetSurfaceArea() * accumulatedCount : 0.0f;
+			}
+
+			float bestCost = FLT_MAX;
+			uint32_t bestBin = BIN_COUNT;
+			accumulatedCount = 0;
+			for(uint32_t bin = 0; bin + 1 < BIN_COUNT; bin++) {
+				if(binCounts[bin]) {
+					accumulated = accumulatedCount ? Aabb::Union(accumulated, binBounds[bin]) : binBounds[bin];
+					accumulatedCount += binCounts[bin];
+				}
+				if(accumulatedCount == 0 || accumulatedCount == count) continue;
+
+				float cost = accumulated.GetSurfaceArea() * accumulatedCount + rightCosts[bin];
+				if(cost < bestCost) {
+					bestCost = cost;
+					bestBin = bin;
+				}
+			}
+
+			if(bestBin != BIN_COUNT) {
+				uint32_t* middle = std::partition(leaves, leaves + count, [&](uint32_t leaf) { return binOf(leaf) <= bestBin; });
+				split = static_cast<uint32_t>(middle - leaves);
+			}
+		}
+
+		// All centres in one place, split anywhere
+		if(split == 0 || split == count) split = count / 2;
+
+		uint32_t left = BuildRange(leaves, split, index, NULL_NODE);
+		uint32_t right = BuildRange(leaves + split, count - split, index, NULL_NODE);
+
+		Node& node = m_Nodes[index];
+		node.Parent = parent;
+		node.Left = left;
+		node.Right = right;
+		node.Bounds = Aabb::Union(m_Nodes[left].Bounds, m_Nodes[right].Bounds);
+		node.Height = 1 + std::max(m_Nodes[left].Height, m_Nodes[right].Height);
+		node.BuiltArea = node.Bounds.GetSurfaceArea();
+		node.Degraded = false;
+		return index;
+	}
+}
@@ -0,0 +1,212 @@
+#pragma once
+
+#include "Geometry.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Rui {
+	class ThreadPool;
+
+	// Items found by a batch of overlap queries: those of query i are
+	// Items[Offsets[i]] up to Items[Offsets[i + 1]]
+	struct BvhBatchResult {
+		std::vector<uint32_t> Offsets;
+		std::vector<uint32_t> Items;
+	};
+
+	struct RayHit {
+		uint32_t Item = UINT32_MAX;
+		float Distance = FLT_MAX;
+
+		inline bool IsHit() const { return Item != UINT32_MAX; }
+	};
+
+	// Dynamic bounding volume hierarchy over boxes, one per proxy, each
+	// carrying a user value that queries report back.
+	//
+	// Proxies are inserted by surface area cost and kept balanced by tree
+	// rotations, after Box2D's b2DynamicTree. Moving one only stores its
+	// new bounds; Update() then refits the nodes above the moved proxies and
+	// rebuilds, with a binned surface area heuristic, every subtree whose
+	// area has grown past `rebuildRatio` times its area when it was built.
+	//
+	// Queries are const and may run on any number of threads at once, but
+	// not while the tree is changed.
+	class Bvh {
+	public:
+		static constexpr uint32_t NULL_NODE = UINT32_MAX;
+
+		explicit Bvh(float rebuildRatio = 2.0f);
+
+		// Returns the proxy, which stays valid until it is removed
+		uint32_t Insert(const Aabb& bounds, uint32_t item);
+		void Remove(uint32_t proxy);
+		// Takes effect in queries after the next Update()
+		void Move(uint32_t proxy, const Aabb& bounds);
+		void Clear();
+
+		void Update();
+		// Builds the whole tree again, for after many insertions at once
+		void Rebuild();
+
+		inline const Aabb& GetBounds(uint32_t proxy) const { return m_Nodes[proxy].Bounds; }
+		inline uint32_t GetItem(uint32_t proxy) const { return m_Nodes[proxy].Item; }
+		inline uint32_t GetProxyCount() const { return m_ProxyCount; }
+		// Of the longest path, 0 for a single proxy
+		inline uint32_t GetHeight() const { return m_Root == NULL_NODE ? 0 : m_Nodes[m_Root].Height; }
+
+		// `callback(item)` for every proxy the shape touches
+		template<typename F> void Query(const Aabb& box, F&& callback) const {
+			Traverse([&](const Aabb& bounds) { return Overlaps(bounds, box); }, callback);
+		}
+		template<typename F> void Query(const Sphere& sphere, F&& callback) const {
+			Traverse([&](const Aabb& bounds) { return Overlaps(bounds, sphere); }, callback);
+		}
+		template<typename F> void Query(const Frustum& frustum, F&& callback) const {
+			Traverse([&](const Aabb& bounds) { return Overlaps(bounds, frustum); }, callback);
+		}
+
+		// Closest proxy along the ray by its bounds. `test(item, distance)`
+		// may refine each candidate against the real geometry and returns
+		// the distance of the hit, or a negative value for a miss; the ray
+		// is shortened to every hit, so candidates come in roughly front to
+		// back order and far ones are skipped.
+		template<typename F> RayHit Raycast(const Ray& ray, F&& test) const;
+		RayHit Raycast(const Ray& ray) const;
+
+		// The batched queries split the batch among the pool's threads and
+		// the calling one, or run on the calling thread without a pool
+		void Query(const Aabb* boxes, size_t count, BvhBatchResult& result, ThreadPool* pool = nullptr) const;
+		void Query(const Sphere* spheres, size_t count, BvhBatchResult& result, ThreadPool* pool = nullptr) const;
+		void Query(const Frustum* frustums, size_t count, BvhBatchResult& result, ThreadPool* pool = nullptr) const;
+		void Raycast(const Ray* rays, size_t count, RayHit* hits, ThreadPool* pool = nullptr) const;
+	private:
+		struct Node {
+			Aabb Bounds;
+			uint32_t Parent = NULL_NODE;
+			// Both NULL_NODE for proxies
+			uint32_t Left = NULL_NODE;
+			uint32_t Right = NULL_NODE;
+			uint32_t Item = 0;
+			uint32_t Height = 0;
+			// Surface area when the node was last built or rebalanced
+			float BuiltArea = 0.0f;
+			bool Moved = false;
+			bool Refit = false;
+			bool Degraded = false;
+
+			inline bool IsLeaf() const { return Left == NULL_NODE; }
+		};
+
+		// Stack for walking the tree without recursion; spills to the heap
+		// only for trees far deeper than rebalancing lets them grow
+		class TraversalStack {
+		public:
+			inline void Push(uint32_t node) {
+				if(m_Size < INLINE_SIZE) m_Inline[m_Size] = node;
+				else m_Spill.push_back(node);
+				m_Size++;
+			}
+			inline uint32_t Pop() {
+				m_Size--;
+				if(m_Size < INLINE_SIZE) return m_Inline[m_Size];
+				uint32_t node = m_Spill.back();
+				m_Spill.pop_back();
+				return node;
+			}
+			inline bool IsEmpty() const { return m_Size == 0; }
+		private:
+			static constexpr uint32_t INLINE_SIZE = 64;
+			uint32_t m_Inline[INLINE_SIZE];
+			std::vector<uint32_t> m_Spill;
+			uint32_t m_Size = 0;
+		};
+
+		template<typename Overlap, typename F> void Traverse(Overlap&& overlaps, F&& callback) const;
+
+		uint32_t AllocateNode();
+		void FreeNode(uint32_t node);
+
+		void InsertLeaf(uint32_t leaf);
+		void RemoveLeaf(uint32_t leaf);
+		uint32_t Balance(uint32_t node);
+		// Recomputes bounds and heights from `node` up to the root
+		void FixUpwards(uint32_t node);
+
+		void RebuildSubtree(uint32_t node);
+		uint32_t BuildRange(uint32_t* leaves, uint32_t count, uint32_t parent, uint32_t reuse);
+
+		std::vector<Node> m_Nodes;
+		uint32_t m_Root = NULL_NODE;
+		uint32_t m_FreeList = NULL_NODE;
+		uint32_t m_ProxyCount = 0;
+		float m_RebuildRatio;
+
+		std::vector<uint32_t> m_Moved;
+		std::vector<uint32_t> m_Refit;
+		std::vector<uint32_t> m_RefitOffsets;
+		std::vector<uint32_t> m_RefitOrder;
+		std::vector<uint32_t> m_Degraded;
+		std::vector<uint32_t> m_BuildLeaves;
+	};
+
+	template<typename Overlap, typename F>
+	void Bvh::Traverse(Overlap&& overlaps, F&& callback) const {
+		if(m_Root == NULL_NODE) return;
+
+		TraversalStack stack;
+		stack.Push(m_Root);
+		while(!stack.IsEmpty()) {
+			const Node& node = m_Nodes[stack.Pop()];
+			if(!overlaps(node.Bounds)) continue;
+
+			if(node.IsLeaf()) {
+				callback(node.Item);
+			} else {
+				stack.Push(node.Left);
+				stack.Push(node.Right);
+			}
+		}
+	}
+
+	template<typename F>
+	RayHit Bvh::Raycast(const Ray& ray, F&& test) const {
+		RayHit hit;
+		if(m_Root == NULL_NODE) return hit;
+
+		glm::vec3 inverseDirection = 1.0f / ray.Direction;
+		float maxDistance = ray.MaxDistance;
+
+		TraversalStack stack;
+		stack.Push(m_Root);
+		while(!stack.IsEmpty()) {
+			const Node& node = m_Nodes[stack.Pop()];
+			float distance = IntersectRay(node.Bounds, ray.Origin, inverseDirection, maxDistance);
+			if(distance < 0.0f) continue;
+
+			if(node.IsLeaf()) {
+				float refined = test(node.Item, distance);
+				if(refined >= 0.0f && refined <= maxDistance) {
+					maxDistance = refined;
+					hit.Item = node.Item;
+					hit.Distance = refined;
+				}
+				continue;
+			}
+
+			// The nearer child goes on top of the stack
+			float left = IntersectRay(m_Nodes[node.Left].Bounds, ray.Origin, inverseDirection, maxDistance);
+			float right = IntersectRay(m_Nodes[node.Right].Bounds, ray.Origin, inverseDirection, maxDistance);
+			if(left >= 0.0f && right >= 0.0f) {
+				stack.Push(left < right ? node.Right : node.Left);
+				stack.Push(left < right ? node.Left : node.Right);
+			} else if(left >= 0.0f) {
+				stack.Push(node.Left);
+			} else if(right >= 0.0f) {
+				stack.Push(node.Right);
+			}
+		}
+		return hit;
+	}
+}
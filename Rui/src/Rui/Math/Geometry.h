@@ -0,0 +1,95 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cfloat>
+
+namespace Rui {
+	struct Aabb {
+		glm::vec3 Min{ 0.0f };
+		glm::vec3 Max{ 0.0f };
+
+		inline glm::vec3 GetCenter() const { return (Min + Max) * 0.5f; }
+		inline float GetSurfaceArea() const {
+			glm::vec3 size = Max - Min;
+			return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+		}
+		inline bool Contains(const Aabb& other) const {
+			return glm::all(glm::lessThanEqual(Min, other.Min)) && glm::all(glm::greaterThanEqual(Max, other.Max));
+		}
+
+		static inline Aabb Union(const Aabb& a, const Aabb& b) {
+			return { glm::min(a.Min, b.Min), glm::max(a.Max, b.Max) };
+		}
+	};
+
+	struct Sphere {
+		glm::vec3 Center{ 0.0f };
+		float Radius = 0.0f;
+	};
+
+	struct Ray {
+		glm::vec3 Origin{ 0.0f };
+		// Need not be normalized, distances are in its units
+		glm::vec3 Direction{ 0.0f, 0.0f, -1.0f };
+		float MaxDistance = FLT_MAX;
+	};
+
+	// Planes face inwards, with unit normals in xyz and the distance in w
+	struct Frustum {
+		glm::vec4 Planes[6];
+
+		// Gribb and Hartmann's extraction from a projection or view
+		// projection matrix. The near plane is taken for a -1 to 1 depth
+		// range, which is conservative for 0 to 1 projections as well.
+		static Frustum FromMatrix(const glm::mat4& matrix) {
+			glm::vec4 rows[4];
+			for(int i = 0; i < 4; i++) rows[i] = glm::vec4(matrix[0][i], matrix[1][i], matrix[2][i], matrix[3][i]);
+
+			Frustum frustum;
+			frustum.Planes[0] = rows[3] + rows[0];
+			frustum.Planes[1] = rows[3] - rows[0];
+			frustum.Planes[2] = rows[3] + rows[1];
+			frustum.Planes[3] = rows[3] - rows[1];
+			frustum.Planes[4] = rows[3] + rows[2];
+			frustum.Planes[5] = rows[3] - rows[2];
+			for(glm::vec4& plane : frustum.Planes) plane /= glm::length(glm::vec3(plane));
+			return frustum;
+		}
+	};
+
+	inline bool Overlaps(const Aabb& a, const Aabb& b) {
+		return glm::all(glm::lessThanEqual(a.Min, b.Max)) && glm::all(glm::greaterThanEqual(a.Max, b.Min));
+	}
+
+	inline bool Overlaps(const Aabb& box, const Sphere& sphere) {
+		glm::vec3 closest = glm::clamp(sphere.Center, box.Min, box.Max);
+		glm::vec3 offset = closest - sphere.Center;
+		return glm::dot(offset, offset) <= sphere.Radius * sphere.Radius;
+	}
+
+	// Conservative: boxes near a frustum corner may pass without touching it
+	inline bool Overlaps(const Aabb& box, const Frustum& frustum) {
+		for(const glm::vec4& plane : frustum.Planes) {
+			// The corner furthest along the normal
+			glm::vec3 corner(plane.x >= 0.0f ? box.Max.x : box.Min.x, plane.y >= 0.0f ? box.Max.y : box.Min.y, plane.z >= 0.0f ? box.Max.z : box.Min.z);
+			if(glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f) return false;
+		}
+		return true;
+	}
+
+	// Slab test; `inverseDirection` is 1 / ray.Direction. Returns the
+	// distance the ray enters the box at, 0 if it starts inside, or a
+	// negative value if it misses it within `maxDistance`.
+	inline float IntersectRay(const Aabb& box, const glm::vec3& origin, const glm::vec3& inverseDirection, float maxDistance) {
+		glm::vec3 t0 = (box.Min - origin) * inverseDirection;
+		glm::vec3 t1 = (box.Max - origin) * inverseDirection;
+		glm::vec3 entries = glm::min(t0, t1);
+		glm::vec3 exits = glm::max(t0, t1);
+
+		float enter = std::max({ entries.x, entries.y, entries.z, 0.0f });
+		float exit = std::min({ exits.x, exits.y, exits.z, maxDistance });
+		return enter <= exit ? enter : -1.0f;
+	}
+}
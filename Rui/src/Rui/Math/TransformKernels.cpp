@@ -0,0 +1,362 @@
+#include "TransformKernels.h"
+
+#include <cmath>
+
+#if !defined(RUI_MATH_SCALAR)
+	#if defined(__AVX2__)
+		#define RUI_MATH_AVX2
+		#include <immintrin.h>
+	#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define RUI_MATH_SSE2
+		#include <emmintrin.h>
+	#elif defined(__ARM_NEON) || defined(_M_ARM64)
+		#define RUI_MATH_NEON
+		#include <arm_neon.h>
+	#endif
+#endif
+
+namespace Rui {
+	// Every instruction set provides the same operations on a vector of
+	// `Width` floats, and the kernels below are written once against them.
+	// Matrix elements are kept as 16 vectors, element [column * 4 + row] of
+	// `Width` consecutive matrices each.
+
+	struct ScalarOps {
+		using Vector = float;
+		static constexpr size_t Width = 1;
+
+		static Vector Load(const float* p) { return *p; }
+		static void Store(float* p, Vector v) { *p = v; }
+		static Vector Set(float v) { return v; }
+		static Vector Add(Vector a, Vector b) { return a + b; }
+		static Vector Sub(Vector a, Vector b) { return a - b; }
+		static Vector Mul(Vector a, Vector b) { return a * b; }
+		// a * b + c
+		static Vector MulAdd(Vector a, Vector b, Vector c) { return a * b + c; }
+		static Vector Abs(Vector v) { return std::abs(v); }
+
+		static void LoadMatrices(const glm::mat4* matrices, Vector elements[16]) {
+			for(int column = 0; column < 4; column++) {
+				for(int row = 0; row < 4; row++) elements[column * 4 + row] = matrices[0][column][row];
+			}
+		}
+		static void StoreMatrices(const Vector elements[16], glm::mat4* matrices) {
+			for(int column = 0; column < 4; column++) {
+				for(int row = 0; row < 4; row++) matrices[0][column][row] = elements[column * 4 + row];
+			}
+		}
+
+		static void Multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& out) {
+			out = a * b;
+		}
+	};
+
+#if defined(RUI_MATH_SSE2) || defined(RUI_MATH_AVX2)
+	static inline void Transpose(__m128& a, __m128& b, __m128& c, __m128& d) {
+		_MM_TRANSPOSE4_PS(a, b, c, d);
+	}
+
+	// Element vectors of four matrices from their columns
+	static inline void LoadMatrices4(const glm::mat4* matrices, __m128 elements[16]) {
+		for(int column = 0; column < 4; column++) {
+			__m128 a = _mm_loadu_ps(&matrices[0][column][0]);
+			__m128 b = _mm_loadu_ps(&matrices[1][column][0]);
+			__m128 c = _mm_loadu_ps(&matrices[2][column][0]);
+			__m128 d = _mm_loadu_ps(&matrices[3][column][0]);
+			Transpose(a, b, c, d);
+			elements[column * 4 + 0] = a;
+			elements[column * 4 + 1] = b;
+			elements[column * 4 + 2] = c;
+			elements[column * 4 + 3] = d;
+		}
+	}
+
+	static inline void StoreMatrices4(const __m128 elements[16], glm::mat4* matrices) {
+		for(int column = 0; column < 4; column++) {
+			__m128 a = elements[column * 4 + 0];
+			__m128 b = elements[column * 4 + 1];
+			__m128 c = elements[column * 4 + 2];
+			__m128 d = elements[column * 4 + 3];
+			Transpose(a, b, c, d);
+			_mm_storeu_ps(&matrices[0][column][0], a);
+			_mm_storeu_ps(&matrices[1][column][0], b);
+			_mm_storeu_ps(&matrices[2][column][0], c);
+			_mm_storeu_ps(&matrices[3][column][0], d);
+		}
+	}
+#endif
+
+#if defined(RUI_MATH_SSE2)
+	struct SseOps {
+		using Vector = __m128;
+		static constexpr size_t Width = 4;
+
+		static Vector Load(const float* p) { return _mm_loadu_ps(p); }
+		static void Store(float* p, Vector v) { _mm_storeu_ps(p, v); }
+		static Vector Set(float v) { return _mm_set1_ps(v); }
+		static Vector Add(Vector a, Vector b) { return _mm_add_ps(a, b); }
+		static Vector Sub(Vector a, Vector b) { return _mm_sub_ps(a, b); }
+		static Vector Mul(Vector a, Vector b) { return _mm_mul_ps(a, b); }
+		static Vector MulAdd(Vector a, Vector b, Vector c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+		static Vector Abs(Vector v) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), v); }
+
+		static void LoadMatrices(const glm::mat4* matrices, Vector elements[16]) { LoadMatrices4(matrices, elements); }
+		static void StoreMatrices(const Vector elements[16], glm::mat4* matrices) { StoreMatrices4(elements, matrices); }
+
+		// Each column of the product is a sum of a's columns scaled by the
+		// elements of b's column, so no transposes are needed
+		static void Multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& out) {
+			__m128 a0 = _mm_loadu_ps(&a[0][0]);
+			__m128 a1 = _mm_loadu_ps(&a[1][0]);
+			__m128 a2 = _mm_loadu_ps(&a[2][0]);
+			__m128 a3 = _mm_loadu_ps(&a[3][0]);
+
+			for(int column = 0; column < 4; column++) {
+				__m128 b0 = _mm_loadu_ps(&b[column][0]);
+				__m128 result = _mm_mul_ps(a0, _mm_shuffle_ps(b0, b0, _MM_SHUFFLE(0, 0, 0, 0)));
+				result = _mm_add_ps(result, _mm_mul_ps(a1, _mm_shuffle_ps(b0, b0, _MM_SHUFFLE(1, 1, 1, 1))));
+				result = _mm_add_ps(result, _mm_mul_ps(a2, _mm_shuffle_ps(b0, b0, _MM_SHUFFLE(2, 2, 2, 2))));
+				result = _mm_add_ps(result, _mm_mul_ps(a3, _mm_shuffle_ps(b0, b0, _MM_SHUFFLE(3, 3, 3, 3))));
+				_mm_storeu_ps(&out[column][0], result);
+			}
+		}
+	};
+	using WideOps = SseOps;
+	static constexpr const char* KERNEL_PATH = "SSE2";
+#elif defined(RUI_MATH_AVX2)
+	struct AvxOps {
+		using Vector = __m256;
+		static constexpr size_t Width = 8;
+
+		static Vector Load(const float* p) { return _mm256_loadu_ps(p); }
+		static void Store(float* p, Vector v) { _mm256_storeu_ps(p, v); }
+		static Vector Set(float v) { return _mm256_set1_ps(v); }
+		static Vector Add(Vector a, Vector b) { return _mm256_add_ps(a, b); }
+		static Vector Sub(Vector a, Vector b) { return _mm256_sub_ps(a, b); }
+		static Vector Mul(Vector a, Vector b) { return _mm256_mul_ps(a, b); }
+		static Vector MulAdd(Vector a, Vector b, Vector c) {
+		#if defined(__FMA__) || defined(_MSC_VER)
+			return _mm256_fmadd_ps(a, b, c);
+		#else
+			return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+		#endif
+		}
+		static Vector Abs(Vector v) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v); }
+
+		// Two groups of four, the low lane holding the first
+		static void LoadMatrices(const glm::mat4* matrices, Vector elements[16]) {
+			__m128 low[16], high[16];
+			LoadMatrices4(matrices, low);
+			LoadMatrices4(matrices + 4, high);
+			for(int i = 0; i < 16; i++) elements[i] = _mm256_insertf128_ps(_mm256_castps128_ps256(low[i]), high[i], 1);
+		}
+		static void StoreMatrices(const Vector elements[16], glm::mat4* matrices) {
+			__m128 low[16], high[16];
+			for(int i = 0; i < 16; i++) {
+				low[i] = _mm256_castps256_ps128(elements[i]);
+				high[i] = _mm256_extractf128_ps(elements[i], 1);
+			}
+			StoreMatrices4(low, matrices);
+			StoreMatrices4(high, matrices + 4);
+		}
+
+		// Two columns of the product per step: a's columns are repeated in
+		// both lanes and multiplied by the matching element of b's column
+		static void Multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& out) {
+			__m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a[0][0]));
+			__m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a[1][0]));
+			__m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a[2][0]));
+			__m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a[3][0]));
+
+			for(int column = 0; column < 4; column += 2) {
+				__m256 b01 = _mm256_loadu_ps(&b[column][0]);
+				__m256 result = _mm256_mul_ps(a0, _mm256_permute_ps(b01, _MM_SHUFFLE(0, 0, 0, 0)));
+				result = MulAdd(a1, _mm256_permute_ps(b01, _MM_SHUFFLE(1, 1, 1, 1)), result);
+				result = MulAdd(a2, _mm256_permute_ps(b01, _MM_SHUFFLE(2, 2, 2, 2)), result);
+				result = MulAdd(a3, _mm256_permute_ps(b01, _MM_SHUFFLE(3, 3, 3, 3)), result);
+				_mm256_storeu_ps(&out[column][0], result);
+			}
+		}
+	};
+	using WideOps = AvxOps;
+	static constexpr const char* KERNEL_PATH = "AVX2";
+#elif defined(RUI_MATH_NEON)
+	struct NeonOps {
+		using Vector = float32x4_t;
+		static constexpr size_t Width = 4;
+
+		static Vector Load(const float* p) { return vld1q_f32(p); }
+		static void Store(float* p, Vector v) { vst1q_f32(p, v); }
+		static Vector Set(float v) { return vdupq_n_f32(v); }
+		static Vector Add(Vector a, Vector b) { return vaddq_f32(a, b); }
+		static Vector Sub(Vector a, Vector b) { return vsubq_f32(a, b); }
+		static Vector Mul(Vector a, Vector b) { return vmulq_f32(a, b); }
+		static Vector MulAdd(Vector a, Vector b, Vector c) { return vmlaq_f32(c, a, b); }
+		static Vector Abs(Vector v) { return vabsq_f32(v); }
+
+		static void Transpose(Vector& a, Vector& b, Vector& c, Vector& d) {
+			float32x4x2_t ab = vtrnq_f32(a, b);
+			float32x4x2_t cd = vtrnq_f32(c, d);
+			a = vcombine_f32(vget_low_f32(ab.val[0]), vget_low_f32(cd.val[0]));
+			b = vcombine_f32(vget_low_f32(ab.val[1]), vget_low_f32(cd.val[1]));
+			c = vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0]));
+			d = vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1]));
+		}
+
+		static void LoadMatrices(const glm::mat4* matrices, Vector elements[16]) {
+			for(int column = 0; column < 4; column++) {
+				Vector a = vld1q_f32(&matrices[0][column][0]);
+				Vector b = vld1q_f32(&matrices[1][column][0]);
+				Vector c = vld1q_f32(&matrices[2][column][0]);
+				Vector d = vld1q_f32(&matrices[3][column][0]);
+				Transpose(a, b, c, d);
+				elements[column * 4 + 0] = a;
+				elements[column * 4 + 1] = b;
+				elements[column * 4 + 2] = c;
+				elements[column * 4 + 3] = d;
+			}
+		}
+		static void StoreMatrices(const Vector elements[16], glm::mat4* matrices) {
+			for(int column = 0; column < 4; column++) {
+				Vector a = elements[column * 4 + 0];
+				Vector b = elements[column * 4 + 1];
+				Vector c = elements[column * 4 + 2];
+				Vector d = elements[column * 4 + 3];
+				Transpose(a, b, c, d);
+				vst1q_f32(&matrices[0][column][0], a);
+				vst1q_f32(&matrices[1][column][0], b);
+				vst1q_f32(&matrices[2][column][0], c);
+				vst1q_f32(&matrices[3][column][0], d);
+			}
+		}
+
+		static void Multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& out) {
+			Vector a0 = vld1q_f32(&a[0][0]);
+			Vector a1 = vld1q_f32(&a[1][0]);
+			Vector a2 = vld1q_f32(&a[2][0]);
+			Vector a3 = vld1q_f32(&a[3][0]);
+
+			for(int column = 0; column < 4; column++) {
+				Vector b0 = vld1q_f32(&b[column][0]);
+				Vector result = vmulq_lane_f32(a0, vget_low_f32(b0), 0);
+				result = vmlaq_lane_f32(result, a1, vget_low_f32(b0), 1);
+				result = vmlaq_lane_f32(result, a2, vget_high_f32(b0), 0);
+				result = vmlaq_lane_f32(result, a3, vget_high_f32(b0), 1);
+				vst1q_f32(&out[column][0], result);
+			}
+		}
+	};
+	using WideOps = NeonOps;
+	static constexpr const char* KERNEL_PATH = "NEON";
+#else
+	using WideOps = ScalarOps;
+	static constexpr const char* KERNEL_PATH = "scalar";
+#endif
+
+	// Each batch function handles whole vectors from `begin` on and returns
+	// where it stopped, the scalar instance then finishes the remainder
+
+	template<typename Ops>
+	static size_t ComposeBatch(const TransformArrays& in, glm::mat4* out, size_t begin, size_t count) {
+		using Vector = typename Ops::Vector;
+		const Vector zero = Ops::Set(0.0f);
+		const Vector one = Ops::Set(1.0f);
+
+		size_t i = begin;
+		for(; i + Ops::Width <= count; i += Ops::Width) {
+			Vector x = Ops::Load(in.RotationX + i);
+			Vector y = Ops::Load(in.RotationY + i);
+			Vector z = Ops::Load(in.RotationZ + i);
+			Vector w = Ops::Load(in.RotationW + i);
+			Vector x2 = Ops::Add(x, x);
+			Vector y2 = Ops::Add(y, y);
+			Vector z2 = Ops::Add(z, z);
+
+			Vector xx = Ops::Mul(x, x2), yy = Ops::Mul(y, y2), zz = Ops::Mul(z, z2);
+			Vector xy = Ops::Mul(x, y2), xz = Ops::Mul(x, z2), yz = Ops::Mul(y, z2);
+			Vector wx = Ops::Mul(w, x2), wy = Ops::Mul(w, y2), wz = Ops::Mul(w, z2);
+
+			Vector scaleX = Ops::Load(in.ScaleX + i);
+			Vector scaleY = Ops::Load(in.ScaleY + i);
+			Vector scaleZ = Ops::Load(in.ScaleZ + i);
+
+			// Rotation columns as in glm::mat3_cast, scaled
+			Vector elements[16];
+			elements[0] = Ops::Mul(Ops::Sub(one, Ops::Add(yy, zz)), scaleX);
+			elements[1] = Ops::Mul(Ops::Add(xy, wz), scaleX);
+			elements[2] = Ops::Mul(Ops::Sub(xz, wy), scaleX);
+			elements[3] = zero;
+			elements[4] = Ops::Mul(Ops::Sub(xy, wz), scaleY);
+			elements[5] = Ops::Mul(Ops::Sub(one, Ops::Add(xx, zz)), scaleY);
+			elements[6] = Ops::Mul(Ops::Add(yz, wx), scaleY);
+			elements[7] = zero;
+			elements[8] = Ops::Mul(Ops::Add(xz, wy), scaleZ);
+			elements[9] = Ops::Mul(Ops::Sub(yz, wx), scaleZ);
+			elements[10] = Ops::Mul(Ops::Sub(one, Ops::Add(xx, yy)), scaleZ);
+			elements[11] = zero;
+			elements[12] = Ops::Load(in.PositionX + i);
+			elements[13] = Ops::Load(in.PositionY + i);
+			elements[14] = Ops::Load(in.PositionZ + i);
+			elements[15] = one;
+
+			Ops::StoreMatrices(elements, out + i);
+		}
+		return i;
+	}
+
+	template<typename Ops>
+	static size_t TransformAabbBatch(const glm::mat4* matrices, const AabbArrays& in, const AabbArrays& out, size_t begin, size_t count) {
+		using Vector = typename Ops::Vector;
+		const Vector half = Ops::Set(0.5f);
+
+		size_t i = begin;
+		for(; i + Ops::Width <= count; i += Ops::Width) {
+			Vector m[16];
+			Ops::LoadMatrices(matrices + i, m);
+
+			Vector minX = Ops::Load(in.MinX + i), maxX = Ops::Load(in.MaxX + i);
+			Vector minY = Ops::Load(in.MinY + i), maxY = Ops::Load(in.MaxY + i);
+			Vector minZ = Ops::Load(in.MinZ + i), maxZ = Ops::Load(in.MaxZ + i);
+			Vector centerX = Ops::Mul(Ops::Add(minX, maxX), half), extentX = Ops::Mul(Ops::Sub(maxX, minX), half);
+			Vector centerY = Ops::Mul(Ops::Add(minY, maxY), half), extentY = Ops::Mul(Ops::Sub(maxY, minY), half);
+			Vector centerZ = Ops::Mul(Ops::Add(minZ, maxZ), half), extentZ = Ops::Mul(Ops::Sub(maxZ, minZ), half);
+
+			// The centre is transformed as a point, the extent by the
+			// absolute values of the linear part
+			auto axis = [&](int row, float* outMin, float* outMax) {
+				Vector center = Ops::MulAdd(m[row], centerX, Ops::MulAdd(m[4 + row], centerY, Ops::MulAdd(m[8 + row], centerZ, m[12 + row])));
+				Vector extent = Ops::MulAdd(Ops::Abs(m[row]), extentX, Ops::MulAdd(Ops::Abs(m[4 + row]), extentY, Ops::Mul(Ops::Abs(m[8 + row]), extentZ)));
+				Ops::Store(outMin + i, Ops::Sub(center, extent));
+				Ops::Store(outMax + i, Ops::Add(center, extent));
+			};
+			axis(0, out.MinX, out.MaxX);
+			axis(1, out.MinY, out.MaxY);
+			axis(2, out.MinZ, out.MaxZ);
+		}
+		return i;
+	}
+
+	void MultiplyMatrices(const glm::mat4& left, const glm::mat4* right, glm::mat4* out, size_t count) {
+		// Copied, `out` may hold `left`
+		const glm::mat4 parent = left;
+		for(size_t i = 0; i < count; i++) WideOps::Multiply(parent, right[i], out[i]);
+	}
+
+	void MultiplyMatrices(const glm::mat4* left, const glm::mat4* right, glm::mat4* out, size_t count) {
+		for(size_t i = 0; i < count; i++) WideOps::Multiply(left[i], right[i], out[i]);
+	}
+
+	void ComposeTransforms(const TransformArrays& transforms, glm::mat4* out, size_t count) {
+		size_t done = ComposeBatch<WideOps>(transforms, out, 0, count);
+		ComposeBatch<ScalarOps>(transforms, out, done, count);
+	}
+
+	void TransformAabbs(const glm::mat4* matrices, const AabbArrays& in, const AabbArrays& out, size_t count) {
+		size_t done = TransformAabbBatch<WideOps>(matrices, in, out, 0, count);
+		TransformAabbBatch<ScalarOps>(matrices, in, out, done, count);
+	}
+
+	const char* GetMathKernelPath() {
+		return KERNEL_PATH;
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+
+namespace Rui {
+	// Batched transform math. Per entity values come in structure of arrays
+	// form, one array of `count` floats per component, so the kernels work on
+	// as many entities at once as a vector register holds. Matrices are glm's
+	// column major mat4.
+	//
+	// Built for the widest instruction set the compiler targets, AVX2, SSE2
+	// or NEON, with a scalar path for the remainder and for RUI_MATH_SCALAR.
+
+	struct TransformArrays {
+		const float* PositionX;
+		const float* PositionY;
+		const float* PositionZ;
+		// Unit quaternions
+		const float* RotationX;
+		const float* RotationY;
+		const float* RotationZ;
+		const float* RotationW;
+		const float* ScaleX;
+		const float* ScaleY;
+		const float* ScaleZ;
+	};
+
+	struct AabbArrays {
+		float* MinX;
+		float* MinY;
+		float* MinZ;
+		float* MaxX;
+		float* MaxY;
+		float* MaxZ;
+	};
+
+	// out[i] = left * right[i]; `out` may be `right`
+	void MultiplyMatrices(const glm::mat4& left, const glm::mat4* right, glm::mat4* out, size_t count);
+	// out[i] = left[i] * right[i]; `out` may be either input
+	void MultiplyMatrices(const glm::mat4* left, const glm::mat4* right, glm::mat4* out, size_t count);
+
+	// out[i] = translate * rotate * scale
+	void ComposeTransforms(const TransformArrays& transforms, glm::mat4* out, size_t count);
+
+	// Axis aligned bounds of the boxes `in` after transforming them by
+	// matrices[i], after Arvo, "Transforming Axis-Aligned Bounding Boxes".
+	// `in` is only read and may be `out`.
+	void TransformAabbs(const glm::mat4* matrices, const AabbArrays& in, const AabbArrays& out, size_t count);
+
+	// "AVX2", "SSE2", "NEON" or "scalar"
+	const char* GetMathKernelPath();
+}
@@ -0,0 +1,111 @@
+#include "PhysicsWorld.h"
+
+#include <chrono>
+
+using namespace physx;
+
+namespace Rui {
+	// PhysX only accepts scratch memory in whole 16 KB blocks
+	static constexpr uint32_t SCRATCH_BLOCK_SIZE = 16 * 1024;
+
+	PhysicsWorld::PhysicsWorld(const PhysicsSettings& settings) {
+		m_Foundation = PxCreateFoundation(PX_PHYSICS_VERSION, m_Allocator, m_ErrorCallback);
+		RUI_CORE_ASSERT(m_Foundation, "Failed to create PhysX foundation!");
+
+		if(settings.ConnectPvd) {
+			m_Pvd = PxCreatePvd(*m_Foundation);
+			m_PvdTransport = PxDefaultPvdSocketTransportCreate("127.0.0.1", 5425, 10);
+			m_Pvd->connect(*m_PvdTransport, PxPvdInstrumentationFlag::eALL);
+		}
+
+		m_Physics = PxCreatePhysics(PX_PHYSICS_VERSION, *m_Foundation, PxTolerancesScale(), true, m_Pvd);
+		m_Cooking = PxCreateCooking(PX_PHYSICS_VERSION, *m_Foundation, PxCookingParams(PxTolerancesScale()));
+
+		m_Dispatcher = PxDefaultCpuDispatcherCreate(settings.WorkerThreads);
+
+		PxSceneDesc sceneDesc(m_Physics->getTolerancesScale());
+		sceneDesc.gravity = settings.Gravity;
+		sceneDesc.cpuDispatcher = m_Dispatcher;
+		sceneDesc.filterShader = PxDefaultSimulationFilterShader;
+		sceneDesc.broadPhaseType = settings.BroadPhase;
+		m_Scene = m_Physics->createScene(sceneDesc);
+
+		if(settings.BroadPhase == PxBroadPhaseType::eMBP) {
+			std::vector<PxBounds3> bounds(settings.MbpSubdivisions * settings.MbpSubdivisions);
+			PxU32 count = PxBroadPhaseExt::createRegionsFromWorldBounds(bounds.data(), settings.WorldBounds, settings.MbpSubdivisions);
+
+			for(PxU32 i = 0; i < count; i++) {
+				PxBroadPhaseRegion region;
+				region.bounds = bounds[i];
+				region.userData = nullptr;
+				m_Scene->addBroadPhaseRegion(region);
+			}
+		}
+
+		if(PxPvdSceneClient* pvdClient = m_Scene->getScenePvdClient()) {
+			pvdClient->setScenePvdFlag(PxPvdSceneFlag::eTRANSMIT_CONSTRAINTS, true);
+			pvdClient->setScenePvdFlag(PxPvdSceneFlag::eTRANSMIT_CONTACTS, true);
+			pvdClient->setScenePvdFlag(PxPvdSceneFlag::eTRANSMIT_SCENEQUERIES, true);
+		}
+
+		m_ScratchBytes = (settings.ScratchBytes + SCRATCH_BLOCK_SIZE - 1) / SCRATCH_BLOCK_SIZE * SCRATCH_BLOCK_SIZE;
+		if(m_ScratchBytes > 0) {
+			m_Scratch = m_Allocator.allocate(m_ScratchBytes, "PhysicsWorld scratch", __FILE__, __LINE__);
+		}
+	}
+
+	PhysicsWorld::~PhysicsWorld() {
+		Collect();
+
+		m_Scene->release();
+		m_Dispatcher->release();
+		m_Cooking->release();
+		m_Physics->release();
+
+		if(m_Pvd) {
+			m_Pvd->release();
+			m_PvdTransport->release();
+		}
+
+		if(m_Scratch) {
+			m_Allocator.deallocate(m_Scratch);
+		}
+
+		m_Foundation->release();
+	}
+
+	void PhysicsWorld::Step(float dt) {
+		Collect();
+
+		m_Scene->simulate(dt, nullptr, m_Scratch, m_ScratchBytes);
+		m_Simulating = true;
+		m_Stats.Steps++;
+	}
+
+	bool PhysicsWorld::TryCollect() {
+		if(!m_Simulating) return true;
+
+		if(!m_Scene->checkResults(false)) return false;
+
+		m_Scene->fetchResults(true);
+		m_Simulating = false;
+		m_Stats.LastWaitMs = 0.0;
+		return true;
+	}
+
+	void PhysicsWorld::Collect() {
+		if(TryCollect()) return;
+
+		auto start = std::chrono::steady_clock::now();
+		m_Scene->fetchResults(true);
+		m_Simulating = false;
+
+		m_Stats.LastWaitMs = std::chrono::duration<double, std::milli>{ std::chrono::steady_clock::now() - start }.count();
+		m_Stats.TotalWaitMs += m_Stats.LastWaitMs;
+		m_Stats.BlockedSteps++;
+	}
+
+	std::unique_ptr<PhysicsWorld> PhysicsWorld::Create(const PhysicsSettings& settings) {
+		return std::make_unique<PhysicsWorld>(settings);
+	}
+}
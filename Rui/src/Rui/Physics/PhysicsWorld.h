@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Rui/Core/Core.h"
+#include "Rui/Core/Log.h"
+
+#include <PxPhysicsAPI.h>
+
+namespace Rui {
+	struct PhysicsSettings {
+		physx::PxVec3 Gravity = physx::PxVec3(0.0f, -9.81f, 0.0f);
+		uint32_t WorkerThreads = 2;
+		// Handed to every simulate() so PhysX does not allocate while
+		// stepping. Rounded up to a multiple of 16 KB.
+		uint32_t ScratchBytes = 256 * 1024;
+		physx::PxBroadPhaseType::Enum BroadPhase = physx::PxBroadPhaseType::eSAP;
+		// Only used by eMBP, which needs the world split into regions up
+		// front: WorldBounds is cut into a grid of MbpSubdivisions squared
+		// regions along the ground plane
+		physx::PxBounds3 WorldBounds = physx::PxBounds3(physx::PxVec3(-512.0f), physx::PxVec3(512.0f));
+		uint32_t MbpSubdivisions = 4;
+		// PhysX Visual Debugger on localhost, if one is listening
+		bool ConnectPvd = false;
+	};
+
+	struct PhysicsStats {
+		uint64_t Steps = 0;
+		// Steps that were still running when their results were needed
+		uint64_t BlockedSteps = 0;
+		double LastWaitMs = 0.0;
+		double TotalWaitMs = 0.0;
+	};
+
+	// Owns the PhysX foundation, physics and scene, and steps the scene split
+	// phase: a step is started at the end of a fixed update and collected at
+	// the start of the next one, so PhysX works on its own threads while the
+	// main thread renders.
+	//
+	// Actors may only be read or written while no step is running, i.e.
+	// between Collect and Step. Main thread only.
+	class PhysicsWorld {
+	public:
+		explicit PhysicsWorld(const PhysicsSettings& settings = {});
+		// Waits for a step still running
+		~PhysicsWorld();
+
+		PhysicsWorld(const PhysicsWorld&) = delete;
+		PhysicsWorld& operator=(const PhysicsWorld&) = delete;
+
+		// Starts simulating `dt` seconds, collecting a step still running first
+		void Step(float dt);
+		// Collects the running step if it finished, never blocks. Returns true
+		// when no step is running anymore.
+		bool TryCollect();
+		// Collects the running step, blocking until it finished
+		void Collect();
+
+		inline bool IsSimulating() const { return m_Simulating; }
+
+		inline physx::PxPhysics& GetPhysics() { return *m_Physics; }
+		inline physx::PxCooking& GetCooking() { return *m_Cooking; }
+		inline physx::PxScene& GetScene() { return *m_Scene; }
+		inline const PhysicsStats& GetStats() const { return m_Stats; }
+
+		static std::unique_ptr<PhysicsWorld> Create(const PhysicsSettings& settings = {});
+	private:
+		physx::PxDefaultAllocator m_Allocator;
+		physx::PxDefaultErrorCallback m_ErrorCallback;
+
+		physx::PxFoundation* m_Foundation = nullptr;
+		physx::PxPvd* m_Pvd = nullptr;
+		physx::PxPvdTransport* m_PvdTransport = nullptr;
+		physx::PxPhysics* m_Physics = nullptr;
+		physx::PxCooking* m_Cooking = nullptr;
+		physx::PxDefaultCpuDispatcher* m_Dispatcher = nullptr;
+		physx::PxScene* m_Scene = nullptr;
+
+		// 16 byte aligned, from m_Allocator
+		void* m_Scratch = nullptr;
+		uint32_t m_ScratchBytes = 0;
+
+		bool m_Simulating = false;
+		PhysicsStats m_Stats;
+	};
+}
@@ -0,0 +1,67 @@
+#include "ConePrepass.h"
+
+#include "Rui/Core/Application.h"
+
+namespace Rui {
+    ConePrepass::ConePrepass(vk::Extent2D extent, vk::RenderPass renderPass, vk::PipelineLayout layout)
+        : m_Extent(GetTileExtent(extent)) {
+        CreateSampler();
+        CreatePipeline(renderPass, layout);
+    }
+
+    ConePrepass::~ConePrepass() {
+        RenderSystem::GetDevice().GetDevice().destroySampler(m_Sampler, nullptr);
+    }
+
+    void ConePrepass::Record(vk::CommandBuffer commandBuffer, vk::Extent2D renderExtent) {
+        vk::Extent2D tiles = GetTileExtent(renderExtent);
+        tiles.width  = std::min(m_Extent.width,  tiles.width);
+        tiles.height = std::min(m_Extent.height, tiles.height);
+
+        vk::Viewport viewport(0.0f, 0.0f, static_cast<float>(tiles.width), static_cast<float>(tiles.height), 0.0f, 1.0f);
+        vk::Rect2D scissor(vk::Offset2D(0, 0), tiles);
+        commandBuffer.setViewport(0, 1, &viewport);
+        commandBuffer.setScissor(0, 1, &scissor);
+
+        m_Pipeline->Bind(commandBuffer);
+        commandBuffer.drawIndexed(static_cast<uint32_t>(RenderSystem::GetData().indices.size()), 1, 0, 0, 0);
+    }
+
+    vk::Extent2D ConePrepass::GetTileExtent(vk::Extent2D extent) {
+        return vk::Extent2D((extent.width + TILE_SIZE - 1) / TILE_SIZE, (extent.height + TILE_SIZE - 1) / TILE_SIZE);
+    }
+
+    void ConePrepass::CreateSampler() {
+        vk::SamplerCreateInfo samplerInfo;
+        samplerInfo.magFilter = vk::Filter::eNearest;
+        samplerInfo.minFilter = vk::Filter::eNearest;
+        samplerInfo.mipmapMode = vk::SamplerMipmapMode::eNearest;
+        samplerInfo.addressModeU = vk::SamplerAddressMode::eClampToEdge;
+        samplerInfo.addressModeV = vk::SamplerAddressMode::eClampToEdge;
+        samplerInfo.addressModeW = vk::SamplerAddressMode::eClampToEdge;
+        samplerInfo.maxLod = 0.0f;
+
+        if(RenderSystem::GetDevice().GetDevice().createSampler(&samplerInfo, nullptr, &m_Sampler) != vk::Result::eSuccess) {
+            RUI_CORE_ERROR("Failed to create cone prepass sampler!");
+        }
+    }
+
+    void ConePrepass::CreatePipeline(vk::RenderPass renderPass, vk::PipelineLayout layout) {
+        std::unique_ptr<PipelineConfigInfo> pipelineConfig(Pipeline::DefaultPipelineConfigInfo(m_Extent.width, m_Extent.height));
+
+        // R32 float attachments are not blendable on most devices
+        pipelineConfig->colorBlendAttachment.blendEnable = false;
+        pipelineConfig->depthStencilInfo.depthTestEnable = false;
+        pipelineConfig->depthStencilInfo.depthWriteEnable = false;
+        pipelineConfig->dynamicStates = { vk::DynamicState::eViewport, vk::DynamicState::eScissor };
+
+        pipelineConfig->renderPass = renderPass;
+        pipelineConfig->pipelineLayout = layout;
+
+        m_Pipeline = std::make_unique<Pipeline>("res/shaders/shader.vert.spv", "res/shaders/shader_shapes_cone.frag.spv", pipelineConfig.get());
+    }
+
+    std::unique_ptr<ConePrepass> ConePrepass::Create(vk::Extent2D extent, vk::RenderPass renderPass, vk::PipelineLayout layout) {
+        return std::make_unique<ConePrepass>(extent, renderPass, layout);
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Pipeline.h"
+
+namespace Rui {
+    // Low resolution pass that cone marches the raymarched scene once per
+    // TILE_SIZE x TILE_SIZE tile and stores a safe starting distance for
+    // every full resolution ray of that tile (see shader_shapes_cone.frag).
+    class ConePrepass {
+    public:
+        static constexpr uint32_t TILE_SIZE = 8;
+        static constexpr vk::Format FORMAT = vk::Format::eR32Sfloat;
+
+        // `extent` is the full resolution the tiles cover; `renderPass` is the
+        // render graph pass writing the tile image
+        ConePrepass(vk::Extent2D extent, vk::RenderPass renderPass, vk::PipelineLayout layout);
+        ~ConePrepass();
+
+        ConePrepass(const ConePrepass&) = delete;
+        ConePrepass& operator=(const ConePrepass&) = delete;
+
+        // Recorded inside the pass. Expects the quad buffers, descriptor set
+        // and push constants of the full pass to be bound already; they are
+        // shared with this pass.
+        void Record(vk::CommandBuffer commandBuffer, vk::Extent2D renderExtent);
+
+        // Tiles covering `extent`, the size of the tile image for the full extent
+        static vk::Extent2D GetTileExtent(vk::Extent2D extent);
+
+        inline vk::Sampler GetSampler() const { return m_Sampler; }
+        inline vk::Extent2D GetExtent() const { return m_Extent; }
+
+        static std::unique_ptr<ConePrepass> Create(vk::Extent2D extent, vk::RenderPass renderPass, vk::PipelineLayout layout);
+    private:
+        void CreateSampler();
+        void CreatePipeline(vk::RenderPass renderPass, vk::PipelineLayout layout);
+
+        vk::Extent2D m_Extent;
+
+        std::unique_ptr<Pipeline> m_Pipeline;
+        vk::Sampler m_Sampler;
+    };
+}
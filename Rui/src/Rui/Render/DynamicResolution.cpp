@@ -0,0 +1,68 @@
+#include "DynamicResolution.h"
+
+namespace Rui {
+    // Exponential smoothing of the measured frame time
+    static constexpr double SMOOTHING = 0.15;
+    // Ignore corrections smaller than this to avoid shimmering between scales
+    static constexpr float HYSTERESIS = 0.02f;
+    // Largest scale change per adjustment; downscaling may react faster
+    static constexpr float MAX_STEP_UP = 0.05f;
+    static constexpr float MAX_STEP_DOWN = 0.15f;
+    // Frames to wait after a change so its effect shows up in the timings
+    static constexpr uint32_t COOLDOWN_FRAMES = 4;
+
+    DynamicResolution::DynamicResolution(const DynamicResolutionSettings& settings) {
+        SetSettings(settings);
+    }
+
+    void DynamicResolution::SetSettings(const DynamicResolutionSettings& settings) {
+        m_Settings = settings;
+        m_Settings.MinScale = std::max(0.1f, m_Settings.MinScale);
+        m_Settings.MaxScale = std::max(m_Settings.MinScale, m_Settings.MaxScale);
+
+        m_Scale = m_Settings.Enabled ? std::clamp(m_Scale, m_Settings.MinScale, m_Settings.MaxScale) : 1.0f;
+        m_SmoothedMs = 0.0;
+        m_Cooldown = 0;
+    }
+
+    void DynamicResolution::Update(double gpuFrameMs) {
+        if(!m_Settings.Enabled || gpuFrameMs <= 0.0) return;
+
+        m_SmoothedMs = m_SmoothedMs == 0.0 ? gpuFrameMs : m_SmoothedMs + (gpuFrameMs - m_SmoothedMs) * SMOOTHING;
+
+        if(m_Cooldown > 0) {
+            m_Cooldown--;
+            return;
+        }
+
+        double target = m_Settings.FrameBudgetMs * m_Settings.TargetUtilization;
+        float desired = m_Scale * static_cast<float>(std::sqrt(target / m_SmoothedMs));
+        desired = std::clamp(desired, m_Settings.MinScale, m_Settings.MaxScale);
+
+        float delta = desired - m_Scale;
+        if(std::abs(delta) < HYSTERESIS) return;
+
+        m_Scale += std::clamp(delta, -MAX_STEP_DOWN, MAX_STEP_UP);
+        m_Cooldown = COOLDOWN_FRAMES;
+    }
+
+    vk::Extent2D DynamicResolution::GetRenderExtent(vk::Extent2D outputExtent) const {
+        float scale = m_Settings.Enabled ? m_Scale : 1.0f;
+        vk::Extent2D target = GetTargetExtent(outputExtent);
+
+        return {
+            std::clamp(static_cast<uint32_t>(outputExtent.width * scale + 0.5f), 1u, target.width),
+            std::clamp(static_cast<uint32_t>(outputExtent.height * scale + 0.5f), 1u, target.height)
+        };
+    }
+
+    vk::Extent2D DynamicResolution::GetTargetExtent(vk::Extent2D outputExtent) const {
+        // Independent of Enabled so toggling the controller never reallocates
+        float scale = std::max(m_Settings.MaxScale, 1.0f);
+
+        return {
+            std::max(1u, static_cast<uint32_t>(std::ceil(outputExtent.width * scale))),
+            std::max(1u, static_cast<uint32_t>(std::ceil(outputExtent.height * scale)))
+        };
+    }
+}
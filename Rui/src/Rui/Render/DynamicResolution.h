@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Rui/Core/Core.h"
+
+#include <vulkan/vulkan.hpp>
+
+namespace Rui {
+    struct DynamicResolutionSettings {
+        bool Enabled = true;
+        float MinScale = 0.5f;
+        float MaxScale = 1.0f;
+        // GPU time budget for a frame, in milliseconds
+        double FrameBudgetMs = 1000.0 / 60.0;
+        // Fraction of the budget the controller aims for, leaving room for spikes
+        double TargetUtilization = 0.9;
+    };
+
+    // Picks the per-axis render scale from measured GPU frame times. Cost is
+    // assumed to be proportional to the pixel count, i.e. to scale squared.
+    class DynamicResolution {
+    public:
+        DynamicResolution() = default;
+        explicit DynamicResolution(const DynamicResolutionSettings& settings);
+
+        void SetSettings(const DynamicResolutionSettings& settings);
+        inline const DynamicResolutionSettings& GetSettings() const { return m_Settings; }
+
+        // Feed the GPU time of a completed frame rendered at the current scale
+        void Update(double gpuFrameMs);
+
+        inline float GetScale() const { return m_Scale; }
+        inline double GetSmoothedFrameMs() const { return m_SmoothedMs; }
+
+        // Render extent for a given output extent at the current scale
+        vk::Extent2D GetRenderExtent(vk::Extent2D outputExtent) const;
+        // Extent the intermediate target must be allocated with
+        vk::Extent2D GetTargetExtent(vk::Extent2D outputExtent) const;
+    private:
+        DynamicResolutionSettings m_Settings;
+
+        float m_Scale = 1.0f;
+        double m_SmoothedMs = 0.0;
+        uint32_t m_Cooldown = 0;
+    };
+}
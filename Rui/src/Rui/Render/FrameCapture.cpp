@@ -0,0 +1,258 @@
+#include "FrameCapture.h"
+
+#include "ImageWriter.h"
+#include "RenderSystem.h"
+
+#include <filesystem>
+#include <iomanip>
+#include <sstream>
+
+namespace Rui {
+    struct FrameCapture::Session {
+        CaptureSettings Settings;
+        std::string Prefix;
+
+        // Frame thread only
+        uint32_t Frames = 0;
+        uint32_t Taken = 0;
+        uint32_t Dropped = 0;
+
+        std::atomic<uint32_t> Written{ 0 };
+
+        // Y4M frames are converted and appended one at a time, in sequence
+        Y4mWriter Stream;
+        bool StreamFailed = false;
+        uint32_t NextSequence = 1;
+        std::mutex Mutex;
+        std::condition_variable Turn;
+
+        // Once the last frame taken is written, on whichever thread wrote it
+        ~Session() {
+            RUI_CORE_INFO("Capture finished: {0} frames written to {1}", Written.load(), Settings.Path);
+        }
+    };
+
+    FrameCapture::FrameCapture(uint32_t bufferCount) {
+        m_Slots.resize(bufferCount);
+        for(auto& slot : m_Slots) slot = std::make_unique<Slot>();
+
+        // PNG frames are compressed in parallel, a 1080p one takes longer than a frame
+        uint32_t threads = std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u);
+        m_Writers = std::make_unique<ThreadPool>(threads);
+    }
+
+    FrameCapture::~FrameCapture() {
+        Stop();
+        Update();
+        // Runs the queued writes first
+        m_Writers.reset();
+
+        for(auto& slot : m_Slots) {
+            if(slot->Buffer) ResourceManager::Destroy(slot->Buffer);
+        }
+    }
+
+    void FrameCapture::Start(const CaptureSettings& settings) {
+        Stop();
+
+        if(!RenderSystem::GetSwapChain().IsReadable()) {
+            RUI_CORE_ERROR("Frame capture needs swapchain images that can be copied from!");
+            return;
+        }
+
+        auto session = std::make_shared<Session>();
+        session->Settings = settings;
+        session->Settings.Interval = std::max(settings.Interval, 1u);
+
+        std::filesystem::path path(settings.Path);
+        std::error_code error;
+        if(path.has_parent_path()) std::filesystem::create_directories(path.parent_path(), error);
+        if(settings.Format == CaptureFormat::Png && path.extension() == ".png") path.replace_extension();
+        session->Prefix = path.string();
+
+        RUI_CORE_INFO("Capturing frames to {0}", settings.Path);
+        m_Session = std::move(session);
+    }
+
+    void FrameCapture::Stop() {
+        if(!m_Session) return;
+
+        RUI_CORE_INFO("Capture stopped: {0} frames taken, {1} dropped", m_Session->Taken, m_Session->Dropped);
+        m_Session.reset();
+    }
+
+    void FrameCapture::Update() {
+        QueueTimeline& timeline = RenderSystem::GetDevice().GetGraphicsTimeline();
+
+        while(!m_InFlight.empty() && timeline.IsComplete(m_InFlight.front()->Value)) {
+            Slot* slot = m_InFlight.front();
+            m_InFlight.pop_front();
+
+            slot->State.store(SlotState::Writing, std::memory_order_relaxed);
+            m_Writers->Submit([this, slot] { Write(*slot); });
+        }
+    }
+
+    void FrameCapture::Record(vk::CommandBuffer commandBuffer, vk::Image image, vk::Extent2D extent, vk::Format format) {
+        if(!m_Session) return;
+
+        Session& session = *m_Session;
+        if(session.Frames++ % session.Settings.Interval != 0) return;
+
+        bool bgra;
+        switch(format) {
+            case vk::Format::eB8G8R8A8Unorm:
+            case vk::Format::eB8G8R8A8Srgb:
+                bgra = true;
+                break;
+            case vk::Format::eR8G8B8A8Unorm:
+            case vk::Format::eR8G8B8A8Srgb:
+                bgra = false;
+                break;
+            default:
+                RUI_CORE_ERROR("Frame capture does not support swapchain format {0}!", vk::to_string(format));
+                Stop();
+                return;
+        }
+
+        Slot* slot = nullptr;
+        for(auto& candidate : m_Slots) {
+            if(candidate->State.load(std::memory_order_acquire) == SlotState::Free) {
+                slot = candidate.get();
+                break;
+            }
+        }
+        if(!slot) {
+            session.Dropped++;
+            m_Dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        vk::DeviceSize size = vk::DeviceSize(extent.width) * extent.height * 4;
+        if(slot->Capacity < size) {
+            if(slot->Buffer) ResourceManager::Destroy(slot->Buffer);
+            slot->Capacity = 0;
+            slot->Mapped = nullptr;
+
+            // Read back on the CPU, which is far faster from cached memory
+            BufferDesc desc;
+            desc.Size = size;
+            desc.Usage = vk::BufferUsageFlagBits::eTransferDst;
+            desc.MemoryProperties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent | vk::MemoryPropertyFlagBits::eHostCached;
+            desc.Category = MemoryCategory::Staging;
+            desc.Mapped = true;
+
+            slot->Buffer = ResourceManager::CreateBuffer(desc);
+            if(!slot->Buffer) {
+                desc.MemoryProperties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+                slot->Buffer = ResourceManager::CreateBuffer(desc);
+            }
+            if(!slot->Buffer) {
+                RUI_CORE_ERROR("Failed to create frame capture buffer!");
+                Stop();
+                return;
+            }
+
+            slot->Capacity = size;
+            slot->Mapped = ResourceManager::Get(slot->Buffer)->Mapped;
+        }
+
+        // The graph's final barrier waits for nothing after it, so nothing can
+        // chain onto it; this one waits on all earlier work and its writes
+        vk::ImageMemoryBarrier barrier;
+        barrier.oldLayout = vk::ImageLayout::ePresentSrcKHR;
+        barrier.newLayout = vk::ImageLayout::eTransferSrcOptimal;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange = vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1);
+        barrier.srcAccessMask = vk::AccessFlagBits::eMemoryWrite;
+        barrier.dstAccessMask = vk::AccessFlagBits::eTransferRead;
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands, vk::PipelineStageFlagBits::eTransfer, {}, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        vk::BufferImageCopy region;
+        region.imageSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1);
+        region.imageExtent = vk::Extent3D(extent.width, extent.height, 1);
+        commandBuffer.copyImageToBuffer(image, vk::ImageLayout::eTransferSrcOptimal, ResourceManager::Get(slot->Buffer)->Buffer, 1, &region);
+
+        // Presentation waits on the submission's semaphore, which covers the copy
+        barrier.oldLayout = vk::ImageLayout::eTransferSrcOptimal;
+        barrier.newLayout = vk::ImageLayout::ePresentSrcKHR;
+        barrier.srcAccessMask = {};
+        barrier.dstAccessMask = {};
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe, {}, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        vk::BufferMemoryBarrier readback;
+        readback.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+        readback.dstAccessMask = vk::AccessFlagBits::eHostRead;
+        readback.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        readback.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        readback.buffer = ResourceManager::Get(slot->Buffer)->Buffer;
+        readback.offset = 0;
+        readback.size = size;
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eHost, {}, 0, nullptr, 1, &readback, 0, nullptr);
+
+        slot->Extent = extent;
+        slot->Bgra = bgra;
+        slot->Sequence = ++session.Taken;
+        slot->Owner = m_Session;
+        slot->State.store(SlotState::InFlight, std::memory_order_relaxed);
+        m_Recorded.push_back(slot);
+
+        if(session.Settings.FrameCount > 0 && session.Taken >= session.Settings.FrameCount) Stop();
+    }
+
+    void FrameCapture::Submitted(uint64_t value) {
+        for(Slot* slot : m_Recorded) {
+            slot->Value = value;
+            m_InFlight.push_back(slot);
+        }
+        m_Recorded.clear();
+    }
+
+    void FrameCapture::Write(Slot& slot) {
+        Session& session = *slot.Owner;
+        const uint8_t* pixels = reinterpret_cast<const uint8_t*>(slot.Mapped);
+        const size_t rowPitch = size_t(slot.Extent.width) * 4;
+
+        bool written = false;
+        if(session.Settings.Format == CaptureFormat::Png) {
+            std::ostringstream path;
+            path << session.Prefix << '_' << std::setw(6) << std::setfill('0') << slot.Sequence << ".png";
+
+            written = WritePng(path.str(), pixels, slot.Extent.width, slot.Extent.height, rowPitch, slot.Bgra);
+            if(!written) RUI_CORE_ERROR("Failed to write {0}!", path.str());
+        } else {
+            // Workers take jobs in submission order, so the frame whose turn
+            // it is was taken by a worker already and waiting never deadlocks
+            std::unique_lock<std::mutex> lock(session.Mutex);
+            session.Turn.wait(lock, [&] { return session.NextSequence == slot.Sequence; });
+
+            if(!session.Stream.IsOpen() && !session.StreamFailed) {
+                session.StreamFailed = !session.Stream.Open(session.Settings.Path, slot.Extent.width, slot.Extent.height, session.Settings.FrameRate);
+                if(session.StreamFailed) RUI_CORE_ERROR("Failed to open {0}!", session.Settings.Path);
+            }
+
+            if(session.Stream.IsOpen()) {
+                if(slot.Extent.width != session.Stream.GetWidth() || slot.Extent.height != session.Stream.GetHeight()) {
+                    RUI_CORE_WARN("Skipping captured frame {0}: the stream is {1}x{2}", slot.Sequence, session.Stream.GetWidth(), session.Stream.GetHeight());
+                } else {
+                    written = session.Stream.WriteFrame(pixels, rowPitch, slot.Bgra);
+                    if(!written) RUI_CORE_ERROR("Failed to write to {0}!", session.Settings.Path);
+                }
+            }
+
+            session.NextSequence++;
+            lock.unlock();
+            session.Turn.notify_all();
+        }
+
+        if(written) {
+            session.Written.fetch_add(1, std::memory_order_relaxed);
+            m_Written.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        slot.Owner.reset();
+        slot.State.store(SlotState::Free, std::memory_order_release);
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "ResourceManager.h"
+#include "Rui/Core/SwapChain.h"
+#include "Rui/Core/ThreadPool.h"
+
+#include <atomic>
+#include <deque>
+
+namespace Rui {
+    enum class CaptureFormat {
+        // One file per frame, Path_000001.png and on; a .png extension of
+        // Path is dropped
+        Png,
+        // A single YUV4MPEG2 stream at Path, of frames the size of the first
+        Y4m
+    };
+
+    struct CaptureSettings {
+        CaptureFormat Format = CaptureFormat::Png;
+        std::string Path;
+        // 0 captures until Stop()
+        uint32_t FrameCount = 0;
+        // Every Interval-th frame
+        uint32_t Interval = 1;
+        // Of the Y4M stream
+        uint32_t FrameRate = 60;
+    };
+
+    // Copies presented frames into a ring of host visible buffers and writes
+    // them out on worker threads. A buffer is handed to the writers once the
+    // graphics timeline shows its copy finished, some frames later, so the
+    // GPU pays for a copy and the frame thread for recording it; neither
+    // waits. Frames arriving while every buffer is still in flight or being
+    // written are dropped and counted.
+    class FrameCapture {
+    public:
+        explicit FrameCapture(uint32_t bufferCount = SwapChain::MAX_FRAMES_IN_FLIGHT + 2);
+        // Expects the device idle; writes the frames still in flight
+        ~FrameCapture();
+
+        FrameCapture(const FrameCapture&) = delete;
+        FrameCapture& operator=(const FrameCapture&) = delete;
+
+        // Stops a running capture first. Frames already taken by it are
+        // still written.
+        void Start(const CaptureSettings& settings);
+        void Stop();
+        inline bool IsCapturing() const { return m_Session != nullptr; }
+
+        // Once per frame: hands the copies the GPU finished to the writers
+        void Update();
+        // After the last pass of the frame. `image` is in ePresentSrcKHR and
+        // left in it; BGRA and RGBA 8 bit formats only.
+        void Record(vk::CommandBuffer commandBuffer, vk::Image image, vk::Extent2D extent, vk::Format format);
+        // Once the frame is submitted, with the graphics timeline value the
+        // submission signals
+        void Submitted(uint64_t value);
+
+        inline uint32_t GetWrittenCount() const { return m_Written.load(std::memory_order_relaxed); }
+        inline uint32_t GetDroppedCount() const { return m_Dropped.load(std::memory_order_relaxed); }
+    private:
+        struct Session;
+
+        enum class SlotState : uint8_t {
+            Free,
+            InFlight,
+            // Owned by a writer, which frees it
+            Writing
+        };
+
+        struct Slot {
+            BufferHandle Buffer;
+            vk::DeviceSize Capacity = 0;
+            const std::byte* Mapped = nullptr;
+
+            vk::Extent2D Extent;
+            bool Bgra = false;
+            // Graphics timeline value of the frame's submission
+            uint64_t Value = 0;
+            // Of the session, from 1
+            uint32_t Sequence = 0;
+            std::shared_ptr<Session> Owner;
+
+            std::atomic<SlotState> State{ SlotState::Free };
+        };
+
+        void Write(Slot& slot);
+
+        std::vector<std::unique_ptr<Slot>> m_Slots;
+        // Recorded into the frame not submitted yet
+        std::vector<Slot*> m_Recorded;
+        // In recording order, which is timeline order
+        std::deque<Slot*> m_InFlight;
+
+        std::shared_ptr<Session> m_Session;
+        std::unique_ptr<ThreadPool> m_Writers;
+
+        std::atomic<uint32_t> m_Written{ 0 };
+        std::atomic<uint32_t> m_Dropped{ 0 };
+    };
+}
@@ -0,0 +1,61 @@
+#include "GpuTimer.h"
+
+#include "Rui/Core/Application.h"
+
+namespace Rui {
+    GpuTimer::GpuTimer(uint32_t slotCount, uint32_t timestampCount)
+        : m_SlotCount(slotCount), m_TimestampCount(timestampCount), m_Written(slotCount, false), m_Results(timestampCount) {
+        Device& device = RenderSystem::GetDevice();
+
+        m_Period = device.GetTimestampPeriod();
+        m_Supported = device.SupportsTimestamps();
+
+        vk::QueryPoolCreateInfo poolInfo;
+        poolInfo.queryType = vk::QueryType::eTimestamp;
+        poolInfo.queryCount = slotCount * timestampCount;
+
+        if(device.GetDevice().createQueryPool(&poolInfo, nullptr, &m_QueryPool) != vk::Result::eSuccess) {
+            RUI_CORE_ERROR("Failed to create timestamp query pool!");
+            m_Supported = false;
+        }
+    }
+
+    GpuTimer::~GpuTimer() {
+        RenderSystem::GetDevice().GetDevice().destroyQueryPool(m_QueryPool, nullptr);
+    }
+
+    void GpuTimer::Reset(vk::CommandBuffer commandBuffer, uint32_t slot) {
+        if(!m_Supported) return;
+
+        commandBuffer.resetQueryPool(m_QueryPool, slot * m_TimestampCount, m_TimestampCount);
+        m_Written[slot] = true;
+    }
+
+    void GpuTimer::Timestamp(vk::CommandBuffer commandBuffer, uint32_t slot, uint32_t index, vk::PipelineStageFlagBits stage) {
+        if(!m_Supported) return;
+
+        commandBuffer.writeTimestamp(stage, m_QueryPool, slot * m_TimestampCount + index);
+    }
+
+    bool GpuTimer::Resolve(uint32_t slot, std::vector<double>& intervals) {
+        if(!m_Supported || !m_Written[slot]) return false;
+
+        auto result = RenderSystem::GetDevice().GetDevice().getQueryPoolResults(
+            m_QueryPool,
+            slot * m_TimestampCount,
+            m_TimestampCount,
+            m_Results.size() * sizeof(uint64_t),
+            m_Results.data(),
+            sizeof(uint64_t),
+            vk::QueryResultFlagBits::e64);
+
+        if(result != vk::Result::eSuccess) return false;
+
+        intervals.resize(m_TimestampCount - 1);
+        for(uint32_t i = 0; i + 1 < m_TimestampCount; i++) {
+            intervals[i] = static_cast<double>(m_Results[i + 1] - m_Results[i]) * m_Period / 1000000.0;
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Rui/Core/Device.h"
+
+namespace Rui {
+    // Timestamp queries for a fixed number of frame slots. Each slot holds
+    // `timestampCount` timestamps; results are read back once the frame that
+    // wrote them has been waited on, so Resolve never stalls.
+    class GpuTimer {
+    public:
+        GpuTimer(uint32_t slotCount, uint32_t timestampCount);
+        ~GpuTimer();
+
+        GpuTimer(const GpuTimer&) = delete;
+        GpuTimer& operator=(const GpuTimer&) = delete;
+
+        // Must be recorded outside of a render pass
+        void Reset(vk::CommandBuffer commandBuffer, uint32_t slot);
+        void Timestamp(vk::CommandBuffer commandBuffer, uint32_t slot, uint32_t index, vk::PipelineStageFlagBits stage = vk::PipelineStageFlagBits::eBottomOfPipe);
+
+        // Milliseconds between timestamp `index` and `index + 1` of the slot.
+        // Returns false if the slot has no complete results yet.
+        bool Resolve(uint32_t slot, std::vector<double>& intervals);
+
+        inline bool IsSupported() const { return m_Supported; }
+    private:
+        vk::QueryPool m_QueryPool;
+
+        uint32_t m_SlotCount;
+        uint32_t m_TimestampCount;
+        double m_Period;
+        bool m_Supported;
+
+        std::vector<bool> m_Written;
+        std::vector<uint64_t> m_Results;
+    };
+}
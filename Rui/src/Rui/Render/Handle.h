@@ -0,0 +1,100 @@
+#pragma once
+
+#include "Rui/Core/Core.h"
+
+namespace Rui {
+    // Index into a HandlePool plus the generation of the slot it was issued
+    // for. Once the object is destroyed the slot's generation moves on, so
+    // stale handles resolve to nothing instead of to whatever reuses the slot.
+    template<typename T>
+    class Handle {
+    public:
+        Handle() = default;
+
+        inline bool IsValid() const { return m_Generation != 0; }
+        inline explicit operator bool() const { return IsValid(); }
+
+        inline uint32_t GetIndex() const { return m_Index; }
+        inline uint32_t GetGeneration() const { return m_Generation; }
+
+        inline bool operator==(const Handle& other) const { return m_Index == other.m_Index && m_Generation == other.m_Generation; }
+        inline bool operator!=(const Handle& other) const { return !(*this == other); }
+    private:
+        Handle(uint32_t index, uint32_t generation) : m_Index(index), m_Generation(generation) {}
+
+        uint32_t m_Index = 0;
+        uint32_t m_Generation = 0;
+
+        template<typename> friend class HandlePool;
+    };
+
+    // Objects live contiguously in slots that are recycled through a free
+    // list; a lookup is one bounds check, one generation compare and one
+    // indexed load.
+    template<typename T>
+    class HandlePool {
+    public:
+        template<typename ... Args>
+        Handle<T> Create(Args&& ... args) {
+            uint32_t index;
+            if(!m_Free.empty()) {
+                index = m_Free.back();
+                m_Free.pop_back();
+                m_Objects[index] = T{ std::forward<Args>(args)... };
+            } else {
+                index = static_cast<uint32_t>(m_Objects.size());
+                m_Objects.push_back(T{ std::forward<Args>(args)... });
+                m_Generations.push_back(1);
+            }
+
+            m_Count++;
+            return Handle<T>(index, m_Generations[index]);
+        }
+
+        inline T* Get(Handle<T> handle) {
+            return IsValid(handle) ? &m_Objects[handle.m_Index] : nullptr;
+        }
+
+        inline const T* Get(Handle<T> handle) const {
+            return IsValid(handle) ? &m_Objects[handle.m_Index] : nullptr;
+        }
+
+        inline bool IsValid(Handle<T> handle) const {
+            return handle.m_Generation != 0 && handle.m_Index < m_Generations.size() && m_Generations[handle.m_Index] == handle.m_Generation;
+        }
+
+        // Moves the object out and frees its slot. Returns false for stale handles.
+        bool Release(Handle<T> handle, T& object) {
+            if(!IsValid(handle)) return false;
+
+            object = std::move(m_Objects[handle.m_Index]);
+            m_Objects[handle.m_Index] = T{};
+
+            // Generation 0 marks the null handle, skip it on wrap around
+            uint32_t& generation = m_Generations[handle.m_Index];
+            generation = generation == UINT32_MAX ? 1 : generation + 1;
+
+            m_Free.push_back(handle.m_Index);
+            m_Count--;
+            return true;
+        }
+
+        // Visits every live object as (Handle<T>, T&)
+        template<typename F>
+        void ForEach(F&& function) {
+            std::vector<bool> free(m_Objects.size(), false);
+            for(uint32_t index : m_Free) free[index] = true;
+
+            for(uint32_t index = 0; index < m_Objects.size(); index++) {
+                if(!free[index]) function(Handle<T>(index, m_Generations[index]), m_Objects[index]);
+            }
+        }
+
+        inline size_t GetCount() const { return m_Count; }
+    private:
+        std::vector<T> m_Objects;
+        std::vector<uint32_t> m_Generations;
+        std::vector<uint32_t> m_Free;
+        size_t m_Count = 0;
+    };
+}
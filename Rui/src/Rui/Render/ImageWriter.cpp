@@ -0,0 +1,338 @@
+#include "ImageWriter.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace Rui {
+    namespace {
+        uint32_t Crc32(uint32_t crc, const uint8_t* data, size_t size) {
+            static const std::array<uint32_t, 256> table = [] {
+                std::array<uint32_t, 256> table{};
+                for(uint32_t i = 0; i < 256; i++) {
+                    uint32_t c = i;
+                    for(int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                    table[i] = c;
+                }
+                return table;
+            }();
+
+            crc = ~crc;
+            for(size_t i = 0; i < size; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+            return ~crc;
+        }
+
+        uint32_t Adler32(const uint8_t* data, size_t size) {
+            uint32_t a = 1, b = 0;
+            while(size > 0) {
+                // Largest run before the sums can overflow
+                size_t run = std::min<size_t>(size, 5552);
+                for(size_t i = 0; i < run; i++) {
+                    a += data[i];
+                    b += a;
+                }
+                a %= 65521;
+                b %= 65521;
+                data += run;
+                size -= run;
+            }
+            return (b << 16) | a;
+        }
+
+        void PutU32(std::vector<uint8_t>& out, uint32_t value) {
+            out.push_back(static_cast<uint8_t>(value >> 24));
+            out.push_back(static_cast<uint8_t>(value >> 16));
+            out.push_back(static_cast<uint8_t>(value >> 8));
+            out.push_back(static_cast<uint8_t>(value));
+        }
+
+        class BitWriter {
+        public:
+            explicit BitWriter(std::vector<uint8_t>& out) : m_Out(out) {}
+
+            // Least significant bit first, as deflate packs everything but
+            // Huffman codes
+            inline void Write(uint32_t bits, uint32_t count) {
+                m_Bits |= static_cast<uint64_t>(bits) << m_Count;
+                m_Count += count;
+                while(m_Count >= 8) {
+                    m_Out.push_back(static_cast<uint8_t>(m_Bits));
+                    m_Bits >>= 8;
+                    m_Count -= 8;
+                }
+            }
+            // Huffman codes go most significant bit first
+            inline void WriteCode(uint32_t code, uint32_t length) {
+                uint32_t reversed = 0;
+                for(uint32_t i = 0; i < length; i++) reversed |= ((code >> i) & 1) << (length - 1 - i);
+                Write(reversed, length);
+            }
+            inline void Flush() {
+                if(m_Count > 0) m_Out.push_back(static_cast<uint8_t>(m_Bits));
+                m_Bits = 0;
+                m_Count = 0;
+            }
+        private:
+            std::vector<uint8_t>& m_Out;
+            uint64_t m_Bits = 0;
+            uint32_t m_Count = 0;
+        };
+
+        // RFC 1951 3.2.5
+        constexpr uint16_t LENGTH_BASE[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+        constexpr uint8_t LENGTH_EXTRA[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+        constexpr uint16_t DISTANCE_BASE[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+        constexpr uint8_t DISTANCE_EXTRA[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+        constexpr uint32_t WINDOW_SIZE = 32768;
+        constexpr uint32_t MIN_MATCH = 3;
+        constexpr uint32_t MAX_MATCH = 258;
+        constexpr uint32_t HASH_BITS = 15;
+        // Candidates tried per position, more compress better but slower
+        constexpr uint32_t MAX_CHAIN = 8;
+
+        // Fixed literal/length codes, RFC 1951 3.2.6
+        void WriteSymbol(BitWriter& bits, uint32_t symbol) {
+            if(symbol < 144) bits.WriteCode(0x30 + symbol, 8);
+            else if(symbol < 256) bits.WriteCode(0x190 + symbol - 144, 9);
+            else if(symbol < 280) bits.WriteCode(symbol - 256, 7);
+            else bits.WriteCode(0xC0 + symbol - 280, 8);
+        }
+
+        void WriteMatch(BitWriter& bits, uint32_t length, uint32_t distance) {
+            uint32_t code = 0;
+            while(code < 28 && LENGTH_BASE[code + 1] <= length) code++;
+            WriteSymbol(bits, 257 + code);
+            bits.Write(length - LENGTH_BASE[code], LENGTH_EXTRA[code]);
+
+            code = 0;
+            while(code < 29 && DISTANCE_BASE[code + 1] <= distance) code++;
+            bits.WriteCode(code, 5);
+            bits.Write(distance - DISTANCE_BASE[code], DISTANCE_EXTRA[code]);
+        }
+
+        inline uint32_t Hash(const uint8_t* data) {
+            uint32_t value = data[0] | (data[1] << 8) | (data[2] << 16);
+            return (value * 2654435761u) >> (32 - HASH_BITS);
+        }
+
+        // zlib stream of a single fixed Huffman block
+        void Deflate(const uint8_t* data, size_t size, std::vector<uint8_t>& out) {
+            out.push_back(0x78);
+            out.push_back(0x01);
+
+            BitWriter bits(out);
+            bits.Write(1, 1);
+            bits.Write(1, 2);
+
+            // Most recent position of each hash, and the one before each position
+            std::vector<int32_t> head(size_t(1) << HASH_BITS, -1);
+            std::vector<int32_t> previous(WINDOW_SIZE, -1);
+            auto insert = [&](size_t position) {
+                uint32_t hash = Hash(data + position);
+                previous[position % WINDOW_SIZE] = head[hash];
+                head[hash] = static_cast<int32_t>(position);
+            };
+
+            size_t position = 0;
+            while(position < size) {
+                uint32_t bestLength = 0, bestDistance = 0;
+                if(position + MIN_MATCH <= size) {
+                    uint32_t maxLength = static_cast<uint32_t>(std::min<size_t>(MAX_MATCH, size - position));
+                    int32_t candidate = head[Hash(data + position)];
+                    for(uint32_t chain = 0; chain < MAX_CHAIN && candidate >= 0; chain++) {
+                        size_t distance = position - candidate;
+                        if(distance > WINDOW_SIZE) break;
+
+                        const uint8_t* a = data + candidate;
+                        const uint8_t* b = data + position;
+                        uint32_t length = 0;
+                        while(length < maxLength && a[length] == b[length]) length++;
+                        if(length > bestLength) {
+                            bestLength = length;
+                            bestDistance = static_cast<uint32_t>(distance);
+                            if(length == maxLength) break;
+                        }
+                        candidate = previous[candidate % WINDOW_SIZE];
+                    }
+                    insert(position);
+                }
+
+                if(bestLength >= MIN_MATCH) {
+                    WriteMatch(bits, bestLength, bestDistance);
+                    for(size_t i = 1; i < bestLength; i++) {
+                        if(position + i + MIN_MATCH <= size) insert(position + i);
+                    }
+                    position += bestLength;
+                } else {
+                    WriteSymbol(bits, data[position]);
+                    position++;
+                }
+            }
+            WriteSymbol(bits, 256);
+            bits.Flush();
+
+            PutU32(out, Adler32(data, size));
+        }
+
+        inline uint8_t Paeth(int a, int b, int c) {
+            int p = a + b - c;
+            int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+            if(pa <= pb && pa <= pc) return static_cast<uint8_t>(a);
+            return static_cast<uint8_t>(pb <= pc ? b : c);
+        }
+
+        void WriteChunk(std::ofstream& file, const char* type, const std::vector<uint8_t>& data) {
+            std::vector<uint8_t> header;
+            PutU32(header, static_cast<uint32_t>(data.size()));
+            header.insert(header.end(), type, type + 4);
+
+            uint32_t crc = Crc32(0, header.data() + 4, 4);
+            crc = Crc32(crc, data.data(), data.size());
+            std::vector<uint8_t> footer;
+            PutU32(footer, crc);
+
+            file.write(reinterpret_cast<const char*>(header.data()), header.size());
+            file.write(reinterpret_cast<const char*>(data.data()), data.size());
+            file.write(reinterpret_cast<const char*>(footer.data()), footer.size());
+        }
+
+        // 8 bit limited range BT.709 from gamma encoded RGB
+        inline uint8_t ToLuma(float r, float g, float b) {
+            return static_cast<uint8_t>(16.0f + 219.0f / 255.0f * (0.2126f * r + 0.7152f * g + 0.0722f * b) + 0.5f);
+        }
+    }
+
+    bool WritePng(const std::string& path, const uint8_t* pixels, uint32_t width, uint32_t height, size_t rowPitch, bool bgra) {
+        if(width == 0 || height == 0) return false;
+
+        const size_t stride = size_t(width) * 3;
+        const int red = bgra ? 2 : 0, blue = bgra ? 0 : 2;
+
+        // Each row after its filter type; the filter is chosen per row by the
+        // smallest sum of residuals taken as signed, as libpng does
+        std::vector<uint8_t> filtered((stride + 1) * height);
+        std::vector<uint8_t> row(stride), above(stride, 0);
+        std::array<std::vector<uint8_t>, 5> candidates;
+        for(auto& candidate : candidates) candidate.resize(stride);
+
+        for(uint32_t y = 0; y < height; y++) {
+            const uint8_t* source = pixels + rowPitch * y;
+            for(uint32_t x = 0; x < width; x++) {
+                row[x * 3 + 0] = source[x * 4 + red];
+                row[x * 3 + 1] = source[x * 4 + 1];
+                row[x * 3 + 2] = source[x * 4 + blue];
+            }
+
+            uint32_t bestFilter = 0;
+            uint64_t bestSum = UINT64_MAX;
+            for(uint32_t filter = 0; filter < 5; filter++) {
+                uint8_t* out = candidates[filter].data();
+                uint64_t sum = 0;
+                for(size_t i = 0; i < stride; i++) {
+                    int left = i >= 3 ? row[i - 3] : 0;
+                    int up = above[i];
+                    int upLeft = i >= 3 ? above[i - 3] : 0;
+
+                    uint8_t predicted = 0;
+                    switch(filter) {
+                        case 1: predicted = static_cast<uint8_t>(left); break;
+                        case 2: predicted = static_cast<uint8_t>(up); break;
+                        case 3: predicted = static_cast<uint8_t>((left + up) / 2); break;
+                        case 4: predicted = Paeth(left, up, upLeft); break;
+                    }
+                    out[i] = static_cast<uint8_t>(row[i] - predicted);
+                    sum += std::abs(static_cast<int>(static_cast<int8_t>(out[i])));
+                }
+                if(sum < bestSum) {
+                    bestSum = sum;
+                    bestFilter = filter;
+                }
+            }
+
+            uint8_t* target = filtered.data() + (stride + 1) * y;
+            target[0] = static_cast<uint8_t>(bestFilter);
+            std::memcpy(target + 1, candidates[bestFilter].data(), stride);
+            std::swap(row, above);
+        }
+
+        std::vector<uint8_t> header;
+        PutU32(header, width);
+        PutU32(header, height);
+        // 8 bits, truecolor, deflate, adaptive filtering, not interlaced
+        header.insert(header.end(), { 8, 2, 0, 0, 0 });
+
+        std::vector<uint8_t> compressed;
+        compressed.reserve(filtered.size() / 2);
+        Deflate(filtered.data(), filtered.size(), compressed);
+
+        std::ofstream file(path, std::ios::binary);
+        if(!file) return false;
+
+        static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+        WriteChunk(file, "IHDR", header);
+        WriteChunk(file, "IDAT", compressed);
+        WriteChunk(file, "IEND", {});
+        return static_cast<bool>(file);
+    }
+
+    bool Y4mWriter::Open(const std::string& path, uint32_t width, uint32_t height, uint32_t frameRate) {
+        m_File.open(path, std::ios::binary);
+        if(!m_File) return false;
+
+        m_Width = width;
+        m_Height = height;
+        m_File << "YUV4MPEG2 W" << width << " H" << height << " F" << frameRate << ":1 Ip A1:1 C420jpeg\n";
+        return static_cast<bool>(m_File);
+    }
+
+    bool Y4mWriter::WriteFrame(const uint8_t* pixels, size_t rowPitch, bool bgra) {
+        if(!m_File.is_open()) return false;
+
+        const uint32_t chromaWidth = (m_Width + 1) / 2, chromaHeight = (m_Height + 1) / 2;
+        const size_t lumaSize = size_t(m_Width) * m_Height, chromaSize = size_t(chromaWidth) * chromaHeight;
+        m_Planes.resize(lumaSize + chromaSize * 2);
+        uint8_t* luma = reinterpret_cast<uint8_t*>(m_Planes.data());
+        uint8_t* cb = luma + lumaSize;
+        uint8_t* cr = cb + chromaSize;
+
+        const int red = bgra ? 2 : 0, blue = bgra ? 0 : 2;
+        for(uint32_t cy = 0; cy < chromaHeight; cy++) {
+            for(uint32_t cx = 0; cx < chromaWidth; cx++) {
+                // Luma for each pixel of the 2x2 block, chroma from their average
+                float sumR = 0.0f, sumG = 0.0f, sumB = 0.0f;
+                uint32_t count = 0;
+                for(uint32_t dy = 0; dy < 2; dy++) {
+                    uint32_t y = cy * 2 + dy;
+                    if(y >= m_Height) break;
+                    for(uint32_t dx = 0; dx < 2; dx++) {
+                        uint32_t x = cx * 2 + dx;
+                        if(x >= m_Width) break;
+
+                        const uint8_t* pixel = pixels + rowPitch * y + x * 4;
+                        float r = pixel[red], g = pixel[1], b = pixel[blue];
+                        luma[size_t(y) * m_Width + x] = ToLuma(r, g, b);
+                        sumR += r;
+                        sumG += g;
+                        sumB += b;
+                        count++;
+                    }
+                }
+
+                float r = sumR / count, g = sumG / count, b = sumB / count;
+                float y = 0.2126f * r + 0.7152f * g + 0.0722f * b;
+                size_t index = size_t(cy) * chromaWidth + cx;
+                cb[index] = static_cast<uint8_t>(std::clamp(128.0f + 224.0f / 255.0f * (b - y) / 1.8556f + 0.5f, 0.0f, 255.0f));
+                cr[index] = static_cast<uint8_t>(std::clamp(128.0f + 224.0f / 255.0f * (r - y) / 1.5748f + 0.5f, 0.0f, 255.0f));
+            }
+        }
+
+        m_File << "FRAME\n";
+        m_File.write(m_Planes.data(), m_Planes.size());
+        return static_cast<bool>(m_File);
+    }
+}
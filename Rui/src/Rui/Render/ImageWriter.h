@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+// Kept free of engine headers; frame capture runs these on its writer thread
+
+namespace Rui {
+    // Pixels are 8 bit with 4 bytes each, RGBA or with `bgra` BGRA as most
+    // swapchains store them. Rows are `rowPitch` bytes apart. Alpha is
+    // dropped, swapchain images are opaque.
+
+    // 8 bit RGB PNG. The zlib stream uses fixed Huffman codes with greedy
+    // LZ77 matching: a fraction of the size of stored blocks at a speed that
+    // keeps up with a frame sequence, though well short of zlib's best.
+    bool WritePng(const std::string& path, const uint8_t* pixels, uint32_t width, uint32_t height, size_t rowPitch, bool bgra);
+
+    // YUV4MPEG2 stream, as read by ffmpeg and most video tools: 4:2:0
+    // chroma at the centre of each 2x2 block, BT.709 limited range
+    class Y4mWriter {
+    public:
+        bool Open(const std::string& path, uint32_t width, uint32_t height, uint32_t frameRate);
+        // Frames must have the size the stream was opened with
+        bool WriteFrame(const uint8_t* pixels, size_t rowPitch, bool bgra);
+
+        inline bool IsOpen() const { return m_File.is_open(); }
+        inline uint32_t GetWidth() const { return m_Width; }
+        inline uint32_t GetHeight() const { return m_Height; }
+    private:
+        std::ofstream m_File;
+        uint32_t m_Width = 0;
+        uint32_t m_Height = 0;
+        std::string m_Planes;
+    };
+}
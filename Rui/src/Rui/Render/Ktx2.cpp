@@ -0,0 +1,94 @@
+#include "Ktx2.h"
+
+#include "Rui/Core/Log.h"
+
+#include <cstring>
+
+namespace Rui {
+    static constexpr uint8_t KTX2_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+    struct Ktx2Header {
+        uint8_t Identifier[12];
+        uint32_t VkFormat;
+        uint32_t TypeSize;
+        uint32_t PixelWidth;
+        uint32_t PixelHeight;
+        uint32_t PixelDepth;
+        uint32_t LayerCount;
+        uint32_t FaceCount;
+        uint32_t LevelCount;
+        uint32_t SupercompressionScheme;
+
+        uint32_t DfdByteOffset;
+        uint32_t DfdByteLength;
+        uint32_t KvdByteOffset;
+        uint32_t KvdByteLength;
+        uint64_t SgdByteOffset;
+        uint64_t SgdByteLength;
+    };
+
+    struct Ktx2LevelIndex {
+        uint64_t ByteOffset;
+        uint64_t ByteLength;
+        uint64_t UncompressedByteLength;
+    };
+
+    static_assert(sizeof(Ktx2Header) == 80, "KTX2 header must match the file layout");
+
+    bool Ktx2Image::Parse(const std::byte* data, size_t size, const std::string& name, Ktx2Image& image) {
+        Ktx2Header header;
+        if(size < sizeof(header)) {
+            RUI_CORE_ERROR("{0} is too small to be a KTX2 file", name);
+            return false;
+        }
+
+        std::memcpy(&header, data, sizeof(header));
+        if(std::memcmp(header.Identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0) {
+            RUI_CORE_ERROR("{0} is not a KTX2 file", name);
+            return false;
+        }
+
+        if(header.VkFormat == 0) {
+            RUI_CORE_ERROR("{0}: Basis Universal textures are not supported", name);
+            return false;
+        }
+
+        if(header.PixelWidth == 0 || header.PixelHeight == 0 || header.PixelDepth > 1 || header.LayerCount > 1 || header.FaceCount != 1) {
+            RUI_CORE_ERROR("{0}: only single 2D textures are supported", name);
+            return false;
+        }
+
+        if(header.SupercompressionScheme != 0) {
+            RUI_CORE_ERROR("{0}: supercompressed KTX2 files are not supported", name);
+            return false;
+        }
+
+        // A level count of 0 asks the loader to generate the mips
+        uint32_t levelCount = std::max(header.LevelCount, 1u);
+        if(size - sizeof(header) < levelCount * sizeof(Ktx2LevelIndex)) {
+            RUI_CORE_ERROR("{0}: truncated level index", name);
+            return false;
+        }
+
+        image.Format = header.VkFormat;
+        image.Width = header.PixelWidth;
+        image.Height = header.PixelHeight;
+        image.GenerateMips = header.LevelCount <= 1;
+        image.Levels.resize(levelCount);
+
+        for(uint32_t i = 0; i < levelCount; i++) {
+            Ktx2LevelIndex index;
+            std::memcpy(&index, data + sizeof(header) + i * sizeof(index), sizeof(index));
+
+            if(index.ByteOffset > size || size - index.ByteOffset < index.ByteLength || index.ByteLength == 0) {
+                RUI_CORE_ERROR("{0}: level {1} lies outside of the file", name, i);
+                return false;
+            }
+
+            image.Levels[i].Data = data + index.ByteOffset;
+            image.Levels[i].Size = static_cast<size_t>(index.ByteLength);
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Rui/Core/Core.h"
+
+#include <cstddef>
+
+namespace Rui {
+    // Mip levels of a KTX2 file, pointing into the file's data. Only 2D
+    // textures with a single layer and face and no supercompression are
+    // supported; block compressed formats are passed through as they are.
+    struct Ktx2Image {
+        struct Level {
+            const std::byte* Data = nullptr;
+            size_t Size = 0;
+        };
+
+        // A VkFormat value
+        uint32_t Format = 0;
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        // Level 0 is the full resolution image. Files that store a single
+        // level, or ask for mips to be generated, have one.
+        std::vector<Level> Levels;
+        bool GenerateMips = false;
+
+        // Logs and returns false if the data is not a supported KTX2 file
+        static bool Parse(const std::byte* data, size_t size, const std::string& name, Ktx2Image& image);
+    };
+}
@@ -0,0 +1,199 @@
+#include "Mesh.h"
+
+#include "RenderSystem.h"
+#include "Rui/Asset/AssetSystem.h"
+
+#include <cstring>
+
+namespace Rui {
+    static bool ValidateHeader(const AssetBlob& blob, MeshHeader& header, std::vector<MeshLod>& lods) {
+        const std::string& name = blob.GetPath();
+
+        if(blob.GetSize() < sizeof(MeshHeader)) {
+            RUI_CORE_ERROR("{0} is too small to be a mesh", name);
+            return false;
+        }
+
+        std::memcpy(&header, blob.GetData(), sizeof(header));
+        if(std::memcmp(header.Magic, MESH_MAGIC, sizeof(header.Magic)) != 0) {
+            RUI_CORE_ERROR("{0} is not a Rui mesh", name);
+            return false;
+        }
+        if(header.Version != MESH_VERSION) {
+            RUI_CORE_ERROR("{0}: mesh version {1}, expected {2}; convert it again with RuiMesh", name, header.Version, MESH_VERSION);
+            return false;
+        }
+        if(header.IndexType != MeshIndexType::Uint16 && header.IndexType != MeshIndexType::Uint32) {
+            RUI_CORE_ERROR("{0}: unknown index type", name);
+            return false;
+        }
+        if(header.VertexCount == 0 || header.IndexCount == 0 || header.IndexCount % 3 != 0) {
+            RUI_CORE_ERROR("{0}: no triangles", name);
+            return false;
+        }
+
+        uint64_t indexSize = header.IndexType == MeshIndexType::Uint16 ? sizeof(uint16_t) : sizeof(uint32_t);
+        uint64_t dataEnd = header.VertexOffset + header.DataSize;
+        if(header.LodCount == 0 || header.LodCount > MESH_MAX_LODS) {
+            RUI_CORE_ERROR("{0}: {1} levels of detail, expected 1 to {2}", name, header.LodCount, MESH_MAX_LODS);
+            return false;
+        }
+        if(header.VertexOffset % MESH_ALIGNMENT != 0 || header.IndexOffset % MESH_ALIGNMENT != 0 ||
+           header.VertexOffset < sizeof(MeshHeader) + header.LodCount * sizeof(MeshLod) || dataEnd > blob.GetSize() ||
+           header.VertexOffset + uint64_t(header.VertexCount) * sizeof(MeshVertex) > header.IndexOffset ||
+           header.IndexOffset + uint64_t(header.IndexCount) * indexSize > dataEnd) {
+            RUI_CORE_ERROR("{0}: vertex or index data lies outside of the file", name);
+            return false;
+        }
+
+        lods.resize(header.LodCount);
+        std::memcpy(lods.data(), blob.GetData() + sizeof(MeshHeader), header.LodCount * sizeof(MeshLod));
+        for(uint32_t i = 0; i < header.LodCount; i++) {
+            const MeshLod& lod = lods[i];
+            if(lod.IndexCount == 0 || lod.IndexCount % 3 != 0 || uint64_t(lod.FirstIndex) + lod.IndexCount > header.IndexCount) {
+                RUI_CORE_ERROR("{0}: level of detail {1} lies outside of the indices", name, i);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    Mesh::~Mesh() {
+        ResourceManager::Destroy(m_Buffer);
+    }
+
+    void Mesh::Bind(vk::CommandBuffer commandBuffer) const {
+        vk::Buffer buffer = ResourceManager::Get(m_Buffer)->Buffer;
+        const vk::DeviceSize offsets[1] = { 0 };
+
+        commandBuffer.bindVertexBuffers(0, 1, &buffer, offsets);
+        commandBuffer.bindIndexBuffer(buffer, m_IndexOffset, m_IndexType);
+    }
+
+    void Mesh::Draw(vk::CommandBuffer commandBuffer, uint32_t lod, uint32_t instanceCount) const {
+        const MeshLod& range = m_Lods[std::min(lod, GetLodCount() - 1)];
+        commandBuffer.drawIndexed(range.IndexCount, instanceCount, range.FirstIndex, 0, 0);
+    }
+
+    uint32_t Mesh::SelectLod(float pixelsPerUnit, const MeshLodSettings& settings, uint32_t current) const {
+        // Errors grow with the level
+        uint32_t lod = 0;
+        while(lod + 1 < GetLodCount() && m_Lods[lod + 1].Error * pixelsPerUnit <= settings.PixelError) lod++;
+
+        // Finer levels are taken right away, coarser ones with a margin
+        float coarserLimit = settings.PixelError * (1.0f - settings.Hysteresis);
+        while(lod > current && m_Lods[lod].Error * pixelsPerUnit > coarserLimit) lod--;
+
+        return lod;
+    }
+
+    glm::mat4 Mesh::GetDequantizeTransform() const {
+        glm::vec3 center = (m_BoundsMin + m_BoundsMax) * 0.5f;
+        glm::vec3 halfExtent = (m_BoundsMax - m_BoundsMin) * 0.5f;
+
+        glm::mat4 transform(1.0f);
+        transform[0][0] = halfExtent.x;
+        transform[1][1] = halfExtent.y;
+        transform[2][2] = halfExtent.z;
+        transform[3] = glm::vec4(center, 1.0f);
+        return transform;
+    }
+
+    std::vector<vk::VertexInputBindingDescription> Mesh::GetBindingDescriptions() {
+        return { vk::VertexInputBindingDescription(0, sizeof(MeshVertex), vk::VertexInputRate::eVertex) };
+    }
+
+    std::vector<vk::VertexInputAttributeDescription> Mesh::GetAttributeDescriptions() {
+        // Expanded by the input assembler, the shader sees plain floats
+        return {
+            {0, 0, vk::Format::eR16G16B16A16Snorm, static_cast<uint32_t>(offsetof(MeshVertex, Position))},
+            {1, 0, vk::Format::eR16G16Snorm, static_cast<uint32_t>(offsetof(MeshVertex, Normal))},
+            {2, 0, vk::Format::eR16G16Sfloat, static_cast<uint32_t>(offsetof(MeshVertex, TexCoord))}
+        };
+    }
+
+    Ref<Mesh> Mesh::Load(const std::string& path) {
+        AssetHandle blob = AssetSystem::Load(path);
+        if(!blob) {
+            RUI_CORE_ERROR("Could not read mesh {0}", path);
+            return nullptr;
+        }
+
+        MeshHeader header;
+        std::vector<MeshLod> lods;
+        if(!ValidateHeader(*blob, header, lods)) return nullptr;
+
+        Ref<Mesh> mesh(new Mesh());
+        mesh->m_Path = path;
+        mesh->m_VertexCount = header.VertexCount;
+        mesh->m_IndexCount = header.IndexCount;
+        mesh->m_Lods = std::move(lods);
+        mesh->m_IndexOffset = header.IndexOffset - header.VertexOffset;
+        mesh->m_IndexType = header.IndexType == MeshIndexType::Uint16 ? vk::IndexType::eUint16 : vk::IndexType::eUint32;
+        mesh->m_BoundsMin = glm::vec3(header.BoundsMin[0], header.BoundsMin[1], header.BoundsMin[2]);
+        mesh->m_BoundsMax = glm::vec3(header.BoundsMax[0], header.BoundsMax[1], header.BoundsMax[2]);
+
+        BufferDesc desc;
+        desc.Size = header.DataSize;
+        desc.Usage = vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eTransferDst;
+        desc.Category = MemoryCategory::Geometry;
+        mesh->m_Buffer = ResourceManager::CreateBuffer(desc);
+
+        // The data block is already laid out as the buffer, one copy each way
+        BufferDesc stagingDesc;
+        stagingDesc.Size = header.DataSize;
+        stagingDesc.Usage = vk::BufferUsageFlagBits::eTransferSrc;
+        stagingDesc.MemoryProperties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+        stagingDesc.Category = MemoryCategory::Staging;
+        stagingDesc.Mapped = true;
+        BufferHandle staging = ResourceManager::CreateBuffer(stagingDesc);
+
+        std::memcpy(ResourceManager::Get(staging)->Mapped, blob->GetData() + header.VertexOffset, static_cast<size_t>(header.DataSize));
+
+        Device& device = RenderSystem::GetDevice();
+
+        vk::CommandBufferAllocateInfo allocInfo;
+        allocInfo.level = vk::CommandBufferLevel::ePrimary;
+        allocInfo.commandPool = device.GetCommandPool();
+        allocInfo.commandBufferCount = 1;
+
+        vk::CommandBuffer commandBuffer;
+        if(device.GetDevice().allocateCommandBuffers(&allocInfo, &commandBuffer) != vk::Result::eSuccess) {
+            RUI_CORE_ERROR("Failed to allocate mesh upload command buffer!");
+            ResourceManager::Destroy(staging);
+            return nullptr;
+        }
+
+        vk::CommandBufferBeginInfo beginInfo;
+        beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+        commandBuffer.begin(&beginInfo);
+
+        vk::BufferCopy region(0, 0, header.DataSize);
+        commandBuffer.copyBuffer(ResourceManager::Get(staging)->Buffer, ResourceManager::Get(mesh->m_Buffer)->Buffer, 1, &region);
+
+        vk::BufferMemoryBarrier barrier;
+        barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+        barrier.dstAccessMask = vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eIndexRead;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.buffer = ResourceManager::Get(mesh->m_Buffer)->Buffer;
+        barrier.offset = 0;
+        barrier.size = VK_WHOLE_SIZE;
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eVertexInput, {}, 0, nullptr, 1, &barrier, 0, nullptr);
+
+        commandBuffer.end();
+
+        // Waits for this upload only, frames in flight keep running
+        QueueTimeline& timeline = device.GetGraphicsTimeline();
+        uint64_t value = device.Submit(timeline, { commandBuffer });
+        timeline.Wait(value);
+
+        device.GetDevice().freeCommandBuffers(device.GetCommandPool(), 1, &commandBuffer);
+        ResourceManager::Destroy(staging);
+
+        RUI_CORE_INFO("Loaded mesh {0}: {1} vertices, {2} triangles, {3} levels of detail, {4} KB", path, header.VertexCount,
+                      mesh->m_Lods[0].IndexCount / 3, header.LodCount, header.DataSize / 1024);
+        return mesh;
+    }
+}
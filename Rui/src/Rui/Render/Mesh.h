@@ -0,0 +1,86 @@
+#pragma once
+
+#include "ResourceManager.h"
+#include "Texture.h"
+#include "Rui/Asset/MeshFormat.h"
+
+#include <glm/glm.hpp>
+
+namespace Rui {
+    struct MeshLodSettings {
+        bool Enabled = true;
+        // Largest simplification error allowed on screen, in pixels
+        float PixelError = 1.0f;
+        // A coarser level is only taken once its error is this share below
+        // the limit, so objects around a switching distance do not pop back
+        // and forth between levels
+        float Hysteresis = 0.25f;
+    };
+
+    // Quantized triangle mesh made by Tools/RuiMesh, see Rui/Asset/MeshFormat.h.
+    // Vertices and indices share one device local buffer, filled with a
+    // single copy of the file's data block.
+    //
+    // Positions stay quantized on the GPU: the vertex shader reads them as
+    // snorm in [-1, 1] and GetDequantizeTransform() maps that onto the
+    // mesh's bounds, so it is folded into the model matrix.
+    //
+    // Levels of detail are index ranges into the same vertices; level 0 is
+    // the full mesh.
+    class Mesh {
+    public:
+        ~Mesh();
+
+        Mesh(const Mesh&) = delete;
+        Mesh& operator=(const Mesh&) = delete;
+
+        void Bind(vk::CommandBuffer commandBuffer) const;
+        void Draw(vk::CommandBuffer commandBuffer, uint32_t lod = 0, uint32_t instanceCount = 1) const;
+
+        // Coarsest level whose error covers at most settings.PixelError
+        // pixels, given how many pixels a unit of the mesh covers on screen.
+        // `current` is the level the mesh was drawn at last, for hysteresis.
+        uint32_t SelectLod(float pixelsPerUnit, const MeshLodSettings& settings, uint32_t current = 0) const;
+
+        inline uint32_t GetVertexCount() const { return m_VertexCount; }
+        // Of all levels together
+        inline uint32_t GetIndexCount() const { return m_IndexCount; }
+        inline uint32_t GetLodCount() const { return static_cast<uint32_t>(m_Lods.size()); }
+        inline const MeshLod& GetLod(uint32_t lod) const { return m_Lods[lod]; }
+        inline const glm::vec3& GetBoundsMin() const { return m_BoundsMin; }
+        inline const glm::vec3& GetBoundsMax() const { return m_BoundsMax; }
+        inline const std::string& GetPath() const { return m_Path; }
+        // Model space from quantized positions
+        glm::mat4 GetDequantizeTransform() const;
+
+        static std::vector<vk::VertexInputBindingDescription> GetBindingDescriptions();
+        static std::vector<vk::VertexInputAttributeDescription> GetAttributeDescriptions();
+
+        // Reads the file and waits for its upload. Logs and returns nullptr
+        // if it cannot be read or is not a valid mesh.
+        static Ref<Mesh> Load(const std::string& path);
+    private:
+        Mesh() = default;
+
+        std::string m_Path;
+        BufferHandle m_Buffer;
+        vk::DeviceSize m_IndexOffset = 0;
+        vk::IndexType m_IndexType = vk::IndexType::eUint16;
+
+        uint32_t m_VertexCount = 0;
+        uint32_t m_IndexCount = 0;
+        std::vector<MeshLod> m_Lods;
+        glm::vec3 m_BoundsMin{ 0.0f };
+        glm::vec3 m_BoundsMax{ 0.0f };
+    };
+
+    // Drawn by its Scene with the entity's world transform while its world
+    // bounds are in view. Entities without a BoundsComponent get the mesh's.
+    struct MeshComponent {
+        Ref<Mesh> Geometry;
+        // Optional, streamed by the mesh's size on screen
+        Ref<Texture> Albedo;
+        // Picked last frame, for hysteresis
+        uint32_t Lod = 0;
+    };
+}
@@ -0,0 +1,263 @@
+#include "ParticleSystem.h"
+
+#include "Rui/Core/Application.h"
+
+namespace Rui {
+    static void ComputeBarrier(vk::CommandBuffer commandBuffer) {
+        vk::MemoryBarrier barrier(vk::AccessFlagBits::eShaderWrite, vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite);
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eComputeShader, {}, 1, &barrier, 0, nullptr, 0, nullptr);
+    }
+
+    ParticleSystem::ParticleSystem(const ParticleSettings& settings)
+        : m_Settings(settings) {
+        CreateBuffers();
+        CreateDescriptors();
+        WriteDescriptors();
+        CreateComputePipelines();
+    }
+
+    ParticleSystem::~ParticleSystem() {
+        DestroyBuffers();
+
+        ResourceManager::Destroy(m_SimulatePipeline);
+        ResourceManager::Destroy(m_EmitPipeline);
+        ResourceManager::Destroy(m_FinalizePipeline);
+        ResourceManager::Destroy(m_DrawPipeline);
+
+        Device& device = RenderSystem::GetDevice();
+        device.GetDevice().destroyPipelineLayout(m_PipelineLayout, nullptr);
+        device.GetDevice().destroyDescriptorPool(m_DescriptorPool, nullptr);
+        device.GetDevice().destroyDescriptorSetLayout(m_DescriptorSetLayout, nullptr);
+    }
+
+    void ParticleSystem::Update(vk::CommandBuffer commandBuffer, float time) {
+        if(!m_Settings.Enabled) {
+            m_LastTime = -1.0f;
+            return;
+        }
+
+        float deltaTime = m_LastTime < 0.0f ? 0.0f : std::clamp(time - m_LastTime, 0.0f, MAX_DELTA_TIME);
+        m_LastTime = time;
+
+        m_PendingEmits += m_Settings.EmitRate * deltaTime;
+        uint32_t emitCount = static_cast<uint32_t>(std::min(m_PendingEmits, static_cast<double>(m_Settings.Capacity)));
+        m_PendingEmits -= emitCount;
+
+        vk::Buffer counters = ResourceManager::Get(m_Counters)->Buffer;
+
+        if(!m_CountersCleared) {
+            commandBuffer.fillBuffer(counters, 0, COUNTERS_SIZE, 0);
+
+            vk::MemoryBarrier barrier(vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite | vk::AccessFlagBits::eIndirectCommandRead);
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eDrawIndirect,
+                                          {}, 1, &barrier, 0, nullptr, 0, nullptr);
+            m_CountersCleared = true;
+        }
+
+        // The previous step wrote the list and arguments used here, and the
+        // previous draw still reads the list this step writes
+        vk::MemoryBarrier previous(vk::AccessFlagBits::eShaderWrite | vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eIndirectCommandRead,
+                                   vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite | vk::AccessFlagBits::eIndirectCommandRead);
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eVertexInput | vk::PipelineStageFlagBits::eDrawIndirect,
+                                      vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eDrawIndirect,
+                                      {}, 1, &previous, 0, nullptr, 0, nullptr);
+
+        SimulationPushConstants push;
+        push.EmitterPosition = glm::vec4(m_Settings.EmitterPosition, m_Settings.EmitterRadius);
+        push.EmitterVelocity = glm::vec4(m_Settings.EmitterVelocity, m_Settings.VelocitySpread);
+        push.Gravity = glm::vec4(m_Settings.Gravity, m_Settings.Drag);
+        push.DeltaTime = deltaTime;
+        push.Lifetime = m_Settings.Lifetime;
+        push.Restitution = m_Settings.Restitution;
+        push.Size = m_Settings.Size;
+        push.EmitCount = emitCount;
+        push.Capacity = m_Settings.Capacity;
+        push.Seed = m_Step++;
+        push.Input = m_Input;
+
+        commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_PipelineLayout, 0, 1, &m_DescriptorSets[m_Input], 0, nullptr);
+        commandBuffer.pushConstants(m_PipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(SimulationPushConstants), &push);
+
+        // Survivors first, so the appended particles are only simulated from
+        // the next step on
+        ResourceManager::Get(m_SimulatePipeline)->Bind(commandBuffer);
+        commandBuffer.dispatchIndirect(counters, SIMULATE_ARGS_OFFSET);
+        ComputeBarrier(commandBuffer);
+
+        if(emitCount > 0) {
+            ResourceManager::Get(m_EmitPipeline)->Bind(commandBuffer);
+            commandBuffer.dispatch((emitCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+            ComputeBarrier(commandBuffer);
+        }
+
+        ResourceManager::Get(m_FinalizePipeline)->Bind(commandBuffer);
+        commandBuffer.dispatch(1, 1, 1);
+
+        vk::MemoryBarrier draw(vk::AccessFlagBits::eShaderWrite, vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eIndirectCommandRead);
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eVertexInput | vk::PipelineStageFlagBits::eDrawIndirect,
+                                      {}, 1, &draw, 0, nullptr, 0, nullptr);
+
+        m_Input = 1 - m_Input;
+    }
+
+    void ParticleSystem::Draw(vk::CommandBuffer commandBuffer) {
+        if(!m_Settings.Enabled || !m_CountersCleared) return;
+
+        // The list the last step wrote
+        vk::Buffer list = ResourceManager::Get(m_Lists[m_Input])->Buffer;
+        const vk::DeviceSize offsets[1] = { 0 };
+
+        ResourceManager::Get(m_DrawPipeline)->Bind(commandBuffer);
+        commandBuffer.bindVertexBuffers(0, 1, &list, offsets);
+        commandBuffer.drawIndirect(ResourceManager::Get(m_Counters)->Buffer, DRAW_ARGS_OFFSET, 1, 0);
+    }
+
+    void ParticleSystem::CreateDrawPipeline(vk::RenderPass renderPass, vk::PipelineLayout layout) {
+        std::unique_ptr<PipelineConfigInfo> pipelineConfig(Pipeline::DefaultPipelineConfigInfo(RenderSystem::GetSwapChain().Width(), RenderSystem::GetSwapChain().Height()));
+
+        // One instance per particle, six vertices of a quad each
+        pipelineConfig->bindingDescriptions = { vk::VertexInputBindingDescription(0, sizeof(Particle), vk::VertexInputRate::eInstance) };
+        pipelineConfig->attributeDescriptions = {
+            {0, 0, vk::Format::eR32G32B32A32Sfloat, static_cast<uint32_t>(offsetof(Particle, PositionLife))},
+            {1, 0, vk::Format::eR32G32B32A32Sfloat, static_cast<uint32_t>(offsetof(Particle, VelocitySize))}
+        };
+
+        // Additive, so the unordered output of the compaction does not matter.
+        // The raymarched scene writes no usable depth to test against.
+        pipelineConfig->colorBlendAttachment.dstColorBlendFactor = vk::BlendFactor::eOne;
+        pipelineConfig->depthStencilInfo.depthTestEnable = false;
+        pipelineConfig->depthStencilInfo.depthWriteEnable = false;
+        pipelineConfig->dynamicStates = { vk::DynamicState::eViewport, vk::DynamicState::eScissor };
+
+        pipelineConfig->renderPass = renderPass;
+        pipelineConfig->pipelineLayout = layout;
+
+        // Recreated with the swapchain
+        ResourceManager::Destroy(m_DrawPipeline);
+        m_DrawPipeline = ResourceManager::CreatePipeline("res/shaders/particles.vert.spv", "res/shaders/particles.frag.spv", pipelineConfig.get());
+    }
+
+    void ParticleSystem::SetSettings(const ParticleSettings& settings) {
+        bool resize = settings.Capacity != m_Settings.Capacity;
+        m_Settings = settings;
+
+        if(resize) {
+            // The descriptor sets may still be in use by frames in flight
+            RenderSystem::GetDevice().GetDevice().waitIdle();
+
+            DestroyBuffers();
+            CreateBuffers();
+            WriteDescriptors();
+
+            m_Input = 0;
+            m_CountersCleared = false;
+        }
+    }
+
+    void ParticleSystem::CreateBuffers() {
+        BufferDesc desc;
+        desc.Size = sizeof(Particle) * m_Settings.Capacity;
+        desc.Usage = vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eVertexBuffer;
+        desc.Category = MemoryCategory::Geometry;
+
+        for(BufferHandle& list : m_Lists) {
+            list = ResourceManager::CreateBuffer(desc);
+        }
+
+        desc.Size = COUNTERS_SIZE;
+        desc.Usage = vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferDst;
+        m_Counters = ResourceManager::CreateBuffer(desc);
+    }
+
+    void ParticleSystem::DestroyBuffers() {
+        for(BufferHandle list : m_Lists) {
+            ResourceManager::Destroy(list);
+        }
+        ResourceManager::Destroy(m_Counters);
+    }
+
+    void ParticleSystem::CreateDescriptors() {
+        Device& device = RenderSystem::GetDevice();
+
+        // Input list, output list, counters
+        std::array<vk::DescriptorSetLayoutBinding, 3> bindings;
+        for(uint32_t i = 0; i < bindings.size(); i++) {
+            bindings[i].binding = i;
+            bindings[i].descriptorType = vk::DescriptorType::eStorageBuffer;
+            bindings[i].descriptorCount = 1;
+            bindings[i].stageFlags = vk::ShaderStageFlagBits::eCompute;
+        }
+
+        vk::DescriptorSetLayoutCreateInfo layoutInfo;
+        layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+        layoutInfo.pBindings = bindings.data();
+
+        if(device.GetDevice().createDescriptorSetLayout(&layoutInfo, nullptr, &m_DescriptorSetLayout) != vk::Result::eSuccess) {
+            RUI_CORE_ERROR("Failed to create particle descriptor set layout!");
+        }
+
+        vk::DescriptorPoolSize poolSize(vk::DescriptorType::eStorageBuffer, static_cast<uint32_t>(bindings.size() * m_DescriptorSets.size()));
+
+        vk::DescriptorPoolCreateInfo poolInfo;
+        poolInfo.poolSizeCount = 1;
+        poolInfo.pPoolSizes = &poolSize;
+        poolInfo.maxSets = static_cast<uint32_t>(m_DescriptorSets.size());
+
+        if(device.GetDevice().createDescriptorPool(&poolInfo, nullptr, &m_DescriptorPool) != vk::Result::eSuccess) {
+            RUI_CORE_ERROR("Failed to create particle descriptor pool!");
+        }
+
+        std::array<vk::DescriptorSetLayout, 2> layouts = { m_DescriptorSetLayout, m_DescriptorSetLayout };
+        vk::DescriptorSetAllocateInfo allocInfo;
+        allocInfo.descriptorPool = m_DescriptorPool;
+        allocInfo.descriptorSetCount = static_cast<uint32_t>(layouts.size());
+        allocInfo.pSetLayouts = layouts.data();
+
+        if(device.GetDevice().allocateDescriptorSets(&allocInfo, m_DescriptorSets.data()) != vk::Result::eSuccess) {
+            RUI_CORE_ERROR("Failed to allocate particle descriptor sets!");
+        }
+
+        vk::PushConstantRange pushConstantRange(vk::ShaderStageFlagBits::eCompute, 0, sizeof(SimulationPushConstants));
+
+        vk::PipelineLayoutCreateInfo pipelineLayoutInfo;
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &m_DescriptorSetLayout;
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+        if(device.GetDevice().createPipelineLayout(&pipelineLayoutInfo, nullptr, &m_PipelineLayout) != vk::Result::eSuccess) {
+            RUI_CORE_ERROR("Failed to create particle pipeline layout!");
+        }
+    }
+
+    void ParticleSystem::WriteDescriptors() {
+        for(uint32_t i = 0; i < m_DescriptorSets.size(); i++) {
+            std::array<vk::DescriptorBufferInfo, 3> bufferInfos;
+            bufferInfos[0] = vk::DescriptorBufferInfo(ResourceManager::Get(m_Lists[i])->Buffer, 0, VK_WHOLE_SIZE);
+            bufferInfos[1] = vk::DescriptorBufferInfo(ResourceManager::Get(m_Lists[1 - i])->Buffer, 0, VK_WHOLE_SIZE);
+            bufferInfos[2] = vk::DescriptorBufferInfo(ResourceManager::Get(m_Counters)->Buffer, 0, VK_WHOLE_SIZE);
+
+            std::array<vk::WriteDescriptorSet, 3> descriptorWrites{};
+            for(uint32_t binding = 0; binding < descriptorWrites.size(); binding++) {
+                descriptorWrites[binding].dstSet = m_DescriptorSets[i];
+                descriptorWrites[binding].dstBinding = binding;
+                descriptorWrites[binding].dstArrayElement = 0;
+                descriptorWrites[binding].descriptorType = vk::DescriptorType::eStorageBuffer;
+                descriptorWrites[binding].descriptorCount = 1;
+                descriptorWrites[binding].pBufferInfo = &bufferInfos[binding];
+            }
+
+            RenderSystem::GetDevice().GetDevice().updateDescriptorSets(static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+        }
+    }
+
+    void ParticleSystem::CreateComputePipelines() {
+        m_SimulatePipeline = ResourceManager::CreatePipeline("res/shaders/particles_simulate.comp.spv", m_PipelineLayout);
+        m_EmitPipeline = ResourceManager::CreatePipeline("res/shaders/particles_emit.comp.spv", m_PipelineLayout);
+        m_FinalizePipeline = ResourceManager::CreatePipeline("res/shaders/particles_finalize.comp.spv", m_PipelineLayout);
+    }
+
+    std::unique_ptr<ParticleSystem> ParticleSystem::Create(const ParticleSettings& settings) {
+        return std::make_unique<ParticleSystem>(settings);
+    }
+}
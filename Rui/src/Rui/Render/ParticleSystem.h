@@ -0,0 +1,122 @@
+#pragma once
+
+#include "Pipeline.h"
+#include "ResourceManager.h"
+
+#include <glm/glm.hpp>
+
+namespace Rui {
+    struct ParticleSettings {
+        bool Enabled = true;
+        // Particles alive at once; each takes 64 bytes over both lists
+        uint32_t Capacity = 1 << 20;
+        // Particles per second
+        float EmitRate = 40000.0f;
+        glm::vec3 EmitterPosition = { 0.0f, 1.2f, 0.0f };
+        float EmitterRadius = 0.05f;
+        glm::vec3 EmitterVelocity = { 0.0f, 1.5f, 0.0f };
+        float VelocitySpread = 1.5f;
+        // In seconds; every particle lives between half of it and all of it
+        float Lifetime = 4.0f;
+        glm::vec3 Gravity = { 0.0f, -9.81f, 0.0f };
+        float Drag = 0.1f;
+        // Share of the normal velocity kept when bouncing off the scene
+        float Restitution = 0.4f;
+        float Size = 0.008f;
+    };
+
+    // Particles emitted, simulated against the ground plane and the SDF
+    // scene, compacted and drawn entirely on the GPU.
+    //
+    // Particles live in two lists that swap roles every step: the simulation
+    // reads one and appends the survivors to the other, and new particles are
+    // appended behind them, so dead particles drop out without a separate
+    // compaction pass. A final single thread dispatch turns the counts into
+    // the arguments of the indirect draw and of the next step's indirect
+    // dispatch. The CPU only ever sends the emitter and the time step.
+    class ParticleSystem {
+    public:
+        static constexpr uint32_t WORKGROUP_SIZE = 256;
+
+        explicit ParticleSystem(const ParticleSettings& settings);
+        ~ParticleSystem();
+
+        ParticleSystem(const ParticleSystem&) = delete;
+        ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+        // Emits and simulates up to `time`, in simulated seconds. Recorded
+        // outside of a render pass, ahead of the pass drawing the particles.
+        void Update(vk::CommandBuffer commandBuffer, float time);
+        // Recorded inside the scene pass. Expects the push constants of the
+        // scene pipeline layout to be set, for the camera.
+        void Draw(vk::CommandBuffer commandBuffer);
+
+        // `renderPass` is the render graph pass the particles are drawn in
+        void CreateDrawPipeline(vk::RenderPass renderPass, vk::PipelineLayout layout);
+
+        // A new capacity reallocates the lists and drops every particle
+        void SetSettings(const ParticleSettings& settings);
+        inline const ParticleSettings& GetSettings() const { return m_Settings; }
+
+        static std::unique_ptr<ParticleSystem> Create(const ParticleSettings& settings = {});
+    private:
+        // Must match particles_common.glsl
+        struct Particle {
+            glm::vec4 PositionLife;
+            glm::vec4 VelocitySize;
+        };
+
+        struct SimulationPushConstants {
+            glm::vec4 EmitterPosition;
+            glm::vec4 EmitterVelocity;
+            glm::vec4 Gravity;
+            float DeltaTime;
+            float Lifetime;
+            float Restitution;
+            float Size;
+            uint32_t EmitCount;
+            uint32_t Capacity;
+            uint32_t Seed;
+            uint32_t Input;
+        };
+
+        // Counts followed by VkDispatchIndirectCommand and VkDrawIndirectCommand
+        static constexpr vk::DeviceSize SIMULATE_ARGS_OFFSET = 16;
+        static constexpr vk::DeviceSize DRAW_ARGS_OFFSET = 32;
+        static constexpr vk::DeviceSize COUNTERS_SIZE = 48;
+
+        // Longest step simulated at once, so hitches do not tunnel particles
+        // through the scene
+        static constexpr float MAX_DELTA_TIME = 1.0f / 20.0f;
+
+        void CreateBuffers();
+        void DestroyBuffers();
+        void CreateDescriptors();
+        void WriteDescriptors();
+        void CreateComputePipelines();
+
+        ParticleSettings m_Settings;
+
+        // Set i reads list i and writes the other one
+        std::array<BufferHandle, 2> m_Lists;
+        BufferHandle m_Counters;
+        std::array<vk::DescriptorSet, 2> m_DescriptorSets;
+
+        vk::DescriptorSetLayout m_DescriptorSetLayout;
+        vk::DescriptorPool m_DescriptorPool;
+        vk::PipelineLayout m_PipelineLayout;
+
+        PipelineHandle m_SimulatePipeline;
+        PipelineHandle m_EmitPipeline;
+        PipelineHandle m_FinalizePipeline;
+        PipelineHandle m_DrawPipeline;
+
+        // List the next step reads, the one the last step wrote
+        uint32_t m_Input = 0;
+        bool m_CountersCleared = false;
+
+        float m_LastTime = -1.0f;
+        double m_PendingEmits = 0.0;
+        uint32_t m_Step = 0;
+    };
+}
@@ -1,4 +1,5 @@
 #include "Pipeline.h"
+#include "ResourceManager.h"
 
 #include "Rui/Core/Application.h"
 
@@ -7,26 +8,25 @@ namespace Rui {
         CreateGraphicsPipeline(vert_filepath, frag_filepath, config_info);
     }
 
+    Pipeline::Pipeline(const std::string& comp_filepath, vk::PipelineLayout layout)
+        : m_bind_point(vk::PipelineBindPoint::eCompute) {
+        CreateComputePipeline(comp_filepath, layout);
+    }
+
     Pipeline::~Pipeline() {
-        //vkDestroyShaderModule(RenderSystem::GetDevice().GetDevice(), m_vert_shader_module, nullptr);
-        //vkDestroyShaderModule(RenderSystem::GetDevice().GetDevice(), m_frag_shader_module, nullptr);
-        //vkDestroyPipeline(RenderSystem::GetDevice().GetDevice(), m_graphics_pipeline, nullptr);
+        // Frames in flight may still be using it
+        if(m_pipeline) {
+            ResourceManager::DestroyLater(m_pipeline);
+        }
     }
 
-    std::vector<char> Pipeline::ReadFile(const std::string& filepath) {
-        std::ifstream file{ filepath, std::ios::ate | std::ios::binary };
-        if(!file.is_open()) {
+    AssetHandle Pipeline::ReadFile(const std::string& filepath) {
+        AssetHandle blob = AssetSystem::Load(filepath);
+        if(!blob) {
             RUI_CORE_ERROR("Could not open file: {0}", filepath);
         }
 
-        size_t fileSize = static_cast<size_t>(file.tellg());
-        std::vector<char> buffer(fileSize);
-
-        file.seekg(0);
-        file.read(buffer.data(), fileSize);
-        file.close();
-
-        return buffer;
+        return blob;
     }
 
     void Pipeline::CreateDescriptorSetLayout() {
@@ -42,11 +42,11 @@ namespace Rui {
         RUI_CORE_ASSERT(configInfo->pipelineLayout, "Cannot create graphics pipeline: no piplineLayout provided in config_info!");
         RUI_CORE_ASSERT(configInfo->renderPass, "Cannot create graphics pipeline: no renderpass provided in config_info!");
 
-        auto vertCode = ReadFile(vertFilepath);
-        auto fragCode = ReadFile(fragFilepath);
+        AssetHandle vertCode = ReadFile(vertFilepath);
+        AssetHandle fragCode = ReadFile(fragFilepath);
 
-        CreateShaderModule(vertCode, &m_vert_shader_module);
-        CreateShaderModule(fragCode, &m_frag_shader_module);
+        CreateShaderModule(*vertCode, &m_vert_shader_module);
+        CreateShaderModule(*fragCode, &m_frag_shader_module);
 
         vk::PipelineShaderStageCreateInfo shaderStages[2];
         shaderStages[0].stage = vk::ShaderStageFlagBits::eVertex;
@@ -61,16 +61,20 @@ namespace Rui {
         shaderStages[1].pName = "main";
         shaderStages[1].flags = {};
         //shaderStages[1].pNext = nullptr;
-        //shaderStages[1].pSpecializationInfo = nullptr;
+        shaderStages[1].pSpecializationInfo = configInfo->fragmentSpecialization;
 
-        auto bindingDescriptions     = Vertex::GetBindingDescriptions();
-        auto attributeDescriptions = Vertex::GetAttributeDescriptions();
+        auto& bindingDescriptions   = configInfo->bindingDescriptions;
+        auto& attributeDescriptions = configInfo->attributeDescriptions;
         vk::PipelineVertexInputStateCreateInfo vertexInputInfo;
         vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
         vertexInputInfo.vertexBindingDescriptionCount   = static_cast<uint32_t>(bindingDescriptions.size());
         vertexInputInfo.pVertexAttributeDescriptions    = attributeDescriptions.data();
         vertexInputInfo.pVertexBindingDescriptions      = bindingDescriptions.data();
 
+        vk::PipelineDynamicStateCreateInfo dynamicStateInfo;
+        dynamicStateInfo.dynamicStateCount = static_cast<uint32_t>(configInfo->dynamicStates.size());
+        dynamicStateInfo.pDynamicStates    = configInfo->dynamicStates.data();
+
         vk::PipelineViewportStateCreateInfo viewportInfo;
         viewportInfo.viewportCount = 1;
         viewportInfo.pViewports    = &configInfo->viewport;
@@ -87,7 +91,7 @@ namespace Rui {
         pipelineInfo.pMultisampleState   = &configInfo->multisampleInfo;
         pipelineInfo.pColorBlendState    = &configInfo->colorBlendInfo;
         pipelineInfo.pDepthStencilState  = &configInfo->depthStencilInfo;
-        pipelineInfo.pDynamicState       = nullptr;
+        pipelineInfo.pDynamicState       = configInfo->dynamicStates.empty() ? nullptr : &dynamicStateInfo;
 
         pipelineInfo.layout     = configInfo->pipelineLayout;
         pipelineInfo.renderPass = configInfo->renderPass;
@@ -96,15 +100,41 @@ namespace Rui {
         pipelineInfo.basePipelineIndex  = -1;
         pipelineInfo.basePipelineHandle = nullptr;
 
-        if(RenderSystem::GetDevice().GetDevice().createGraphicsPipelines({}, 1, &pipelineInfo, nullptr, &m_graphics_pipeline) != vk::Result::eSuccess) {
+        if(RenderSystem::GetDevice().GetDevice().createGraphicsPipelines({}, 1, &pipelineInfo, nullptr, &m_pipeline) != vk::Result::eSuccess) {
             RUI_CORE_ERROR("Failed to create graphics pipeline");
         }
+
+        // Only needed while the pipeline is created
+        RenderSystem::GetDevice().GetDevice().destroyShaderModule(m_vert_shader_module, nullptr);
+        RenderSystem::GetDevice().GetDevice().destroyShaderModule(m_frag_shader_module, nullptr);
+        m_vert_shader_module = nullptr;
+        m_frag_shader_module = nullptr;
     }
 
-    void Pipeline::CreateShaderModule(std::vector<char>& code, vk::ShaderModule* shaderModule) {
+    void Pipeline::CreateComputePipeline(const std::string& compFilepath, vk::PipelineLayout layout) {
+        AssetHandle compCode = ReadFile(compFilepath);
+
+        vk::ShaderModule compShaderModule;
+        CreateShaderModule(*compCode, &compShaderModule);
+
+        vk::ComputePipelineCreateInfo pipelineInfo;
+        pipelineInfo.stage.stage  = vk::ShaderStageFlagBits::eCompute;
+        pipelineInfo.stage.module = compShaderModule;
+        pipelineInfo.stage.pName  = "main";
+        pipelineInfo.layout       = layout;
+
+        if(RenderSystem::GetDevice().GetDevice().createComputePipelines({}, 1, &pipelineInfo, nullptr, &m_pipeline) != vk::Result::eSuccess) {
+            RUI_CORE_ERROR("Failed to create compute pipeline: {0}", compFilepath);
+        }
+
+        RenderSystem::GetDevice().GetDevice().destroyShaderModule(compShaderModule, nullptr);
+    }
+
+    void Pipeline::CreateShaderModule(const AssetBlob& code, vk::ShaderModule* shaderModule) {
+        // SPIR-V is consumed straight from the mapped file
         vk::ShaderModuleCreateInfo createInfo;
-        createInfo.codeSize = code.size();
-        createInfo.pCode    = reinterpret_cast<const uint32_t*>(code.data());
+        createInfo.codeSize = code.GetSize();
+        createInfo.pCode    = reinterpret_cast<const uint32_t*>(code.GetData());
 
         if(RenderSystem::GetDevice().GetDevice().createShaderModule(&createInfo, nullptr, shaderModule) != vk::Result::eSuccess) {
             throw std::runtime_error("Failed to create shader module");
@@ -173,10 +203,13 @@ namespace Rui {
         configInfo->depthStencilInfo.front                 = vk::StencilOpState();  // Optional
         configInfo->depthStencilInfo.back                  = vk::StencilOpState();  // Optional
 
+        configInfo->bindingDescriptions   = Vertex::GetBindingDescriptions();
+        configInfo->attributeDescriptions = Vertex::GetAttributeDescriptions();
+
         return configInfo;
     }
 
     void Pipeline::Bind(vk::CommandBuffer command_buffer) {
-        command_buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, m_graphics_pipeline);
+        command_buffer.bindPipeline(m_bind_point, m_pipeline);
     }
 }
@@ -1,13 +1,14 @@
 #pragma once
 
 #include "Rui/Core/Device.h"
+#include "Rui/Asset/AssetSystem.h"
 
 //#define GLM_FORCE_DEPTH_ZERO_TO_ONE
-//#define GLM_FORCE_DEFAULT_ALIGNED_GENTYPES
+// Aligned SIMD types are configured for the whole build, see RUI_SIMD
 #include <glm/glm.hpp>
 
 namespace Rui {
-    struct Vertex {
+    struct alignas(16) Vertex {
         glm::vec2 Position;
         glm::vec2 TexCoord;
         //glm::vec3 Normal;
@@ -26,6 +27,7 @@ namespace Rui {
             };
         }
     };
+    static_assert(sizeof(Vertex) == 16, "Vertex layout changed");
 
     struct PipelineConfigInfo {
         vk::Viewport viewport;
@@ -36,30 +38,39 @@ namespace Rui {
         vk::PipelineColorBlendAttachmentState colorBlendAttachment;
         vk::PipelineColorBlendStateCreateInfo colorBlendInfo;
         vk::PipelineDepthStencilStateCreateInfo depthStencilInfo;
+        std::vector<vk::VertexInputBindingDescription> bindingDescriptions;
+        std::vector<vk::VertexInputAttributeDescription> attributeDescriptions;
+        std::vector<vk::DynamicState> dynamicStates;
         vk::PipelineLayout pipelineLayout = nullptr;
         vk::RenderPass renderPass = nullptr;
         uint32_t subpass = 0;
+        // Specialization constants of the fragment shader, if it has any
+        const vk::SpecializationInfo* fragmentSpecialization = nullptr;
     };
 
     class Pipeline {
     public:
         Pipeline(const std::string& vert_filepath, const std::string& frag_filepath, PipelineConfigInfo* config_info);
+        // Compute pipeline
+        Pipeline(const std::string& comp_filepath, vk::PipelineLayout layout);
         ~Pipeline();
 
         Pipeline(const Pipeline&) = delete;
         Pipeline& operator=(const Pipeline&) = delete;
 
         void Bind(vk::CommandBuffer command_buffer);
-        inline const vk::Pipeline& GetPipeline() const { return m_graphics_pipeline; }
+        inline const vk::Pipeline& GetPipeline() const { return m_pipeline; }
         static PipelineConfigInfo* DefaultPipelineConfigInfo(uint32_t width, uint32_t height);
     private:
-        static std::vector<char> ReadFile(const std::string& filepath);
+        static AssetHandle ReadFile(const std::string& filepath);
 
         void CreateGraphicsPipeline(const std::string& vertFilepath, const std::string& fragFilepath, PipelineConfigInfo* configInfo);
+        void CreateComputePipeline(const std::string& compFilepath, vk::PipelineLayout layout);
         void CreateDescriptorSetLayout();
-        void CreateShaderModule(std::vector<char>& code, vk::ShaderModule* shader_module);
+        void CreateShaderModule(const AssetBlob& code, vk::ShaderModule* shader_module);
 
-        vk::Pipeline m_graphics_pipeline;
+        vk::Pipeline m_pipeline;
+        vk::PipelineBindPoint m_bind_point = vk::PipelineBindPoint::eGraphics;
 
         vk::ShaderModule m_vert_shader_module;
         vk::ShaderModule m_frag_shader_module;
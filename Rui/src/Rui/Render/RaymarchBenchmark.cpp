@@ -0,0 +1,65 @@
+#include "RaymarchBenchmark.h"
+
+#include "Rui/Core/Log.h"
+
+namespace Rui {
+    void RaymarchBenchmark::Start(uint32_t framesPerMode) {
+        RUI_CORE_INFO("Starting raymarch benchmark: {0} frames per mode", framesPerMode);
+
+        m_FramesPerMode = framesPerMode;
+        m_Baseline = {};
+        m_ConeMarching = {};
+        m_Phase = Phase::Baseline;
+    }
+
+    uint32_t RaymarchBenchmark::GetFrameFlags(uint32_t flags) const {
+        switch(m_Phase) {
+        case Phase::Baseline:
+            return (flags & ~RaymarchFlagConeMarching) | RaymarchFlagCollectStats;
+        case Phase::ConeMarching:
+            return flags | RaymarchFlagConeMarching | RaymarchFlagCollectStats;
+        default:
+            return flags;
+        }
+    }
+
+    void RaymarchBenchmark::OnFrameStats(uint32_t flags, const RaymarchStats& stats) {
+        if(m_Phase == Phase::Idle || !(flags & RaymarchFlagCollectStats)) return;
+
+        // Frames still in flight from the previous phase finish with the old
+        // flags, so bucket by what the frame was actually rendered with.
+        const bool cone = flags & RaymarchFlagConeMarching;
+        if(cone != (m_Phase == Phase::ConeMarching)) return;
+
+        Totals& totals = cone ? m_ConeMarching : m_Baseline;
+        totals.PrepassSteps += stats.PrepassSteps;
+        totals.Steps += stats.Steps;
+        totals.Rays += stats.Rays;
+        totals.Frames++;
+
+        if(totals.Frames < m_FramesPerMode) return;
+
+        if(m_Phase == Phase::Baseline) {
+            m_Phase = Phase::ConeMarching;
+        } else {
+            m_Phase = Phase::Idle;
+            Report();
+        }
+    }
+
+    void RaymarchBenchmark::Report() const {
+        auto perRay = [](uint64_t steps, uint64_t rays) {
+            return rays ? static_cast<double>(steps) / static_cast<double>(rays) : 0.0;
+        };
+
+        double baseline = perRay(m_Baseline.Steps, m_Baseline.Rays);
+        double full     = perRay(m_ConeMarching.Steps, m_ConeMarching.Rays);
+        double prepass  = perRay(m_ConeMarching.PrepassSteps, m_ConeMarching.Rays);
+        double saved    = baseline > 0.0 ? 100.0 * (1.0 - (full + prepass) / baseline) : 0.0;
+
+        RUI_CORE_INFO("Raymarch benchmark ({0} frames per mode):", m_FramesPerMode);
+        RUI_CORE_INFO("  no prepass:   {0:.2f} steps/ray", baseline);
+        RUI_CORE_INFO("  cone prepass: {0:.2f} steps/ray + {1:.3f} prepass steps/ray", full, prepass);
+        RUI_CORE_INFO("  {0:.1f}% fewer map() evaluations", saved);
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Rui/Core/Core.h"
+
+namespace Rui {
+    // Must match the RAYMARCH_FLAG_* constants in shapes_scene.glsl
+    enum RaymarchFlags : uint32_t {
+        RaymarchFlagNone         = 0,
+        RaymarchFlagConeMarching = BIT(0),
+        RaymarchFlagCollectStats = BIT(1)
+    };
+
+    // Mirrors the RaymarchStats storage buffer in shapes_scene.glsl
+    struct RaymarchStats {
+        uint32_t PrepassSteps = 0;
+        uint32_t Steps = 0;
+        uint32_t Rays = 0;
+    };
+
+    // A/B comparison of raymarch step counts with and without the cone prepass.
+    // Renders FramesPerMode frames in each mode and logs the average number of
+    // map() evaluations per ray.
+    class RaymarchBenchmark {
+    public:
+        void Start(uint32_t framesPerMode);
+        inline bool IsRunning() const { return m_Phase != Phase::Idle; }
+
+        // Flags to render the next frame with, overriding the user's choice
+        // while the benchmark is running.
+        uint32_t GetFrameFlags(uint32_t flags) const;
+
+        // Called with the stats of a completed frame and the flags it used.
+        void OnFrameStats(uint32_t flags, const RaymarchStats& stats);
+    private:
+        enum class Phase { Idle, Baseline, ConeMarching };
+
+        struct Totals {
+            uint64_t PrepassSteps = 0;
+            uint64_t Steps = 0;
+            uint64_t Rays = 0;
+            uint32_t Frames = 0;
+        };
+
+        void Report() const;
+
+        Phase m_Phase = Phase::Idle;
+        uint32_t m_FramesPerMode = 0;
+
+        Totals m_Baseline;
+        Totals m_ConeMarching;
+    };
+}
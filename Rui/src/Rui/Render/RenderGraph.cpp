@@ -0,0 +1,615 @@
+#include "RenderGraph.h"
+
+#include "Rui/Core/Application.h"
+
+namespace Rui {
+    namespace {
+        // How a pass touches an image, for barriers
+        struct ImageState {
+            bool Used = false;
+            vk::ImageLayout Layout = vk::ImageLayout::eUndefined;
+            vk::PipelineStageFlags Stages;
+            vk::AccessFlags Access;
+            bool Write = false;
+        };
+
+        bool IsDepthFormat(vk::Format format) {
+            switch(format) {
+                case vk::Format::eD16Unorm:
+                case vk::Format::eD32Sfloat:
+                case vk::Format::eD16UnormS8Uint:
+                case vk::Format::eD24UnormS8Uint:
+                case vk::Format::eD32SfloatS8Uint:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        bool HasStencil(vk::Format format) {
+            return format == vk::Format::eD16UnormS8Uint || format == vk::Format::eD24UnormS8Uint || format == vk::Format::eD32SfloatS8Uint;
+        }
+
+        bool Overlaps(uint32_t firstA, uint32_t lastA, uint32_t firstB, uint32_t lastB) {
+            return firstA <= lastB && firstB <= lastA;
+        }
+    }
+
+    void RenderGraphBuilder::WriteColor(RenderGraphResource resource, vk::AttachmentLoadOp loadOp, vk::ClearColorValue clear) {
+        RenderGraph::Access access;
+        access.Resource = resource;
+        access.Type = RenderGraph::AccessType::ColorWrite;
+        access.LoadOp = loadOp;
+        access.Clear.color = clear;
+        m_Graph.m_Passes[m_Pass].Accesses.push_back(access);
+    }
+
+    void RenderGraphBuilder::WriteDepth(RenderGraphResource resource, vk::AttachmentLoadOp loadOp, vk::ClearDepthStencilValue clear) {
+        RenderGraph::Access access;
+        access.Resource = resource;
+        access.Type = RenderGraph::AccessType::DepthWrite;
+        access.LoadOp = loadOp;
+        access.Clear.depthStencil = clear;
+        m_Graph.m_Passes[m_Pass].Accesses.push_back(access);
+    }
+
+    void RenderGraphBuilder::Read(RenderGraphResource resource) {
+        RenderGraph::Access access;
+        access.Resource = resource;
+        access.Type = RenderGraph::AccessType::Read;
+        m_Graph.m_Passes[m_Pass].Accesses.push_back(access);
+    }
+
+    void RenderGraphBuilder::SetSideEffect() {
+        m_Graph.m_Passes[m_Pass].SideEffect = true;
+    }
+
+    RenderGraph::~RenderGraph() {
+        Device& device = RenderSystem::GetDevice();
+
+        for(Pass& pass : m_Passes) {
+            for(vk::Framebuffer framebuffer : pass.Framebuffers) {
+                device.GetDevice().destroyFramebuffer(framebuffer, nullptr);
+            }
+            if(pass.RenderPass) device.GetDevice().destroyRenderPass(pass.RenderPass, nullptr);
+        }
+
+        for(Resource& resource : m_Resources) {
+            if(resource.Imported) continue;
+
+            for(vk::ImageView view : resource.Views) device.GetDevice().destroyImageView(view, nullptr);
+            for(vk::Image image : resource.Images) device.GetDevice().destroyImage(image, nullptr);
+        }
+
+        for(MemoryBlock& block : m_Blocks) {
+            for(vma::Allocation allocation : block.Allocations) device.GetAllocator().FreeMemory(allocation);
+        }
+    }
+
+    RenderGraphResource RenderGraph::CreateImage(const std::string& name, const RenderGraphImageDesc& desc) {
+        Resource resource;
+        resource.Name = name;
+        resource.Desc = desc;
+        m_Resources.push_back(std::move(resource));
+
+        return static_cast<RenderGraphResource>(m_Resources.size() - 1);
+    }
+
+    RenderGraphResource RenderGraph::ImportImage(const std::string& name, const RenderGraphImageDesc& desc,
+                                                 const std::vector<vk::Image>& images, const std::vector<vk::ImageView>& views,
+                                                 vk::ImageLayout finalLayout) {
+        Resource resource;
+        resource.Name = name;
+        resource.Desc = desc;
+        resource.Imported = true;
+        resource.FinalLayout = finalLayout;
+        resource.Images = images;
+        resource.Views = views;
+        m_Resources.push_back(std::move(resource));
+
+        return static_cast<RenderGraphResource>(m_Resources.size() - 1);
+    }
+
+    RenderGraphPass RenderGraph::AddPass(const std::string& name, const std::function<void(RenderGraphBuilder&)>& setup, ExecuteFunction execute) {
+        Pass pass;
+        pass.Name = name;
+        pass.Execute = std::move(execute);
+        m_Passes.push_back(std::move(pass));
+
+        RenderGraphPass index = static_cast<RenderGraphPass>(m_Passes.size() - 1);
+        RenderGraphBuilder builder(*this, index);
+        setup(builder);
+
+        return index;
+    }
+
+    void RenderGraph::Compile(uint32_t frames) {
+        if(m_Compiled) {
+            RUI_CORE_ERROR("Render graph is already compiled!");
+            return;
+        }
+
+        m_Frames = frames;
+        for(const Resource& resource : m_Resources) {
+            if(resource.Imported) m_ImageCount = std::max(m_ImageCount, static_cast<uint32_t>(resource.Images.size()));
+        }
+
+        Cull();
+        ComputeLifetimes();
+        CreateImages();
+        ComputeBarriers();
+        CreateRenderPasses();
+        m_Compiled = true;
+
+        size_t culled = std::count_if(m_Passes.begin(), m_Passes.end(), [](const Pass& pass) { return pass.Culled; });
+        RUI_CORE_INFO("Render graph: {0} passes ({1} culled), {2:.1f} MB of transient attachments, {3:.1f} MB without aliasing or lazy allocation",
+                      m_Passes.size(), culled, m_TransientBytes / (1024.0 * 1024.0), m_UnaliasedBytes / (1024.0 * 1024.0));
+    }
+
+    void RenderGraph::Cull() {
+        // Walking backwards, an image is needed if a later pass that is kept
+        // reads it. Imported images are needed by whoever imported them.
+        std::vector<bool> needed(m_Resources.size(), false);
+        for(size_t i = 0; i < m_Resources.size(); i++) {
+            needed[i] = m_Resources[i].Imported;
+        }
+
+        for(size_t i = m_Passes.size(); i-- > 0;) {
+            Pass& pass = m_Passes[i];
+
+            bool kept = pass.SideEffect;
+            for(const Access& access : pass.Accesses) {
+                if(access.Type != AccessType::Read && needed[access.Resource]) kept = true;
+            }
+
+            pass.Culled = !kept;
+            if(!kept) continue;
+
+            // Earlier contents only matter if this pass loads or samples them
+            for(const Access& access : pass.Accesses) {
+                if(access.Type != AccessType::Read && access.LoadOp != vk::AttachmentLoadOp::eLoad && !m_Resources[access.Resource].Imported) {
+                    needed[access.Resource] = false;
+                }
+            }
+            for(const Access& access : pass.Accesses) {
+                if(access.Type == AccessType::Read || access.LoadOp == vk::AttachmentLoadOp::eLoad) needed[access.Resource] = true;
+            }
+        }
+    }
+
+    void RenderGraph::ComputeLifetimes() {
+        for(uint32_t i = 0; i < m_Passes.size(); i++) {
+            Pass& pass = m_Passes[i];
+            if(pass.Culled) continue;
+
+            bool hasExtent = false;
+            for(const Access& access : pass.Accesses) {
+                Resource& resource = m_Resources[access.Resource];
+                resource.FirstUse = std::min(resource.FirstUse, i);
+                resource.LastUse = std::max(resource.LastUse, i);
+
+                switch(access.Type) {
+                    case AccessType::ColorWrite: resource.UsageFlags |= vk::ImageUsageFlagBits::eColorAttachment; break;
+                    case AccessType::DepthWrite: resource.UsageFlags |= vk::ImageUsageFlagBits::eDepthStencilAttachment; break;
+                    case AccessType::Read:       resource.UsageFlags |= vk::ImageUsageFlagBits::eSampled; break;
+                }
+
+                if(access.Type == AccessType::Read) continue;
+
+                // All attachments of a framebuffer must be at least as large as it
+                if(!hasExtent) {
+                    pass.Extent = resource.Desc.Extent;
+                    hasExtent = true;
+                } else if(resource.Desc.Extent != pass.Extent) {
+                    RUI_CORE_ERROR("Render graph pass {0}: attachment {1} is {2}x{3}, expected {4}x{5}", pass.Name, resource.Name,
+                                   resource.Desc.Extent.width, resource.Desc.Extent.height, pass.Extent.width, pass.Extent.height);
+                    pass.Extent.width = std::min(pass.Extent.width, resource.Desc.Extent.width);
+                    pass.Extent.height = std::min(pass.Extent.height, resource.Desc.Extent.height);
+                }
+            }
+
+            pass.RenderArea = pass.Extent;
+        }
+
+        // Written and dropped by a single pass, so never sampled or loaded
+        for(RenderGraphResource i = 0; i < m_Resources.size(); i++) {
+            Resource& resource = m_Resources[i];
+            if(resource.Imported || resource.FirstUse == UINT32_MAX || resource.FirstUse != resource.LastUse) continue;
+
+            resource.PassLocal = std::none_of(m_Passes[resource.FirstUse].Accesses.begin(), m_Passes[resource.FirstUse].Accesses.end(), [&](const Access& access) {
+                return access.Resource == i && (access.Type == AccessType::Read || access.LoadOp == vk::AttachmentLoadOp::eLoad);
+            });
+            if(resource.PassLocal) resource.UsageFlags |= vk::ImageUsageFlagBits::eTransientAttachment;
+        }
+    }
+
+    void RenderGraph::CreateImages() {
+        Device& device = RenderSystem::GetDevice();
+
+        std::vector<RenderGraphResource> transients;
+        std::vector<vk::MemoryRequirements> requirements(m_Resources.size());
+
+        for(RenderGraphResource i = 0; i < m_Resources.size(); i++) {
+            Resource& resource = m_Resources[i];
+            if(resource.Imported) {
+                if(resource.FirstUse == UINT32_MAX) {
+                    RUI_CORE_WARN("Render graph: nothing writes imported image {0}", resource.Name);
+                }
+                continue;
+            }
+            if(resource.FirstUse == UINT32_MAX) continue;
+
+            vk::ImageCreateInfo imageInfo;
+            imageInfo.imageType = vk::ImageType::e2D;
+            imageInfo.extent = vk::Extent3D(resource.Desc.Extent.width, resource.Desc.Extent.height, 1);
+            imageInfo.mipLevels = 1;
+            imageInfo.arrayLayers = 1;
+            imageInfo.format = resource.Desc.Format;
+            imageInfo.tiling = vk::ImageTiling::eOptimal;
+            imageInfo.initialLayout = vk::ImageLayout::eUndefined;
+            imageInfo.usage = resource.UsageFlags;
+            imageInfo.samples = vk::SampleCountFlagBits::e1;
+            imageInfo.sharingMode = vk::SharingMode::eExclusive;
+
+            resource.Images.resize(m_Frames);
+            for(uint32_t frame = 0; frame < m_Frames; frame++) {
+                if(device.GetDevice().createImage(&imageInfo, nullptr, &resource.Images[frame]) != vk::Result::eSuccess) {
+                    RUI_CORE_ERROR("Failed to create render graph image {0}!", resource.Name);
+                }
+            }
+
+            // Copies are created identically, so they share requirements
+            device.GetDevice().getImageMemoryRequirements(resource.Images[0], &requirements[i]);
+            m_UnaliasedBytes += requirements[i].size * m_Frames;
+            transients.push_back(i);
+        }
+
+        // Largest first, each into the first block whose images are all dead
+        // while it is alive
+        std::sort(transients.begin(), transients.end(), [&](RenderGraphResource a, RenderGraphResource b) {
+            return requirements[a].size > requirements[b].size;
+        });
+
+        for(RenderGraphResource index : transients) {
+            Resource& resource = m_Resources[index];
+            const vk::MemoryRequirements& required = requirements[index];
+
+            // Lazily allocated memory only takes transient attachments
+            bool lazy = resource.PassLocal && IsLazilyAllocatable(required.memoryTypeBits);
+
+            for(uint32_t b = 0; b < m_Blocks.size() && resource.Block == UINT32_MAX; b++) {
+                MemoryBlock& block = m_Blocks[b];
+                if(block.Lazy != lazy || !(block.Requirements.memoryTypeBits & required.memoryTypeBits)) continue;
+
+                bool free = std::none_of(block.Resources.begin(), block.Resources.end(), [&](RenderGraphResource other) {
+                    return Overlaps(resource.FirstUse, resource.LastUse, m_Resources[other].FirstUse, m_Resources[other].LastUse);
+                });
+                if(!free) continue;
+
+                block.Requirements.size = std::max(block.Requirements.size, required.size);
+                block.Requirements.alignment = std::max(block.Requirements.alignment, required.alignment);
+                block.Requirements.memoryTypeBits &= required.memoryTypeBits;
+                block.Resources.push_back(index);
+                resource.Block = b;
+            }
+
+            if(resource.Block == UINT32_MAX) {
+                MemoryBlock block;
+                block.Requirements = required;
+                block.Resources.push_back(index);
+                block.Lazy = lazy;
+                m_Blocks.push_back(std::move(block));
+                resource.Block = static_cast<uint32_t>(m_Blocks.size() - 1);
+            }
+        }
+
+        for(MemoryBlock& block : m_Blocks) {
+            vk::MemoryPropertyFlags properties = vk::MemoryPropertyFlagBits::eDeviceLocal;
+            if(block.Lazy) properties |= vk::MemoryPropertyFlagBits::eLazilyAllocated;
+
+            block.Allocations.resize(m_Frames);
+            for(uint32_t frame = 0; frame < m_Frames; frame++) {
+                device.GetAllocator().AllocateMemory(block.Requirements, properties, MemoryCategory::Attachments, &block.Allocations[frame]);
+
+                for(RenderGraphResource index : block.Resources) {
+                    if(device.GetAllocator().BindImage(block.Allocations[frame], m_Resources[index].Images[frame]) != vk::Result::eSuccess) {
+                        RUI_CORE_ERROR("Failed to bind render graph image {0}!", m_Resources[index].Name);
+                    }
+                }
+            }
+
+            // Lazily allocated memory is only committed where a tile spills
+            if(!block.Lazy) m_TransientBytes += block.Requirements.size * m_Frames;
+        }
+
+        for(RenderGraphResource index : transients) {
+            Resource& resource = m_Resources[index];
+
+            vk::ImageViewCreateInfo viewInfo;
+            viewInfo.viewType = vk::ImageViewType::e2D;
+            viewInfo.format = resource.Desc.Format;
+            viewInfo.subresourceRange.aspectMask = IsDepthFormat(resource.Desc.Format) ? vk::ImageAspectFlagBits::eDepth : vk::ImageAspectFlagBits::eColor;
+            viewInfo.subresourceRange.baseMipLevel = 0;
+            viewInfo.subresourceRange.levelCount = 1;
+            viewInfo.subresourceRange.baseArrayLayer = 0;
+            viewInfo.subresourceRange.layerCount = 1;
+
+            resource.Views.resize(m_Frames);
+            for(uint32_t frame = 0; frame < m_Frames; frame++) {
+                viewInfo.image = resource.Images[frame];
+                if(device.GetDevice().createImageView(&viewInfo, nullptr, &resource.Views[frame]) != vk::Result::eSuccess) {
+                    RUI_CORE_ERROR("Failed to create render graph image view {0}!", resource.Name);
+                }
+            }
+        }
+    }
+
+    void RenderGraph::ComputeBarriers() {
+        std::vector<ImageState> states(m_Resources.size());
+        // Image currently occupying each memory block
+        std::vector<RenderGraphResource> occupants(m_Blocks.size(), UINT32_MAX);
+
+        for(Pass& pass : m_Passes) {
+            if(pass.Culled) continue;
+
+            for(const Access& access : pass.Accesses) {
+                Resource& resource = m_Resources[access.Resource];
+                ImageState& state = states[access.Resource];
+
+                ImageState next;
+                next.Used = true;
+                switch(access.Type) {
+                    case AccessType::ColorWrite:
+                        next.Layout = vk::ImageLayout::eColorAttachmentOptimal;
+                        next.Stages = vk::PipelineStageFlagBits::eColorAttachmentOutput;
+                        next.Access = vk::AccessFlagBits::eColorAttachmentWrite;
+                        if(access.LoadOp == vk::AttachmentLoadOp::eLoad) next.Access |= vk::AccessFlagBits::eColorAttachmentRead;
+                        next.Write = true;
+                        break;
+                    case AccessType::DepthWrite:
+                        next.Layout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
+                        next.Stages = vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests;
+                        next.Access = vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite;
+                        next.Write = true;
+                        break;
+                    case AccessType::Read:
+                        next.Layout = vk::ImageLayout::eShaderReadOnlyOptimal;
+                        next.Stages = vk::PipelineStageFlagBits::eFragmentShader;
+                        next.Access = vk::AccessFlagBits::eShaderRead;
+                        break;
+                }
+
+                vk::ImageMemoryBarrier barrier;
+                barrier.newLayout = next.Layout;
+                barrier.dstAccessMask = next.Access;
+                barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+                if(IsDepthFormat(resource.Desc.Format)) {
+                    barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eDepth;
+                    if(HasStencil(resource.Desc.Format)) barrier.subresourceRange.aspectMask |= vk::ImageAspectFlagBits::eStencil;
+                }
+                barrier.subresourceRange.baseMipLevel = 0;
+                barrier.subresourceRange.levelCount = 1;
+                barrier.subresourceRange.baseArrayLayer = 0;
+                barrier.subresourceRange.layerCount = 1;
+
+                vk::PipelineStageFlags srcStages;
+                if(!state.Used) {
+                    // Previous contents are discarded. Imported images wait for
+                    // the stage the acquire semaphore is waited on; aliased ones
+                    // for the image that had the memory before.
+                    barrier.oldLayout = vk::ImageLayout::eUndefined;
+                    srcStages = vk::PipelineStageFlagBits::eTopOfPipe;
+
+                    if(resource.Imported) {
+                        srcStages = vk::PipelineStageFlagBits::eColorAttachmentOutput;
+                    } else if(RenderGraphResource occupant = occupants[resource.Block]; occupant != UINT32_MAX) {
+                        srcStages = states[occupant].Stages;
+                        barrier.srcAccessMask = states[occupant].Write ? states[occupant].Access : vk::AccessFlags();
+                    }
+
+                    if(!resource.Imported) occupants[resource.Block] = access.Resource;
+                } else {
+                    // Read after read in the same layout needs nothing; write
+                    // after read only an execution dependency
+                    if(state.Layout == next.Layout && !state.Write && !next.Write) continue;
+
+                    barrier.oldLayout = state.Layout;
+                    barrier.srcAccessMask = state.Write ? state.Access : vk::AccessFlags();
+                    srcStages = state.Stages;
+                }
+
+                pass.Barriers.push_back(barrier);
+                pass.BarrierResources.push_back(access.Resource);
+                pass.SrcStages |= srcStages;
+                pass.DstStages |= next.Stages;
+
+                state = next;
+            }
+        }
+
+        for(RenderGraphResource i = 0; i < m_Resources.size(); i++) {
+            Resource& resource = m_Resources[i];
+            ImageState& state = states[i];
+            if(!resource.Imported || !state.Used || state.Layout == resource.FinalLayout) continue;
+
+            vk::ImageMemoryBarrier barrier;
+            barrier.oldLayout = state.Layout;
+            barrier.newLayout = resource.FinalLayout;
+            barrier.srcAccessMask = state.Write ? state.Access : vk::AccessFlags();
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.subresourceRange = vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1);
+
+            m_FinalBarriers.push_back(barrier);
+            m_FinalBarrierResources.push_back(i);
+            m_FinalSrcStages |= state.Stages;
+        }
+    }
+
+    void RenderGraph::CreateRenderPasses() {
+        Device& device = RenderSystem::GetDevice();
+
+        for(uint32_t i = 0; i < m_Passes.size(); i++) {
+            Pass& pass = m_Passes[i];
+            if(pass.Culled) continue;
+
+            std::vector<vk::AttachmentDescription> attachments;
+            std::vector<vk::AttachmentReference> colorRefs;
+            vk::AttachmentReference depthRef;
+            bool hasDepth = false;
+            std::vector<RenderGraphResource> attached;
+
+            for(const Access& access : pass.Accesses) {
+                if(access.Type == AccessType::Read) continue;
+                const Resource& resource = m_Resources[access.Resource];
+
+                // Contents are stored only if a later pass samples or loads them
+                bool store = resource.Imported;
+                for(uint32_t j = i + 1; j < m_Passes.size() && !store; j++) {
+                    if(m_Passes[j].Culled) continue;
+                    for(const Access& later : m_Passes[j].Accesses) {
+                        if(later.Resource == access.Resource && (later.Type == AccessType::Read || later.LoadOp == vk::AttachmentLoadOp::eLoad)) store = true;
+                    }
+                }
+
+                vk::ImageLayout layout = access.Type == AccessType::DepthWrite ? vk::ImageLayout::eDepthStencilAttachmentOptimal : vk::ImageLayout::eColorAttachmentOptimal;
+
+                // Layouts are transitioned by the graph's barriers around the pass
+                vk::AttachmentDescription attachment;
+                attachment.format = resource.Desc.Format;
+                attachment.samples = vk::SampleCountFlagBits::e1;
+                attachment.loadOp = access.LoadOp;
+                attachment.storeOp = store ? vk::AttachmentStoreOp::eStore : vk::AttachmentStoreOp::eDontCare;
+                attachment.stencilLoadOp = vk::AttachmentLoadOp::eDontCare;
+                attachment.stencilStoreOp = vk::AttachmentStoreOp::eDontCare;
+                attachment.initialLayout = layout;
+                attachment.finalLayout = layout;
+
+                vk::AttachmentReference reference(static_cast<uint32_t>(attachments.size()), layout);
+                if(access.Type == AccessType::DepthWrite) {
+                    depthRef = reference;
+                    hasDepth = true;
+                } else {
+                    colorRefs.push_back(reference);
+                }
+
+                attachments.push_back(attachment);
+                attached.push_back(access.Resource);
+                if(resource.Imported) {
+                    pass.PerImage = true;
+                } else {
+                    pass.PerFrame = true;
+                }
+                pass.ClearValues.push_back(access.Clear);
+            }
+
+            vk::SubpassDescription subpass;
+            subpass.pipelineBindPoint = vk::PipelineBindPoint::eGraphics;
+            subpass.colorAttachmentCount = static_cast<uint32_t>(colorRefs.size());
+            subpass.pColorAttachments = colorRefs.data();
+            subpass.pDepthStencilAttachment = hasDepth ? &depthRef : nullptr;
+
+            vk::RenderPassCreateInfo renderPassInfo;
+            renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+            renderPassInfo.pAttachments = attachments.data();
+            renderPassInfo.subpassCount = 1;
+            renderPassInfo.pSubpasses = &subpass;
+
+            if(device.GetDevice().createRenderPass(&renderPassInfo, nullptr, &pass.RenderPass) != vk::Result::eSuccess) {
+                RUI_CORE_ERROR("Failed to create render pass for {0}!", pass.Name);
+            }
+
+            uint32_t frames = pass.PerFrame ? m_Frames : 1;
+            uint32_t images = pass.PerImage ? m_ImageCount : 1;
+
+            pass.Framebuffers.resize(frames * images);
+            for(uint32_t framebuffer = 0; framebuffer < pass.Framebuffers.size(); framebuffer++) {
+                std::vector<vk::ImageView> views;
+                for(RenderGraphResource resource : attached) {
+                    views.push_back(m_Resources[resource].Views[m_Resources[resource].Imported ? framebuffer % images : framebuffer / images]);
+                }
+
+                vk::FramebufferCreateInfo framebufferInfo;
+                framebufferInfo.renderPass = pass.RenderPass;
+                framebufferInfo.attachmentCount = static_cast<uint32_t>(views.size());
+                framebufferInfo.pAttachments = views.data();
+                framebufferInfo.width = pass.Extent.width;
+                framebufferInfo.height = pass.Extent.height;
+                framebufferInfo.layers = 1;
+
+                if(device.GetDevice().createFramebuffer(&framebufferInfo, nullptr, &pass.Framebuffers[framebuffer]) != vk::Result::eSuccess) {
+                    RUI_CORE_ERROR("Failed to create framebuffer for {0}!", pass.Name);
+                }
+            }
+        }
+    }
+
+    void RenderGraph::Execute(vk::CommandBuffer commandBuffer, uint32_t frame, uint32_t imageIndex) {
+        for(Pass& pass : m_Passes) {
+            if(pass.Culled) continue;
+
+            RecordBarriers(commandBuffer, frame, imageIndex, pass.Barriers, pass.BarrierResources, pass.SrcStages, pass.DstStages);
+            if(!pass.Enabled) continue;
+
+            uint32_t framebuffer = (pass.PerFrame ? frame : 0) * (pass.PerImage ? m_ImageCount : 1) + (pass.PerImage ? imageIndex : 0);
+
+            vk::RenderPassBeginInfo renderPassInfo;
+            renderPassInfo.renderPass = pass.RenderPass;
+            renderPassInfo.framebuffer = pass.Framebuffers[framebuffer];
+            renderPassInfo.renderArea.offset = vk::Offset2D(0, 0);
+            renderPassInfo.renderArea.extent = pass.RenderArea;
+            renderPassInfo.clearValueCount = static_cast<uint32_t>(pass.ClearValues.size());
+            renderPassInfo.pClearValues = pass.ClearValues.data();
+
+            commandBuffer.beginRenderPass(&renderPassInfo, vk::SubpassContents::eInline);
+            pass.Execute(commandBuffer, frame, imageIndex);
+            commandBuffer.endRenderPass();
+        }
+
+        RecordBarriers(commandBuffer, frame, imageIndex, m_FinalBarriers, m_FinalBarrierResources, m_FinalSrcStages, vk::PipelineStageFlagBits::eBottomOfPipe);
+    }
+
+    void RenderGraph::SetPassEnabled(RenderGraphPass pass, bool enabled) {
+        m_Passes[pass].Enabled = enabled;
+    }
+
+    void RenderGraph::SetRenderArea(RenderGraphPass pass, vk::Extent2D extent) {
+        m_Passes[pass].RenderArea.width = std::min(extent.width, m_Passes[pass].Extent.width);
+        m_Passes[pass].RenderArea.height = std::min(extent.height, m_Passes[pass].Extent.height);
+    }
+
+    bool RenderGraph::IsLazilyAllocatable(uint32_t memoryTypeBits) const {
+        vk::PhysicalDeviceMemoryProperties memoryProperties;
+        RenderSystem::GetDevice().GetPhysicalDevice().getMemoryProperties(&memoryProperties);
+
+        for(uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+            if((memoryTypeBits & (1u << i)) && (memoryProperties.memoryTypes[i].propertyFlags & vk::MemoryPropertyFlagBits::eLazilyAllocated)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void RenderGraph::RecordBarriers(vk::CommandBuffer commandBuffer, uint32_t frame, uint32_t imageIndex, const std::vector<vk::ImageMemoryBarrier>& barriers,
+                                     const std::vector<RenderGraphResource>& resources, vk::PipelineStageFlags srcStages, vk::PipelineStageFlags dstStages) {
+        if(barriers.empty()) return;
+
+        // Barriers are compiled without images, which differ per frame and
+        // swapchain image
+        std::array<vk::ImageMemoryBarrier, 16> recorded;
+        uint32_t count = 0;
+        for(size_t i = 0; i < barriers.size(); i++) {
+            const Resource& resource = m_Resources[resources[i]];
+            recorded[count] = barriers[i];
+            recorded[count].image = resource.Images[resource.Imported ? imageIndex : frame];
+
+            if(++count == recorded.size() || i + 1 == barriers.size()) {
+                commandBuffer.pipelineBarrier(srcStages, dstStages, {}, 0, nullptr, 0, nullptr, count, recorded.data());
+                count = 0;
+            }
+        }
+    }
+}
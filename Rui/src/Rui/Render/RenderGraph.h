@@ -0,0 +1,186 @@
+#pragma once
+
+#include "Rui/Core/Device.h"
+
+namespace Rui {
+    class RenderGraph;
+
+    using RenderGraphResource = uint32_t;
+    using RenderGraphPass = uint32_t;
+
+    struct RenderGraphImageDesc {
+        vk::Extent2D Extent;
+        vk::Format Format = vk::Format::eUndefined;
+    };
+
+    // Declares what a pass does with the graph's images while it is added
+    class RenderGraphBuilder {
+    public:
+        void WriteColor(RenderGraphResource resource, vk::AttachmentLoadOp loadOp = vk::AttachmentLoadOp::eClear,
+                        vk::ClearColorValue clear = std::array<float, 4>{ 0.0f, 0.0f, 0.0f, 1.0f });
+        void WriteDepth(RenderGraphResource resource, vk::AttachmentLoadOp loadOp = vk::AttachmentLoadOp::eClear,
+                        vk::ClearDepthStencilValue clear = vk::ClearDepthStencilValue(1.0f, 0));
+        // Sampled in the fragment shader
+        void Read(RenderGraphResource resource);
+        // Never culled, even if nothing reads what it writes
+        void SetSideEffect();
+    private:
+        RenderGraphBuilder(RenderGraph& graph, RenderGraphPass pass) : m_Graph(graph), m_Pass(pass) {}
+
+        RenderGraph& m_Graph;
+        RenderGraphPass m_Pass;
+
+        friend class RenderGraph;
+    };
+
+    // Frame of render passes over a set of images, compiled once and replayed
+    // every frame.
+    //
+    // Passes declare the images they write as attachments and the images they
+    // sample; the graph derives the Vulkan render passes and framebuffers, the
+    // barriers and layout transitions between passes, and store ops that drop
+    // contents nobody reads. Passes whose results never reach an imported
+    // image or a side effect are culled. Transient images whose lifetimes do
+    // not overlap share memory.
+    //
+    // Passes run in the order they were added, so producers come first.
+    // Transient images exist once per frame in flight, since a frame slot is
+    // only recorded again once the GPU reached its last timeline value.
+    // Images only ever used within one pass get transient usage and lazily
+    // allocated memory where the device has it, so tilers may never back
+    // them at all.
+    class RenderGraph {
+    public:
+        using ExecuteFunction = std::function<void(vk::CommandBuffer commandBuffer, uint32_t frame, uint32_t imageIndex)>;
+
+        RenderGraph() = default;
+        ~RenderGraph();
+
+        RenderGraph(const RenderGraph&) = delete;
+        RenderGraph& operator=(const RenderGraph&) = delete;
+
+        // Owned by the graph; contents do not survive the frame
+        RenderGraphResource CreateImage(const std::string& name, const RenderGraphImageDesc& desc);
+        // Owned elsewhere, one image per swapchain image. The first pass sees
+        // it in eUndefined and it is left in `finalLayout`.
+        RenderGraphResource ImportImage(const std::string& name, const RenderGraphImageDesc& desc,
+                                        const std::vector<vk::Image>& images, const std::vector<vk::ImageView>& views,
+                                        vk::ImageLayout finalLayout);
+
+        RenderGraphPass AddPass(const std::string& name, const std::function<void(RenderGraphBuilder&)>& setup, ExecuteFunction execute);
+
+        // `frames` copies of every transient image
+        void Compile(uint32_t frames);
+        // Must be recorded outside of a render pass
+        void Execute(vk::CommandBuffer commandBuffer, uint32_t frame, uint32_t imageIndex);
+
+        // Per frame; a disabled pass keeps its barriers but leaves its
+        // attachments undefined
+        void SetPassEnabled(RenderGraphPass pass, bool enabled);
+        // Per frame; defaults to the whole attachment extent
+        void SetRenderArea(RenderGraphPass pass, vk::Extent2D extent);
+
+        inline bool IsCulled(RenderGraphPass pass) const { return m_Passes[pass].Culled; }
+        // Compatible with the pass; for creating its pipelines
+        inline vk::RenderPass GetRenderPass(RenderGraphPass pass) const { return m_Passes[pass].RenderPass; }
+        // By frame for transient images, by swapchain image for imported ones
+        inline vk::ImageView GetImageView(RenderGraphResource resource, uint32_t index) const { return m_Resources[resource].Views[index]; }
+        inline vk::Extent2D GetExtent(RenderGraphResource resource) const { return m_Resources[resource].Desc.Extent; }
+
+        // Memory of the transient images with and without aliasing
+        inline vk::DeviceSize GetTransientBytes() const { return m_TransientBytes; }
+        inline vk::DeviceSize GetUnaliasedBytes() const { return m_UnaliasedBytes; }
+    private:
+        enum class AccessType : uint8_t {
+            ColorWrite,
+            DepthWrite,
+            Read
+        };
+
+        struct Access {
+            RenderGraphResource Resource;
+            AccessType Type;
+            vk::AttachmentLoadOp LoadOp = vk::AttachmentLoadOp::eDontCare;
+            vk::ClearValue Clear;
+        };
+
+        struct Resource {
+            std::string Name;
+            RenderGraphImageDesc Desc;
+            bool Imported = false;
+            vk::ImageLayout FinalLayout = vk::ImageLayout::eUndefined;
+            vk::ImageUsageFlags UsageFlags;
+            // Contents never leave the pass using it
+            bool PassLocal = false;
+
+            // Passes between which the image is alive, in execution order
+            uint32_t FirstUse = UINT32_MAX;
+            uint32_t LastUse = 0;
+            // Memory block the image lives in, if transient
+            uint32_t Block = UINT32_MAX;
+
+            std::vector<vk::Image> Images;
+            std::vector<vk::ImageView> Views;
+        };
+
+        struct Pass {
+            std::string Name;
+            std::vector<Access> Accesses;
+            ExecuteFunction Execute;
+            bool SideEffect = false;
+            bool Culled = false;
+            bool Enabled = true;
+            vk::Extent2D Extent;
+            vk::Extent2D RenderArea;
+
+            vk::RenderPass RenderPass;
+            // One per frame, per swapchain image or per both, depending on
+            // the attachments
+            std::vector<vk::Framebuffer> Framebuffers;
+            bool PerFrame = false;
+            bool PerImage = false;
+            std::vector<vk::ClearValue> ClearValues;
+
+            // Recorded ahead of the pass
+            std::vector<vk::ImageMemoryBarrier> Barriers;
+            std::vector<RenderGraphResource> BarrierResources;
+            vk::PipelineStageFlags SrcStages;
+            vk::PipelineStageFlags DstStages;
+        };
+
+        // Transient images sharing memory, none of them alive at the same time
+        struct MemoryBlock {
+            vk::MemoryRequirements Requirements;
+            std::vector<RenderGraphResource> Resources;
+            std::vector<vma::Allocation> Allocations;
+            bool Lazy = false;
+        };
+
+        void Cull();
+        void ComputeLifetimes();
+        void ComputeBarriers();
+        void CreateImages();
+        void CreateRenderPasses();
+        bool IsLazilyAllocatable(uint32_t memoryTypeBits) const;
+        void RecordBarriers(vk::CommandBuffer commandBuffer, uint32_t frame, uint32_t imageIndex, const std::vector<vk::ImageMemoryBarrier>& barriers,
+                            const std::vector<RenderGraphResource>& resources, vk::PipelineStageFlags srcStages, vk::PipelineStageFlags dstStages);
+
+        std::vector<Resource> m_Resources;
+        std::vector<Pass> m_Passes;
+        std::vector<MemoryBlock> m_Blocks;
+
+        // Imported images into their final layouts, after the last pass
+        std::vector<vk::ImageMemoryBarrier> m_FinalBarriers;
+        std::vector<RenderGraphResource> m_FinalBarrierResources;
+        vk::PipelineStageFlags m_FinalSrcStages;
+
+        uint32_t m_Frames = 0;
+        uint32_t m_ImageCount = 0;
+
+        vk::DeviceSize m_TransientBytes = 0;
+        vk::DeviceSize m_UnaliasedBytes = 0;
+        bool m_Compiled = false;
+
+        friend class RenderGraphBuilder;
+    };
+}
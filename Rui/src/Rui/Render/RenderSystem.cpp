@@ -8,81 +8,248 @@ namespace Rui {
 	std::unique_ptr<Device>					  RenderSystem::s_Device	= nullptr;
 	std::unique_ptr<SwapChain>				  RenderSystem::s_SwapChain = nullptr;
 
+	// Must match sceneCamera in shapes_scene.glsl and the planes in mesh.vert
+	static constexpr float SCENE_CAMERA_FOCAL_LENGTH = 2.5f;
+	static constexpr float SCENE_NEAR_PLANE = 0.1f;
+	static constexpr float SCENE_FAR_PLANE = 100.0f;
+	static const glm::vec3 SCENE_CAMERA_TARGET(0.5f, -0.5f, -0.6f);
+
+	static glm::vec3 SceneCameraPosition(float time, vk::Extent2D resolution) {
+		glm::vec2 mo = 1.0f / glm::vec2(static_cast<float>(resolution.width), static_cast<float>(resolution.height));
+		float t = 32.0f + time * 1.5f;
+
+		return SCENE_CAMERA_TARGET + glm::vec3(4.5f * std::cos(0.1f * t + 7.0f * mo.x), 1.3f + 2.0f * mo.y, 4.5f * std::sin(0.1f * t + 7.0f * mo.x));
+	}
+
+	// Of the projection in mesh.vert
+	static Frustum SceneCameraFrustum(const glm::vec3& position, vk::Extent2D resolution) {
+		// setCamera in shapes_scene.glsl, without roll
+		glm::vec3 forward = glm::normalize(SCENE_CAMERA_TARGET - position);
+		glm::vec3 right = glm::normalize(glm::cross(forward, glm::vec3(0.0f, 1.0f, 0.0f)));
+		glm::vec3 up = glm::cross(right, forward);
+
+		float aspect = static_cast<float>(resolution.height) / static_cast<float>(resolution.width);
+		float depthScale = SCENE_FAR_PLANE / (SCENE_FAR_PLANE - SCENE_NEAR_PLANE);
+		glm::vec4 rows[4] = {
+			-SCENE_CAMERA_FOCAL_LENGTH * aspect * glm::vec4(right, -glm::dot(right, position)),
+			-SCENE_CAMERA_FOCAL_LENGTH * glm::vec4(up, -glm::dot(up, position)),
+			depthScale * glm::vec4(forward, -glm::dot(forward, position) - SCENE_NEAR_PLANE),
+			glm::vec4(forward, -glm::dot(forward, position))
+		};
+
+		glm::mat4 viewProjection;
+		for(int i = 0; i < 4; i++) {
+			for(int j = 0; j < 4; j++) viewProjection[j][i] = rows[i][j];
+		}
+		return Frustum::FromMatrix(viewProjection);
+	}
+
 	void RenderSystem::Init() {
 		RUI_CORE_INFO("Initializing RenderSystem!");
 		s_Data		= std::make_unique<RenderData>();
 		s_Device	= Device::Create();
+
+		ResourceManager::Init();
+
 		s_SwapChain = SwapChain::Create(Application::Get().GetDisplay().GetExtent());
+		s_Data->CameraPosition = SceneCameraPosition(0.0f, s_SwapChain->GetSwapChainExtent());
+		s_Data->CameraFrustum = SceneCameraFrustum(s_Data->CameraPosition, s_SwapChain->GetSwapChainExtent());
+
+		TextureSystem::Init();
 
 		CreateDescriptorSetLayout();
 		CreatePipelineLayout();
-		CreatePipeline();
 		CreateUniformBuffers();
+		CreateRaymarchStatsBuffer();
 		CreateDescriptorSets();
+		CreateRenderGraph();
+		s_Data->Particles = ParticleSystem::Create();
+		CreatePipeline();
+		CreateGeometryBuffers();
 		CreateCommandBuffers();
+
+		// start, after prepass, after scene pass, after upscale
+		s_Data->Timer = std::make_unique<GpuTimer>(SwapChain::MAX_FRAMES_IN_FLIGHT, 4);
+		s_Data->Capture = std::make_unique<FrameCapture>();
 	}
 
 	void RenderSystem::Dispose() {
+		s_Device->GetDevice().waitIdle();
+
+		// Writes the frames still in flight
+		s_Data->Capture.reset();
+		TextureSystem::Shutdown();
+
+		for(BufferHandle buffer : s_Data->UniformBuffers) {
+			ResourceManager::Destroy(buffer);
+		}
+		ResourceManager::Destroy(s_Data->RaymarchStatsBuffer);
+		ResourceManager::Destroy(s_Data->VertexBuffer);
+		ResourceManager::Destroy(s_Data->IndexBuffer);
+		DestroyPipelines();
+		s_Device->GetDevice().destroySampler(s_Data->TargetSampler, nullptr);
+
+		s_Data.reset();
+		s_SwapChain.reset();
+
+		ResourceManager::Shutdown();
 	}
 
-	void RenderSystem::DrawTriangle() {
+	void RenderSystem::DrawTriangle(const Timestep& ts) {
 		uint32_t imageIndex;
 		auto result = s_SwapChain->AcquireNextImage(&imageIndex);
 
 		if(result == vk::Result::eErrorOutOfDateKHR || result == vk::Result::eSuboptimalKHR) {
 			//framebufferResized = false;
 			GetSwapChain().ReCreateSwapChain();
+			s_Data->MeshDraws.clear();
 			return;
 		} else if(result != vk::Result::eSuccess) {
 			RUI_CORE_ERROR("Failed to acquire swap chain image!");
 		}
 
-		auto commandBuffer = s_Data->CommandBuffers[imageIndex];
+		// AcquireNextImage waited for this frame slot's last timeline value, so
+		// the stats and timestamps the GPU wrote the last time this slot was
+		// used are complete.
+		size_t frame = s_SwapChain->CurrentFrame();
+		ResourceManager::Update();
+		s_Data->Capture->Update();
+
+		RaymarchStats* stats = reinterpret_cast<RaymarchStats*>(ResourceManager::Get(s_Data->RaymarchStatsBuffer)->Mapped + frame * RAYMARCH_STATS_STRIDE);
+		if(s_Data->RaymarchStatsFlags[frame] & RaymarchFlagCollectStats) {
+			s_Data->LastRaymarchStats = *stats;
+			s_Data->Benchmark.OnFrameStats(s_Data->RaymarchStatsFlags[frame], *stats);
+		}
+		*stats = {};
+
+		if(s_Data->Timer->Resolve(static_cast<uint32_t>(frame), s_Data->GpuIntervals)) {
+			GpuTimings& timings = s_Data->LastGpuTimings;
+			timings.PrepassMs = s_Data->GpuIntervals[0];
+			timings.ScenePassMs = s_Data->GpuIntervals[1];
+			timings.UpscaleMs = s_Data->GpuIntervals[2];
+			timings.TotalMs = timings.PrepassMs + timings.ScenePassMs + timings.UpscaleMs;
+
+			s_Data->Resolution.Update(timings.TotalMs);
+		}
+
+		vk::Extent2D renderExtent = s_Data->Resolution.GetRenderExtent(s_SwapChain->GetSwapChainExtent());
+
+		uint32_t flags = s_Data->ConeMarching ? RaymarchFlagConeMarching : RaymarchFlagNone;
+		if(s_Data->CollectRaymarchStats) flags |= RaymarchFlagCollectStats;
+		flags = s_Data->Benchmark.GetFrameFlags(flags);
+		s_Data->RaymarchStatsFlags[frame] = flags;
+
+		auto commandBuffer = s_Data->CommandBuffers[frame];
 
 		const VkDeviceSize offsets[1] = { 0 };
+		const uint32_t statsOffset = static_cast<uint32_t>(frame * RAYMARCH_STATS_STRIDE);
 
 			vk::CommandBufferBeginInfo beginInfo;
 			commandBuffer.begin(&beginInfo);
 
-			vk::RenderPassBeginInfo renderPassInfo;
-			renderPassInfo.renderPass = s_SwapChain->GetRenderPass();
-			renderPassInfo.framebuffer = s_SwapChain->GetFrameBuffer(imageIndex);
+			// Defragmentation copies go into frames with GPU time to spare. Moved
+			// textures are picked up by the texture update below.
+			bool idle = s_Data->LastGpuTimings.TotalMs < s_Data->Resolution.GetSettings().FrameBudgetMs * 0.75;
+			s_Device->GetAllocator().Update(commandBuffer, idle);
 
-			renderPassInfo.renderArea.offset = vk::Offset2D(0, 0);
-			renderPassInfo.renderArea.extent = s_SwapChain->GetSwapChainExtent();
+			// Texture uploads and residency changes, ahead of any pass sampling them
+			TextureSystem::Update(commandBuffer, static_cast<uint32_t>(frame));
 
-			vk::ClearColorValue ab = std::array<float, 4>{0.3f, 0.1f, 0.35f, 1.0f};
+			// Simulated rather than wall clock time, so replays render identical frames
+			float time = static_cast<float>(ts.m_Time + ts.m_Interpolation * ts.m_dt);
 
-			std::array<vk::ClearValue, 2> clearValues{};
-			clearValues[0].color = ab;
-			clearValues[1].depthStencil = vk::ClearDepthStencilValue(1.0f, 0);
-			renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
-			renderPassInfo.pClearValues = clearValues.data();
+			s_Data->Particles->Update(commandBuffer, time);
 
-			commandBuffer.beginRenderPass(&renderPassInfo, vk::SubpassContents::eInline);
+			s_Data->Timer->Reset(commandBuffer, static_cast<uint32_t>(frame));
+			s_Data->Timer->Timestamp(commandBuffer, static_cast<uint32_t>(frame), 0, vk::PipelineStageFlagBits::eTopOfPipe);
 
-			s_Data->Pipeline->Bind(commandBuffer);
-			commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, s_Data->PipelineLayout, 0, 1, &s_Data->DescriptorSets[imageIndex], 0, nullptr);
+			// Bound state is shared by the cone prepass and the scene pass
+			vk::DescriptorSet textureSet = TextureSystem::GetDescriptorSet(static_cast<uint32_t>(frame));
+			commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, s_Data->PipelineLayout, 0, 1, &s_Data->DescriptorSets[frame], 1, &statsOffset);
+			commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, s_Data->PipelineLayout, 1, 1, &textureSet, 0, nullptr);
 
-			commandBuffer.bindVertexBuffers(0, 1, &s_Data->vertexBuffer, offsets);
-			commandBuffer.bindIndexBuffer(s_Data->indexBuffer, 0, vk::IndexType::eUint32);
-			float time = std::chrono::steady_clock::now().time_since_epoch().count() / 1000000000.0f;
+			vk::Buffer vertexBuffer = ResourceManager::Get(s_Data->VertexBuffer)->Buffer;
+			commandBuffer.bindVertexBuffers(0, 1, &vertexBuffer, offsets);
+			commandBuffer.bindIndexBuffer(ResourceManager::Get(s_Data->IndexBuffer)->Buffer, 0, vk::IndexType::eUint32);
 			PushConstants tmp;
 
-			float w = Application::Get().GetDisplay().GetWidth();
-			float h = Application::Get().GetDisplay().GetHeight();
-
 			tmp.iTime = time;
-			tmp.iResolution = {w, h};
+			tmp.iResolution = { static_cast<float>(renderExtent.width), static_cast<float>(renderExtent.height) };
+			tmp.iFlags = flags;
 
 			commandBuffer.pushConstants(s_Data->PipelineLayout, vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment, 0, sizeof(PushConstants), &tmp);
 
-			commandBuffer.drawIndexed(static_cast<uint32_t>(s_Data->indices.size()), 1, 0, 0, 0);
+			// Cone prepass, scene pass into the top left renderExtent of the scene
+			// image, upscale into the swapchain image
+			s_Data->RenderExtent = renderExtent;
+			s_Data->CameraPosition = SceneCameraPosition(time, renderExtent);
+			s_Data->CameraFrustum = SceneCameraFrustum(s_Data->CameraPosition, renderExtent);
+			s_Data->Graph->SetPassEnabled(s_Data->PrepassPass, (flags & RaymarchFlagConeMarching) != 0);
+			s_Data->Graph->SetRenderArea(s_Data->PrepassPass, ConePrepass::GetTileExtent(renderExtent));
+			s_Data->Graph->SetRenderArea(s_Data->ScenePass, renderExtent);
+			s_Data->Graph->Execute(commandBuffer, static_cast<uint32_t>(frame), imageIndex);
+
+			s_Data->Capture->Record(commandBuffer, s_SwapChain->GetImage(imageIndex), s_SwapChain->GetSwapChainExtent(), s_SwapChain->GetSwapChainImageFormat());
 
-			commandBuffer.endRenderPass();
 			commandBuffer.end();
 
-		result = s_SwapChain->SubmitCommandBuffers(&s_Data->CommandBuffers[imageIndex], &imageIndex);
+		Application::Get().GetInput().OnSubmit();
+		result = s_SwapChain->SubmitCommandBuffers(&s_Data->CommandBuffers[frame], &imageIndex);
+		s_Data->Capture->Submitted(s_SwapChain->GetSubmittedValue());
+		s_Data->MeshDraws.clear();
+	}
+
+	void RenderSystem::SubmitMesh(const Ref<Mesh>& mesh, const glm::mat4& transform, uint32_t* lod, const Ref<Texture>& texture) {
+		if(!mesh) return;
+
+		// Scene space box around the transformed bounds
+		glm::vec3 halfExtent = (mesh->GetBoundsMax() - mesh->GetBoundsMin()) * 0.5f;
+		glm::vec3 center = glm::vec3(transform * glm::vec4(mesh->GetBoundsMin() + halfExtent, 1.0f));
+		glm::vec3 extent = glm::abs(glm::vec3(transform[0])) * halfExtent.x + glm::abs(glm::vec3(transform[1])) * halfExtent.y + glm::abs(glm::vec3(transform[2])) * halfExtent.z;
+		if(!Overlaps(Aabb{ center - extent, center + extent }, s_Data->CameraFrustum)) return;
+
+		uint32_t level = 0;
+		if(s_Data->RenderExtent.height > 0) {
+			// Distance to the bounding sphere, so the nearest part of the mesh
+			// decides. The error is in model units and scales with the mesh.
+			float scale = std::max({ glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2])) });
+			float radius = glm::length(mesh->GetBoundsMax() - mesh->GetBoundsMin()) * 0.5f * scale;
+			float distance = std::max(glm::length(center - s_Data->CameraPosition) - radius, SCENE_NEAR_PLANE);
+
+			float pixelsPerUnit = scale * SCENE_CAMERA_FOCAL_LENGTH * 0.5f * s_Data->RenderExtent.height / distance;
+			if(s_Data->MeshLod.Enabled) {
+				level = mesh->SelectLod(pixelsPerUnit, s_Data->MeshLod, lod ? *lod : 0);
+			}
+
+			// The texture spans the bounding sphere's diameter at that distance
+			if(texture) {
+				TextureSystem::ReportUsage(*texture, radius * SCENE_CAMERA_FOCAL_LENGTH * s_Data->RenderExtent.height / distance);
+			}
+		}
+
+		if(lod) *lod = level;
+		s_Data->MeshDraws.push_back({ mesh, transform, level, texture });
+	}
+
+	void RenderSystem::SetConeMarching(bool enabled) {
+		RUI_CORE_INFO("Cone marching prepass: {0}", enabled ? "on" : "off");
+		s_Data->ConeMarching = enabled;
+	}
+
+	void RenderSystem::RunRaymarchBenchmark(uint32_t framesPerMode) {
+		s_Data->Benchmark.Start(framesPerMode);
+	}
+
+	void RenderSystem::SetDynamicResolution(const DynamicResolutionSettings& settings) {
+		vk::Extent2D outputExtent = s_SwapChain->GetSwapChainExtent();
+		vk::Extent2D oldTarget = s_Data->Resolution.GetTargetExtent(outputExtent);
+
+		s_Data->Resolution.SetSettings(settings);
+
+		if(s_Data->Resolution.GetTargetExtent(outputExtent) != oldTarget) {
+			s_Device->GetDevice().waitIdle();
+			CreateRenderGraph();
+		}
 	}
 
 	void RenderSystem::CreateDescriptorSetLayout() {
@@ -93,14 +260,22 @@ namespace Rui {
 		uboLayoutBinding.stageFlags = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
 		uboLayoutBinding.pImmutableSamplers = nullptr; // Optional
 
-		/*VkDescriptorSetLayoutBinding samplerLayoutBinding{};
-		samplerLayoutBinding.binding = 1;
-		samplerLayoutBinding.descriptorCount = 2;
-		samplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-		samplerLayoutBinding.pImmutableSamplers = nullptr;
-		samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;*/
 
-		std::array<vk::DescriptorSetLayoutBinding, 1> bindings = { uboLayoutBinding };
+		vk::DescriptorSetLayoutBinding coneDepthLayoutBinding;
+		coneDepthLayoutBinding.binding = 1;
+		coneDepthLayoutBinding.descriptorType = vk::DescriptorType::eCombinedImageSampler;
+		coneDepthLayoutBinding.descriptorCount = 1;
+		coneDepthLayoutBinding.stageFlags = vk::ShaderStageFlagBits::eFragment;
+		coneDepthLayoutBinding.pImmutableSamplers = nullptr;
+
+		vk::DescriptorSetLayoutBinding statsLayoutBinding;
+		statsLayoutBinding.binding = 2;
+		statsLayoutBinding.descriptorType = vk::DescriptorType::eStorageBufferDynamic;
+		statsLayoutBinding.descriptorCount = 1;
+		statsLayoutBinding.stageFlags = vk::ShaderStageFlagBits::eFragment;
+		statsLayoutBinding.pImmutableSamplers = nullptr;
+
+		std::array<vk::DescriptorSetLayoutBinding, 3> bindings = { uboLayoutBinding, coneDepthLayoutBinding, statsLayoutBinding };
 		vk::DescriptorSetLayoutCreateInfo layoutInfo{};
 		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
 		layoutInfo.pBindings = bindings.data();
@@ -108,27 +283,55 @@ namespace Rui {
 		if(s_Device->GetDevice().createDescriptorSetLayout(&layoutInfo, nullptr, &s_Data->DescriptorSetLayout) != vk::Result::eSuccess) {
 			RUI_CORE_ERROR("Failed to create descriptor set layout!");
 		}
+
+		vk::DescriptorSetLayoutBinding sceneLayoutBinding;
+		sceneLayoutBinding.binding = 0;
+		sceneLayoutBinding.descriptorType = vk::DescriptorType::eCombinedImageSampler;
+		sceneLayoutBinding.descriptorCount = 1;
+		sceneLayoutBinding.stageFlags = vk::ShaderStageFlagBits::eFragment;
+		sceneLayoutBinding.pImmutableSamplers = nullptr;
+
+		vk::DescriptorSetLayoutCreateInfo upscaleLayoutInfo{};
+		upscaleLayoutInfo.bindingCount = 1;
+		upscaleLayoutInfo.pBindings = &sceneLayoutBinding;
+
+		if(s_Device->GetDevice().createDescriptorSetLayout(&upscaleLayoutInfo, nullptr, &s_Data->UpscaleDescriptorSetLayout) != vk::Result::eSuccess) {
+			RUI_CORE_ERROR("Failed to create upscale descriptor set layout!");
+		}
 	}
 
 	void RenderSystem::CreateDescriptorSets() {
-		std::vector<vk::DescriptorSetLayout> layouts(s_SwapChain->ImageCount(), s_Data->DescriptorSetLayout);
+		std::vector<vk::DescriptorSetLayout> layouts(SwapChain::MAX_FRAMES_IN_FLIGHT, s_Data->DescriptorSetLayout);
 		vk::DescriptorSetAllocateInfo allocInfo;
 		allocInfo.descriptorPool = s_Data->DescriptorPool;
-		allocInfo.descriptorSetCount = static_cast<uint32_t>(s_SwapChain->ImageCount());
+		allocInfo.descriptorSetCount = SwapChain::MAX_FRAMES_IN_FLIGHT;
 		allocInfo.pSetLayouts = layouts.data();
 
-		s_Data->DescriptorSets.resize(s_SwapChain->ImageCount());
+		s_Data->DescriptorSets.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
 		if(s_Device->GetDevice().allocateDescriptorSets(&allocInfo, s_Data->DescriptorSets.data()) != vk::Result::eSuccess) {
 			RUI_CORE_ERROR("Failed to allocate descriptor sets!");
 		}
 
-		for(size_t i = 0; i < s_SwapChain->ImageCount(); i++) {
+		std::vector<vk::DescriptorSetLayout> upscaleLayouts(SwapChain::MAX_FRAMES_IN_FLIGHT, s_Data->UpscaleDescriptorSetLayout);
+		allocInfo.pSetLayouts = upscaleLayouts.data();
+
+		s_Data->UpscaleDescriptorSets.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
+		if(s_Device->GetDevice().allocateDescriptorSets(&allocInfo, s_Data->UpscaleDescriptorSets.data()) != vk::Result::eSuccess) {
+			RUI_CORE_ERROR("Failed to allocate upscale descriptor sets!");
+		}
+
+		for(size_t i = 0; i < SwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
 			vk::DescriptorBufferInfo bufferInfo;
-			bufferInfo.buffer = s_Data->UniformBuffers[i];
+			bufferInfo.buffer = ResourceManager::Get(s_Data->UniformBuffers[i])->Buffer;
 			bufferInfo.offset = 0;
 			bufferInfo.range = sizeof(UniformBufferObject);
 
-			std::array<vk::WriteDescriptorSet, 1> descriptorWrites{};
+			vk::DescriptorBufferInfo statsInfo;
+			statsInfo.buffer = ResourceManager::Get(s_Data->RaymarchStatsBuffer)->Buffer;
+			statsInfo.offset = 0;
+			statsInfo.range = sizeof(RaymarchStats);
+
+			std::array<vk::WriteDescriptorSet, 2> descriptorWrites{};
 
 			descriptorWrites[0].dstSet = s_Data->DescriptorSets[i];
 			descriptorWrites[0].dstBinding = 0;
@@ -137,164 +340,327 @@ namespace Rui {
 			descriptorWrites[0].descriptorCount = 1;
 			descriptorWrites[0].pBufferInfo = &bufferInfo;
 
+			descriptorWrites[1].dstSet = s_Data->DescriptorSets[i];
+			descriptorWrites[1].dstBinding = 2;
+			descriptorWrites[1].dstArrayElement = 0;
+			descriptorWrites[1].descriptorType = vk::DescriptorType::eStorageBufferDynamic;
+			descriptorWrites[1].descriptorCount = 1;
+			descriptorWrites[1].pBufferInfo = &statsInfo;
+
 			s_Device->GetDevice().updateDescriptorSets(static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
 		}
 	}
 
 	void RenderSystem::CreatePipelineLayout() {
 		std::vector<vk::PushConstantRange> pushConstantRanges = {
-			vk::PushConstantRange(vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment, 0, sizeof(PushConstants))
+			vk::PushConstantRange(vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment, 0, sizeof(PushConstants) + sizeof(MeshPushConstants))
 		};
 
+		// Set 1 is the texture table
+		std::array<vk::DescriptorSetLayout, 2> setLayouts = { s_Data->DescriptorSetLayout, TextureSystem::GetDescriptorSetLayout() };
+
 		vk::PipelineLayoutCreateInfo pipelineLayoutInfo;
-		pipelineLayoutInfo.setLayoutCount = 1;
-		pipelineLayoutInfo.pSetLayouts = &s_Data->DescriptorSetLayout;
+		pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+		pipelineLayoutInfo.pSetLayouts = setLayouts.data();
 		pipelineLayoutInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstantRanges.size());
 		pipelineLayoutInfo.pPushConstantRanges = pushConstantRanges.data();
 
 		if(s_Device->GetDevice().createPipelineLayout(&pipelineLayoutInfo, nullptr, &s_Data->PipelineLayout) != vk::Result::eSuccess) {
 			RUI_CORE_ERROR("Failed to create pipeline layout!");
 		}
+
+		vk::PushConstantRange upscalePushConstantRange(vk::ShaderStageFlagBits::eFragment, 0, sizeof(UpscalePushConstants));
+
+		vk::PipelineLayoutCreateInfo upscaleLayoutInfo;
+		upscaleLayoutInfo.setLayoutCount = 1;
+		upscaleLayoutInfo.pSetLayouts = &s_Data->UpscaleDescriptorSetLayout;
+		upscaleLayoutInfo.pushConstantRangeCount = 1;
+		upscaleLayoutInfo.pPushConstantRanges = &upscalePushConstantRange;
+
+		if(s_Device->GetDevice().createPipelineLayout(&upscaleLayoutInfo, nullptr, &s_Data->UpscalePipelineLayout) != vk::Result::eSuccess) {
+			RUI_CORE_ERROR("Failed to create upscale pipeline layout!");
+		}
 	}
 
 	void RenderSystem::CreatePipeline() {
 		auto pipelineConfig = Pipeline::DefaultPipelineConfigInfo(s_SwapChain->Width(), s_SwapChain->Height());
 
-		pipelineConfig->renderPass = s_SwapChain->GetRenderPass();
+		// The scene is rendered at a dynamic resolution
+		pipelineConfig->dynamicStates = { vk::DynamicState::eViewport, vk::DynamicState::eScissor };
+		pipelineConfig->renderPass = s_Data->Graph->GetRenderPass(s_Data->ScenePass);
 		pipelineConfig->pipelineLayout = s_Data->PipelineLayout;
+		// The raymarched quad has no meaningful depth; leaving the cleared
+		// depth alone lets meshes depth test among themselves
+		pipelineConfig->depthStencilInfo.depthTestEnable = false;
+		pipelineConfig->depthStencilInfo.depthWriteEnable = false;
+
+		s_Data->Pipeline = ResourceManager::CreatePipeline("res/shaders/shader.vert.spv", "res/shaders/shader_shapes.frag.spv", pipelineConfig);
+
+		std::unique_ptr<PipelineConfigInfo> meshConfig(Pipeline::DefaultPipelineConfigInfo(s_SwapChain->Width(), s_SwapChain->Height()));
+
+		meshConfig->bindingDescriptions = Mesh::GetBindingDescriptions();
+		meshConfig->attributeDescriptions = Mesh::GetAttributeDescriptions();
+		meshConfig->colorBlendAttachment.blendEnable = false;
+		meshConfig->dynamicStates = { vk::DynamicState::eViewport, vk::DynamicState::eScissor };
+		meshConfig->renderPass = s_Data->Graph->GetRenderPass(s_Data->ScenePass);
+		meshConfig->pipelineLayout = s_Data->PipelineLayout;
+
+		// mesh.frag sizes its texture array by what the device holds
+		uint32_t textureCapacity = TextureSystem::GetCapacity();
+		vk::SpecializationMapEntry capacityEntry(0, 0, sizeof(uint32_t));
+		vk::SpecializationInfo fragmentSpecialization(1, &capacityEntry, sizeof(uint32_t), &textureCapacity);
+		meshConfig->fragmentSpecialization = &fragmentSpecialization;
+
+		s_Data->MeshPipeline = ResourceManager::CreatePipeline("res/shaders/mesh.vert.spv", "res/shaders/mesh.frag.spv", meshConfig.get());
+		s_Data->Particles->CreateDrawPipeline(s_Data->Graph->GetRenderPass(s_Data->ScenePass), s_Data->PipelineLayout);
+
+		std::unique_ptr<PipelineConfigInfo> upscaleConfig(Pipeline::DefaultPipelineConfigInfo(s_SwapChain->Width(), s_SwapChain->Height()));
+
+		upscaleConfig->bindingDescriptions.clear();
+		upscaleConfig->attributeDescriptions.clear();
+		upscaleConfig->colorBlendAttachment.blendEnable = false;
+		upscaleConfig->depthStencilInfo.depthTestEnable = false;
+		upscaleConfig->depthStencilInfo.depthWriteEnable = false;
+		upscaleConfig->renderPass = s_Data->Graph->GetRenderPass(s_Data->UpscalePass);
+		upscaleConfig->pipelineLayout = s_Data->UpscalePipelineLayout;
+
+		s_Data->UpscalePipeline = ResourceManager::CreatePipeline("res/shaders/fullscreen.vert.spv", "res/shaders/upscale.frag.spv", upscaleConfig.get());
+	}
+
+	void RenderSystem::DestroyPipelines() {
+		ResourceManager::Destroy(s_Data->Pipeline);
+		ResourceManager::Destroy(s_Data->MeshPipeline);
+		s_Device->GetDevice().destroyPipelineLayout(s_Data->PipelineLayout, nullptr);
 
-		s_Data->Pipeline = std::make_unique<Pipeline>("res/shaders/shader.vert.spv", "res/shaders/shader_shapes.frag.spv", pipelineConfig);
+		ResourceManager::Destroy(s_Data->UpscalePipeline);
+		s_Device->GetDevice().destroyPipelineLayout(s_Data->UpscalePipelineLayout, nullptr);
 	}
 
 	void RenderSystem::CreateUniformBuffers() {
 		vk::DeviceSize bufferSize = sizeof(UniformBufferObject);
 
-		s_Data->UniformBuffers.resize(s_SwapChain->ImageCount());
-		s_Data->UniformBuffersMemory.resize(s_SwapChain->ImageCount());
-
-		vma::AllocationCreateInfo create_info;
-		create_info.requiredFlags = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
-
-		vma::AllocationInfo info;
-		vma::Allocation alloc;
-		vk::BufferCreateInfo bufferInfo({}, bufferSize, vk::BufferUsageFlagBits::eUniformBuffer, vk::SharingMode::eExclusive);
+		BufferDesc desc;
+		desc.Size = bufferSize;
+		desc.Usage = vk::BufferUsageFlagBits::eUniformBuffer;
+		desc.MemoryProperties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+		desc.Category = MemoryCategory::Uniforms;
 
-		for(size_t i = 0; i < s_SwapChain->ImageCount(); i++) {
-			s_Device->m_Allocator.createBuffer(&bufferInfo, &create_info, &s_Data->UniformBuffers[i], &alloc, &info);
+		s_Data->UniformBuffers.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
+		for(size_t i = 0; i < SwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+			s_Data->UniformBuffers[i] = ResourceManager::CreateBuffer(desc);
 		}
 
-		std::array<vk::DescriptorPoolSize, 1> poolSizes;
+		// Scene sets plus one upscale set per frame in flight
+		std::array<vk::DescriptorPoolSize, 3> poolSizes;
 		poolSizes[0].type = vk::DescriptorType::eUniformBuffer;
-		poolSizes[0].descriptorCount = static_cast<uint32_t>(s_SwapChain->ImageCount());
+		poolSizes[0].descriptorCount = SwapChain::MAX_FRAMES_IN_FLIGHT;
+		poolSizes[1].type = vk::DescriptorType::eCombinedImageSampler;
+		poolSizes[1].descriptorCount = SwapChain::MAX_FRAMES_IN_FLIGHT * 2;
+		poolSizes[2].type = vk::DescriptorType::eStorageBufferDynamic;
+		poolSizes[2].descriptorCount = SwapChain::MAX_FRAMES_IN_FLIGHT;
 
 		vk::DescriptorPoolCreateInfo poolInfo;
 		poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
 		poolInfo.pPoolSizes = poolSizes.data();
-		poolInfo.maxSets = static_cast<uint32_t>(s_SwapChain->ImageCount());
+		poolInfo.maxSets = SwapChain::MAX_FRAMES_IN_FLIGHT * 2;
 
 		if(s_Device->GetDevice().createDescriptorPool(&poolInfo, nullptr, &s_Data->DescriptorPool) != vk::Result::eSuccess) {
 			RUI_CORE_ERROR("Failed to create descriptor pool!");
 		}
 	}
 
-	void RenderSystem::CreateCommandBuffers() {
-		s_Data->CommandBuffers.resize(s_SwapChain->ImageCount());
-		vk::CommandBufferAllocateInfo allocInfo;
-		allocInfo.level = vk::CommandBufferLevel::ePrimary;
-		allocInfo.commandPool = s_Device->GetCommandPool();
-		allocInfo.commandBufferCount = static_cast<uint32_t>(s_Data->CommandBuffers.size());
+	void RenderSystem::CreateRaymarchStatsBuffer() {
+		BufferDesc desc;
+		desc.Size = RAYMARCH_STATS_STRIDE * SwapChain::MAX_FRAMES_IN_FLIGHT;
+		desc.Usage = vk::BufferUsageFlagBits::eStorageBuffer;
+		desc.MemoryProperties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+		desc.Category = MemoryCategory::Uniforms;
+		desc.Mapped = true;
 
-		if(s_Device->GetDevice().allocateCommandBuffers(&allocInfo, s_Data->CommandBuffers.data()) != vk::Result::eSuccess) {
-			RUI_CORE_ERROR("Failed to allocate command buffers!");
+		s_Data->RaymarchStatsBuffer = ResourceManager::CreateBuffer(desc);
+		memset(ResourceManager::Get(s_Data->RaymarchStatsBuffer)->Mapped, 0, static_cast<size_t>(desc.Size));
+	}
+
+	void RenderSystem::CreateRenderGraph() {
+		s_Data->ConePrepass.reset();
+		s_Data->Graph.reset();
+
+		if(!s_Data->TargetSampler) {
+			vk::SamplerCreateInfo samplerInfo;
+			samplerInfo.magFilter = vk::Filter::eLinear;
+			samplerInfo.minFilter = vk::Filter::eLinear;
+			samplerInfo.mipmapMode = vk::SamplerMipmapMode::eNearest;
+			samplerInfo.addressModeU = vk::SamplerAddressMode::eClampToEdge;
+			samplerInfo.addressModeV = vk::SamplerAddressMode::eClampToEdge;
+			samplerInfo.addressModeW = vk::SamplerAddressMode::eClampToEdge;
+			samplerInfo.maxLod = 0.0f;
+
+			if(s_Device->GetDevice().createSampler(&samplerInfo, nullptr, &s_Data->TargetSampler) != vk::Result::eSuccess) {
+				RUI_CORE_ERROR("Failed to create render target sampler!");
+			}
 		}
 
-		s_Data->vertices = {
-			{{0.0f, 0.0f}, {1.0f, 0.0f}},
-			{{1.0f, 0.0f}, {0.0f, 1.0f}},
-			{{1.0f, 1.0f}, {0.0f, 0.0f}},
-			{{0.0f, 1.0f}, {1.0f, 1.0f}}
-		};
+		vk::Extent2D outputExtent = s_SwapChain->GetSwapChainExtent();
+		vk::Extent2D targetExtent = s_Data->Resolution.GetTargetExtent(outputExtent);
+		s_Data->TargetExtent = targetExtent;
 
-		s_Data->indices = {
-			0, 1, 2, 2, 3, 0
-		};
+		std::vector<vk::Image> swapChainImages;
+		std::vector<vk::ImageView> swapChainViews;
+		for(size_t i = 0; i < s_SwapChain->ImageCount(); i++) {
+			swapChainImages.push_back(s_SwapChain->GetImage(static_cast<int>(i)));
+			swapChainViews.push_back(s_SwapChain->GetImageView(static_cast<int>(i)));
+		}
 
-		vk::BufferCreateInfo buffer_info;
-		buffer_info.size = sizeof(s_Data->vertices[0]) * s_Data->vertices.size();
-		buffer_info.usage = vk::BufferUsageFlagBits::eVertexBuffer;
-		vma::AllocationCreateInfo create_info;
-		create_info.requiredFlags = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+		s_Data->Graph = std::make_unique<RenderGraph>();
+		RenderGraph& graph = *s_Data->Graph;
+
+		RenderGraphResource coneDistance = graph.CreateImage("ConeDistance", { ConePrepass::GetTileExtent(targetExtent), ConePrepass::FORMAT });
+		RenderGraphResource sceneColor = graph.CreateImage("SceneColor", { targetExtent, s_SwapChain->GetSwapChainImageFormat() });
+		RenderGraphResource sceneDepth = graph.CreateImage("SceneDepth", { targetExtent, s_SwapChain->FindDepthFormat() });
+		RenderGraphResource backbuffer = graph.ImportImage("Backbuffer", { outputExtent, s_SwapChain->GetSwapChainImageFormat() },
+														   swapChainImages, swapChainViews, vk::ImageLayout::ePresentSrcKHR);
+
+		// Bound state of the frame is shared by the prepass and the scene pass
+		s_Data->PrepassPass = graph.AddPass("ConePrepass", [&](RenderGraphBuilder& builder) {
+			builder.WriteColor(coneDistance, vk::AttachmentLoadOp::eDontCare);
+		}, [](vk::CommandBuffer commandBuffer, uint32_t, uint32_t) {
+			s_Data->ConePrepass->Record(commandBuffer, s_Data->RenderExtent);
+		});
+
+		s_Data->ScenePass = graph.AddPass("Scene", [&](RenderGraphBuilder& builder) {
+			builder.Read(coneDistance);
+			builder.WriteColor(sceneColor, vk::AttachmentLoadOp::eClear, std::array<float, 4>{ 0.3f, 0.1f, 0.35f, 1.0f });
+			builder.WriteDepth(sceneDepth);
+		}, [](vk::CommandBuffer commandBuffer, uint32_t frame, uint32_t) {
+			vk::Extent2D renderExtent = s_Data->RenderExtent;
+			s_Data->Timer->Timestamp(commandBuffer, frame, 1);
+
+			vk::Viewport viewport(0.0f, 0.0f, static_cast<float>(renderExtent.width), static_cast<float>(renderExtent.height), 0.0f, 1.0f);
+			vk::Rect2D scissor(vk::Offset2D(0, 0), renderExtent);
+			commandBuffer.setViewport(0, 1, &viewport);
+			commandBuffer.setScissor(0, 1, &scissor);
+
+			ResourceManager::Get(s_Data->Pipeline)->Bind(commandBuffer);
+			commandBuffer.drawIndexed(static_cast<uint32_t>(s_Data->indices.size()), 1, 0, 0, 0);
 
-		vma::AllocationInfo info;
-		vma::Allocation alloc;
+			if(!s_Data->MeshDraws.empty()) {
+				ResourceManager::Get(s_Data->MeshPipeline)->Bind(commandBuffer);
 
-		s_Device->m_Allocator.createBuffer(&buffer_info, &create_info, &s_Data->vertexBuffer, &alloc, &info);
+				for(const MeshDraw& draw : s_Data->MeshDraws) {
+					MeshPushConstants push;
+					push.iModel = draw.Transform * draw.Geometry->GetDequantizeTransform();
+					push.iTexture = draw.Albedo ? draw.Albedo->GetSlot() : TextureSystem::DEFAULT_TEXTURE_SLOT;
+					commandBuffer.pushConstants(s_Data->PipelineLayout, vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment, sizeof(PushConstants), sizeof(MeshPushConstants), &push);
 
-		void* a;
+					draw.Geometry->Bind(commandBuffer);
+					draw.Geometry->Draw(commandBuffer, draw.Lod);
+				}
+			}
 
-		s_Device->m_Allocator.mapMemory(alloc, &a);
-		memcpy(a, s_Data->vertices.data(), sizeof(s_Data->vertices[0]) * s_Data->vertices.size());
-		s_Device->m_Allocator.unmapMemory(alloc);
-		//------------------------------//
-		vk::BufferCreateInfo buffer_info2;
-		buffer_info2.size = sizeof(s_Data->indices[0]) * s_Data->indices.size();
-		buffer_info2.usage = vk::BufferUsageFlagBits::eIndexBuffer;
-		vma::AllocationCreateInfo create_info2;
-		create_info2.requiredFlags = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+			s_Data->Particles->Draw(commandBuffer);
 
-		vma::AllocationInfo info2;
-		vma::Allocation alloc2;
+			s_Data->Timer->Timestamp(commandBuffer, frame, 2);
+		});
 
-		s_Device->m_Allocator.createBuffer(&buffer_info2, &create_info2, &s_Data->indexBuffer, &alloc2, &info2);
+		s_Data->UpscalePass = graph.AddPass("Upscale", [&](RenderGraphBuilder& builder) {
+			builder.Read(sceneColor);
+			builder.WriteColor(backbuffer, vk::AttachmentLoadOp::eDontCare);
+		}, [](vk::CommandBuffer commandBuffer, uint32_t frame, uint32_t) {
+			vk::Extent2D renderExtent = s_Data->RenderExtent;
+			vk::Extent2D targetExtent = s_Data->TargetExtent;
 
-		void* a2;
+			ResourceManager::Get(s_Data->UpscalePipeline)->Bind(commandBuffer);
+			commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, s_Data->UpscalePipelineLayout, 0, 1, &s_Data->UpscaleDescriptorSets[frame], 0, nullptr);
 
-		s_Device->m_Allocator.mapMemory(alloc2, &a2);
-		memcpy(a2, s_Data->indices.data(), sizeof(s_Data->indices[0]) * s_Data->indices.size());
-		s_Device->m_Allocator.unmapMemory(alloc2);
-		const VkDeviceSize offsets[1] = { 0 };
+			UpscalePushConstants upscale;
+			upscale.iUVScale = {
+				static_cast<float>(renderExtent.width) / targetExtent.width,
+				static_cast<float>(renderExtent.height) / targetExtent.height
+			};
+			upscale.iUVClamp = {
+				(renderExtent.width - 0.5f) / targetExtent.width,
+				(renderExtent.height - 0.5f) / targetExtent.height
+			};
 
-		for(size_t i = 0; i < s_Data->CommandBuffers.size(); i++) {
-			auto commandBuffer = s_Data->CommandBuffers[i];
-			vk::CommandBufferBeginInfo beginInfo;
-			commandBuffer.begin(&beginInfo);
+			commandBuffer.pushConstants(s_Data->UpscalePipelineLayout, vk::ShaderStageFlagBits::eFragment, 0, sizeof(UpscalePushConstants), &upscale);
+			commandBuffer.draw(3, 1, 0, 0);
 
-			vk::RenderPassBeginInfo renderPassInfo;
-			renderPassInfo.renderPass = s_SwapChain->GetRenderPass();
-			renderPassInfo.framebuffer = s_SwapChain->GetFrameBuffer(static_cast<int>(i));
+			s_Data->Timer->Timestamp(commandBuffer, frame, 3);
+		});
 
-			renderPassInfo.renderArea.offset = vk::Offset2D(0, 0);
-			renderPassInfo.renderArea.extent = s_SwapChain->GetSwapChainExtent();
+		graph.Compile(SwapChain::MAX_FRAMES_IN_FLIGHT);
 
-			vk::ClearColorValue ab = std::array<float, 4>{0.8f, 0.4f, 0.7f, 0.5f};
+		s_Data->ConePrepass = ConePrepass::Create(targetExtent, graph.GetRenderPass(s_Data->PrepassPass), s_Data->PipelineLayout);
 
-			std::array<vk::ClearValue, 2> clearValues{};
-			clearValues[0].color = ab;
-			clearValues[1].depthStencil = vk::ClearDepthStencilValue(1.0f, 0);
-			renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
-			renderPassInfo.pClearValues = clearValues.data();
+		for(size_t i = 0; i < SwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+			vk::DescriptorImageInfo coneInfo;
+			coneInfo.sampler = s_Data->ConePrepass->GetSampler();
+			coneInfo.imageView = graph.GetImageView(coneDistance, static_cast<uint32_t>(i));
+			coneInfo.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
 
-			commandBuffer.beginRenderPass(&renderPassInfo, vk::SubpassContents::eInline);
+			vk::DescriptorImageInfo sceneInfo;
+			sceneInfo.sampler = s_Data->TargetSampler;
+			sceneInfo.imageView = graph.GetImageView(sceneColor, static_cast<uint32_t>(i));
+			sceneInfo.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
 
-			s_Data->Pipeline->Bind(commandBuffer);
-			commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, s_Data->PipelineLayout, 0, 1, &s_Data->DescriptorSets[i], 0, nullptr);
-			PushConstants tmp= { {1280.0f, 720.0f}, 0.0f };
-			RUI_CORE_ERROR("Size of PushConstants: {0}", sizeof(PushConstants));
-			commandBuffer.pushConstants(RenderSystem::GetData().PipelineLayout, vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment, 0, sizeof(PushConstants), &tmp);
-			commandBuffer.bindVertexBuffers(0, 1, &s_Data->vertexBuffer, offsets);
-			commandBuffer.bindIndexBuffer(s_Data->indexBuffer, 0, vk::IndexType::eUint32);
+			std::array<vk::WriteDescriptorSet, 2> descriptorWrites{};
 
+			descriptorWrites[0].dstSet = s_Data->DescriptorSets[i];
+			descriptorWrites[0].dstBinding = 1;
+			descriptorWrites[0].dstArrayElement = 0;
+			descriptorWrites[0].descriptorType = vk::DescriptorType::eCombinedImageSampler;
+			descriptorWrites[0].descriptorCount = 1;
+			descriptorWrites[0].pImageInfo = &coneInfo;
 
-			commandBuffer.drawIndexed(static_cast<uint32_t>(s_Data->indices.size()), 1, 0, 0, 0);
+			descriptorWrites[1].dstSet = s_Data->UpscaleDescriptorSets[i];
+			descriptorWrites[1].dstBinding = 0;
+			descriptorWrites[1].dstArrayElement = 0;
+			descriptorWrites[1].descriptorType = vk::DescriptorType::eCombinedImageSampler;
+			descriptorWrites[1].descriptorCount = 1;
+			descriptorWrites[1].pImageInfo = &sceneInfo;
 
-			commandBuffer.endRenderPass();
-			commandBuffer.end();
+			s_Device->GetDevice().updateDescriptorSets(static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
 		}
 	}
 
-	void RenderSystem::PrepareCompute() {
-		vk::ComputePipelineCreateInfo info;
-		//info.flags = vk::PipelineCreateFlagBits::e
-		//RenderSystem::GetDevice().GetDevice().createComputePipeline({},)
+	void RenderSystem::CreateGeometryBuffers() {
+		s_Data->vertices = {
+			{{0.0f, 0.0f}, {1.0f, 0.0f}},
+			{{1.0f, 0.0f}, {0.0f, 1.0f}},
+			{{1.0f, 1.0f}, {0.0f, 0.0f}},
+			{{0.0f, 1.0f}, {1.0f, 1.0f}}
+		};
+
+		s_Data->indices = {
+			0, 1, 2, 2, 3, 0
+		};
+
+		BufferDesc desc;
+		desc.MemoryProperties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+		desc.Category = MemoryCategory::Geometry;
+		desc.Mapped = true;
+
+		desc.Size = sizeof(s_Data->vertices[0]) * s_Data->vertices.size();
+		desc.Usage = vk::BufferUsageFlagBits::eVertexBuffer;
+		s_Data->VertexBuffer = ResourceManager::CreateBuffer(desc);
+		memcpy(ResourceManager::Get(s_Data->VertexBuffer)->Mapped, s_Data->vertices.data(), desc.Size);
+		//------------------------------//
+		desc.Size = sizeof(s_Data->indices[0]) * s_Data->indices.size();
+		desc.Usage = vk::BufferUsageFlagBits::eIndexBuffer;
+		s_Data->IndexBuffer = ResourceManager::CreateBuffer(desc);
+		memcpy(ResourceManager::Get(s_Data->IndexBuffer)->Mapped, s_Data->indices.data(), desc.Size);
+	}
+
+	void RenderSystem::CreateCommandBuffers() {
+		// One per frame slot, recorded again once the slot's timeline value is reached
+		s_Data->CommandBuffers.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
+		vk::CommandBufferAllocateInfo allocInfo;
+		allocInfo.level = vk::CommandBufferLevel::ePrimary;
+		allocInfo.commandPool = s_Device->GetCommandPool();
+		allocInfo.commandBufferCount = static_cast<uint32_t>(s_Data->CommandBuffers.size());
+
+		if(s_Device->GetDevice().allocateCommandBuffers(&allocInfo, s_Data->CommandBuffers.data()) != vk::Result::eSuccess) {
+			RUI_CORE_ERROR("Failed to allocate command buffers!");
+		}
 	}
 }
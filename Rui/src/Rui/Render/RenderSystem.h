@@ -3,43 +3,132 @@
 #include <vulkan/vulkan.hpp>
 
 #include "Pipeline.h"
+#include "ConePrepass.h"
+#include "DynamicResolution.h"
+#include "FrameCapture.h"
+#include "GpuTimer.h"
+#include "Mesh.h"
+#include "ParticleSystem.h"
+#include "RaymarchBenchmark.h"
+#include "RenderGraph.h"
+#include "ResourceManager.h"
+#include "TextureSystem.h"
 #include "Rui/Core/SwapChain.h"
+#include "Rui/Core/Timestep.h"
+#include "Rui/Math/Geometry.h"
 
 namespace Rui {
 	class RenderSystem {
 	public:
-        struct UniformBufferObject {
+        // Aligned for the SIMD glm types; the GPU copies of these must keep
+        // std140 / push constant layout whatever RUI_SIMD is set to
+        struct alignas(16) UniformBufferObject {
             glm::mat4 Model;
             glm::mat4 View;
             glm::mat4 Proj;
         };
+        static_assert(sizeof(UniformBufferObject) == 192, "Uniform buffer layout changed");
 
         struct PushConstants {
             glm::vec2 iResolution;
             float iTime;
+            uint32_t iFlags;
+        };
+        static_assert(sizeof(PushConstants) == 16, "Push constant layout changed");
+
+        // Behind PushConstants in the same range, for mesh.vert and mesh.frag
+        struct alignas(16) MeshPushConstants {
+            glm::mat4 iModel;
+            // Slot in the TextureSystem's array
+            uint32_t iTexture;
+        };
+        static_assert(sizeof(MeshPushConstants) == 80, "Mesh push constant layout changed");
+
+        struct MeshDraw {
+            Ref<Mesh> Geometry;
+            glm::mat4 Transform;
+            uint32_t Lod;
+            Ref<Texture> Albedo;
+        };
+
+        struct UpscalePushConstants {
+            glm::vec2 iUVScale;
+            glm::vec2 iUVClamp;
+        };
+
+        // Each frame in flight gets its own stats slot, bound with a dynamic offset
+        static constexpr vk::DeviceSize RAYMARCH_STATS_STRIDE = 256;
+
+        // GPU time of the last completed frame, per pass
+        struct GpuTimings {
+            double PrepassMs = 0.0;
+            double ScenePassMs = 0.0;
+            double UpscaleMs = 0.0;
+            double TotalMs = 0.0;
         };
 
         struct RenderData {
             vk::DescriptorSetLayout DescriptorSetLayout;
 
-            std::unique_ptr<Pipeline> ComputePipeline;
-            vk::PipelineLayout ComputePipelineLayout;
-
-            std::unique_ptr<Pipeline> Pipeline;
+            PipelineHandle Pipeline;
             vk::PipelineLayout PipelineLayout;
 
             std::vector<vk::CommandBuffer> CommandBuffers;
 
-            std::vector<vk::Buffer> UniformBuffers;
-            std::vector<vk::DeviceMemory> UniformBuffersMemory;
+            std::vector<BufferHandle> UniformBuffers;
 
             vk::DescriptorPool DescriptorPool;
             std::vector<vk::DescriptorSet> DescriptorSets;
 
+            // The scene is rendered into the graph's scene image at a dynamic
+            // resolution and upscaled into the swapchain image by UpscalePipeline
+            std::unique_ptr<RenderGraph> Graph;
+            RenderGraphPass PrepassPass = 0;
+            RenderGraphPass ScenePass = 0;
+            RenderGraphPass UpscalePass = 0;
+            vk::Extent2D TargetExtent;
+            vk::Sampler TargetSampler;
+            DynamicResolution Resolution;
+
+            PipelineHandle UpscalePipeline;
+            vk::PipelineLayout UpscalePipelineLayout;
+            vk::DescriptorSetLayout UpscaleDescriptorSetLayout;
+            std::vector<vk::DescriptorSet> UpscaleDescriptorSets;
+
+            std::unique_ptr<GpuTimer> Timer;
+            std::vector<double> GpuIntervals;
+            GpuTimings LastGpuTimings;
+
+            // Submitted during the frame, drawn over the raymarched scene
+            PipelineHandle MeshPipeline;
+            std::vector<MeshDraw> MeshDraws;
+            MeshLodSettings MeshLod;
+            // Of the last frame, for picking levels of detail and culling
+            glm::vec3 CameraPosition{ 0.0f };
+            Frustum CameraFrustum;
+
+            // Simulated ahead of the graph, drawn in the scene pass
+            std::unique_ptr<ParticleSystem> Particles;
+
+            std::unique_ptr<ConePrepass> ConePrepass;
+            bool ConeMarching = true;
+            bool CollectRaymarchStats = false;
+
+            BufferHandle RaymarchStatsBuffer;
+            std::array<uint32_t, SwapChain::MAX_FRAMES_IN_FLIGHT> RaymarchStatsFlags{};
+            RaymarchStats LastRaymarchStats;
+            RaymarchBenchmark Benchmark;
+
             std::vector<uint32_t> indices;
         	std::vector<Vertex> vertices;
-            vk::Buffer vertexBuffer;
-            vk::Buffer indexBuffer;
+            BufferHandle VertexBuffer;
+            BufferHandle IndexBuffer;
+
+            // Copies of the presented frames, written out on worker threads
+            std::unique_ptr<FrameCapture> Capture;
+
+            // Of the frame being recorded, for the graph's passes
+            vk::Extent2D RenderExtent;
 
             uint32_t ImageIndex = 0;
             bool IsFrameStarted = false;
@@ -48,7 +137,37 @@ namespace Rui {
         static void Init();
         static void Dispose();
 
-        static void DrawTriangle();
+        static void DrawTriangle(const Timestep& ts);
+
+        // Draws the mesh in the next frame's scene pass; `transform` is its
+        // model matrix in scene space. Meshes whose bounds are outside the
+        // last frame's view are dropped. The level of detail is picked from
+        // the mesh's projected error. `lod` keeps the level of this instance from
+        // frame to frame for hysteresis: pass the same variable every frame,
+        // or nullptr to pick without. `texture` is sampled with the mesh's
+        // texture coordinates, which are taken to span it once across the
+        // mesh; its mips are streamed by the mesh's size on screen.
+        static void SubmitMesh(const Ref<Mesh>& mesh, const glm::mat4& transform, uint32_t* lod = nullptr, const Ref<Texture>& texture = nullptr);
+        inline static void SetMeshLodSettings(const MeshLodSettings& settings) { s_Data->MeshLod = settings; }
+        inline static const MeshLodSettings& GetMeshLodSettings() { return s_Data->MeshLod; }
+        // View of the last frame in scene space, the one meshes are culled against
+        inline static const Frustum& GetCameraFrustum() { return s_Data->CameraFrustum; }
+
+        static void SetConeMarching(bool enabled);
+        inline static bool IsConeMarching() { return s_Data->ConeMarching; }
+        inline static void SetCollectRaymarchStats(bool enabled) { s_Data->CollectRaymarchStats = enabled; }
+        inline static const RaymarchStats& GetRaymarchStats() { return s_Data->LastRaymarchStats; }
+        static void RunRaymarchBenchmark(uint32_t framesPerMode = 240);
+
+        static void SetDynamicResolution(const DynamicResolutionSettings& settings);
+        inline static const DynamicResolution& GetDynamicResolution() { return s_Data->Resolution; }
+        inline static const GpuTimings& GetGpuTimings() { return s_Data->LastGpuTimings; }
+        inline static ParticleSystem& GetParticles() { return *s_Data->Particles; }
+
+        // Frames from the next one on go to `settings.Path`, see FrameCapture
+        inline static void StartCapture(const CaptureSettings& settings) { s_Data->Capture->Start(settings); }
+        inline static void StopCapture() { s_Data->Capture->Stop(); }
+        inline static FrameCapture& GetCapture() { return *s_Data->Capture; }
 
         inline static RenderData& GetData()      { return *s_Data; }
         inline static Device&     GetDevice()    { return *s_Device; }
@@ -58,10 +177,12 @@ namespace Rui {
         static void CreateDescriptorSets();
         static void CreatePipelineLayout();
         static void CreatePipeline();
+        static void DestroyPipelines();
         static void CreateUniformBuffers();
+        static void CreateRaymarchStatsBuffer();
+        static void CreateRenderGraph();
+        static void CreateGeometryBuffers();
         static void CreateCommandBuffers();
-
-		static void PrepareCompute();
     private:
         static std::unique_ptr<RenderData> s_Data;
         static std::unique_ptr<Device>     s_Device;
@@ -0,0 +1,229 @@
+#include "ResourceManager.h"
+
+#include "Rui/Core/Application.h"
+
+#include <deque>
+
+namespace Rui {
+    namespace {
+        // Whichever members are set get destroyed
+        struct PendingDeletion {
+            vk::Buffer Buffer;
+            vk::Image Image;
+            vma::Allocation Allocation;
+            vk::ImageView View;
+            vk::Pipeline Pipeline;
+            vk::Framebuffer Framebuffer;
+            vk::Sampler Sampler;
+            // Graphics timeline value after which the GPU is done with it
+            uint64_t Value = 0;
+        };
+
+        struct ResourceManagerData {
+            HandlePool<BufferResource> Buffers;
+            HandlePool<ImageResource> Images;
+            HandlePool<PipelineResource> Pipelines;
+
+            // In timeline order, since values only ever grow
+            std::deque<PendingDeletion> Deletions;
+        };
+    }
+
+    static std::unique_ptr<ResourceManagerData> s_Data;
+
+    static void Flush(const PendingDeletion& deletion) {
+        Device& device = RenderSystem::GetDevice();
+
+        if(deletion.Framebuffer) device.GetDevice().destroyFramebuffer(deletion.Framebuffer, nullptr);
+        if(deletion.Pipeline) device.GetDevice().destroyPipeline(deletion.Pipeline, nullptr);
+        if(deletion.Sampler) device.GetDevice().destroySampler(deletion.Sampler, nullptr);
+        if(deletion.View) device.GetDevice().destroyImageView(deletion.View, nullptr);
+        if(deletion.Image) device.GetAllocator().DestroyImage(deletion.Image, deletion.Allocation);
+        if(deletion.Buffer) device.GetAllocator().DestroyBuffer(deletion.Buffer, deletion.Allocation);
+    }
+
+    static void Defer(PendingDeletion deletion) {
+        // Before Init or after Shutdown nothing is in flight
+        if(!s_Data) {
+            Flush(deletion);
+            return;
+        }
+
+        // Whatever is being recorded now goes into the next submission
+        deletion.Value = RenderSystem::GetDevice().GetGraphicsTimeline().GetPendingValue();
+        s_Data->Deletions.push_back(deletion);
+    }
+
+    void ResourceManager::Init() {
+        s_Data = std::make_unique<ResourceManagerData>();
+    }
+
+    void ResourceManager::Shutdown() {
+        if(!s_Data) return;
+
+        RenderSystem::GetDevice().GetDevice().waitIdle();
+
+        if(size_t live = s_Data->Buffers.GetCount() + s_Data->Images.GetCount() + s_Data->Pipelines.GetCount(); live > 0) {
+            RUI_CORE_WARN("Destroying {0} buffers, {1} images and {2} pipelines still held by handles",
+                          s_Data->Buffers.GetCount(), s_Data->Images.GetCount(), s_Data->Pipelines.GetCount());
+        }
+
+        s_Data->Buffers.ForEach([](BufferHandle handle, BufferResource&) { Destroy(handle); });
+        s_Data->Images.ForEach([](ImageHandle handle, ImageResource&) { Destroy(handle); });
+        s_Data->Pipelines.ForEach([](PipelineHandle handle, PipelineResource&) { Destroy(handle); });
+
+        for(const PendingDeletion& deletion : s_Data->Deletions) {
+            Flush(deletion);
+        }
+
+        s_Data.reset();
+    }
+
+    void ResourceManager::Update() {
+        QueueTimeline& timeline = RenderSystem::GetDevice().GetGraphicsTimeline();
+
+        while(!s_Data->Deletions.empty() && timeline.IsComplete(s_Data->Deletions.front().Value)) {
+            Flush(s_Data->Deletions.front());
+            s_Data->Deletions.pop_front();
+        }
+    }
+
+    BufferHandle ResourceManager::CreateBuffer(const BufferDesc& desc) {
+        vk::BufferCreateInfo bufferInfo({}, desc.Size, desc.Usage, vk::SharingMode::eExclusive);
+
+        BufferResource buffer;
+        buffer.Size = desc.Size;
+
+        void* mapped = nullptr;
+        if(RenderSystem::GetDevice().GetAllocator().CreateBuffer(bufferInfo, desc.MemoryProperties, desc.Category,
+                                                                 &buffer.Buffer, &buffer.Allocation, desc.Mapped ? &mapped : nullptr) != vk::Result::eSuccess) {
+            return {};
+        }
+
+        buffer.Mapped = static_cast<std::byte*>(mapped);
+        return s_Data->Buffers.Create(buffer);
+    }
+
+    ImageHandle ResourceManager::CreateImage(const ImageDesc& desc) {
+        Device& device = RenderSystem::GetDevice();
+
+        vk::ImageCreateInfo imageInfo;
+        imageInfo.imageType = vk::ImageType::e2D;
+        imageInfo.extent = vk::Extent3D(desc.Extent.width, desc.Extent.height, 1);
+        imageInfo.mipLevels = desc.MipLevels;
+        imageInfo.arrayLayers = 1;
+        imageInfo.format = desc.Format;
+        imageInfo.tiling = vk::ImageTiling::eOptimal;
+        imageInfo.initialLayout = vk::ImageLayout::eUndefined;
+        imageInfo.usage = desc.Usage;
+        imageInfo.samples = vk::SampleCountFlagBits::e1;
+        imageInfo.sharingMode = vk::SharingMode::eExclusive;
+
+        ImageResource image;
+        image.Format = desc.Format;
+        image.Extent = desc.Extent;
+        image.MipLevels = desc.MipLevels;
+
+        if(device.GetAllocator().CreateImage(imageInfo, vk::MemoryPropertyFlagBits::eDeviceLocal, desc.Category, &image.Image, &image.Allocation) != vk::Result::eSuccess) {
+            return {};
+        }
+
+        vk::ImageViewCreateInfo viewInfo;
+        viewInfo.image = image.Image;
+        viewInfo.viewType = vk::ImageViewType::e2D;
+        viewInfo.format = desc.Format;
+        viewInfo.subresourceRange = vk::ImageSubresourceRange(desc.Aspect, 0, desc.MipLevels, 0, 1);
+
+        if(device.GetDevice().createImageView(&viewInfo, nullptr, &image.View) != vk::Result::eSuccess) {
+            RUI_CORE_ERROR("Failed to create image view!");
+            device.GetAllocator().DestroyImage(image.Image, image.Allocation);
+            return {};
+        }
+
+        return s_Data->Images.Create(image);
+    }
+
+    PipelineHandle ResourceManager::CreatePipeline(const std::string& vertPath, const std::string& fragPath, PipelineConfigInfo* config) {
+        return s_Data->Pipelines.Create(std::make_unique<Pipeline>(vertPath, fragPath, config));
+    }
+
+    PipelineHandle ResourceManager::CreatePipeline(const std::string& compPath, vk::PipelineLayout layout) {
+        return s_Data->Pipelines.Create(std::make_unique<Pipeline>(compPath, layout));
+    }
+
+    BufferResource* ResourceManager::Get(BufferHandle handle) {
+        return s_Data->Buffers.Get(handle);
+    }
+
+    ImageResource* ResourceManager::Get(ImageHandle handle) {
+        return s_Data->Images.Get(handle);
+    }
+
+    Pipeline* ResourceManager::Get(PipelineHandle handle) {
+        PipelineResource* resource = s_Data->Pipelines.Get(handle);
+        return resource ? resource->Pipeline.get() : nullptr;
+    }
+
+    void ResourceManager::Destroy(BufferHandle handle) {
+        BufferResource buffer;
+        if(s_Data->Buffers.Release(handle, buffer)) {
+            DestroyLater(buffer.Buffer, buffer.Allocation);
+        }
+    }
+
+    void ResourceManager::Destroy(ImageHandle handle) {
+        ImageResource image;
+        if(s_Data->Images.Release(handle, image)) {
+            DestroyLater(image.Image, image.Allocation, image.View);
+        }
+    }
+
+    void ResourceManager::Destroy(PipelineHandle handle) {
+        // ~Pipeline defers the Vulkan pipeline itself
+        PipelineResource pipeline;
+        s_Data->Pipelines.Release(handle, pipeline);
+    }
+
+    void ResourceManager::DestroyLater(vk::Buffer buffer, vma::Allocation allocation) {
+        PendingDeletion deletion;
+        deletion.Buffer = buffer;
+        deletion.Allocation = allocation;
+        Defer(deletion);
+    }
+
+    void ResourceManager::DestroyLater(vk::Image image, vma::Allocation allocation, vk::ImageView view) {
+        PendingDeletion deletion;
+        deletion.Image = image;
+        deletion.Allocation = allocation;
+        deletion.View = view;
+        Defer(deletion);
+    }
+
+    void ResourceManager::DestroyLater(vk::ImageView view) {
+        PendingDeletion deletion;
+        deletion.View = view;
+        Defer(deletion);
+    }
+
+    void ResourceManager::DestroyLater(vk::Pipeline pipeline) {
+        PendingDeletion deletion;
+        deletion.Pipeline = pipeline;
+        Defer(deletion);
+    }
+
+    void ResourceManager::DestroyLater(vk::Framebuffer framebuffer) {
+        PendingDeletion deletion;
+        deletion.Framebuffer = framebuffer;
+        Defer(deletion);
+    }
+
+    void ResourceManager::DestroyLater(vk::Sampler sampler) {
+        PendingDeletion deletion;
+        deletion.Sampler = sampler;
+        Defer(deletion);
+    }
+
+    size_t ResourceManager::GetPendingCount() {
+        return s_Data->Deletions.size();
+    }
+}
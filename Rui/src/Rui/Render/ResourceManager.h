@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Handle.h"
+#include "Pipeline.h"
+#include "Rui/Core/SwapChain.h"
+
+namespace Rui {
+    struct BufferDesc {
+        vk::DeviceSize Size = 0;
+        vk::BufferUsageFlags Usage;
+        vk::MemoryPropertyFlags MemoryProperties = vk::MemoryPropertyFlagBits::eDeviceLocal;
+        MemoryCategory Category = MemoryCategory::Geometry;
+        // Persistently map host visible memory
+        bool Mapped = false;
+    };
+
+    struct ImageDesc {
+        vk::Extent2D Extent;
+        vk::Format Format = vk::Format::eUndefined;
+        vk::ImageUsageFlags Usage;
+        vk::ImageAspectFlags Aspect = vk::ImageAspectFlagBits::eColor;
+        uint32_t MipLevels = 1;
+        MemoryCategory Category = MemoryCategory::Attachments;
+    };
+
+    struct BufferResource {
+        vk::Buffer Buffer;
+        vma::Allocation Allocation;
+        vk::DeviceSize Size = 0;
+        std::byte* Mapped = nullptr;
+    };
+
+    struct ImageResource {
+        vk::Image Image;
+        vma::Allocation Allocation;
+        vk::ImageView View;
+        vk::Format Format = vk::Format::eUndefined;
+        vk::Extent2D Extent;
+        uint32_t MipLevels = 1;
+    };
+
+    struct PipelineResource {
+        Scope<Pipeline> Pipeline;
+    };
+
+    using BufferHandle = Handle<BufferResource>;
+    using ImageHandle = Handle<ImageResource>;
+    using PipelineHandle = Handle<PipelineResource>;
+
+    // Owns GPU resources behind generational handles and defers destroying
+    // them until the GPU is done with them.
+    //
+    // Everything destroyed is tagged with the graphics timeline value of the
+    // submission being recorded and goes once the timeline reached it. No
+    // submission still in flight can reference it by then, since the
+    // timeline only grows in submission order. Main thread only.
+    class ResourceManager {
+    public:
+        static void Init();
+        // Waits for the device and destroys everything queued; reports live handles
+        static void Shutdown();
+
+        // Destroys what the GPU is done with; polls, never blocks
+        static void Update();
+
+        static BufferHandle CreateBuffer(const BufferDesc& desc);
+        static ImageHandle CreateImage(const ImageDesc& desc);
+        static PipelineHandle CreatePipeline(const std::string& vertPath, const std::string& fragPath, PipelineConfigInfo* config);
+        static PipelineHandle CreatePipeline(const std::string& compPath, vk::PipelineLayout layout);
+
+        // Returns nullptr for destroyed handles
+        static BufferResource* Get(BufferHandle handle);
+        static ImageResource* Get(ImageHandle handle);
+        static Pipeline* Get(PipelineHandle handle);
+
+        // The handle is invalid right away; the Vulkan objects go once no
+        // frame in flight can use them
+        static void Destroy(BufferHandle handle);
+        static void Destroy(ImageHandle handle);
+        static void Destroy(PipelineHandle handle);
+
+        // For objects not owned through a handle
+        static void DestroyLater(vk::Buffer buffer, vma::Allocation allocation);
+        static void DestroyLater(vk::Image image, vma::Allocation allocation, vk::ImageView view = nullptr);
+        static void DestroyLater(vk::ImageView view);
+        static void DestroyLater(vk::Pipeline pipeline);
+        static void DestroyLater(vk::Framebuffer framebuffer);
+        static void DestroyLater(vk::Sampler sampler);
+
+        // Objects waiting in the deletion queues
+        static size_t GetPendingCount();
+    };
+}
@@ -0,0 +1,9 @@
+#include "Texture.h"
+
+#include "TextureSystem.h"
+
+namespace Rui {
+    Texture::~Texture() {
+        TextureSystem::Release(*this);
+    }
+}
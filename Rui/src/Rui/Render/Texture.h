@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Ktx2.h"
+#include "Rui/Asset/AssetBlob.h"
+#include "Rui/Core/Device.h"
+
+namespace Rui {
+    // Sampled 2D texture owned by the TextureSystem. Only the coarsest mips
+    // are guaranteed to be on the GPU; finer ones are streamed in while the
+    // texture is reported on screen and dropped again under memory pressure.
+    // Shaders index the texture table with GetSlot().
+    class Texture {
+    public:
+        ~Texture();
+
+        Texture(const Texture&) = delete;
+        Texture& operator=(const Texture&) = delete;
+
+        inline uint32_t GetSlot() const { return m_Slot; }
+        inline uint32_t GetWidth() const { return m_Width; }
+        inline uint32_t GetHeight() const { return m_Height; }
+        inline uint32_t GetMipCount() const { return m_MipCount; }
+        // Finest mip on the GPU; equals GetMipCount() until the first upload
+        inline uint32_t GetResidentMip() const { return m_ResidentMip; }
+        inline uint64_t GetResidentBytes() const { return m_TailBytes[m_ResidentMip]; }
+        inline const std::string& GetPath() const { return m_Path; }
+    private:
+        Texture() = default;
+
+        std::string m_Path;
+        // Mips are uploaded straight from the (usually mapped) file
+        AssetHandle m_Source;
+        std::vector<Ktx2Image::Level> m_Levels;
+        bool m_GenerateMips = false;
+
+        vk::Format m_Format = vk::Format::eUndefined;
+        uint32_t m_Width = 0;
+        uint32_t m_Height = 0;
+        uint32_t m_MipCount = 0;
+        // m_TailBytes[i] is the size of mips i to the end
+        std::vector<uint64_t> m_TailBytes;
+
+        // Mips from here on are never evicted
+        uint32_t m_MinResidentMip = 0;
+        uint32_t m_ResidentMip = 0;
+        uint32_t m_TargetMip = 0;
+
+        // Finest mip asked for by ReportUsage this frame and the last frame
+        // anyone asked
+        uint32_t m_FrameRequestMip = 0;
+        uint32_t m_RequestedMip = 0;
+        uint64_t m_LastUsedFrame = 0;
+
+        uint32_t m_Slot = 0;
+        vk::Image m_Image;
+        vma::Allocation m_Allocation;
+        vk::ImageView m_View;
+
+        friend class TextureSystem;
+    };
+}
@@ -0,0 +1,780 @@
+#include "TextureSystem.h"
+
+#include "Rui/Asset/AssetSystem.h"
+#include "Rui/Core/Application.h"
+#include "ResourceManager.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace Rui {
+    namespace {
+        struct StagingBuffer {
+            vk::Buffer Buffer;
+            vma::Allocation Allocation;
+            std::byte* Mapped = nullptr;
+            vk::DeviceSize Size = 0;
+            vk::DeviceSize Used = 0;
+        };
+
+        struct TextureSystemData {
+            TextureStreamingSettings Settings;
+            TextureStreamingStats Stats;
+
+            uint32_t Capacity = 0;
+            vk::Sampler Sampler;
+            vk::DescriptorSetLayout DescriptorSetLayout;
+            vk::DescriptorPool DescriptorPool;
+            std::array<vk::DescriptorSet, SwapChain::MAX_FRAMES_IN_FLIGHT> DescriptorSets;
+
+            std::array<StagingBuffer, SwapChain::MAX_FRAMES_IN_FLIGHT> Staging;
+
+            std::vector<Texture*> Textures;
+            std::unordered_map<std::string, std::weak_ptr<Texture>> Cache;
+            Ref<Texture> DefaultTexture;
+
+            // Per slot, a bit for each frame in flight whose descriptor set
+            // still needs rewriting
+            std::vector<Texture*> Slots;
+            std::vector<uint8_t> DirtySlots;
+            std::vector<uint32_t> FreeSlots;
+
+            uint64_t FrameNumber = 0;
+            vk::CommandBuffer CommandBuffer;
+            uint32_t Frame = 0;
+        };
+    }
+
+    static std::unique_ptr<TextureSystemData> s_Data;
+
+    static constexpr uint8_t ALL_FRAMES = (1 << SwapChain::MAX_FRAMES_IN_FLIGHT) - 1;
+    static constexpr vk::DeviceSize STAGING_ALIGNMENT = 16;
+
+    static void CreateStagingBuffer(vk::DeviceSize size, StagingBuffer& staging) {
+        vk::BufferCreateInfo bufferInfo({}, size, vk::BufferUsageFlagBits::eTransferSrc, vk::SharingMode::eExclusive);
+
+        void* mapped = nullptr;
+        RenderSystem::GetDevice().GetAllocator().CreateBuffer(bufferInfo, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+                                                              MemoryCategory::Staging, &staging.Buffer, &staging.Allocation, &mapped);
+        staging.Mapped = static_cast<std::byte*>(mapped);
+        staging.Size = size;
+        staging.Used = 0;
+    }
+
+    static void DestroyStagingBuffer(StagingBuffer& staging) {
+        if(!staging.Buffer) return;
+
+        RenderSystem::GetDevice().GetAllocator().DestroyBuffer(staging.Buffer, staging.Allocation);
+        staging = {};
+    }
+
+    // Copies `size` bytes into staging memory of the current frame. Uploads
+    // that do not fit get a buffer of their own, destroyed with the frame.
+    static std::pair<vk::Buffer, vk::DeviceSize> Stage(const std::byte* data, size_t size) {
+        StagingBuffer& staging = s_Data->Staging[s_Data->Frame];
+        vk::DeviceSize offset = (staging.Used + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+
+        if(offset + size <= staging.Size) {
+            std::memcpy(staging.Mapped + offset, data, size);
+            staging.Used = offset + size;
+            return { staging.Buffer, offset };
+        }
+
+        StagingBuffer dedicated;
+        CreateStagingBuffer(size, dedicated);
+        std::memcpy(dedicated.Mapped, data, size);
+
+        ResourceManager::DestroyLater(dedicated.Buffer, dedicated.Allocation);
+
+        return { dedicated.Buffer, 0 };
+    }
+
+    static void Transition(vk::CommandBuffer commandBuffer, vk::Image image, uint32_t baseMip, uint32_t mipCount,
+                           vk::ImageLayout oldLayout, vk::ImageLayout newLayout,
+                           vk::PipelineStageFlags srcStage, vk::AccessFlags srcAccess,
+                           vk::PipelineStageFlags dstStage, vk::AccessFlags dstAccess) {
+        vk::ImageMemoryBarrier barrier;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange = vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, baseMip, mipCount, 0, 1);
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstAccessMask = dstAccess;
+
+        commandBuffer.pipelineBarrier(srcStage, dstStage, {}, 0, nullptr, 0, nullptr, 1, &barrier);
+    }
+
+    static inline uint32_t MipExtent(uint32_t size, uint32_t mip) {
+        return std::max(size >> mip, 1u);
+    }
+
+    // Records a one off command buffer and waits for it, used during Init
+    static void SubmitImmediate(const std::function<void(vk::CommandBuffer)>& record) {
+        Device& device = RenderSystem::GetDevice();
+
+        vk::CommandBufferAllocateInfo allocInfo;
+        allocInfo.level = vk::CommandBufferLevel::ePrimary;
+        allocInfo.commandPool = device.GetCommandPool();
+        allocInfo.commandBufferCount = 1;
+
+        vk::CommandBuffer commandBuffer;
+        if(device.GetDevice().allocateCommandBuffers(&allocInfo, &commandBuffer) != vk::Result::eSuccess) {
+            RUI_CORE_ERROR("Failed to allocate texture upload command buffer!");
+            return;
+        }
+
+        vk::CommandBufferBeginInfo beginInfo;
+        beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+        commandBuffer.begin(&beginInfo);
+        record(commandBuffer);
+        commandBuffer.end();
+
+        // Waits for this upload only, not for the frames still in flight
+        QueueTimeline& timeline = device.GetGraphicsTimeline();
+        timeline.Wait(device.Submit(timeline, { commandBuffer }));
+        device.GetDevice().freeCommandBuffers(device.GetCommandPool(), 1, &commandBuffer);
+    }
+
+    void TextureSystem::Init() {
+        s_Data = std::make_unique<TextureSystemData>();
+        Device& device = RenderSystem::GetDevice();
+
+        // Leave some room for the samplers of the other sets
+        vk::PhysicalDeviceLimits limits = device.GetPhysicalDevice().getProperties().limits;
+        uint32_t stageLimit = std::min(limits.maxPerStageDescriptorSamplers, limits.maxPerStageDescriptorSampledImages);
+        s_Data->Capacity = std::min(MAX_TEXTURES, stageLimit > 8 ? stageLimit - 8 : 1u);
+
+        vk::SamplerCreateInfo samplerInfo;
+        samplerInfo.magFilter = vk::Filter::eLinear;
+        samplerInfo.minFilter = vk::Filter::eLinear;
+        samplerInfo.mipmapMode = vk::SamplerMipmapMode::eLinear;
+        samplerInfo.addressModeU = vk::SamplerAddressMode::eRepeat;
+        samplerInfo.addressModeV = vk::SamplerAddressMode::eRepeat;
+        samplerInfo.addressModeW = vk::SamplerAddressMode::eRepeat;
+        samplerInfo.anisotropyEnable = true;
+        samplerInfo.maxAnisotropy = std::min(8.0f, limits.maxSamplerAnisotropy);
+        samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+
+        if(device.GetDevice().createSampler(&samplerInfo, nullptr, &s_Data->Sampler) != vk::Result::eSuccess) {
+            RUI_CORE_ERROR("Failed to create texture sampler!");
+        }
+
+        vk::DescriptorSetLayoutBinding texturesBinding;
+        texturesBinding.binding = 0;
+        texturesBinding.descriptorType = vk::DescriptorType::eCombinedImageSampler;
+        texturesBinding.descriptorCount = s_Data->Capacity;
+        texturesBinding.stageFlags = vk::ShaderStageFlagBits::eFragment;
+        texturesBinding.pImmutableSamplers = nullptr;
+
+        vk::DescriptorSetLayoutCreateInfo layoutInfo;
+        layoutInfo.bindingCount = 1;
+        layoutInfo.pBindings = &texturesBinding;
+
+        if(device.GetDevice().createDescriptorSetLayout(&layoutInfo, nullptr, &s_Data->DescriptorSetLayout) != vk::Result::eSuccess) {
+            RUI_CORE_ERROR("Failed to create texture descriptor set layout!");
+        }
+
+        vk::DescriptorPoolSize poolSize(vk::DescriptorType::eCombinedImageSampler, s_Data->Capacity * SwapChain::MAX_FRAMES_IN_FLIGHT);
+
+        vk::DescriptorPoolCreateInfo poolInfo;
+        poolInfo.poolSizeCount = 1;
+        poolInfo.pPoolSizes = &poolSize;
+        poolInfo.maxSets = SwapChain::MAX_FRAMES_IN_FLIGHT;
+
+        if(device.GetDevice().createDescriptorPool(&poolInfo, nullptr, &s_Data->DescriptorPool) != vk::Result::eSuccess) {
+            RUI_CORE_ERROR("Failed to create texture descriptor pool!");
+        }
+
+        std::array<vk::DescriptorSetLayout, SwapChain::MAX_FRAMES_IN_FLIGHT> layouts;
+        layouts.fill(s_Data->DescriptorSetLayout);
+
+        vk::DescriptorSetAllocateInfo allocInfo;
+        allocInfo.descriptorPool = s_Data->DescriptorPool;
+        allocInfo.descriptorSetCount = static_cast<uint32_t>(layouts.size());
+        allocInfo.pSetLayouts = layouts.data();
+
+        if(device.GetDevice().allocateDescriptorSets(&allocInfo, s_Data->DescriptorSets.data()) != vk::Result::eSuccess) {
+            RUI_CORE_ERROR("Failed to allocate texture descriptor sets!");
+        }
+
+        for(StagingBuffer& staging : s_Data->Staging) {
+            CreateStagingBuffer(s_Data->Settings.UploadBytesPerFrame, staging);
+        }
+
+        s_Data->Slots.resize(s_Data->Capacity, nullptr);
+        s_Data->DirtySlots.resize(s_Data->Capacity, ALL_FRAMES);
+        for(uint32_t slot = s_Data->Capacity; slot > DEFAULT_TEXTURE_SLOT + 1; slot--) {
+            s_Data->FreeSlots.push_back(slot - 1);
+        }
+
+        // Every slot shows the default texture until something else is put
+        // there, so the whole array is always valid to sample
+        static const uint8_t white[4] = { 255, 255, 255, 255 };
+
+        Ktx2Image image;
+        image.Format = static_cast<uint32_t>(vk::Format::eR8G8B8A8Unorm);
+        image.Width = 1;
+        image.Height = 1;
+        image.Levels.push_back({ reinterpret_cast<const std::byte*>(white), sizeof(white) });
+
+        s_Data->DefaultTexture = Create("<default>", nullptr, image);
+
+        SubmitImmediate([](vk::CommandBuffer commandBuffer) {
+            s_Data->CommandBuffer = commandBuffer;
+            SetResidentMip(commandBuffer, *s_Data->DefaultTexture, 0);
+        });
+
+        for(uint32_t frame = 0; frame < SwapChain::MAX_FRAMES_IN_FLIGHT; frame++) {
+            UpdateDescriptors(frame);
+        }
+    }
+
+    void TextureSystem::Shutdown() {
+        if(!s_Data) return;
+
+        Device& device = RenderSystem::GetDevice();
+        device.GetDevice().waitIdle();
+
+        s_Data->Cache.clear();
+        s_Data->DefaultTexture.reset();
+
+        // Textures still referenced elsewhere lose their GPU resources
+        std::vector<Texture*> textures = std::move(s_Data->Textures);
+        for(Texture* texture : textures) {
+            if(texture->m_Image) {
+                device.GetDevice().destroyImageView(texture->m_View, nullptr);
+                device.GetAllocator().DestroyImage(texture->m_Image, texture->m_Allocation);
+            }
+
+            texture->m_Image = nullptr;
+            texture->m_View = nullptr;
+            texture->m_ResidentMip = texture->m_MipCount;
+        }
+
+        for(StagingBuffer& staging : s_Data->Staging) {
+            DestroyStagingBuffer(staging);
+        }
+
+        device.GetDevice().destroyDescriptorPool(s_Data->DescriptorPool, nullptr);
+        device.GetDevice().destroyDescriptorSetLayout(s_Data->DescriptorSetLayout, nullptr);
+        device.GetDevice().destroySampler(s_Data->Sampler, nullptr);
+
+        s_Data.reset();
+    }
+
+    Ref<Texture> TextureSystem::Load(const std::string& path) {
+        if(auto cached = s_Data->Cache[path].lock()) return cached;
+
+        AssetHandle blob = AssetSystem::Load(path);
+        if(!blob) return nullptr;
+
+        Ktx2Image image;
+        if(!Ktx2Image::Parse(blob->GetData(), blob->GetSize(), path, image)) return nullptr;
+
+        return Create(path, blob, image);
+    }
+
+    Task<Ref<Texture>> TextureSystem::LoadAsync(std::string path) {
+        AssetHandle blob = co_await LoadAsset(path);
+        if(!blob) co_return nullptr;
+
+        Ktx2Image image;
+        if(!Ktx2Image::Parse(blob->GetData(), blob->GetSize(), path, image)) co_return nullptr;
+
+        // Textures are created and registered on the main thread only
+        co_await AssetSystem::ResumeOnMainThread();
+
+        if(auto cached = s_Data->Cache[path].lock()) co_return cached;
+        co_return Create(path, blob, image);
+    }
+
+    Ref<Texture> TextureSystem::Create(const std::string& path, AssetHandle source, const Ktx2Image& image) {
+        Device& device = RenderSystem::GetDevice();
+        vk::Format format = static_cast<vk::Format>(image.Format);
+
+        if(!device.IsFormatSupported(format, vk::FormatFeatureFlagBits::eSampledImage | vk::FormatFeatureFlagBits::eTransferDst)) {
+            RUI_CORE_ERROR("{0}: format {1} cannot be sampled on this device", path, vk::to_string(format));
+            return nullptr;
+        }
+
+        if(s_Data->FreeSlots.empty() && s_Data->DefaultTexture) {
+            RUI_CORE_ERROR("{0}: all {1} texture slots are in use", path, s_Data->Capacity);
+            return nullptr;
+        }
+
+        Ref<Texture> texture(new Texture());
+        texture->m_Path = path;
+        texture->m_Source = std::move(source);
+        texture->m_Levels = image.Levels;
+        texture->m_Format = format;
+        texture->m_Width = image.Width;
+        texture->m_Height = image.Height;
+
+        vk::FormatFeatureFlags blitFeatures = vk::FormatFeatureFlagBits::eBlitSrc | vk::FormatFeatureFlagBits::eBlitDst | vk::FormatFeatureFlagBits::eSampledImageFilterLinear;
+        texture->m_GenerateMips = image.GenerateMips && std::max(image.Width, image.Height) > 1;
+        if(texture->m_GenerateMips && !device.IsFormatSupported(format, blitFeatures)) {
+            RUI_CORE_WARN("{0}: mips cannot be generated for format {1}", path, vk::to_string(format));
+            texture->m_GenerateMips = false;
+        }
+
+        std::vector<uint64_t> levelSizes;
+        if(texture->m_GenerateMips) {
+            texture->m_MipCount = static_cast<uint32_t>(std::floor(std::log2(std::max(image.Width, image.Height)))) + 1;
+
+            uint64_t texelSize = image.Levels[0].Size / (static_cast<uint64_t>(image.Width) * image.Height);
+            for(uint32_t mip = 0; mip < texture->m_MipCount; mip++) {
+                levelSizes.push_back(texelSize * MipExtent(image.Width, mip) * MipExtent(image.Height, mip));
+            }
+        } else {
+            texture->m_MipCount = static_cast<uint32_t>(image.Levels.size());
+            for(const Ktx2Image::Level& level : image.Levels) {
+                levelSizes.push_back(level.Size);
+            }
+        }
+
+        texture->m_TailBytes.resize(texture->m_MipCount + 1, 0);
+        for(uint32_t mip = texture->m_MipCount; mip > 0; mip--) {
+            texture->m_TailBytes[mip - 1] = texture->m_TailBytes[mip] + levelSizes[mip - 1];
+        }
+
+        // Generated chains come from the full resolution level, so they are
+        // resident as a whole
+        texture->m_MinResidentMip = 0;
+        if(!texture->m_GenerateMips) {
+            while(texture->m_MinResidentMip + 1 < texture->m_MipCount
+                  && std::max(MipExtent(image.Width, texture->m_MinResidentMip), MipExtent(image.Height, texture->m_MinResidentMip)) > s_Data->Settings.MinResidentSize) {
+                texture->m_MinResidentMip++;
+            }
+        }
+
+        texture->m_ResidentMip = texture->m_MipCount;
+        texture->m_TargetMip = texture->m_MinResidentMip;
+        texture->m_FrameRequestMip = texture->m_MipCount;
+        texture->m_RequestedMip = texture->m_MinResidentMip;
+
+        if(s_Data->DefaultTexture) {
+            texture->m_Slot = s_Data->FreeSlots.back();
+            s_Data->FreeSlots.pop_back();
+        } else {
+            texture->m_Slot = DEFAULT_TEXTURE_SLOT;
+        }
+
+        s_Data->Slots[texture->m_Slot] = texture.get();
+        s_Data->Textures.push_back(texture.get());
+        s_Data->Cache[path] = texture;
+
+        return texture;
+    }
+
+    void TextureSystem::Release(Texture& texture) {
+        if(!s_Data) return;
+
+        auto it = std::find(s_Data->Textures.begin(), s_Data->Textures.end(), &texture);
+        if(it == s_Data->Textures.end()) return;
+
+        *it = s_Data->Textures.back();
+        s_Data->Textures.pop_back();
+
+        auto cached = s_Data->Cache.find(texture.m_Path);
+        if(cached != s_Data->Cache.end() && cached->second.expired()) {
+            s_Data->Cache.erase(cached);
+        }
+
+        if(texture.m_Image) {
+            RenderSystem::GetDevice().GetAllocator().SetRelocator(texture.m_Allocation, nullptr);
+
+            ResourceManager::DestroyLater(texture.m_Image, texture.m_Allocation, texture.m_View);
+        }
+
+        if(texture.m_Slot != DEFAULT_TEXTURE_SLOT) {
+            s_Data->Slots[texture.m_Slot] = nullptr;
+            s_Data->DirtySlots[texture.m_Slot] = ALL_FRAMES;
+            s_Data->FreeSlots.push_back(texture.m_Slot);
+        }
+    }
+
+    void TextureSystem::ReportUsage(Texture& texture, float screenPixels) {
+        uint32_t size = std::max(texture.m_Width, texture.m_Height);
+
+        uint32_t mip = texture.m_MipCount - 1;
+        if(screenPixels >= 1.0f) {
+            float lod = std::floor(std::log2(static_cast<float>(size) / screenPixels));
+            mip = static_cast<uint32_t>(std::clamp(lod, 0.0f, static_cast<float>(texture.m_MipCount - 1)));
+        }
+
+        texture.m_FrameRequestMip = std::min(texture.m_FrameRequestMip, mip);
+        texture.m_LastUsedFrame = s_Data->FrameNumber;
+    }
+
+    void TextureSystem::Update(vk::CommandBuffer commandBuffer, uint32_t frame) {
+        TextureStreamingSettings& settings = s_Data->Settings;
+        TextureStreamingStats& stats = s_Data->Stats;
+
+        s_Data->FrameNumber++;
+        s_Data->CommandBuffer = commandBuffer;
+        s_Data->Frame = frame;
+        s_Data->Staging[frame].Used = 0;
+        stats.UploadedBytes = 0;
+
+        // What each texture would like resident
+        for(Texture* texture : s_Data->Textures) {
+            if(texture->m_FrameRequestMip < texture->m_MipCount) {
+                texture->m_RequestedMip = texture->m_FrameRequestMip;
+            }
+            texture->m_FrameRequestMip = texture->m_MipCount;
+
+            bool used = texture->m_LastUsedFrame > 0 && s_Data->FrameNumber - texture->m_LastUsedFrame <= settings.EvictAfterFrames;
+            texture->m_TargetMip = used ? std::min(texture->m_RequestedMip, texture->m_MinResidentMip) : texture->m_MinResidentMip;
+        }
+
+        FitBudget();
+
+        // Shrink first, freeing memory for what streams in
+        for(Texture* texture : s_Data->Textures) {
+            if(texture->m_ResidentMip < texture->m_MipCount && texture->m_TargetMip > texture->m_ResidentMip) {
+                SetResidentMip(commandBuffer, *texture, texture->m_TargetMip);
+            }
+        }
+
+        std::vector<Texture*> streaming;
+        for(Texture* texture : s_Data->Textures) {
+            if(texture->m_TargetMip < texture->m_ResidentMip) {
+                streaming.push_back(texture);
+            }
+        }
+
+        // Textures with nothing on the GPU first, then the most recently used
+        std::sort(streaming.begin(), streaming.end(), [](const Texture* a, const Texture* b) {
+            bool aEmpty = a->m_ResidentMip == a->m_MipCount;
+            bool bEmpty = b->m_ResidentMip == b->m_MipCount;
+            if(aEmpty != bEmpty) return aEmpty;
+            if(a->m_LastUsedFrame != b->m_LastUsedFrame) return a->m_LastUsedFrame > b->m_LastUsedFrame;
+            return a->m_ResidentMip - a->m_TargetMip > b->m_ResidentMip - b->m_TargetMip;
+        });
+
+        for(Texture* texture : streaming) {
+            uint64_t remaining = settings.UploadBytesPerFrame > stats.UploadedBytes ? settings.UploadBytesPerFrame - stats.UploadedBytes : 0;
+            uint32_t resident = std::min(texture->m_ResidentMip, texture->m_MipCount);
+
+            // Generated chains upload their full resolution level in one go;
+            // stored chains stream in as many levels as fit
+            uint32_t mip = texture->m_TargetMip;
+            if(!texture->m_GenerateMips) {
+                while(mip + 1 < resident && texture->m_TailBytes[mip] - texture->m_TailBytes[resident] > remaining) {
+                    mip++;
+                }
+            }
+
+            uint64_t uploadBytes = texture->m_GenerateMips ? texture->m_Levels[0].Size : texture->m_TailBytes[mip] - texture->m_TailBytes[resident];
+            if(uploadBytes > remaining && stats.UploadedBytes > 0) continue;
+
+            if(SetResidentMip(commandBuffer, *texture, mip)) {
+                stats.UploadedBytes += uploadBytes;
+            }
+        }
+
+        UpdateDescriptors(frame);
+
+        stats.TextureCount = static_cast<uint32_t>(s_Data->Textures.size());
+        stats.PendingCount = 0;
+        stats.ResidentBytes = 0;
+        for(const Texture* texture : s_Data->Textures) {
+            stats.ResidentBytes += texture->m_TailBytes[texture->m_ResidentMip];
+            if(texture->m_ResidentMip != texture->m_TargetMip) stats.PendingCount++;
+        }
+    }
+
+    void TextureSystem::FitBudget() {
+        TextureStreamingStats& stats = s_Data->Stats;
+
+        stats.TargetBytes = 0;
+        for(const Texture* texture : s_Data->Textures) {
+            stats.TargetBytes += texture->m_TailBytes[texture->m_TargetMip];
+        }
+
+        // Never plan for more than the device holds next to everything else,
+        // keeping a tenth of it spare
+        const GpuAllocator& allocator = RenderSystem::GetDevice().GetAllocator();
+        uint64_t available = allocator.GetStats().Categories[static_cast<size_t>(MemoryCategory::Textures)].Bytes + allocator.GetDeviceHeadroom();
+        uint64_t budget = std::min(s_Data->Settings.BudgetBytes, available - available / 10);
+        if(stats.TargetBytes <= budget) return;
+
+        // Take mips from the least recently used textures first, the largest
+        // among equals
+        std::vector<Texture*> textures = s_Data->Textures;
+        std::sort(textures.begin(), textures.end(), [](const Texture* a, const Texture* b) {
+            if(a->m_LastUsedFrame != b->m_LastUsedFrame) return a->m_LastUsedFrame < b->m_LastUsedFrame;
+            return a->m_TailBytes[a->m_TargetMip] > b->m_TailBytes[b->m_TargetMip];
+        });
+
+        for(Texture* texture : textures) {
+            while(stats.TargetBytes > budget && texture->m_TargetMip < texture->m_MinResidentMip) {
+                stats.TargetBytes -= texture->m_TailBytes[texture->m_TargetMip] - texture->m_TailBytes[texture->m_TargetMip + 1];
+                texture->m_TargetMip++;
+            }
+
+            if(stats.TargetBytes <= budget) break;
+        }
+    }
+
+    bool TextureSystem::SetResidentMip(vk::CommandBuffer commandBuffer, Texture& texture, uint32_t mip) {
+        Device& device = RenderSystem::GetDevice();
+
+        uint32_t oldMip = texture.m_ResidentMip;
+        uint32_t levelCount = texture.m_MipCount - mip;
+        vk::Image oldImage = texture.m_Image;
+
+        vk::ImageCreateInfo imageInfo = GetImageInfo(texture, mip);
+
+        // Fails when the device is out of budget; the texture stays as it is
+        vk::Image image;
+        vma::Allocation allocation;
+        if(device.GetAllocator().CreateImage(imageInfo, vk::MemoryPropertyFlagBits::eDeviceLocal, MemoryCategory::Textures, &image, &allocation) != vk::Result::eSuccess) {
+            RUI_CORE_WARN("{0}: could not allocate mips {1} to {2}", texture.m_Path, mip, texture.m_MipCount - 1);
+            return false;
+        }
+
+        Transition(commandBuffer, image, 0, levelCount, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal,
+                   vk::PipelineStageFlagBits::eTopOfPipe, {}, vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferWrite);
+
+        // Mips already on the GPU are copied over from the old image
+        if(oldImage) {
+            uint32_t firstShared = std::max(oldMip, mip);
+
+            Transition(commandBuffer, oldImage, firstShared - oldMip, texture.m_MipCount - firstShared,
+                       vk::ImageLayout::eShaderReadOnlyOptimal, vk::ImageLayout::eTransferSrcOptimal,
+                       vk::PipelineStageFlagBits::eFragmentShader, {}, vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferRead);
+
+            std::vector<vk::ImageCopy> regions;
+            for(uint32_t level = firstShared; level < texture.m_MipCount; level++) {
+                vk::ImageCopy region;
+                region.srcSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, level - oldMip, 0, 1);
+                region.dstSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, level - mip, 0, 1);
+                region.extent = vk::Extent3D(MipExtent(texture.m_Width, level), MipExtent(texture.m_Height, level), 1);
+                regions.push_back(region);
+            }
+
+            commandBuffer.copyImage(oldImage, vk::ImageLayout::eTransferSrcOptimal, image, vk::ImageLayout::eTransferDstOptimal,
+                                    static_cast<uint32_t>(regions.size()), regions.data());
+        }
+
+        if(texture.m_GenerateMips && mip < oldMip) {
+            auto [buffer, offset] = Stage(texture.m_Levels[0].Data, texture.m_Levels[0].Size);
+
+            vk::BufferImageCopy region;
+            region.bufferOffset = offset;
+            region.imageSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1);
+            region.imageExtent = vk::Extent3D(texture.m_Width, texture.m_Height, 1);
+            commandBuffer.copyBufferToImage(buffer, image, vk::ImageLayout::eTransferDstOptimal, 1, &region);
+
+            // Each level is blitted from the one above, which then becomes
+            // a transfer source
+            for(uint32_t level = 1; level < levelCount; level++) {
+                Transition(commandBuffer, image, level - 1, 1, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eTransferSrcOptimal,
+                           vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferWrite, vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferRead);
+
+                vk::ImageBlit blit;
+                blit.srcSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, level - 1, 0, 1);
+                blit.srcOffsets[1] = vk::Offset3D(MipExtent(texture.m_Width, level - 1), MipExtent(texture.m_Height, level - 1), 1);
+                blit.dstSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, level, 0, 1);
+                blit.dstOffsets[1] = vk::Offset3D(MipExtent(texture.m_Width, level), MipExtent(texture.m_Height, level), 1);
+
+                commandBuffer.blitImage(image, vk::ImageLayout::eTransferSrcOptimal, image, vk::ImageLayout::eTransferDstOptimal, 1, &blit, vk::Filter::eLinear);
+            }
+
+            if(levelCount > 1) {
+                Transition(commandBuffer, image, 0, levelCount - 1, vk::ImageLayout::eTransferSrcOptimal, vk::ImageLayout::eShaderReadOnlyOptimal,
+                           vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferRead, vk::PipelineStageFlagBits::eFragmentShader, vk::AccessFlagBits::eShaderRead);
+            }
+
+            Transition(commandBuffer, image, levelCount - 1, 1, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal,
+                       vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferWrite, vk::PipelineStageFlagBits::eFragmentShader, vk::AccessFlagBits::eShaderRead);
+        } else {
+            // Levels finer than what was resident come from the file
+            for(uint32_t level = mip; level < std::min(oldMip, texture.m_MipCount); level++) {
+                auto [buffer, offset] = Stage(texture.m_Levels[level].Data, texture.m_Levels[level].Size);
+
+                vk::BufferImageCopy region;
+                region.bufferOffset = offset;
+                region.imageSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, level - mip, 0, 1);
+                region.imageExtent = vk::Extent3D(MipExtent(texture.m_Width, level), MipExtent(texture.m_Height, level), 1);
+                commandBuffer.copyBufferToImage(buffer, image, vk::ImageLayout::eTransferDstOptimal, 1, &region);
+            }
+
+            Transition(commandBuffer, image, 0, levelCount, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal,
+                       vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferWrite, vk::PipelineStageFlagBits::eFragmentShader, vk::AccessFlagBits::eShaderRead);
+        }
+
+        vk::ImageViewCreateInfo viewInfo;
+        viewInfo.image = image;
+        viewInfo.viewType = vk::ImageViewType::e2D;
+        viewInfo.format = texture.m_Format;
+        viewInfo.subresourceRange = vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, levelCount, 0, 1);
+
+        vk::ImageView view;
+        if(device.GetDevice().createImageView(&viewInfo, nullptr, &view) != vk::Result::eSuccess) {
+            RUI_CORE_ERROR("Failed to create texture image view!");
+        }
+
+        if(oldImage) {
+            device.GetAllocator().SetRelocator(texture.m_Allocation, nullptr);
+
+            ResourceManager::DestroyLater(oldImage, texture.m_Allocation, texture.m_View);
+        }
+
+        texture.m_Image = image;
+        texture.m_Allocation = allocation;
+        texture.m_View = view;
+        texture.m_ResidentMip = mip;
+        s_Data->DirtySlots[texture.m_Slot] = ALL_FRAMES;
+
+        device.GetAllocator().SetRelocator(allocation, [&texture](vk::CommandBuffer commandBuffer, vma::Allocation target) {
+            return Relocate(commandBuffer, texture, target);
+        });
+        return true;
+    }
+
+    std::function<void()> TextureSystem::Relocate(vk::CommandBuffer commandBuffer, Texture& texture, vma::Allocation target) {
+        vk::Device device = RenderSystem::GetDevice().GetDevice();
+        uint32_t levelCount = texture.m_MipCount - texture.m_ResidentMip;
+
+        vk::ImageCreateInfo imageInfo = GetImageInfo(texture, texture.m_ResidentMip);
+
+        vk::Image image;
+        if(device.createImage(&imageInfo, nullptr, &image) != vk::Result::eSuccess) return {};
+        if(RenderSystem::GetDevice().GetAllocator().BindImage(target, image) != vk::Result::eSuccess) {
+            device.destroyImage(image, nullptr);
+            return {};
+        }
+
+        Transition(commandBuffer, image, 0, levelCount, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal,
+                   vk::PipelineStageFlagBits::eTopOfPipe, {}, vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferWrite);
+        Transition(commandBuffer, texture.m_Image, 0, levelCount, vk::ImageLayout::eShaderReadOnlyOptimal, vk::ImageLayout::eTransferSrcOptimal,
+                   vk::PipelineStageFlagBits::eFragmentShader, {}, vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferRead);
+
+        std::vector<vk::ImageCopy> regions;
+        for(uint32_t level = 0; level < levelCount; level++) {
+            vk::ImageCopy region;
+            region.srcSubresource = vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, level, 0, 1);
+            region.dstSubresource = region.srcSubresource;
+            region.extent = vk::Extent3D(MipExtent(imageInfo.extent.width, level), MipExtent(imageInfo.extent.height, level), 1);
+            regions.push_back(region);
+        }
+
+        commandBuffer.copyImage(texture.m_Image, vk::ImageLayout::eTransferSrcOptimal, image, vk::ImageLayout::eTransferDstOptimal,
+                                static_cast<uint32_t>(regions.size()), regions.data());
+
+        Transition(commandBuffer, image, 0, levelCount, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal,
+                   vk::PipelineStageFlagBits::eTransfer, vk::AccessFlagBits::eTransferWrite, vk::PipelineStageFlagBits::eFragmentShader, vk::AccessFlagBits::eShaderRead);
+
+        vk::ImageViewCreateInfo viewInfo;
+        viewInfo.image = image;
+        viewInfo.viewType = vk::ImageViewType::e2D;
+        viewInfo.format = texture.m_Format;
+        viewInfo.subresourceRange = vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, levelCount, 0, 1);
+
+        vk::ImageView view;
+        if(device.createImageView(&viewInfo, nullptr, &view) != vk::Result::eSuccess) {
+            RUI_CORE_ERROR("Failed to create texture image view!");
+        }
+
+        vk::Image oldImage = texture.m_Image;
+        vk::ImageView oldView = texture.m_View;
+
+        texture.m_Image = image;
+        texture.m_View = view;
+        s_Data->DirtySlots[texture.m_Slot] = ALL_FRAMES;
+
+        // The allocation itself stays the texture's; only the memory behind it moves
+        return [device, oldImage, oldView]() {
+            device.destroyImageView(oldView, nullptr);
+            device.destroyImage(oldImage, nullptr);
+        };
+    }
+
+    vk::ImageCreateInfo TextureSystem::GetImageInfo(const Texture& texture, uint32_t mip) {
+        vk::ImageCreateInfo imageInfo;
+        imageInfo.imageType = vk::ImageType::e2D;
+        imageInfo.extent.width = MipExtent(texture.m_Width, mip);
+        imageInfo.extent.height = MipExtent(texture.m_Height, mip);
+        imageInfo.extent.depth = 1;
+        imageInfo.mipLevels = texture.m_MipCount - mip;
+        imageInfo.arrayLayers = 1;
+        imageInfo.format = texture.m_Format;
+        imageInfo.tiling = vk::ImageTiling::eOptimal;
+        imageInfo.initialLayout = vk::ImageLayout::eUndefined;
+        imageInfo.usage = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eTransferSrc;
+        imageInfo.samples = vk::SampleCountFlagBits::e1;
+        imageInfo.sharingMode = vk::SharingMode::eExclusive;
+
+        return imageInfo;
+    }
+
+    void TextureSystem::UpdateDescriptors(uint32_t frame) {
+        uint8_t bit = static_cast<uint8_t>(1 << frame);
+        vk::ImageView defaultView = s_Data->DefaultTexture->m_View;
+
+        std::vector<vk::DescriptorImageInfo> imageInfos;
+        std::vector<vk::WriteDescriptorSet> writes;
+        imageInfos.reserve(s_Data->Capacity);
+
+        for(uint32_t slot = 0; slot < s_Data->Capacity; slot++) {
+            if(!(s_Data->DirtySlots[slot] & bit)) continue;
+            s_Data->DirtySlots[slot] &= ~bit;
+
+            const Texture* texture = s_Data->Slots[slot];
+
+            vk::DescriptorImageInfo& imageInfo = imageInfos.emplace_back();
+            imageInfo.sampler = s_Data->Sampler;
+            imageInfo.imageView = texture && texture->m_View ? texture->m_View : defaultView;
+            imageInfo.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+
+            vk::WriteDescriptorSet& write = writes.emplace_back();
+            write.dstSet = s_Data->DescriptorSets[frame];
+            write.dstBinding = 0;
+            write.dstArrayElement = slot;
+            write.descriptorType = vk::DescriptorType::eCombinedImageSampler;
+            write.descriptorCount = 1;
+            write.pImageInfo = &imageInfo;
+        }
+
+        if(!writes.empty()) {
+            RenderSystem::GetDevice().GetDevice().updateDescriptorSets(static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+        }
+    }
+
+    vk::DescriptorSetLayout TextureSystem::GetDescriptorSetLayout() {
+        return s_Data->DescriptorSetLayout;
+    }
+
+    vk::DescriptorSet TextureSystem::GetDescriptorSet(uint32_t frame) {
+        return s_Data->DescriptorSets[frame];
+    }
+
+    uint32_t TextureSystem::GetCapacity() {
+        return s_Data->Capacity;
+    }
+
+    void TextureSystem::SetSettings(const TextureStreamingSettings& settings) {
+        bool resizeStaging = settings.UploadBytesPerFrame != s_Data->Settings.UploadBytesPerFrame;
+        s_Data->Settings = settings;
+
+        if(resizeStaging) {
+            RenderSystem::GetDevice().GetDevice().waitIdle();
+            for(StagingBuffer& staging : s_Data->Staging) {
+                DestroyStagingBuffer(staging);
+                CreateStagingBuffer(settings.UploadBytesPerFrame, staging);
+            }
+        }
+    }
+
+    const TextureStreamingSettings& TextureSystem::GetSettings() {
+        return s_Data->Settings;
+    }
+
+    const TextureStreamingStats& TextureSystem::GetStats() {
+        return s_Data->Stats;
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Texture.h"
+#include "Rui/Asset/Task.h"
+
+namespace Rui {
+    struct TextureStreamingSettings {
+        // GPU memory for all textures together, lowered further when the
+        // device budget runs short. Mip tails are kept even if they alone
+        // exceed it.
+        uint64_t BudgetBytes = 512ull << 20;
+        // Staging space per frame in flight, which caps uploads per frame.
+        // A single larger upload still goes through on its own.
+        uint64_t UploadBytesPerFrame = 16ull << 20;
+        // Mips no larger than this along either side stay resident
+        uint32_t MinResidentSize = 64;
+        // Textures not reported on screen for this many frames drop back to
+        // their mip tail
+        uint32_t EvictAfterFrames = 120;
+    };
+
+    struct TextureStreamingStats {
+        uint32_t TextureCount = 0;
+        // Textures still streaming towards their target mip
+        uint32_t PendingCount = 0;
+        uint64_t ResidentBytes = 0;
+        // What the visible textures ask for, after fitting into the budget
+        uint64_t TargetBytes = 0;
+        uint64_t UploadedBytes = 0;
+    };
+
+    // Loads KTX2 textures and keeps their mips resident by on-screen demand
+    // under a memory budget. Uploads go through per-frame staging buffers;
+    // files with a single level get their mip chain generated on the GPU
+    // with blits, block compressed files must carry their mips.
+    //
+    // Every texture has a slot in a descriptor array (set 1, binding 0 of the
+    // scene pipeline layout). Residency changes reallocate the image, copy
+    // the mips that stay on the GPU and rewrite the slot; the old image is
+    // destroyed once no frame in flight can use it.
+    class TextureSystem {
+    public:
+        static constexpr uint32_t MAX_TEXTURES = 1024;
+        // Slot of a 1x1 white texture, also shown until a texture's first upload
+        static constexpr uint32_t DEFAULT_TEXTURE_SLOT = 0;
+
+        static void Init();
+        static void Shutdown();
+
+        // Reads the file on the calling thread; uploads happen over the next frames
+        static Ref<Texture> Load(const std::string& path);
+        // Reads and validates on an I/O thread, finishes on the main thread
+        static Task<Ref<Texture>> LoadAsync(std::string path);
+
+        // Called every frame the texture is drawn, with the screen pixels
+        // covered along its longest side
+        static void ReportUsage(Texture& texture, float screenPixels);
+
+        // Records this frame's residency changes. Called outside of a render
+        // pass, after the frame slot's timeline value was waited on.
+        static void Update(vk::CommandBuffer commandBuffer, uint32_t frame);
+
+        static vk::DescriptorSetLayout GetDescriptorSetLayout();
+        static vk::DescriptorSet GetDescriptorSet(uint32_t frame);
+        // Slots in the descriptor array, at most MAX_TEXTURES
+        static uint32_t GetCapacity();
+
+        static void SetSettings(const TextureStreamingSettings& settings);
+        static const TextureStreamingSettings& GetSettings();
+        static const TextureStreamingStats& GetStats();
+    private:
+        static Ref<Texture> Create(const std::string& path, AssetHandle source, const Ktx2Image& image);
+        static void Release(Texture& texture);
+
+        static void FitBudget();
+        // Returns false if the new image could not be allocated
+        static bool SetResidentMip(vk::CommandBuffer commandBuffer, Texture& texture, uint32_t mip);
+        // GpuAllocator::Relocator for texture images
+        static std::function<void()> Relocate(vk::CommandBuffer commandBuffer, Texture& texture, vma::Allocation target);
+        static vk::ImageCreateInfo GetImageInfo(const Texture& texture, uint32_t mip);
+        static void UpdateDescriptors(uint32_t frame);
+
+        friend class Texture;
+    };
+}
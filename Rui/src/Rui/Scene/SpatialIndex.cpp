@@ -0,0 +1,45 @@
+#include "SpatialIndex.h"
+
+namespace Rui {
+	SpatialIndex::SpatialIndex(entt::registry& registry, float rebuildRatio)
+		: m_Registry(registry), m_Bvh(rebuildRatio) {
+		// Whichever of the two goes first, on destroying an entity
+		m_BoundsDestroyed = registry.on_destroy<WorldBoundsComponent>().connect<&SpatialIndex::OnDestroyed>(*this);
+		m_ProxyDestroyed = registry.on_destroy<SpatialProxyComponent>().connect<&SpatialIndex::OnDestroyed>(*this);
+	}
+
+	void SpatialIndex::Update() {
+		m_Added.clear();
+		for(entt::entity entity : m_Registry.view<WorldBoundsComponent>(entt::exclude<SpatialProxyComponent>)) m_Added.push_back(entity);
+		for(entt::entity entity : m_Added) m_Registry.emplace<SpatialProxyComponent>(entity);
+
+		uint32_t inserted = 0;
+		m_Registry.view<const WorldBoundsComponent, SpatialProxyComponent>().each([&](entt::entity entity, const WorldBoundsComponent& world, SpatialProxyComponent& proxy) {
+			Aabb bounds{ world.Min, world.Max };
+
+			// New, or its bounds were removed and added again
+			if(proxy.Proxy >= m_Entities.size() || m_Entities[proxy.Proxy] != entity) {
+				proxy.Proxy = m_Bvh.Insert(bounds, static_cast<uint32_t>(entity));
+				if(proxy.Proxy >= m_Entities.size()) m_Entities.resize(proxy.Proxy + 1, entt::null);
+				m_Entities[proxy.Proxy] = entity;
+				inserted++;
+				return;
+			}
+
+			const Aabb& current = m_Bvh.GetBounds(proxy.Proxy);
+			if(current.Min != bounds.Min || current.Max != bounds.Max) m_Bvh.Move(proxy.Proxy, bounds);
+		});
+
+		// Mostly new entities, as on the first update, build better at once
+		if(inserted > m_Bvh.GetProxyCount() / 2) m_Bvh.Rebuild();
+		m_Bvh.Update();
+	}
+
+	void SpatialIndex::OnDestroyed(entt::registry& registry, entt::entity entity) {
+		const SpatialProxyComponent* proxy = registry.try_get<SpatialProxyComponent>(entity);
+		if(!proxy || proxy->Proxy >= m_Entities.size() || m_Entities[proxy->Proxy] != entity) return;
+
+		m_Bvh.Remove(proxy->Proxy);
+		m_Entities[proxy->Proxy] = entt::null;
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Transform.h"
+#include "Rui/Math/Bvh.h"
+
+namespace Rui {
+	// The proxy of an entity in its SpatialIndex
+	struct SpatialProxyComponent {
+		uint32_t Proxy = Bvh::NULL_NODE;
+	};
+
+	// Keeps a Bvh over the WorldBoundsComponent of a registry's entities, for
+	// picking, culling and proximity queries. Items in query results are
+	// entity ids, see ToEntity().
+	//
+	// Entities that lose their bounds or are destroyed leave the tree right
+	// away; new and moved ones are picked up by Update(), after
+	// TransformSystem::Update(). Only entities whose bounds actually changed
+	// are moved, so the tree refits just the paths above them.
+	//
+	// The proxies are components, so a registry has a single index: a Scene
+	// keeps the one of its registry and updates it every tick.
+	class SpatialIndex {
+	public:
+		explicit SpatialIndex(entt::registry& registry, float rebuildRatio = 2.0f);
+
+		SpatialIndex(const SpatialIndex&) = delete;
+		SpatialIndex& operator=(const SpatialIndex&) = delete;
+
+		void Update();
+
+		inline const Bvh& GetBvh() const { return m_Bvh; }
+
+		static inline entt::entity ToEntity(uint32_t item) { return static_cast<entt::entity>(item); }
+	private:
+		void OnDestroyed(entt::registry& registry, entt::entity entity);
+
+		entt::registry& m_Registry;
+		Bvh m_Bvh;
+		// Owner of each proxy, entt::null for free ones
+		std::vector<entt::entity> m_Entities;
+		std::vector<entt::entity> m_Added;
+
+		entt::scoped_connection m_BoundsDestroyed;
+		entt::scoped_connection m_ProxyDestroyed;
+	};
+}
@@ -0,0 +1,83 @@
+#include "Transform.h"
+
+#include "Rui/Math/TransformKernels.h"
+
+namespace Rui {
+	void TransformSystem::Update(entt::registry& registry) {
+		// Added before the views below are walked, which adding would invalidate
+		m_Missing.clear();
+		for(entt::entity entity : registry.view<TransformComponent>(entt::exclude<WorldTransformComponent>)) m_Missing.push_back(entity);
+		for(entt::entity entity : m_Missing) registry.emplace<WorldTransformComponent>(entity);
+
+		m_Missing.clear();
+		for(entt::entity entity : registry.view<BoundsComponent>(entt::exclude<WorldBoundsComponent>)) m_Missing.push_back(entity);
+		for(entt::entity entity : m_Missing) registry.emplace<WorldBoundsComponent>(entity);
+
+		// One plane of floats per component
+		size_t capacity = registry.view<const TransformComponent>().size();
+		m_Transforms.resize(capacity * 10);
+		m_Matrices.resize(capacity);
+
+		float* planes = m_Transforms.data();
+		TransformArrays transforms{
+			planes, planes + capacity, planes + capacity * 2,
+			planes + capacity * 3, planes + capacity * 4, planes + capacity * 5, planes + capacity * 6,
+			planes + capacity * 7, planes + capacity * 8, planes + capacity * 9
+		};
+
+		auto transformView = registry.view<const TransformComponent, WorldTransformComponent>();
+		size_t count = 0;
+		transformView.each([&](const TransformComponent& transform, WorldTransformComponent&) {
+			planes[count] = transform.Position.x;
+			planes[capacity + count] = transform.Position.y;
+			planes[capacity * 2 + count] = transform.Position.z;
+			planes[capacity * 3 + count] = transform.Rotation.x;
+			planes[capacity * 4 + count] = transform.Rotation.y;
+			planes[capacity * 5 + count] = transform.Rotation.z;
+			planes[capacity * 6 + count] = transform.Rotation.w;
+			planes[capacity * 7 + count] = transform.Scale.x;
+			planes[capacity * 8 + count] = transform.Scale.y;
+			planes[capacity * 9 + count] = transform.Scale.z;
+			count++;
+		});
+
+		ComposeTransforms(transforms, m_Matrices.data(), count);
+
+		// Views walk in the same order as long as the registry is unchanged
+		count = 0;
+		transformView.each([&](const TransformComponent&, WorldTransformComponent& world) {
+			world.Transform = m_Matrices[count++];
+		});
+
+		capacity = registry.view<const BoundsComponent>().size();
+		m_Bounds.resize(capacity * 6);
+		m_Matrices.resize(std::max(m_Matrices.size(), capacity));
+
+		float* bounds = m_Bounds.data();
+		AabbArrays boxes{
+			bounds, bounds + capacity, bounds + capacity * 2,
+			bounds + capacity * 3, bounds + capacity * 4, bounds + capacity * 5
+		};
+
+		auto boundsView = registry.view<const BoundsComponent, const WorldTransformComponent, WorldBoundsComponent>();
+		count = 0;
+		boundsView.each([&](const BoundsComponent& local, const WorldTransformComponent& world, WorldBoundsComponent&) {
+			for(int axis = 0; axis < 3; axis++) {
+				bounds[capacity * axis + count] = local.Min[axis];
+				bounds[capacity * (3 + axis) + count] = local.Max[axis];
+			}
+			m_Matrices[count++] = world.Transform;
+		});
+
+		TransformAabbs(m_Matrices.data(), boxes, boxes, count);
+
+		count = 0;
+		boundsView.each([&](const BoundsComponent&, const WorldTransformComponent&, WorldBoundsComponent& world) {
+			for(int axis = 0; axis < 3; axis++) {
+				world.Min[axis] = bounds[capacity * axis + count];
+				world.Max[axis] = bounds[capacity * (3 + axis) + count];
+			}
+			count++;
+		});
+	}
+}
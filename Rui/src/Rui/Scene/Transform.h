@@ -0,0 +1,48 @@
+#pragma once
+
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <vector>
+
+namespace Rui {
+	struct TransformComponent {
+		glm::vec3 Position{ 0.0f };
+		glm::quat Rotation{ 1.0f, 0.0f, 0.0f, 0.0f };
+		glm::vec3 Scale{ 1.0f };
+	};
+
+	// Written by TransformSystem from TransformComponent
+	struct WorldTransformComponent {
+		glm::mat4 Transform{ 1.0f };
+	};
+
+	// Model space bounds, for entities that are culled
+	struct BoundsComponent {
+		glm::vec3 Min{ 0.0f };
+		glm::vec3 Max{ 0.0f };
+	};
+
+	// Written by TransformSystem from BoundsComponent and the world transform
+	struct WorldBoundsComponent {
+		glm::vec3 Min{ 0.0f };
+		glm::vec3 Max{ 0.0f };
+	};
+
+	// Updates the world transforms and bounds of a registry in batches: the
+	// components are gathered into structure of arrays form, run through the
+	// kernels in Rui/Math/TransformKernels.h and scattered back. The arrays
+	// are kept between updates, so a steady scene does not allocate.
+	class TransformSystem {
+	public:
+		// Adds the world components to entities that lack them, then
+		// recomputes them for every entity
+		void Update(entt::registry& registry);
+	private:
+		std::vector<float> m_Transforms;
+		std::vector<float> m_Bounds;
+		std::vector<glm::mat4> m_Matrices;
+		std::vector<entt::entity> m_Missing;
+	};
+}
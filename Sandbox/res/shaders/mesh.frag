@@ -0,0 +1,28 @@
+#version 450
+
+layout(location = 0) in vec3 v_Normal;
+layout(location = 1) in vec2 v_TexCoord;
+
+layout(location = 0) out vec4 color;
+
+layout(push_constant) uniform Push {
+    vec2 iResolution;
+    float iTime;
+    uint iFlags;
+    mat4 iModel;
+    uint iTexture;
+} PushConstants;
+
+// The TextureSystem's array; its size is specialized to the device's
+// capacity. Untextured meshes use slot 0, which is plain white.
+layout(constant_id = 0) const uint TEXTURE_CAPACITY = 1024;
+layout(set = 1, binding = 0) uniform sampler2D textures[TEXTURE_CAPACITY];
+
+const vec3 LIGHT_DIRECTION = vec3( 0.57735, 0.57735, 0.57735 );
+
+void main() {
+    float diffuse = max( dot( normalize( v_Normal ), LIGHT_DIRECTION ), 0.0 );
+    vec3 albedo = texture( textures[PushConstants.iTexture], v_TexCoord ).rgb;
+
+    color = vec4( albedo*vec3( 0.75 )*( 0.2 + 0.8*diffuse ), 1.0 );
+}
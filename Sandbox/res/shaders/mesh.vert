@@ -0,0 +1,55 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+// Quantized mesh vertices, see Rui/Asset/MeshFormat.h. The input assembler
+// expands snorm16 and half floats, iModel already includes the dequantize
+// transform from the snorm cube to the mesh bounds.
+layout(location = 0) in vec4 a_Position;
+layout(location = 1) in vec2 a_Normal;
+layout(location = 2) in vec2 a_TexCoord;
+
+layout(location = 0) out vec3 v_Normal;
+layout(location = 1) out vec2 v_TexCoord;
+
+layout(push_constant) uniform Push {
+    vec2 iResolution;
+    float iTime;
+    uint iFlags;
+    mat4 iModel;
+    uint iTexture;
+} PushConstants;
+
+#include "shapes_scene.glsl"
+
+const float NEAR_PLANE = 0.1;
+const float FAR_PLANE = 100.0;
+
+vec3 decodeOctahedral( vec2 e )
+{
+    vec3 n = vec3( e, 1.0 - abs(e.x) - abs(e.y) );
+    float t = max( -n.z, 0.0 );
+    n.xy += vec2( n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t );
+    return normalize( n );
+}
+
+void main() {
+    vec3 ro;
+    mat3 ca;
+    sceneCamera( ro, ca );
+
+    vec3 world = ( PushConstants.iModel * vec4( a_Position.xyz, 1.0 ) ).xyz;
+
+    // The dequantize scale is not uniform, so normals take the inverse
+    // transpose of the whole model matrix
+    v_Normal = normalize( transpose( inverse( mat3( PushConstants.iModel ) ) ) * decodeOctahedral( a_Normal ) );
+    v_TexCoord = a_TexCoord;
+
+    // Same projection as the rays of shader_shapes.frag and the particles,
+    // with depth from the near to the far plane
+    vec3 local = transpose( ca ) * ( world - ro );
+    float aspect = PushConstants.iResolution.y/PushConstants.iResolution.x;
+    gl_Position = vec4( -local.x*CAMERA_FOCAL_LENGTH*aspect,
+                        -local.y*CAMERA_FOCAL_LENGTH,
+                        ( local.z - NEAR_PLANE )*FAR_PLANE/( FAR_PLANE - NEAR_PLANE ),
+                        local.z );
+}
@@ -0,0 +1,14 @@
+#version 450
+
+layout(location = 0) in vec4 v_Color;
+layout(location = 1) in vec2 v_Corner;
+
+layout(location = 0) out vec4 color;
+
+void main() {
+    float r = dot( v_Corner, v_Corner );
+    if( r > 1.0 )
+        discard;
+
+    color = vec4( v_Color.rgb, v_Color.a*(1.0 - r) );
+}
@@ -0,0 +1,44 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+// One instance per particle, read straight from the simulated list
+layout(location = 0) in vec4 a_PositionLife;
+layout(location = 1) in vec4 a_VelocitySize;
+
+layout(location = 0) out vec4 v_Color;
+layout(location = 1) out vec2 v_Corner;
+
+layout(push_constant) uniform Push {
+    vec2 iResolution;
+    float iTime;
+    uint iFlags;
+} PushConstants;
+
+#include "shapes_scene.glsl"
+
+const vec2 CORNERS[6] = vec2[]( vec2(-1.0,-1.0), vec2(1.0,-1.0), vec2(1.0,1.0), vec2(1.0,1.0), vec2(-1.0,1.0), vec2(-1.0,-1.0) );
+
+void main() {
+    vec3 ro;
+    mat3 ca;
+    sceneCamera( ro, ca );
+
+    v_Corner = CORNERS[gl_VertexIndex];
+
+    // Camera space, z along the view direction
+    vec3 local = transpose( ca ) * ( a_PositionLife.xyz - ro );
+    if( local.z < 0.1 )
+    {
+        // Behind the camera, clipped away
+        gl_Position = vec4( 0.0, 0.0, 2.0, 1.0 );
+        return;
+    }
+
+    // Same projection as the rays of shader_shapes.frag, whose quad maps
+    // screen coordinates to clip space mirrored
+    vec2 p = ( local.xy + v_Corner*a_VelocitySize.w ) * CAMERA_FOCAL_LENGTH / local.z;
+    gl_Position = vec4( -p.x*PushConstants.iResolution.y/PushConstants.iResolution.x, -p.y, 0.0, 1.0 );
+
+    float heat = clamp( length( a_VelocitySize.xyz )*0.25, 0.0, 1.0 );
+    v_Color = vec4( mix( vec3(1.0,0.35,0.05), vec3(1.0,0.9,0.6), heat ), clamp( a_PositionLife.w, 0.0, 1.0 ) );
+}
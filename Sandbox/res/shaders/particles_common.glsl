@@ -0,0 +1,57 @@
+// Shared by the particle compute shaders. Must match ParticleSystem on the
+// CPU side.
+
+struct Particle {
+    vec4 PositionLife;  // xyz position, w seconds left to live
+    vec4 VelocitySize;  // xyz velocity, w radius
+};
+
+layout(set = 0, binding = 0) readonly buffer InputBuffer {
+    Particle particles[];
+} sourceData;
+
+layout(set = 0, binding = 1) buffer OutputBuffer {
+    Particle particles[];
+} outputData;
+
+layout(std430, set = 0, binding = 2) buffer Counters {
+    uint Count[2];       // alive particles in each of the two lists
+    uvec2 Padding;
+    uvec4 SimulateArgs;  // VkDispatchIndirectCommand of the next simulation
+    uvec4 DrawArgs;      // VkDrawIndirectCommand
+} counters;
+
+layout(push_constant) uniform Push {
+    vec4 EmitterPosition;  // w radius
+    vec4 EmitterVelocity;  // w random spread
+    vec4 Gravity;          // w drag
+    float DeltaTime;
+    float Lifetime;
+    float Restitution;
+    float Size;
+    uint EmitCount;
+    uint Capacity;
+    uint Seed;
+    uint Input;            // list read this frame, the other one is written
+} PushConstants;
+
+// http://www.jcgt.org/published/0009/03/02/
+uint pcg( uint v )
+{
+    uint state = v * 747796405u + 2891336453u;
+    uint word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    return (word >> 22u) ^ word;
+}
+
+float random( inout uint state )
+{
+    state = pcg( state );
+    return float( state ) / 4294967295.0;
+}
+
+vec3 randomDirection( inout uint state )
+{
+    float z = 2.0*random( state ) - 1.0;
+    float a = 6.2831853*random( state );
+    return vec3( sqrt( 1.0 - z*z )*vec2( cos(a), sin(a) ), z );
+}
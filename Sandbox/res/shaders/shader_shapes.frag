@@ -1,4 +1,5 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
 
 layout(binding = 0) uniform UniformBufferObject {
     mat4 model;
@@ -6,6 +7,9 @@ layout(binding = 0) uniform UniformBufferObject {
     mat4 proj;
 } ubo;
 
+// Safe per-tile start distance written by shader_shapes_cone.frag
+layout(binding = 1) uniform sampler2D u_ConeDepth;
+
 layout(location = 0) in vec3 v_Color;
 layout(location = 1) in vec2 v_TexCoord;
 //layout(location = 2) in vec3 v_Normal;
@@ -17,399 +21,18 @@ layout(location = 0) out vec4 color;
 layout(push_constant) uniform Push {
     vec2 iResolution;
     float iTime;
+    uint iFlags;
 } PushConstants;
 
-// Copyright Inigo Quilez, 2016 - https://iquilezles.org/
-// I am the sole copyright owner of this Work.
-// You cannot host, display, distribute or share this Work in any form,
-// including physical and digital. You cannot use this Work in any
-// commercial or non-commercial product, website or project. You cannot
-// sell this Work and you cannot mint an NFTs of it.
-// I share this Work for educational purposes, and you can link to it,
-// through an URL, proper attribution and unmodified screenshot, as part
-// of your educational material. If these conditions are too restrictive
-// please contact me and we'll definitely work it out.
-
-// A list of useful distance function to simple primitives. All
-// these functions (except for ellipsoid) return an exact
-// euclidean distance, meaning they produce a better SDF than
-// what you'd get if you were constructing them from boolean
-// operations (such as cutting an infinite cylinder with two planes).
-
-// List of other 3D SDFs:
-//    https://www.shadertoy.com/playlist/43cXRl
-// and
-//    http://iquilezles.org/www/articles/distfunctions/distfunctions.htm
-
 #if HW_PERFORMANCE==0
 #define AA 2
 #else
 #define AA 2   // make this 2 or 3 for antialiasing
 #endif
 
-//------------------------------------------------------------------
-float dot2( in vec2 v ) { return dot(v,v); }
-float dot2( in vec3 v ) { return dot(v,v); }
-float ndot( in vec2 a, in vec2 b ) { return a.x*b.x - a.y*b.y; }
-
-float sdPlane( vec3 p )
-{
-	return p.y;
-}
-
-float sdSphere( vec3 p, float s )
-{
-    return length(p)-s;
-}
-
-float sdBox( vec3 p, vec3 b )
-{
-    vec3 d = abs(p) - b;
-    return min(max(d.x,max(d.y,d.z)),0.0) + length(max(d,0.0));
-}
-
-float sdBoundingBox( vec3 p, vec3 b, float e )
-{
-       p = abs(p  )-b;
-  vec3 q = abs(p+e)-e;
-
-  return min(min(
-      length(max(vec3(p.x,q.y,q.z),0.0))+min(max(p.x,max(q.y,q.z)),0.0),
-      length(max(vec3(q.x,p.y,q.z),0.0))+min(max(q.x,max(p.y,q.z)),0.0)),
-      length(max(vec3(q.x,q.y,p.z),0.0))+min(max(q.x,max(q.y,p.z)),0.0));
-}
-float sdEllipsoid( in vec3 p, in vec3 r ) // approximated
-{
-    float k0 = length(p/r);
-    float k1 = length(p/(r*r));
-    return k0*(k0-1.0)/k1;
-}
-
-float sdTorus( vec3 p, vec2 t )
-{
-    return length( vec2(length(p.xz)-t.x,p.y) )-t.y;
-}
-
-float sdCappedTorus(in vec3 p, in vec2 sc, in float ra, in float rb)
-{
-    p.x = abs(p.x);
-    float k = (sc.y*p.x>sc.x*p.y) ? dot(p.xy,sc) : length(p.xy);
-    return sqrt( dot(p,p) + ra*ra - 2.0*ra*k ) - rb;
-}
-
-float sdHexPrism( vec3 p, vec2 h )
-{
-    vec3 q = abs(p);
-
-    const vec3 k = vec3(-0.8660254, 0.5, 0.57735);
-    p = abs(p);
-    p.xy -= 2.0*min(dot(k.xy, p.xy), 0.0)*k.xy;
-    vec2 d = vec2(
-       length(p.xy - vec2(clamp(p.x, -k.z*h.x, k.z*h.x), h.x))*sign(p.y - h.x),
-       p.z-h.y );
-    return min(max(d.x,d.y),0.0) + length(max(d,0.0));
-}
-
-float sdOctogonPrism( in vec3 p, in float r, float h )
-{
-  const vec3 k = vec3(-0.9238795325,   // sqrt(2+sqrt(2))/2 
-                       0.3826834323,   // sqrt(2-sqrt(2))/2
-                       0.4142135623 ); // sqrt(2)-1 
-  // reflections
-  p = abs(p);
-  p.xy -= 2.0*min(dot(vec2( k.x,k.y),p.xy),0.0)*vec2( k.x,k.y);
-  p.xy -= 2.0*min(dot(vec2(-k.x,k.y),p.xy),0.0)*vec2(-k.x,k.y);
-  // polygon side
-  p.xy -= vec2(clamp(p.x, -k.z*r, k.z*r), r);
-  vec2 d = vec2( length(p.xy)*sign(p.y), p.z-h );
-  return min(max(d.x,d.y),0.0) + length(max(d,0.0));
-}
-
-float sdCapsule( vec3 p, vec3 a, vec3 b, float r )
-{
-	vec3 pa = p-a, ba = b-a;
-	float h = clamp( dot(pa,ba)/dot(ba,ba), 0.0, 1.0 );
-	return length( pa - ba*h ) - r;
-}
+#include "shapes_scene.glsl"
 
-float sdRoundCone( in vec3 p, in float r1, float r2, float h )
-{
-    vec2 q = vec2( length(p.xz), p.y );
-    
-    float b = (r1-r2)/h;
-    float a = sqrt(1.0-b*b);
-    float k = dot(q,vec2(-b,a));
-    
-    if( k < 0.0 ) return length(q) - r1;
-    if( k > a*h ) return length(q-vec2(0.0,h)) - r2;
-        
-    return dot(q, vec2(a,b) ) - r1;
-}
-
-float sdRoundCone(vec3 p, vec3 a, vec3 b, float r1, float r2)
-{
-    // sampling independent computations (only depend on shape)
-    vec3  ba = b - a;
-    float l2 = dot(ba,ba);
-    float rr = r1 - r2;
-    float a2 = l2 - rr*rr;
-    float il2 = 1.0/l2;
-    
-    // sampling dependant computations
-    vec3 pa = p - a;
-    float y = dot(pa,ba);
-    float z = y - l2;
-    float x2 = dot2( pa*l2 - ba*y );
-    float y2 = y*y*l2;
-    float z2 = z*z*l2;
-
-    // single square root!
-    float k = sign(rr)*rr*rr*x2;
-    if( sign(z)*a2*z2 > k ) return  sqrt(x2 + z2)        *il2 - r2;
-    if( sign(y)*a2*y2 < k ) return  sqrt(x2 + y2)        *il2 - r1;
-                            return (sqrt(x2*a2*il2)+y*rr)*il2 - r1;
-}
-
-float sdTriPrism( vec3 p, vec2 h )
-{
-    const float k = sqrt(3.0);
-    h.x *= 0.5*k;
-    p.xy /= h.x;
-    p.x = abs(p.x) - 1.0;
-    p.y = p.y + 1.0/k;
-    if( p.x+k*p.y>0.0 ) p.xy=vec2(p.x-k*p.y,-k*p.x-p.y)/2.0;
-    p.x -= clamp( p.x, -2.0, 0.0 );
-    float d1 = length(p.xy)*sign(-p.y)*h.x;
-    float d2 = abs(p.z)-h.y;
-    return length(max(vec2(d1,d2),0.0)) + min(max(d1,d2), 0.);
-}
-
-// vertical
-float sdCylinder( vec3 p, vec2 h )
-{
-    vec2 d = abs(vec2(length(p.xz),p.y)) - h;
-    return min(max(d.x,d.y),0.0) + length(max(d,0.0));
-}
-
-// arbitrary orientation
-float sdCylinder(vec3 p, vec3 a, vec3 b, float r)
-{
-    vec3 pa = p - a;
-    vec3 ba = b - a;
-    float baba = dot(ba,ba);
-    float paba = dot(pa,ba);
-
-    float x = length(pa*baba-ba*paba) - r*baba;
-    float y = abs(paba-baba*0.5)-baba*0.5;
-    float x2 = x*x;
-    float y2 = y*y*baba;
-    float d = (max(x,y)<0.0)?-min(x2,y2):(((x>0.0)?x2:0.0)+((y>0.0)?y2:0.0));
-    return sign(d)*sqrt(abs(d))/baba;
-}
-
-// vertical
-float sdCone( in vec3 p, in vec2 c, float h )
-{
-    vec2 q = h*vec2(c.x,-c.y)/c.y;
-    vec2 w = vec2( length(p.xz), p.y );
-    
-	vec2 a = w - q*clamp( dot(w,q)/dot(q,q), 0.0, 1.0 );
-    vec2 b = w - q*vec2( clamp( w.x/q.x, 0.0, 1.0 ), 1.0 );
-    float k = sign( q.y );
-    float d = min(dot( a, a ),dot(b, b));
-    float s = max( k*(w.x*q.y-w.y*q.x),k*(w.y-q.y)  );
-	return sqrt(d)*sign(s);
-}
-
-float sdCappedCone( in vec3 p, in float h, in float r1, in float r2 )
-{
-    vec2 q = vec2( length(p.xz), p.y );
-    
-    vec2 k1 = vec2(r2,h);
-    vec2 k2 = vec2(r2-r1,2.0*h);
-    vec2 ca = vec2(q.x-min(q.x,(q.y < 0.0)?r1:r2), abs(q.y)-h);
-    vec2 cb = q - k1 + k2*clamp( dot(k1-q,k2)/dot2(k2), 0.0, 1.0 );
-    float s = (cb.x < 0.0 && ca.y < 0.0) ? -1.0 : 1.0;
-    return s*sqrt( min(dot2(ca),dot2(cb)) );
-}
-
-float sdCappedCone(vec3 p, vec3 a, vec3 b, float ra, float rb)
-{
-    float rba  = rb-ra;
-    float baba = dot(b-a,b-a);
-    float papa = dot(p-a,p-a);
-    float paba = dot(p-a,b-a)/baba;
-
-    float x = sqrt( papa - paba*paba*baba );
-
-    float cax = max(0.0,x-((paba<0.5)?ra:rb));
-    float cay = abs(paba-0.5)-0.5;
-
-    float k = rba*rba + baba;
-    float f = clamp( (rba*(x-ra)+paba*baba)/k, 0.0, 1.0 );
-
-    float cbx = x-ra - f*rba;
-    float cby = paba - f;
-    
-    float s = (cbx < 0.0 && cay < 0.0) ? -1.0 : 1.0;
-    
-    return s*sqrt( min(cax*cax + cay*cay*baba,
-                       cbx*cbx + cby*cby*baba) );
-}
-
-// c is the sin/cos of the desired cone angle
-float sdSolidAngle(vec3 pos, vec2 c, float ra)
-{
-    vec2 p = vec2( length(pos.xz), pos.y );
-    float l = length(p) - ra;
-	float m = length(p - c*clamp(dot(p,c),0.0,ra) );
-    return max(l,m*sign(c.y*p.x-c.x*p.y));
-}
-
-float sdOctahedron(vec3 p, float s)
-{
-    p = abs(p);
-    float m = p.x + p.y + p.z - s;
-
-    // exact distance
-    #if 0
-    vec3 o = min(3.0*p - m, 0.0);
-    o = max(6.0*p - m*2.0 - o*3.0 + (o.x+o.y+o.z), 0.0);
-    return length(p - s*o/(o.x+o.y+o.z));
-    #endif
-    
-    // exact distance
-    #if 1
- 	vec3 q;
-         if( 3.0*p.x < m ) q = p.xyz;
-    else if( 3.0*p.y < m ) q = p.yzx;
-    else if( 3.0*p.z < m ) q = p.zxy;
-    else return m*0.57735027;
-    float k = clamp(0.5*(q.z-q.y+s),0.0,s); 
-    return length(vec3(q.x,q.y-s+k,q.z-k)); 
-    #endif
-    
-    // bound, not exact
-    #if 0
-	return m*0.57735027;
-    #endif
-}
-
-float sdPyramid( in vec3 p, in float h )
-{
-    float m2 = h*h + 0.25;
-    
-    // symmetry
-    p.xz = abs(p.xz);
-    p.xz = (p.z>p.x) ? p.zx : p.xz;
-    p.xz -= 0.5;
-	
-    // project into face plane (2D)
-    vec3 q = vec3( p.z, h*p.y - 0.5*p.x, h*p.x + 0.5*p.y);
-   
-    float s = max(-q.x,0.0);
-    float t = clamp( (q.y-0.5*p.z)/(m2+0.25), 0.0, 1.0 );
-    
-    float a = m2*(q.x+s)*(q.x+s) + q.y*q.y;
-	float b = m2*(q.x+0.5*t)*(q.x+0.5*t) + (q.y-m2*t)*(q.y-m2*t);
-    
-    float d2 = min(q.y,-q.x*m2-q.y*0.5) > 0.0 ? 0.0 : min(a,b);
-    
-    // recover 3D and scale, and add sign
-    return sqrt( (d2+q.z*q.z)/m2 ) * sign(max(q.z,-p.y));;
-}
-
-// la,lb=semi axis, h=height, ra=corner
-float sdRhombus(vec3 p, float la, float lb, float h, float ra)
-{
-    p = abs(p);
-    vec2 b = vec2(la,lb);
-    float f = clamp( (ndot(b,b-2.0*p.xz))/dot(b,b), -1.0, 1.0 );
-	vec2 q = vec2(length(p.xz-0.5*b*vec2(1.0-f,1.0+f))*sign(p.x*b.y+p.z*b.x-b.x*b.y)-ra, p.y-h);
-    return min(max(q.x,q.y),0.0) + length(max(q,0.0));
-}
-
-//------------------------------------------------------------------
-
-vec2 opU( vec2 d1, vec2 d2 )
-{
-	return (d1.x<d2.x) ? d1 : d2;
-}
-
-//------------------------------------------------------------------
-
-#define ZERO (min(0,0))
-
-//------------------------------------------------------------------
-
-vec2 map( in vec3 pos )
-{
-    vec2 res = vec2( 1e10, 0.0 );
-
-    {
-      res = opU( res, vec2( sdSphere(    pos-vec3(-2.0,0.25, 0.0), 0.25 ), 26.9 ) );
-    }
-
-    // bounding box
-    if( sdBox( pos-vec3(0.0,0.3,-1.0),vec3(0.35,0.3,2.5) )<res.x )
-    {
-    // more primitives
-    res = opU( res, vec2( sdBoundingBox( pos-vec3( 0.0,0.25, 0.0), vec3(0.3,0.25,0.2), 0.025 ), 16.9 ) );
-	res = opU( res, vec2( sdTorus(      (pos-vec3( 0.0,0.30, 1.0)).xzy, vec2(0.25,0.05) ), 25.0 ) );
-	res = opU( res, vec2( sdCone(        pos-vec3( 0.0,0.45,-1.0), vec2(0.6,0.8),0.45 ), 55.0 ) );
-    res = opU( res, vec2( sdCappedCone(  pos-vec3( 0.0,0.25,-2.0), 0.25, 0.25, 0.1 ), 13.67 ) );
-    res = opU( res, vec2( sdSolidAngle(  pos-vec3( 0.0,0.00,-3.0), vec2(3,4)/5.0, 0.4 ), 49.13 ) );
-    }
-
-    // bounding box
-    if( sdBox( pos-vec3(1.0,0.3,-1.0),vec3(0.35,0.3,2.5) )<res.x )
-    {
-    // more primitives
-	res = opU( res, vec2( sdCappedTorus((pos-vec3( 1.0,0.30, 1.0))*vec3(1,-1,1), vec2(0.866025,-0.5), 0.25, 0.05), 8.5) );
-    res = opU( res, vec2( sdBox(         pos-vec3( 1.0,0.25, 0.0), vec3(0.3,0.25,0.1) ), 3.0 ) );
-    res = opU( res, vec2( sdCapsule(     pos-vec3( 1.0,0.00,-1.0),vec3(-0.1,0.1,-0.1), vec3(0.2,0.4,0.2), 0.1  ), 31.9 ) );
-	res = opU( res, vec2( sdCylinder(    pos-vec3( 1.0,0.25,-2.0), vec2(0.15,0.25) ), 8.0 ) );
-    res = opU( res, vec2( sdHexPrism(    pos-vec3( 1.0,0.2,-3.0), vec2(0.2,0.05) ), 18.4 ) );
-    }
-
-    // bounding box
-    if( sdBox( pos-vec3(-1.0,0.35,-1.0),vec3(0.35,0.35,2.5))<res.x )
-    {
-    // more primitives
-	res = opU( res, vec2( sdPyramid(    pos-vec3(-1.0,-0.6,-3.0), 1.0 ), 13.56 ) );
-	res = opU( res, vec2( sdOctahedron( pos-vec3(-1.0,0.15,-2.0), 0.35 ), 23.56 ) );
-    res = opU( res, vec2( sdTriPrism(   pos-vec3(-1.0,0.15,-1.0), vec2(0.3,0.05) ),43.5 ) );
-    res = opU( res, vec2( sdEllipsoid(  pos-vec3(-1.0,0.25, 0.0), vec3(0.2, 0.25, 0.05) ), 43.17 ) );
-	res = opU( res, vec2( sdRhombus(   (pos-vec3(-1.0,0.34, 1.0)).xzy, 0.15, 0.25, 0.04, 0.08 ),17.0 ) );
-    }
-
-    // bounding box
-    if( sdBox( pos-vec3(2.0,0.3,-1.0),vec3(0.35,0.3,2.5) )<res.x )
-    {
-    // more primitives
-    res = opU( res, vec2( sdOctogonPrism(pos-vec3( 2.0,0.2,-3.0), 0.2, 0.05), 51.8 ) );
-    res = opU( res, vec2( sdCylinder(    pos-vec3( 2.0,0.15,-2.0), vec3(0.1,-0.1,0.0), vec3(-0.2,0.35,0.1), 0.08), 31.2 ) );
-	res = opU( res, vec2( sdCappedCone(  pos-vec3( 2.0,0.10,-1.0), vec3(0.1,0.0,0.0), vec3(-0.2,0.40,0.1), 0.15, 0.05), 46.1 ) );
-    res = opU( res, vec2( sdRoundCone(   pos-vec3( 2.0,0.15, 0.0), vec3(0.1,0.0,0.0), vec3(-0.1,0.35,0.1), 0.15, 0.05), 51.7 ) );
-    res = opU( res, vec2( sdRoundCone(   pos-vec3( 2.0,0.20, 1.0), 0.2, 0.1, 0.3 ), 37.0 ) );
-    }
-    
-    return res;
-}
-
-// http://iquilezles.org/www/articles/boxfunctions/boxfunctions.htm
-vec2 iBox( in vec3 ro, in vec3 rd, in vec3 rad ) 
-{
-    vec3 m = 1.0/rd;
-    vec3 n = m*ro;
-    vec3 k = abs(m)*rad;
-    vec3 t1 = -n - k;
-    vec3 t2 = -n + k;
-	return vec2( max( max( t1.x, t1.y ), t1.z ),
-	             min( min( t2.x, t2.y ), t2.z ) );
-}
-
-vec2 raycast( in vec3 ro, in vec3 rd )
+vec2 raycast( in vec3 ro, in vec3 rd, in float tstart, inout uint steps )
 {
     vec2 res = vec2(-1.0,-1.0);
 
@@ -426,16 +49,20 @@ vec2 raycast( in vec3 ro, in vec3 rd )
     //else return res;
     
     // raymarch primitives   
-    vec2 tb = iBox( ro-vec3(0.0,0.4,-0.5), rd, vec3(2.5,0.41,3.0) );
+    vec2 tb = iSceneBox( ro, rd );
     if( tb.x<tb.y && tb.y>0.0 && tb.x<tmax)
     {
         //return vec2(tb.x,2.0);
         tmin = max(tb.x,tmin);
         tmax = min(tb.y,tmax);
 
+        // skip the empty space the cone prepass already proved for this tile
+        tmin = max(tmin,tstart);
+
         float t = tmin;
         for( int i=0; i<70 && t<tmax; i++ )
         {
+            steps++;
             vec2 h = map( ro+rd*t );
             if( abs(h.x)<(0.0001*t) )
             { 
@@ -516,13 +143,13 @@ float checkersGradBox( in vec2 p, in vec2 dpdx, in vec2 dpdy )
     return 0.5 - 0.5*i.x*i.y;                  
 }
 
-vec3 render( in vec3 ro, in vec3 rd, in vec3 rdx, in vec3 rdy )
+vec3 render( in vec3 ro, in vec3 rd, in vec3 rdx, in vec3 rdy, in float tstart, inout uint steps )
 { 
     // background
     vec3 col = vec3(0.7, 0.7, 0.9) - max(rd.y,0.0)*0.3;
     
     // raycast scene
-    vec2 res = raycast(ro,rd);
+    vec2 res = raycast(ro,rd,tstart,steps);
     float t = res.x;
 	float m = res.y;
     if( m>-0.5 )
@@ -597,27 +224,19 @@ vec3 render( in vec3 ro, in vec3 rd, in vec3 rdx, in vec3 rdy )
 	return vec3( clamp(col,0.0,1.0) );
 }
 
-mat3 setCamera( in vec3 ro, in vec3 ta, float cr )
-{
-	vec3 cw = normalize(ta-ro);
-	vec3 cp = vec3(sin(cr), cos(cr),0.0);
-	vec3 cu = normalize( cross(cw,cp) );
-	vec3 cv =          ( cross(cu,cw) );
-    return mat3( cu, cv, cw );
-}
-
-
 void main() {
 	vec2 uv = (2.0*v_FragPos-PushConstants.iResolution.xy)/PushConstants.iResolution.y;
 
-    vec2 mo = 1/PushConstants.iResolution.xy;
-	float time = 32.0 + PushConstants.iTime * 1.5;
+    // camera
+    vec3 ro;
+    mat3 ca;
+    sceneCamera( ro, ca );
+
+    float tstart = 0.0;
+    if( (PushConstants.iFlags & RAYMARCH_FLAG_CONE_MARCHING) != 0u )
+        tstart = texelFetch( u_ConeDepth, ivec2(gl_FragCoord.xy) / CONE_TILE_SIZE, 0 ).r;
 
-    // camera	
-    vec3 ta = vec3( 0.5, -0.5, -0.6 );
-    vec3 ro = ta + vec3( 4.5*cos(0.1*time + 7.0*mo.x), 1.3 + 2.0*mo.y, 4.5*sin(0.1*time + 7.0*mo.x) );
-    // camera-to-world transformation
-    mat3 ca = setCamera( ro, ta, 0.0 );
+    uint steps = 0u;
 
     vec3 tot = vec3(0.0);
 #if AA>1
@@ -632,7 +251,7 @@ void main() {
 #endif
 
         // focal length
-        const float fl = 2.5;
+        const float fl = CAMERA_FOCAL_LENGTH;
         
         // ray direction
         vec3 rd = ca * normalize( vec3(p,fl) );
@@ -644,7 +263,7 @@ void main() {
         vec3 rdy = ca * normalize( vec3(py,fl) );
         
         // render	
-        vec3 col = render( ro, rd, rdx, rdy );
+        vec3 col = render( ro, rd, rdx, rdy, tstart, steps );
 
         // gain
         // col = col*3.0/(2.5+col);
@@ -658,6 +277,12 @@ void main() {
     tot /= float(AA*AA);
 #endif
 
+    if( (PushConstants.iFlags & RAYMARCH_FLAG_COLLECT_STATS) != 0u )
+    {
+        atomicAdd( stats.Steps, steps );
+        atomicAdd( stats.Rays, uint(AA*AA) );
+    }
+
     float gamma = 2.2;
     //tot.rgb = pow(tot.rgb, vec3(1.0/gamma));
     color = vec4( tot, 1.0 );
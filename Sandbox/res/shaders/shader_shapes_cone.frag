@@ -0,0 +1,61 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+// Coarse cone marching prepass for shader_shapes.frag.
+//
+// Runs at 1/CONE_TILE_SIZE resolution. Each fragment marches a cone that
+// encloses every ray of its full-resolution tile (including AA sub-samples)
+// and writes the distance up to which the whole cone is known to be empty.
+// The full-resolution pass then starts raycast() from that distance.
+
+layout(location = 3) in vec2 v_FragPos;
+
+layout(location = 0) out float coneDepth;
+
+layout(push_constant) uniform Push {
+    vec2 iResolution;
+    float iTime;
+    uint iFlags;
+} PushConstants;
+
+#include "shapes_scene.glsl"
+
+void main() {
+    // Tile center in full resolution coordinates. shader.vert mirrors the
+    // quad, so v_FragPos = iResolution - gl_FragCoord in the full pass.
+    vec2 fragPos = PushConstants.iResolution - gl_FragCoord.xy * float(CONE_TILE_SIZE);
+    vec2 p = (2.0*fragPos-PushConstants.iResolution.xy)/PushConstants.iResolution.y;
+
+    vec3 ro;
+    mat3 ca;
+    sceneCamera( ro, ca );
+    vec3 rd = ca * normalize( vec3(p,CAMERA_FOCAL_LENGTH) );
+
+    // cone half-angle: half tile diagonal plus one pixel of slack for the
+    // AA offsets, converted to world units per unit of ray distance
+    float radiusPx = 0.70710678*float(CONE_TILE_SIZE) + 1.0;
+    float coneK = (2.0*radiusPx/PushConstants.iResolution.y) / CAMERA_FOCAL_LENGTH;
+
+    // march from the same tmin as raycast() rather than from this ray's
+    // bounding box entry: rays near the tile edge may enter the box earlier
+    float tmin = 1.0;
+    float tmax = 20.0;
+
+    uint steps = 0u;
+    float t = tmin;
+    for( int i=0; i<48 && t<tmax; i++ )
+    {
+        steps++;
+        // any ray of the tile is within coneK*t of this point, so the
+        // clearance left for it is h - coneK*t
+        float h = map( ro+rd*t ).x - coneK*t;
+        if( h<(0.002*t) )
+            break;
+        t += h;
+    }
+
+    if( (PushConstants.iFlags & RAYMARCH_FLAG_COLLECT_STATS) != 0u )
+        atomicAdd( stats.PrepassSteps, steps );
+
+    coneDepth = t;
+}
@@ -0,0 +1,23 @@
+#version 450
+
+// Upscales the dynamic resolution scene target to the swapchain image
+
+layout(binding = 0) uniform sampler2D u_Scene;
+
+layout(location = 0) in vec2 v_TexCoord;
+
+layout(location = 0) out vec4 color;
+
+layout(push_constant) uniform Push {
+    // rendered region of the target, in target UV space
+    vec2 iUVScale;
+    // last texel center inside the rendered region, keeps bilinear
+    // filtering from reading stale texels beyond it
+    vec2 iUVClamp;
+} PushConstants;
+
+void main() {
+    vec2 uv = min(v_TexCoord * PushConstants.iUVScale, PushConstants.iUVClamp);
+
+    color = vec4(texture(u_Scene, uv).rgb, 1.0);
+}
@@ -10,47 +10,26 @@ using namespace physx;
 
 class GameScene : public Rui::Scene {
 public:
-    PxDefaultAllocator		gAllocator;
-    PxDefaultErrorCallback	gErrorCallback;
+    std::unique_ptr<Rui::PhysicsWorld> physics;
 
-    PxFoundation* gFoundation = NULL;
     PxPhysics* gPhysics = NULL;
-    PxCooking* gCooking = NULL;
-
-    PxDefaultCpuDispatcher* gDispatcher = NULL;
     PxScene* gScene = NULL;
 
     PxMaterial* gMaterial = NULL;
 
-    PxPvd* gPvd = NULL;
-
     PxReal stackZ = 10.0f;
 
     std::vector<PxRigidDynamic*> objects;
 
     GameScene() {
-        gFoundation = PxCreateFoundation(PX_PHYSICS_VERSION, gAllocator, gErrorCallback);
-
-        gPvd = PxCreatePvd(*gFoundation);
-        PxPvdTransport* transport = PxDefaultPvdSocketTransportCreate("127.0.0.1", 5425, 10);
-        gPvd->connect(*transport, PxPvdInstrumentationFlag::eALL);
-
-        gPhysics = PxCreatePhysics(PX_PHYSICS_VERSION, *gFoundation, PxTolerancesScale(), true, gPvd);
-        gCooking = PxCreateCooking(PX_PHYSICS_VERSION, *gFoundation, PxCookingParams(PxTolerancesScale()));
-
-        PxSceneDesc sceneDesc(gPhysics->getTolerancesScale());
-        sceneDesc.gravity = PxVec3(0.0f, -1.81f, 0.0f);
-        gDispatcher = PxDefaultCpuDispatcherCreate(2);
-        sceneDesc.cpuDispatcher = gDispatcher;
-        sceneDesc.filterShader = PxDefaultSimulationFilterShader;
-        gScene = gPhysics->createScene(sceneDesc);
-
-        PxPvdSceneClient* pvdClient = gScene->getScenePvdClient();
-        if(pvdClient) {
-            pvdClient->setScenePvdFlag(PxPvdSceneFlag::eTRANSMIT_CONSTRAINTS, true);
-            pvdClient->setScenePvdFlag(PxPvdSceneFlag::eTRANSMIT_CONTACTS, true);
-            pvdClient->setScenePvdFlag(PxPvdSceneFlag::eTRANSMIT_SCENEQUERIES, true);
-        }
+        Rui::PhysicsSettings settings;
+        settings.Gravity = PxVec3(0.0f, -1.81f, 0.0f);
+        settings.ConnectPvd = true;
+        physics = Rui::PhysicsWorld::Create(settings);
+
+        gPhysics = &physics->GetPhysics();
+        gScene = &physics->GetScene();
+
         gMaterial = gPhysics->createMaterial(0.5f, 0.5f, 0.9f);
 
         PxRigidStatic* groundPlane = PxCreatePlane(*gPhysics, PxPlane(0, 1, 0, 0), *gMaterial);
@@ -64,9 +43,8 @@ public:
     };
 
     ~GameScene() {
-        gCooking->release();
-        gPhysics->release();
-        gFoundation->release();
+        // Waits for the last step before the scene goes
+        physics.reset();
     };
 
     PxRigidDynamic* CreateDynamic(const PxTransform& t, const PxGeometry& geometry, const PxVec3& velocity) {
@@ -95,23 +73,47 @@ public:
 
     void OnUpdate(const Rui::Timestep& ts) override {
         //RUI_TRACE("{0}s Timestep", 1);
-        
-        gScene->simulate(static_cast<PxReal>(ts.m_dt));
-        gScene->fetchResults(true);
+
+        // Results of the step started last tick; usually done by now
+        physics->Collect();
+
+        // Gameplay reads and writes actors here
+
+        // Runs on the PhysX workers while the frame is rendered
+        physics->Step(static_cast<PxReal>(ts.m_dt));
+    }
+
+    bool OnKeyPressed(Rui::KeyPressedEvent& e) {
+        switch(e.GetKeyCode()) {
+        case SDLK_c:
+            Rui::RenderSystem::SetConeMarching(!Rui::RenderSystem::IsConeMarching());
+            return true;
+        case SDLK_b:
+            Rui::RenderSystem::RunRaymarchBenchmark();
+            return true;
+        }
+        return false;
     }
 
     void OnEvent(Rui::Event& event) override {}
-    void OnLoad() override {}
-    void OnUnload() override {}
+    void OnLoad() override {
+        Rui::Application::Get().GetEventBus().Subscribe<Rui::KeyPressedEvent, &GameScene::OnKeyPressed>(this);
+    }
+    void OnUnload() override {
+        Rui::Application::Get().GetEventBus().Unsubscribe<Rui::KeyPressedEvent, &GameScene::OnKeyPressed>(this);
+    }
 	void OnRender(const Rui::Timestep& ts) override {
-        Rui::RenderSystem::DrawTriangle();
+        Rui::RenderSystem::DrawTriangle(ts);
+
+        // Picks the step up early if it finished while rendering
+        physics->TryCollect();
     }
 };
 
 class Sandbox : public Rui::Application {
 public:
 	
-	Sandbox() : Rui::Application("Hello College Admissions Person :)", 1280, 720) {
+	Sandbox(Rui::ApplicationCommandLineArgs args) : Rui::Application("Hello College Admissions Person :)", 1280, 720, args) {
 		LoadScene(new GameScene());
 	}
 
@@ -120,6 +122,6 @@ public:
 	}
 };
 
-Rui::Application* Rui::CreateApplication() {
-	return new Sandbox();
+Rui::Application* Rui::CreateApplication(Rui::ApplicationCommandLineArgs args) {
+	return new Sandbox(args);
 }
\ No newline at end of file
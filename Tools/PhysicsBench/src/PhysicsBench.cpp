@@ -0,0 +1,305 @@
+// Measures how stepping a PhysX scene scales, without a window or PVD
+//
+//     PhysicsBench [--bodies <n,...>] [--stacks <n,...>] [--threads <n,...>]
+//                  [--broadphase <sap|mbp|abp,...>] [--steps <n>] [--warmup <n>]
+//                  [--csv <file>] [--json <file>]
+//
+// Every combination of the swept values is one run. A run fills a fresh
+// PhysicsWorld with pyramids of boxes like the sandbox's CreateStack, lets
+// them settle for the warmup steps and then times each fixed step from
+// simulate until its results are fetched. Results go to stdout as CSV
+// unless a file is given.
+
+#include "Rui/Physics/PhysicsWorld.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace physx;
+
+struct BenchOptions {
+	std::vector<uint32_t> Bodies = { 1000, 4000, 16000 };
+	// Boxes along the base of each pyramid
+	std::vector<uint32_t> StackSizes = { 10 };
+	std::vector<uint32_t> Threads = { 0, 1, 2, 4, 8 };
+	std::vector<PxBroadPhaseType::Enum> BroadPhases = { PxBroadPhaseType::eSAP, PxBroadPhaseType::eMBP, PxBroadPhaseType::eABP };
+
+	uint32_t Steps = 600;
+	uint32_t Warmup = 60;
+	float DeltaTime = 1.0f / 60.0f;
+
+	std::string CsvPath;
+	std::string JsonPath;
+};
+
+struct BenchResult {
+	uint32_t Bodies = 0;
+	uint32_t StackSize = 0;
+	uint32_t Threads = 0;
+	PxBroadPhaseType::Enum BroadPhase = PxBroadPhaseType::eSAP;
+
+	double MeanMs = 0.0;
+	double P50Ms = 0.0;
+	double P90Ms = 0.0;
+	double P99Ms = 0.0;
+	double MaxMs = 0.0;
+
+	double MeanContacts = 0.0;
+	uint32_t MaxContacts = 0;
+	// Bodies still awake after the last step
+	uint32_t ActiveBodies = 0;
+};
+
+static const char* BroadPhaseName(PxBroadPhaseType::Enum type) {
+	switch(type) {
+	case PxBroadPhaseType::eSAP: return "sap";
+	case PxBroadPhaseType::eMBP: return "mbp";
+	case PxBroadPhaseType::eABP: return "abp";
+	default: return "unknown";
+	}
+}
+
+static bool ParseList(const std::string& text, std::vector<uint32_t>& values) {
+	values.clear();
+
+	std::stringstream stream(text);
+	std::string item;
+	while(std::getline(stream, item, ',')) {
+		try {
+			values.push_back(static_cast<uint32_t>(std::stoul(item)));
+		} catch(const std::exception&) {
+			return false;
+		}
+	}
+
+	return !values.empty();
+}
+
+static bool ParseCount(const std::string& text, uint32_t& value) {
+	try {
+		value = static_cast<uint32_t>(std::stoul(text));
+	} catch(const std::exception&) {
+		return false;
+	}
+
+	return true;
+}
+
+static bool ParseBroadPhases(const std::string& text, std::vector<PxBroadPhaseType::Enum>& values) {
+	values.clear();
+
+	std::stringstream stream(text);
+	std::string item;
+	while(std::getline(stream, item, ',')) {
+		if(item == "sap") values.push_back(PxBroadPhaseType::eSAP);
+		else if(item == "mbp") values.push_back(PxBroadPhaseType::eMBP);
+		else if(item == "abp") values.push_back(PxBroadPhaseType::eABP);
+		else return false;
+	}
+
+	return !values.empty();
+}
+
+static bool ParseOptions(int argc, char** argv, BenchOptions& options) {
+	for(int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if(i + 1 >= argc) {
+			std::cerr << "Missing value for " << arg << "\n";
+			return false;
+		}
+		std::string value = argv[++i];
+
+		bool ok = true;
+		if(arg == "--bodies") ok = ParseList(value, options.Bodies);
+		else if(arg == "--stacks") ok = ParseList(value, options.StackSizes);
+		else if(arg == "--threads") ok = ParseList(value, options.Threads);
+		else if(arg == "--broadphase") ok = ParseBroadPhases(value, options.BroadPhases);
+		else if(arg == "--steps") ok = ParseCount(value, options.Steps) && options.Steps > 0;
+		else if(arg == "--warmup") ok = ParseCount(value, options.Warmup);
+		else if(arg == "--csv") options.CsvPath = value;
+		else if(arg == "--json") options.JsonPath = value;
+		else {
+			std::cerr << "Unknown option " << arg << "\n";
+			return false;
+		}
+
+		if(!ok) {
+			std::cerr << "Invalid value " << value << " for " << arg << "\n";
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Pyramids of unit boxes as in the sandbox, laid out on a square grid so
+// that they do not touch. Returns the number of bodies created.
+static uint32_t CreateStacks(Rui::PhysicsWorld& world, PxMaterial& material, uint32_t bodies, uint32_t stackSize) {
+	PxPhysics& physics = world.GetPhysics();
+	PxScene& scene = world.GetScene();
+
+	const PxReal halfExtent = 0.5f;
+	PxShape* shape = physics.createShape(PxBoxGeometry(halfExtent, halfExtent, halfExtent), material);
+
+	uint32_t perStack = stackSize * (stackSize + 1) / 2;
+	uint32_t stacks = std::max(1u, (bodies + perStack - 1) / perStack);
+	uint32_t columns = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(stacks))));
+	PxReal spacing = stackSize * halfExtent * 2.0f + 4.0f;
+
+	uint32_t created = 0;
+	for(uint32_t s = 0; s < stacks && created < bodies; s++) {
+		PxTransform origin(PxVec3(
+			(static_cast<PxReal>(s % columns) - columns * 0.5f) * spacing,
+			0.0f,
+			(static_cast<PxReal>(s / columns) - columns * 0.5f) * spacing));
+
+		for(uint32_t i = 0; i < stackSize && created < bodies; i++) {
+			for(uint32_t j = 0; j < stackSize - i && created < bodies; j++) {
+				PxTransform local(PxVec3(PxReal(j * 2) - PxReal(stackSize - i), PxReal(i * 2 + 1), 0) * halfExtent);
+				PxRigidDynamic* body = physics.createRigidDynamic(origin.transform(local));
+				body->attachShape(*shape);
+				PxRigidBodyExt::updateMassAndInertia(*body, 10.0f);
+				scene.addActor(*body);
+				created++;
+			}
+		}
+	}
+
+	shape->release();
+	return created;
+}
+
+static double Percentile(const std::vector<double>& sorted, double fraction) {
+	size_t index = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+	return sorted[std::clamp<size_t>(index, 1, sorted.size()) - 1];
+}
+
+static BenchResult Run(const BenchOptions& options, uint32_t bodies, uint32_t stackSize, uint32_t threads, PxBroadPhaseType::Enum broadPhase) {
+	uint32_t columns = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(bodies) / (stackSize * (stackSize + 1) / 2))));
+	PxReal extent = (columns * 0.5f + 1.0f) * (stackSize + 4.0f);
+
+	Rui::PhysicsSettings settings;
+	settings.WorkerThreads = threads;
+	settings.BroadPhase = broadPhase;
+	settings.WorldBounds = PxBounds3(PxVec3(-extent, -extent, -extent), PxVec3(extent, extent, extent));
+	auto world = Rui::PhysicsWorld::Create(settings);
+
+	PxMaterial* material = world->GetPhysics().createMaterial(0.5f, 0.5f, 0.6f);
+	world->GetScene().addActor(*PxCreatePlane(world->GetPhysics(), PxPlane(0, 1, 0, 0), *material));
+
+	BenchResult result;
+	result.Bodies = CreateStacks(*world, *material, bodies, stackSize);
+	result.StackSize = stackSize;
+	result.Threads = threads;
+	result.BroadPhase = broadPhase;
+
+	for(uint32_t i = 0; i < options.Warmup; i++) {
+		world->Step(options.DeltaTime);
+		world->Collect();
+	}
+
+	std::vector<double> times;
+	times.reserve(options.Steps);
+	uint64_t totalContacts = 0;
+
+	for(uint32_t i = 0; i < options.Steps; i++) {
+		auto start = std::chrono::steady_clock::now();
+		world->Step(options.DeltaTime);
+		world->Collect();
+		times.push_back(std::chrono::duration<double, std::milli>{ std::chrono::steady_clock::now() - start }.count());
+
+		PxSimulationStatistics statistics;
+		world->GetScene().getSimulationStatistics(statistics);
+		totalContacts += statistics.nbDiscreteContactPairsTotal;
+		result.MaxContacts = std::max(result.MaxContacts, statistics.nbDiscreteContactPairsTotal);
+		result.ActiveBodies = statistics.nbActiveDynamicBodies;
+	}
+
+	for(double time : times) result.MeanMs += time;
+	result.MeanMs /= times.size();
+	result.MeanContacts = static_cast<double>(totalContacts) / times.size();
+
+	std::sort(times.begin(), times.end());
+	result.P50Ms = Percentile(times, 0.50);
+	result.P90Ms = Percentile(times, 0.90);
+	result.P99Ms = Percentile(times, 0.99);
+	result.MaxMs = times.back();
+
+	material->release();
+	return result;
+}
+
+static void WriteCsv(std::ostream& out, const std::vector<BenchResult>& results) {
+	out << "bodies,stack_size,threads,broadphase,mean_ms,p50_ms,p90_ms,p99_ms,max_ms,mean_contacts,max_contacts,active_bodies\n";
+	out << std::fixed << std::setprecision(4);
+	for(const BenchResult& r : results) {
+		out << r.Bodies << ',' << r.StackSize << ',' << r.Threads << ',' << BroadPhaseName(r.BroadPhase) << ','
+			<< r.MeanMs << ',' << r.P50Ms << ',' << r.P90Ms << ',' << r.P99Ms << ',' << r.MaxMs << ','
+			<< r.MeanContacts << ',' << r.MaxContacts << ',' << r.ActiveBodies << '\n';
+	}
+}
+
+static void WriteJson(std::ostream& out, const BenchOptions& options, const std::vector<BenchResult>& results) {
+	out << std::fixed << std::setprecision(4);
+	out << "{\n  \"steps\": " << options.Steps << ",\n  \"warmup\": " << options.Warmup << ",\n  \"dt\": " << options.DeltaTime << ",\n  \"runs\": [";
+	for(size_t i = 0; i < results.size(); i++) {
+		const BenchResult& r = results[i];
+		out << (i ? ",\n" : "\n")
+			<< "    { \"bodies\": " << r.Bodies << ", \"stack_size\": " << r.StackSize << ", \"threads\": " << r.Threads
+			<< ", \"broadphase\": \"" << BroadPhaseName(r.BroadPhase) << "\""
+			<< ", \"mean_ms\": " << r.MeanMs << ", \"p50_ms\": " << r.P50Ms << ", \"p90_ms\": " << r.P90Ms
+			<< ", \"p99_ms\": " << r.P99Ms << ", \"max_ms\": " << r.MaxMs
+			<< ", \"mean_contacts\": " << r.MeanContacts << ", \"max_contacts\": " << r.MaxContacts
+			<< ", \"active_bodies\": " << r.ActiveBodies << " }";
+	}
+	out << "\n  ]\n}\n";
+}
+
+int main(int argc, char** argv) {
+	BenchOptions options;
+	if(!ParseOptions(argc, argv, options)) {
+		std::cerr << "Usage: PhysicsBench [--bodies <n,...>] [--stacks <n,...>] [--threads <n,...>] [--broadphase <sap|mbp|abp,...>] [--steps <n>] [--warmup <n>] [--csv <file>] [--json <file>]\n";
+		return 1;
+	}
+
+	Rui::LogSettings logSettings;
+	logSettings.Async = false;
+	Rui::Log::Init("PhysicsBench", logSettings);
+
+	std::vector<BenchResult> results;
+	for(uint32_t bodies : options.Bodies) {
+		for(uint32_t stackSize : options.StackSizes) {
+			for(uint32_t threads : options.Threads) {
+				for(PxBroadPhaseType::Enum broadPhase : options.BroadPhases) {
+					results.push_back(Run(options, bodies, std::max(1u, stackSize), threads, broadPhase));
+
+					const BenchResult& r = results.back();
+					std::cerr << r.Bodies << " bodies, stacks of " << r.StackSize << ", " << r.Threads << " threads, " << BroadPhaseName(r.BroadPhase)
+						<< ": p50 " << r.P50Ms << " ms, p99 " << r.P99Ms << " ms\n";
+				}
+			}
+		}
+	}
+
+	if(!options.CsvPath.empty()) {
+		std::ofstream out(options.CsvPath, std::ios::trunc);
+		WriteCsv(out, results);
+	}
+	if(!options.JsonPath.empty()) {
+		std::ofstream out(options.JsonPath, std::ios::trunc);
+		WriteJson(out, options, results);
+	}
+	if(options.CsvPath.empty() && options.JsonPath.empty()) {
+		WriteCsv(std::cout, results);
+	}
+
+	Rui::Log::Shutdown();
+	return 0;
+}
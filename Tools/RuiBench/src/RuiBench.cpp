@@ -0,0 +1,663 @@
+// Renders scripted scenarios for a fixed number of frames and reports frame
+// and GPU times, optionally against a baseline from an earlier run
+//
+//     RuiBench [--scenarios <name[:arg],...>] [--frames <n>] [--warmup <n>]
+//              [--out <file.json>] [--baseline <file.json>] [--threshold <fraction>]
+//              [--mesh <file.rmesh>] [--texture <file.ktx2>] [--visible]
+//              [--gpu <name>] [engine options]
+//
+// Runs without a visible window unless --visible is given; --gpu picks e.g.
+// a software driver. Shaders are read from res/ like the sandbox does, so
+// run it from the Sandbox directory. Scenarios:
+//
+//     raymarch       the fullscreen raymarched scene alone
+//     quads:<n>      the scene plus up to n particle quads, one instanced draw
+//     upload:<mb>    the scene plus mb megabytes copied from staging each frame
+//     recreate       the scene, recreating the swapchain every frame
+//     meshes:<n>     the scene plus n instances of the --mesh file on a grid
+//                    around the camera target, each picking its own level
+//                    of detail; added to the defaults when --mesh is given
+//     streaming      the scene plus one --mesh instance with the --texture
+//                    file, growing from a speck to the whole view and
+//                    shrinking back; added to the defaults when both are
+//                    given. Fails unless the texture's resident mips follow,
+//                    so the texture needs mips above the always resident
+//                    tail (larger than 64 pixels).
+//
+// The results are written as JSON with one scenario per line. With a
+// baseline, every scenario whose median frame or GPU time grew by more than
+// the threshold is reported and the exit code is 1. A failed streaming
+// scenario also exits with 1.
+
+#include <Rui.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+
+using Clock = std::chrono::steady_clock;
+
+enum class ScenarioType {
+	Raymarch,
+	Quads,
+	Upload,
+	Recreate,
+	Meshes,
+	Streaming
+};
+
+struct Scenario {
+	std::string Name;
+	ScenarioType Type = ScenarioType::Raymarch;
+	uint32_t Count = 0;
+};
+
+struct TimingSummary {
+	double Mean = 0.0;
+	double P50 = 0.0;
+	double P95 = 0.0;
+	double P99 = 0.0;
+	double Max = 0.0;
+};
+
+struct ScenarioResult {
+	std::string Name;
+	TimingSummary FrameMs;
+	TimingSummary GpuMs;
+	// Upload scenarios only
+	TimingSummary CopyMs;
+	double UploadMBps = 0.0;
+	// Streaming scenarios only: the texture's finest resident mip with the
+	// mesh far, the finest while it was near and the one it ended at
+	bool Streamed = false;
+	uint32_t FarMip = 0;
+	uint32_t NearMip = 0;
+	uint32_t EndMip = 0;
+};
+
+struct BenchOptions {
+	std::vector<Scenario> Scenarios;
+	uint32_t Frames = 500;
+	uint32_t WarmupFrames = 100;
+	// Also warmed up for at least this long, so particles reach their steady count
+	double WarmupSeconds = 1.5;
+
+	// Drawn by the meshes and streaming scenarios
+	std::string MeshPath;
+	// Streamed by the streaming scenarios
+	std::string TexturePath;
+
+	std::string OutPath = "RuiBench.json";
+	std::string BaselinePath;
+	double Threshold = 0.10;
+};
+
+static bool ParseScenario(const std::string& text, Scenario& scenario) {
+	size_t colon = text.find(':');
+	std::string type = text.substr(0, colon);
+	uint32_t count = 0;
+	if(colon != std::string::npos) {
+		try {
+			count = static_cast<uint32_t>(std::stoul(text.substr(colon + 1)));
+		} catch(const std::exception&) {
+			return false;
+		}
+	}
+
+	scenario.Name = text;
+	scenario.Count = count;
+	if(type == "raymarch") scenario.Type = ScenarioType::Raymarch;
+	else if(type == "quads" && count > 0) scenario.Type = ScenarioType::Quads;
+	else if(type == "upload" && count > 0) scenario.Type = ScenarioType::Upload;
+	else if(type == "recreate") scenario.Type = ScenarioType::Recreate;
+	else if(type == "meshes" && count > 0) scenario.Type = ScenarioType::Meshes;
+	else if(type == "streaming") scenario.Type = ScenarioType::Streaming;
+	else return false;
+
+	return true;
+}
+
+// Unknown arguments are left to the engine
+static bool ParseOptions(Rui::ApplicationCommandLineArgs args, BenchOptions& options) {
+	std::string scenarios;
+
+	for(int i = 1; i < args.Count; i++) {
+		std::string arg = args[i];
+		bool hasValue = i + 1 < args.Count;
+
+		try {
+			if(arg == "--scenarios" && hasValue) scenarios = args[++i];
+			else if(arg == "--frames" && hasValue) options.Frames = static_cast<uint32_t>(std::stoul(args[++i]));
+			else if(arg == "--warmup" && hasValue) options.WarmupFrames = static_cast<uint32_t>(std::stoul(args[++i]));
+			else if(arg == "--out" && hasValue) options.OutPath = args[++i];
+			else if(arg == "--baseline" && hasValue) options.BaselinePath = args[++i];
+			else if(arg == "--threshold" && hasValue) options.Threshold = std::stod(args[++i]);
+			else if(arg == "--mesh" && hasValue) options.MeshPath = args[++i];
+			else if(arg == "--texture" && hasValue) options.TexturePath = args[++i];
+		} catch(const std::exception&) {
+			RUI_ERROR("Invalid value for {0}", arg);
+			return false;
+		}
+	}
+
+	if(scenarios.empty()) {
+		scenarios = "raymarch,quads:65536,quads:1048576,upload:64,recreate";
+		if(!options.MeshPath.empty()) scenarios += ",meshes:4096";
+		if(!options.MeshPath.empty() && !options.TexturePath.empty()) scenarios += ",streaming";
+	}
+
+	std::stringstream stream(scenarios);
+	std::string item;
+	while(std::getline(stream, item, ',')) {
+		Scenario scenario;
+		if(!ParseScenario(item, scenario)) {
+			RUI_ERROR("Unknown scenario {0}", item);
+			return false;
+		}
+		if(scenario.Type == ScenarioType::Meshes && options.MeshPath.empty()) {
+			RUI_ERROR("Scenario {0} needs --mesh", item);
+			return false;
+		}
+		if(scenario.Type == ScenarioType::Streaming && (options.MeshPath.empty() || options.TexturePath.empty())) {
+			RUI_ERROR("Scenario {0} needs --mesh and --texture", item);
+			return false;
+		}
+		options.Scenarios.push_back(scenario);
+	}
+
+	return !options.Scenarios.empty() && options.Frames > 0;
+}
+
+static TimingSummary Summarize(std::vector<double> samples) {
+	TimingSummary summary;
+	if(samples.empty()) return summary;
+
+	for(double sample : samples) summary.Mean += sample;
+	summary.Mean /= samples.size();
+
+	std::sort(samples.begin(), samples.end());
+	auto percentile = [&](double fraction) {
+		size_t index = static_cast<size_t>(std::ceil(fraction * samples.size()));
+		return samples[std::clamp<size_t>(index, 1, samples.size()) - 1];
+	};
+	summary.P50 = percentile(0.50);
+	summary.P95 = percentile(0.95);
+	summary.P99 = percentile(0.99);
+	summary.Max = samples.back();
+
+	return summary;
+}
+
+// Copies from a host visible staging buffer into a device local one, on
+// the graphics queue between frames. Each frame slot has its own staging
+// buffer and command buffer, reused once the slot's copy completed.
+class UploadWorkload {
+public:
+	explicit UploadWorkload(vk::DeviceSize bytes)
+		: m_Bytes(bytes), m_Source(static_cast<size_t>(bytes)), m_Timer(Rui::SwapChain::MAX_FRAMES_IN_FLIGHT, 2) {
+		// Not all zeros, so nothing along the way can shortcut the copy
+		for(size_t i = 0; i < m_Source.size(); i++) {
+			m_Source[i] = static_cast<std::byte>(i * 2654435761u >> 24);
+		}
+
+		Rui::BufferDesc stagingDesc;
+		stagingDesc.Size = bytes;
+		stagingDesc.Usage = vk::BufferUsageFlagBits::eTransferSrc;
+		stagingDesc.MemoryProperties = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+		stagingDesc.Category = Rui::MemoryCategory::Staging;
+		stagingDesc.Mapped = true;
+
+		Rui::BufferDesc targetDesc;
+		targetDesc.Size = bytes;
+		targetDesc.Usage = vk::BufferUsageFlagBits::eTransferDst;
+
+		for(auto& slot : m_Slots) {
+			slot.Staging = Rui::ResourceManager::CreateBuffer(stagingDesc);
+			slot.Target = Rui::ResourceManager::CreateBuffer(targetDesc);
+		}
+
+		Rui::Device& device = Rui::RenderSystem::GetDevice();
+		vk::CommandBufferAllocateInfo allocInfo(device.GetCommandPool(), vk::CommandBufferLevel::ePrimary, static_cast<uint32_t>(m_Slots.size()));
+		std::vector<vk::CommandBuffer> commandBuffers(m_Slots.size());
+		if(device.GetDevice().allocateCommandBuffers(&allocInfo, commandBuffers.data()) != vk::Result::eSuccess) {
+			RUI_ERROR("Failed to allocate upload command buffers!");
+		}
+		for(size_t i = 0; i < m_Slots.size(); i++) {
+			m_Slots[i].CommandBuffer = commandBuffers[i];
+		}
+	}
+
+	~UploadWorkload() {
+		Rui::Device& device = Rui::RenderSystem::GetDevice();
+		device.GetDevice().waitIdle();
+
+		for(auto& slot : m_Slots) {
+			device.GetDevice().freeCommandBuffers(device.GetCommandPool(), 1, &slot.CommandBuffer);
+			Rui::ResourceManager::Destroy(slot.Staging);
+			Rui::ResourceManager::Destroy(slot.Target);
+		}
+	}
+
+	UploadWorkload(const UploadWorkload&) = delete;
+	UploadWorkload& operator=(const UploadWorkload&) = delete;
+
+	// Returns the GPU time of the copy last submitted from this slot, or a
+	// negative value if it has none
+	double Submit() {
+		Rui::Device& device = Rui::RenderSystem::GetDevice();
+		uint32_t index = m_Next;
+		m_Next = (m_Next + 1) % m_Slots.size();
+		Slot& slot = m_Slots[index];
+
+		device.GetGraphicsTimeline().Wait(slot.Value);
+
+		double copyMs = -1.0;
+		if(slot.Value && m_Timer.Resolve(index, m_Intervals)) {
+			copyMs = m_Intervals[0];
+		}
+
+		std::memcpy(Rui::ResourceManager::Get(slot.Staging)->Mapped, m_Source.data(), m_Source.size());
+
+		vk::CommandBuffer commandBuffer = slot.CommandBuffer;
+		vk::CommandBufferBeginInfo beginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+		commandBuffer.begin(&beginInfo);
+
+		m_Timer.Reset(commandBuffer, index);
+		m_Timer.Timestamp(commandBuffer, index, 0, vk::PipelineStageFlagBits::eTopOfPipe);
+
+		vk::BufferCopy region(0, 0, m_Bytes);
+		commandBuffer.copyBuffer(Rui::ResourceManager::Get(slot.Staging)->Buffer, Rui::ResourceManager::Get(slot.Target)->Buffer, 1, &region);
+
+		m_Timer.Timestamp(commandBuffer, index, 1, vk::PipelineStageFlagBits::eTransfer);
+		commandBuffer.end();
+
+		slot.Value = device.Submit(device.GetGraphicsTimeline(), { commandBuffer });
+		return copyMs;
+	}
+private:
+	struct Slot {
+		Rui::BufferHandle Staging;
+		Rui::BufferHandle Target;
+		vk::CommandBuffer CommandBuffer;
+		uint64_t Value = 0;
+	};
+
+	vk::DeviceSize m_Bytes;
+	std::vector<std::byte> m_Source;
+	std::array<Slot, Rui::SwapChain::MAX_FRAMES_IN_FLIGHT> m_Slots;
+	uint32_t m_Next = 0;
+
+	Rui::GpuTimer m_Timer;
+	std::vector<double> m_Intervals;
+};
+
+class BenchScene : public Rui::Scene {
+public:
+	explicit BenchScene(const BenchOptions& options) : m_Options(options) {
+		m_DefaultParticles = Rui::RenderSystem::GetParticles().GetSettings();
+
+		// Measured at full resolution, the controller would hide regressions
+		Rui::DynamicResolutionSettings resolution = Rui::RenderSystem::GetDynamicResolution().GetSettings();
+		resolution.Enabled = false;
+		Rui::RenderSystem::SetDynamicResolution(resolution);
+
+		BeginScenario(0);
+	}
+
+	void OnLoad() override {}
+	void OnUnload() override {}
+	void OnEvent(Rui::Event& event) override {}
+	void OnUpdate(const Rui::Timestep& ts) override {}
+
+	void OnRender(const Rui::Timestep& ts) override {
+		if(m_Current >= m_Options.Scenarios.size()) return;
+
+		auto now = Clock::now();
+		double frameMs = std::chrono::duration<double, std::milli>{ now - m_LastFrame }.count();
+		m_LastFrame = now;
+
+		const Scenario& scenario = m_Options.Scenarios[m_Current];
+
+		double copyMs = -1.0;
+		if(m_Upload) {
+			copyMs = m_Upload->Submit();
+		}
+		if(scenario.Type == ScenarioType::Recreate) {
+			Rui::RenderSystem::GetSwapChain().ReCreateSwapChain();
+		}
+		for(size_t i = 0; i < m_MeshTransforms.size(); i++) {
+			Rui::RenderSystem::SubmitMesh(m_Mesh, m_MeshTransforms[i], &m_MeshLods[i]);
+		}
+		if(scenario.Type == ScenarioType::Streaming) {
+			// Far through the warmup, near halfway through the measured frames
+			float progress = m_Warmup ? 0.0f : static_cast<float>(m_Frame) / m_Options.Frames;
+			float nearness = 1.0f - std::abs(2.0f * progress - 1.0f);
+			Rui::RenderSystem::SubmitMesh(m_Mesh, FitToTarget(0.02f + 1.98f * nearness), nullptr, m_Texture);
+		}
+
+		Rui::RenderSystem::DrawTriangle(ts);
+
+		if(m_Texture && !m_Warmup) {
+			uint32_t mip = m_Texture->GetResidentMip();
+			if(m_Frame == 0) m_FarMip = mip;
+			m_NearMip = std::min(m_NearMip, mip);
+			m_EndMip = mip;
+		}
+
+		if(m_Warmup) {
+			m_Frame++;
+			double warmedUp = std::chrono::duration<double>{ now - m_ScenarioStart }.count();
+			if(m_Frame >= m_Options.WarmupFrames && warmedUp >= m_Options.WarmupSeconds) {
+				m_Warmup = false;
+				m_Frame = 0;
+			}
+			return;
+		}
+
+		m_FrameSamples.push_back(frameMs);
+		m_GpuSamples.push_back(Rui::RenderSystem::GetGpuTimings().TotalMs);
+		if(copyMs >= 0.0) m_CopySamples.push_back(copyMs);
+
+		if(++m_Frame >= m_Options.Frames) {
+			EndScenario();
+			BeginScenario(m_Current + 1);
+		}
+	}
+private:
+	void BeginScenario(size_t index) {
+		m_Current = index;
+		if(m_Current >= m_Options.Scenarios.size()) {
+			Finish();
+			return;
+		}
+
+		const Scenario& scenario = m_Options.Scenarios[m_Current];
+		RUI_INFO("Running {0}", scenario.Name);
+
+		Rui::ParticleSettings particles = m_DefaultParticles;
+		particles.Enabled = scenario.Type == ScenarioType::Quads;
+		if(particles.Enabled) {
+			// Particles live 0.75 lifetimes on average, so this keeps the
+			// lists about full
+			particles.Capacity = scenario.Count;
+			particles.Lifetime = 1.0f;
+			particles.EmitRate = scenario.Count / (0.75f * particles.Lifetime);
+		}
+		Rui::RenderSystem::GetParticles().SetSettings(particles);
+
+		if(scenario.Type == ScenarioType::Upload) {
+			m_Upload = std::make_unique<UploadWorkload>(static_cast<vk::DeviceSize>(scenario.Count) << 20);
+		}
+		if(scenario.Type == ScenarioType::Meshes && !CreateMeshGrid(scenario.Count)) {
+			m_Current = m_Options.Scenarios.size();
+			Rui::Application::Get().Close(2);
+			return;
+		}
+		if(scenario.Type == ScenarioType::Streaming && !LoadStreamingAssets()) {
+			m_Current = m_Options.Scenarios.size();
+			Rui::Application::Get().Close(2);
+			return;
+		}
+
+		m_Warmup = true;
+		m_Frame = 0;
+		m_ScenarioStart = Clock::now();
+		m_LastFrame = m_ScenarioStart;
+		m_FrameSamples.clear();
+		m_GpuSamples.clear();
+		m_CopySamples.clear();
+	}
+
+	void EndScenario() {
+		const Scenario& scenario = m_Options.Scenarios[m_Current];
+
+		ScenarioResult result;
+		result.Name = scenario.Name;
+		result.FrameMs = Summarize(m_FrameSamples);
+		result.GpuMs = Summarize(m_GpuSamples);
+		result.CopyMs = Summarize(m_CopySamples);
+		if(result.CopyMs.Mean > 0.0) {
+			result.UploadMBps = scenario.Count / (result.CopyMs.Mean / 1000.0);
+		}
+
+		RUI_INFO("{0}: frame p50 {1:.3f} ms p99 {2:.3f} ms, gpu p50 {3:.3f} ms", result.Name, result.FrameMs.P50, result.FrameMs.P99, result.GpuMs.P50);
+
+		if(m_Texture) {
+			result.Streamed = true;
+			result.FarMip = m_FarMip;
+			result.NearMip = m_NearMip;
+			result.EndMip = m_EndMip;
+
+			// Finer mips have to come in as the mesh nears and go again as it recedes
+			if(m_NearMip < m_FarMip && m_EndMip > m_NearMip) {
+				RUI_INFO("{0}: resident mip {1} far, {2} near, {3} far again", result.Name, m_FarMip, m_NearMip, m_EndMip);
+			} else {
+				RUI_ERROR("{0}: resident mips did not follow the mesh: {1} far, {2} near, {3} far again", result.Name, m_FarMip, m_NearMip, m_EndMip);
+				m_Failed = true;
+			}
+		}
+
+		m_Results.push_back(result);
+
+		m_Upload.reset();
+		m_MeshTransforms.clear();
+		m_MeshLods.clear();
+		m_Texture.reset();
+	}
+
+	bool LoadStreamingAssets() {
+		if(!m_Mesh) m_Mesh = Rui::Mesh::Load(m_Options.MeshPath);
+		if(!m_Mesh) return false;
+
+		m_Texture = Rui::TextureSystem::Load(m_Options.TexturePath);
+		if(!m_Texture) return false;
+
+		m_FarMip = m_Texture->GetMipCount();
+		m_NearMip = m_FarMip;
+		m_EndMip = m_FarMip;
+		return true;
+	}
+
+	// The mesh centered on the point the scene camera orbits, scaled so its
+	// largest side is `size` long
+	glm::mat4 FitToTarget(float size) const {
+		const glm::vec3 target(0.5f, -0.5f, -0.6f);
+
+		glm::vec3 extent = m_Mesh->GetBoundsMax() - m_Mesh->GetBoundsMin();
+		float scale = size / std::max({ extent.x, extent.y, extent.z, 1e-6f });
+		glm::vec3 center = (m_Mesh->GetBoundsMin() + m_Mesh->GetBoundsMax()) * 0.5f;
+
+		glm::mat4 transform(scale);
+		transform[3] = glm::vec4(target - center * scale, 1.0f);
+		return transform;
+	}
+
+	// Lays the instances out on a square grid centered on the point the
+	// scene camera orbits, each scaled to fit its cell
+	bool CreateMeshGrid(uint32_t count) {
+		if(!m_Mesh) m_Mesh = Rui::Mesh::Load(m_Options.MeshPath);
+		if(!m_Mesh) return false;
+
+		const glm::vec3 target(0.5f, -0.5f, -0.6f);
+		const float extent = 8.0f;
+
+		uint32_t side = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+		float cell = extent / side;
+		glm::vec3 size = m_Mesh->GetBoundsMax() - m_Mesh->GetBoundsMin();
+		float scale = 0.8f * cell / std::max({ size.x, size.y, size.z, 1e-6f });
+		glm::vec3 center = (m_Mesh->GetBoundsMin() + m_Mesh->GetBoundsMax()) * 0.5f;
+
+		m_MeshTransforms.resize(count);
+		m_MeshLods.assign(count, 0);
+		for(uint32_t i = 0; i < count; i++) {
+			glm::vec3 position = target + glm::vec3((i % side + 0.5f) * cell - extent * 0.5f, 0.0f, (i / side + 0.5f) * cell - extent * 0.5f);
+
+			glm::mat4 transform(scale);
+			transform[3] = glm::vec4(position - center * scale, 1.0f);
+			m_MeshTransforms[i] = transform;
+		}
+
+		return true;
+	}
+
+	void Finish() {
+		Rui::RenderSystem::GetParticles().SetSettings(m_DefaultParticles);
+		m_Mesh.reset();
+
+		WriteResults();
+
+		int exitCode = m_Failed ? 1 : 0;
+		if(!m_Options.BaselinePath.empty() && !CompareBaseline()) {
+			exitCode = 1;
+		}
+
+		Rui::Application::Get().Close(exitCode);
+	}
+
+	static void WriteSummary(std::ostream& out, const char* name, const TimingSummary& summary) {
+		out << ", \"" << name << "_mean_ms\": " << summary.Mean << ", \"" << name << "_p50_ms\": " << summary.P50
+			<< ", \"" << name << "_p95_ms\": " << summary.P95 << ", \"" << name << "_p99_ms\": " << summary.P99
+			<< ", \"" << name << "_max_ms\": " << summary.Max;
+	}
+
+	void WriteResults() const {
+		std::ofstream out(m_Options.OutPath, std::ios::trunc);
+		if(!out.is_open()) {
+			RUI_ERROR("Could not write {0}", m_Options.OutPath);
+			return;
+		}
+
+		vk::Extent2D extent = Rui::RenderSystem::GetSwapChain().GetSwapChainExtent();
+		std::string device = Rui::RenderSystem::GetDevice().GetPhysicalDevice().getProperties().deviceName;
+
+		out << std::fixed << std::setprecision(4);
+		out << "{\n  \"device\": \"" << device << "\",\n  \"width\": " << extent.width << ",\n  \"height\": " << extent.height
+			<< ",\n  \"frames\": " << m_Options.Frames << ",\n  \"scenarios\": [";
+		for(size_t i = 0; i < m_Results.size(); i++) {
+			const ScenarioResult& result = m_Results[i];
+			out << (i ? ",\n" : "\n") << "    { \"name\": \"" << result.Name << "\"";
+			WriteSummary(out, "frame", result.FrameMs);
+			WriteSummary(out, "gpu", result.GpuMs);
+			if(result.UploadMBps > 0.0) {
+				WriteSummary(out, "copy", result.CopyMs);
+				out << ", \"upload_mb_per_s\": " << result.UploadMBps;
+			}
+			if(result.Streamed) {
+				out << ", \"far_mip\": " << result.FarMip << ", \"near_mip\": " << result.NearMip << ", \"end_mip\": " << result.EndMip;
+			}
+			out << " }";
+		}
+		out << "\n  ]\n}\n";
+
+		RUI_INFO("Wrote {0}", m_Options.OutPath);
+	}
+
+	// Reads `"key": number` from a scenario line of a results file
+	static double ReadNumber(const std::string& line, const std::string& key) {
+		size_t at = line.find("\"" + key + "\":");
+		if(at == std::string::npos) return 0.0;
+
+		return std::strtod(line.c_str() + at + key.size() + 3, nullptr);
+	}
+
+	// Returns false if any scenario regressed past the threshold
+	bool CompareBaseline() const {
+		std::ifstream in(m_Options.BaselinePath);
+		if(!in.is_open()) {
+			RUI_ERROR("Could not read baseline {0}", m_Options.BaselinePath);
+			return false;
+		}
+
+		bool passed = true;
+		std::string line;
+		while(std::getline(in, line)) {
+			size_t nameAt = line.find("\"name\": \"");
+			if(nameAt == std::string::npos) continue;
+
+			size_t nameStart = nameAt + 9;
+			std::string name = line.substr(nameStart, line.find('"', nameStart) - nameStart);
+
+			auto result = std::find_if(m_Results.begin(), m_Results.end(), [&](const ScenarioResult& r) { return r.Name == name; });
+			if(result == m_Results.end()) continue;
+
+			auto check = [&](const char* metric, double baseline, double current) {
+				if(baseline <= 0.0) return;
+
+				double change = current / baseline - 1.0;
+				if(change > m_Options.Threshold) {
+					RUI_ERROR("REGRESSION {0} {1}: {2:.3f} ms -> {3:.3f} ms (+{4:.1f}%)", name, metric, baseline, current, change * 100.0);
+					passed = false;
+				} else {
+					RUI_INFO("{0} {1}: {2:.3f} ms -> {3:.3f} ms ({4:+.1f}%)", name, metric, baseline, current, change * 100.0);
+				}
+			};
+			check("frame p50", ReadNumber(line, "frame_p50_ms"), result->FrameMs.P50);
+			check("gpu p50", ReadNumber(line, "gpu_p50_ms"), result->GpuMs.P50);
+		}
+
+		return passed;
+	}
+
+	BenchOptions m_Options;
+	Rui::ParticleSettings m_DefaultParticles;
+
+	size_t m_Current = 0;
+	bool m_Warmup = true;
+	uint32_t m_Frame = 0;
+	Clock::time_point m_ScenarioStart;
+	Clock::time_point m_LastFrame;
+
+	std::vector<double> m_FrameSamples;
+	std::vector<double> m_GpuSamples;
+	std::vector<double> m_CopySamples;
+	std::unique_ptr<UploadWorkload> m_Upload;
+
+	Rui::Ref<Rui::Mesh> m_Mesh;
+	std::vector<glm::mat4> m_MeshTransforms;
+	// Level each instance was drawn at, for hysteresis
+	std::vector<uint32_t> m_MeshLods;
+
+	Rui::Ref<Rui::Texture> m_Texture;
+	uint32_t m_FarMip = 0;
+	uint32_t m_NearMip = 0;
+	uint32_t m_EndMip = 0;
+	// A streaming scenario's mips did not follow the mesh
+	bool m_Failed = false;
+
+	std::vector<ScenarioResult> m_Results;
+};
+
+// Headless unless --visible is passed
+static Rui::ApplicationCommandLineArgs WithHeadless(Rui::ApplicationCommandLineArgs args) {
+	static std::vector<char*> arguments;
+	arguments.assign(args.Args, args.Args + args.Count);
+
+	static char headless[] = "--headless";
+	if(std::none_of(arguments.begin(), arguments.end(), [](const char* arg) { return std::strcmp(arg, "--visible") == 0; })) {
+		arguments.push_back(headless);
+	}
+
+	return { static_cast<int>(arguments.size()), arguments.data() };
+}
+
+class RuiBench : public Rui::Application {
+public:
+	RuiBench(Rui::ApplicationCommandLineArgs args) : Rui::Application("RuiBench", 1280, 720, WithHeadless(args)) {
+		BenchOptions options;
+		if(!ParseOptions(args, options)) {
+			RUI_ERROR("Usage: RuiBench [--scenarios <name[:arg],...>] [--frames <n>] [--warmup <n>] [--out <file.json>] [--baseline <file.json>] [--threshold <fraction>] [--mesh <file.rmesh>] [--texture <file.ktx2>] [--visible] [--gpu <name>]");
+			Close(2);
+			return;
+		}
+
+		m_Scene = std::make_unique<BenchScene>(options);
+		LoadScene(m_Scene.get());
+	}
+private:
+	std::unique_ptr<BenchScene> m_Scene;
+};
+
+Rui::Application* Rui::CreateApplication(Rui::ApplicationCommandLineArgs args) {
+	return new RuiBench(args);
+}
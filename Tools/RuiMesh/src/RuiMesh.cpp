@@ -0,0 +1,1104 @@
+// Converts OBJ and glTF meshes into Rui meshes (.rmesh), see Rui/Asset/MeshFormat.h
+//
+//     RuiMesh [--no-overdraw] [--overdraw-threshold <f>] [--lods <n>] [--lod-ratio <f>] [--lod-error <f>]
+//             <input.obj|.gltf|.glb> <output.rmesh>
+//
+// All triangles of the input are merged into one mesh, glTF nodes baked in.
+// Vertices are welded, normals generated when the input has none, indices
+// ordered for the vertex cache and overdraw, vertices for fetch, and the
+// attributes quantized.
+//
+// Up to --lods levels of detail are simplified from the full mesh, each
+// with --lod-ratio of the triangles of the one before. Simplification stops
+// early once the error would exceed --lod-error times the largest extent of
+// the mesh, which leaves a level above its target and ends the chain there.
+
+#include "Rui/Asset/MeshFormat.h"
+#include "Rui/Asset/MeshOptimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+struct MeshOptions {
+	fs::path Input;
+	fs::path Output;
+	bool Overdraw = true;
+	float OverdrawThreshold = 1.05f;
+	// Including the full mesh
+	uint32_t LodCount = 4;
+	float LodRatio = 0.5f;
+	float LodError = 0.02f;
+};
+
+struct ImportedVertex {
+	float Position[3];
+	float Normal[3];
+	float TexCoord[2];
+
+	bool operator==(const ImportedVertex& other) const {
+		return std::memcmp(this, &other, sizeof(ImportedVertex)) == 0;
+	}
+};
+
+struct ImportedVertexHash {
+	size_t operator()(const ImportedVertex& vertex) const {
+		// FNV-1a over the bytes, matching operator==
+		const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&vertex);
+		uint64_t hash = 14695981039346656037ull;
+		for(size_t i = 0; i < sizeof(ImportedVertex); i++) hash = (hash ^ bytes[i]) * 1099511628211ull;
+		return static_cast<size_t>(hash);
+	}
+};
+
+struct ImportedMesh {
+	// Three vertices per triangle until welded
+	std::vector<ImportedVertex> Vertices;
+	// Every level of detail, one after the other
+	std::vector<uint32_t> Indices;
+	std::vector<Rui::MeshLod> Lods;
+	bool HasNormals = true;
+};
+
+static bool ReadWholeFile(const fs::path& path, std::vector<std::byte>& data) {
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if(!file.is_open()) return false;
+
+	data.resize(static_cast<size_t>(file.tellg()));
+	file.seekg(0);
+	return static_cast<bool>(file.read(reinterpret_cast<char*>(data.data()), data.size()));
+}
+
+// ---- OBJ ----
+
+// "v", "v/t", "v//n" or "v/t/n", one based or negative from the end
+static bool ParseObjCorner(const std::string& token, const int64_t counts[3], int64_t corner[3]) {
+	corner[0] = corner[1] = corner[2] = -1;
+
+	size_t start = 0;
+	for(int k = 0; k < 3 && start <= token.size(); k++) {
+		size_t end = token.find('/', start);
+		if(end == std::string::npos) end = token.size();
+
+		if(end > start) {
+			int64_t index = std::strtoll(token.c_str() + start, nullptr, 10);
+			if(index < 0) index += counts[k];
+			else index -= 1;
+			if(index < 0 || index >= counts[k]) return false;
+			corner[k] = index;
+		}
+
+		start = end + 1;
+	}
+
+	return corner[0] >= 0;
+}
+
+static bool LoadObj(const fs::path& path, ImportedMesh& mesh) {
+	std::ifstream file(path);
+	if(!file.is_open()) {
+		std::cerr << "Could not read " << path << "\n";
+		return false;
+	}
+
+	std::vector<float> positions;
+	std::vector<float> normals;
+	std::vector<float> texCoords;
+	std::vector<int64_t> face;
+
+	std::string line;
+	size_t lineNumber = 0;
+	while(std::getline(file, line)) {
+		lineNumber++;
+		std::istringstream stream(line);
+		std::string keyword;
+		stream >> keyword;
+
+		if(keyword == "v") {
+			float x = 0.0f, y = 0.0f, z = 0.0f;
+			stream >> x >> y >> z;
+			positions.insert(positions.end(), { x, y, z });
+		} else if(keyword == "vn") {
+			float x = 0.0f, y = 0.0f, z = 0.0f;
+			stream >> x >> y >> z;
+			normals.insert(normals.end(), { x, y, z });
+		} else if(keyword == "vt") {
+			float u = 0.0f, v = 0.0f;
+			stream >> u >> v;
+			texCoords.insert(texCoords.end(), { u, v });
+		} else if(keyword == "f") {
+			int64_t counts[3] = {
+				static_cast<int64_t>(positions.size() / 3),
+				static_cast<int64_t>(texCoords.size() / 2),
+				static_cast<int64_t>(normals.size() / 3)
+			};
+
+			face.clear();
+			std::string token;
+			while(stream >> token) {
+				int64_t corner[3];
+				if(!ParseObjCorner(token, counts, corner)) {
+					std::cerr << path.generic_string() << ":" << lineNumber << ": bad face corner " << token << "\n";
+					return false;
+				}
+				face.insert(face.end(), corner, corner + 3);
+			}
+
+			auto emit = [&](size_t c) {
+				const int64_t* corner = &face[c * 3];
+				ImportedVertex vertex{};
+				std::memcpy(vertex.Position, &positions[corner[0] * 3], sizeof(vertex.Position));
+				if(corner[1] >= 0) {
+					// OBJ puts the texture origin at the bottom
+					vertex.TexCoord[0] = texCoords[corner[1] * 2];
+					vertex.TexCoord[1] = 1.0f - texCoords[corner[1] * 2 + 1];
+				}
+				if(corner[2] >= 0) {
+					std::memcpy(vertex.Normal, &normals[corner[2] * 3], sizeof(vertex.Normal));
+				} else {
+					mesh.HasNormals = false;
+				}
+				mesh.Vertices.push_back(vertex);
+			};
+
+			// Polygons as fans
+			for(size_t c = 2; c < face.size() / 3; c++) {
+				emit(0);
+				emit(c - 1);
+				emit(c);
+			}
+		}
+	}
+
+	return true;
+}
+
+// ---- glTF ----
+
+struct JsonValue {
+	enum class Type { Null, Bool, Number, String, Array, Object };
+
+	Type Kind = Type::Null;
+	bool Bool = false;
+	double Number = 0.0;
+	std::string String;
+	std::vector<JsonValue> Array;
+	std::vector<std::pair<std::string, JsonValue>> Members;
+
+	const JsonValue* Find(std::string_view key) const {
+		for(const auto& [name, value] : Members) {
+			if(name == key) return &value;
+		}
+		return nullptr;
+	}
+
+	double GetNumber(std::string_view key, double fallback) const {
+		const JsonValue* value = Find(key);
+		return value && value->Kind == Type::Number ? value->Number : fallback;
+	}
+
+	std::string GetString(std::string_view key) const {
+		const JsonValue* value = Find(key);
+		return value && value->Kind == Type::String ? value->String : std::string();
+	}
+
+	// Element `index` of the array member `key`, if there is one
+	const JsonValue* At(std::string_view key, double index) const {
+		const JsonValue* array = Find(key);
+		if(!array || array->Kind != Type::Array || index < 0 || index >= array->Array.size()) return nullptr;
+		return &array->Array[static_cast<size_t>(index)];
+	}
+};
+
+// Enough JSON for glTF: no validation beyond what parsing needs
+class JsonParser {
+public:
+	JsonParser(const char* begin, const char* end) : m_Cursor(begin), m_End(end) {}
+
+	bool Parse(JsonValue& value) {
+		if(!ParseValue(value, 0)) return false;
+		SkipWhitespace();
+		return m_Cursor == m_End;
+	}
+private:
+	void SkipWhitespace() {
+		while(m_Cursor < m_End && (*m_Cursor == ' ' || *m_Cursor == '\t' || *m_Cursor == '\n' || *m_Cursor == '\r')) m_Cursor++;
+	}
+
+	bool Consume(char c) {
+		SkipWhitespace();
+		if(m_Cursor < m_End && *m_Cursor == c) {
+			m_Cursor++;
+			return true;
+		}
+		return false;
+	}
+
+	bool ConsumeWord(std::string_view word) {
+		if(static_cast<size_t>(m_End - m_Cursor) < word.size() || std::string_view(m_Cursor, word.size()) != word) return false;
+		m_Cursor += word.size();
+		return true;
+	}
+
+	static void AppendUtf8(std::string& out, uint32_t code) {
+		if(code < 0x80) {
+			out += static_cast<char>(code);
+		} else if(code < 0x800) {
+			out += static_cast<char>(0xC0 | (code >> 6));
+			out += static_cast<char>(0x80 | (code & 0x3F));
+		} else if(code < 0x10000) {
+			out += static_cast<char>(0xE0 | (code >> 12));
+			out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+			out += static_cast<char>(0x80 | (code & 0x3F));
+		} else {
+			out += static_cast<char>(0xF0 | (code >> 18));
+			out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+			out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+			out += static_cast<char>(0x80 | (code & 0x3F));
+		}
+	}
+
+	bool ParseHex4(uint32_t& code) {
+		if(m_End - m_Cursor < 4) return false;
+		code = 0;
+		for(int i = 0; i < 4; i++) {
+			char c = *m_Cursor++;
+			code <<= 4;
+			if(c >= '0' && c <= '9') code |= c - '0';
+			else if(c >= 'a' && c <= 'f') code |= c - 'a' + 10;
+			else if(c >= 'A' && c <= 'F') code |= c - 'A' + 10;
+			else return false;
+		}
+		return true;
+	}
+
+	bool ParseString(std::string& out) {
+		if(!Consume('"')) return false;
+
+		while(m_Cursor < m_End && *m_Cursor != '"') {
+			char c = *m_Cursor++;
+			if(c != '\\') {
+				out += c;
+				continue;
+			}
+			if(m_Cursor == m_End) return false;
+
+			switch(char escape = *m_Cursor++) {
+				case 'b': out += '\b'; break;
+				case 'f': out += '\f'; break;
+				case 'n': out += '\n'; break;
+				case 'r': out += '\r'; break;
+				case 't': out += '\t'; break;
+				case 'u': {
+					uint32_t code;
+					if(!ParseHex4(code)) return false;
+					// Surrogate pair
+					if(code >= 0xD800 && code < 0xDC00 && ConsumeWord("\\u")) {
+						uint32_t low;
+						if(!ParseHex4(low)) return false;
+						code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+					}
+					AppendUtf8(out, code);
+					break;
+				}
+				default: out += escape; break;
+			}
+		}
+
+		return m_Cursor++ < m_End;
+	}
+
+	bool ParseValue(JsonValue& value, int depth) {
+		if(depth > 64) return false;
+
+		SkipWhitespace();
+		if(m_Cursor == m_End) return false;
+
+		switch(*m_Cursor) {
+			case '{': {
+				m_Cursor++;
+				value.Kind = JsonValue::Type::Object;
+				if(Consume('}')) return true;
+				do {
+					std::pair<std::string, JsonValue> member;
+					if(!ParseString(member.first) || !Consume(':') || !ParseValue(member.second, depth + 1)) return false;
+					value.Members.push_back(std::move(member));
+				} while(Consume(','));
+				return Consume('}');
+			}
+			case '[': {
+				m_Cursor++;
+				value.Kind = JsonValue::Type::Array;
+				if(Consume(']')) return true;
+				do {
+					if(!ParseValue(value.Array.emplace_back(), depth + 1)) return false;
+				} while(Consume(','));
+				return Consume(']');
+			}
+			case '"':
+				value.Kind = JsonValue::Type::String;
+				return ParseString(value.String);
+			case 't':
+				value.Kind = JsonValue::Type::Bool;
+				value.Bool = true;
+				return ConsumeWord("true");
+			case 'f':
+				value.Kind = JsonValue::Type::Bool;
+				return ConsumeWord("false");
+			case 'n':
+				return ConsumeWord("null");
+			default: {
+				char* end = nullptr;
+				// strtod stops at the closing quote, bracket or comma
+				value.Kind = JsonValue::Type::Number;
+				value.Number = std::strtod(m_Cursor, &end);
+				if(end == m_Cursor || end > m_End) return false;
+				m_Cursor = end;
+				return true;
+			}
+		}
+	}
+
+	const char* m_Cursor;
+	const char* m_End;
+};
+
+struct GltfDocument {
+	JsonValue Root;
+	std::vector<std::vector<std::byte>> Buffers;
+};
+
+static bool DecodeBase64(std::string_view text, std::vector<std::byte>& data) {
+	uint32_t bits = 0;
+	int count = 0;
+
+	for(char c : text) {
+		uint32_t value;
+		if(c >= 'A' && c <= 'Z') value = c - 'A';
+		else if(c >= 'a' && c <= 'z') value = c - 'a' + 26;
+		else if(c >= '0' && c <= '9') value = c - '0' + 52;
+		else if(c == '+' || c == '-') value = 62;
+		else if(c == '/' || c == '_') value = 63;
+		else if(c == '=') break;
+		else return false;
+
+		bits = (bits << 6) | value;
+		count += 6;
+		if(count >= 8) {
+			count -= 8;
+			data.push_back(static_cast<std::byte>((bits >> count) & 0xFF));
+		}
+	}
+
+	return true;
+}
+
+static bool LoadGltfDocument(const fs::path& path, GltfDocument& gltf) {
+	static constexpr uint32_t GLB_MAGIC = 0x46546C67;
+	static constexpr uint32_t GLB_CHUNK_JSON = 0x4E4F534A;
+	static constexpr uint32_t GLB_CHUNK_BIN = 0x004E4942;
+
+	std::vector<std::byte> file;
+	if(!ReadWholeFile(path, file)) {
+		std::cerr << "Could not read " << path << "\n";
+		return false;
+	}
+
+	const char* json = reinterpret_cast<const char*>(file.data());
+	size_t jsonSize = file.size();
+	std::vector<std::byte> binary;
+	bool hasBinary = false;
+
+	uint32_t magic = 0;
+	if(file.size() >= 12) std::memcpy(&magic, file.data(), sizeof(magic));
+
+	if(magic == GLB_MAGIC) {
+		// 12 byte header, then chunks of length, type and data
+		jsonSize = 0;
+		size_t offset = 12;
+		while(offset + 8 <= file.size()) {
+			uint32_t length, type;
+			std::memcpy(&length, file.data() + offset, sizeof(length));
+			std::memcpy(&type, file.data() + offset + 4, sizeof(type));
+			offset += 8;
+			if(offset + length > file.size()) break;
+
+			if(type == GLB_CHUNK_JSON && jsonSize == 0) {
+				json = reinterpret_cast<const char*>(file.data() + offset);
+				jsonSize = length;
+			} else if(type == GLB_CHUNK_BIN && !hasBinary) {
+				binary.assign(file.data() + offset, file.data() + offset + length);
+				hasBinary = true;
+			}
+			offset += (length + 3) & ~3u;
+		}
+
+		if(jsonSize == 0) {
+			std::cerr << path << " has no JSON chunk\n";
+			return false;
+		}
+	}
+
+	JsonParser parser(json, json + jsonSize);
+	if(!parser.Parse(gltf.Root) || gltf.Root.Kind != JsonValue::Type::Object) {
+		std::cerr << path << " is not valid JSON\n";
+		return false;
+	}
+
+	if(const JsonValue* buffers = gltf.Root.Find("buffers")) {
+		for(const JsonValue& buffer : buffers->Array) {
+			std::vector<std::byte>& data = gltf.Buffers.emplace_back();
+			std::string uri = buffer.GetString("uri");
+
+			if(uri.empty()) {
+				// The binary chunk of a .glb
+				if(!hasBinary) {
+					std::cerr << "Buffer without uri outside of a .glb\n";
+					return false;
+				}
+				data = binary;
+			} else if(uri.rfind("data:", 0) == 0) {
+				size_t comma = uri.find(";base64,");
+				if(comma == std::string::npos || !DecodeBase64(std::string_view(uri).substr(comma + 8), data)) {
+					std::cerr << "Unsupported data uri in buffer\n";
+					return false;
+				}
+			} else if(!ReadWholeFile(path.parent_path() / uri, data)) {
+				std::cerr << "Could not read buffer " << uri << "\n";
+				return false;
+			}
+
+			if(data.size() < buffer.GetNumber("byteLength", 0.0)) {
+				std::cerr << "Buffer " << uri << " is shorter than its byteLength\n";
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+// Reads `components` values per element as floats, normalizing integer
+// components when the accessor says so
+static bool ReadAccessor(const GltfDocument& gltf, double index, uint32_t components, std::vector<float>& out) {
+	const JsonValue* accessor = gltf.Root.At("accessors", index);
+	if(!accessor) {
+		std::cerr << "Missing accessor " << index << "\n";
+		return false;
+	}
+	if(accessor->Find("sparse")) {
+		std::cerr << "Sparse accessors are not supported\n";
+		return false;
+	}
+
+	std::string type = accessor->GetString("type");
+	uint32_t available = type == "SCALAR" ? 1 : type == "VEC2" ? 2 : type == "VEC3" ? 3 : type == "VEC4" ? 4 : 0;
+	if(available < components) {
+		std::cerr << "Accessor " << index << " of type " << type << " has fewer than " << components << " components\n";
+		return false;
+	}
+
+	size_t count = static_cast<size_t>(accessor->GetNumber("count", 0.0));
+	uint32_t componentType = static_cast<uint32_t>(accessor->GetNumber("componentType", 0.0));
+	bool normalized = accessor->Find("normalized") && accessor->Find("normalized")->Bool;
+
+	size_t componentSize;
+	switch(componentType) {
+		case 5120: case 5121: componentSize = 1; break;
+		case 5122: case 5123: componentSize = 2; break;
+		case 5125: case 5126: componentSize = 4; break;
+		default:
+			std::cerr << "Accessor " << index << " has unknown component type " << componentType << "\n";
+			return false;
+	}
+
+	out.assign(count * components, 0.0f);
+
+	// Accessors without a view are all zeros
+	const JsonValue* view = accessor->Find("bufferView") ? gltf.Root.At("bufferViews", accessor->GetNumber("bufferView", -1.0)) : nullptr;
+	if(!view) return !accessor->Find("bufferView");
+
+	size_t bufferIndex = static_cast<size_t>(view->GetNumber("buffer", 0.0));
+	if(bufferIndex >= gltf.Buffers.size()) {
+		std::cerr << "Buffer view refers to missing buffer " << bufferIndex << "\n";
+		return false;
+	}
+
+	const std::vector<std::byte>& buffer = gltf.Buffers[bufferIndex];
+	size_t elementSize = componentSize * available;
+	size_t stride = static_cast<size_t>(view->GetNumber("byteStride", static_cast<double>(elementSize)));
+	size_t offset = static_cast<size_t>(view->GetNumber("byteOffset", 0.0) + accessor->GetNumber("byteOffset", 0.0));
+	size_t viewEnd = static_cast<size_t>(view->GetNumber("byteOffset", 0.0) + view->GetNumber("byteLength", 0.0));
+
+	if(count > 0 && (offset + (count - 1) * stride + elementSize > viewEnd || viewEnd > buffer.size())) {
+		std::cerr << "Accessor " << index << " reads past its buffer view\n";
+		return false;
+	}
+
+	for(size_t i = 0; i < count; i++) {
+		const std::byte* element = buffer.data() + offset + i * stride;
+		for(uint32_t c = 0; c < components; c++) {
+			const std::byte* source = element + c * componentSize;
+			float value = 0.0f;
+
+			switch(componentType) {
+				case 5120: { int8_t v; std::memcpy(&v, source, 1); value = normalized ? std::max(v / 127.0f, -1.0f) : v; break; }
+				case 5121: { uint8_t v; std::memcpy(&v, source, 1); value = normalized ? v / 255.0f : v; break; }
+				case 5122: { int16_t v; std::memcpy(&v, source, 2); value = normalized ? std::max(v / 32767.0f, -1.0f) : v; break; }
+				case 5123: { uint16_t v; std::memcpy(&v, source, 2); value = normalized ? v / 65535.0f : v; break; }
+				case 5125: { uint32_t v; std::memcpy(&v, source, 4); value = static_cast<float>(v); break; }
+				case 5126: std::memcpy(&value, source, 4); break;
+			}
+
+			out[i * components + c] = value;
+		}
+	}
+
+	return true;
+}
+
+static bool ReadIndices(const GltfDocument& gltf, double index, std::vector<uint32_t>& out) {
+	// Indices are at most 32 bit integers, which floats would round
+	const JsonValue* accessor = gltf.Root.At("accessors", index);
+	const JsonValue* view = accessor ? gltf.Root.At("bufferViews", accessor->GetNumber("bufferView", -1.0)) : nullptr;
+	if(!view || accessor->GetString("type") != "SCALAR") {
+		std::cerr << "Bad index accessor " << index << "\n";
+		return false;
+	}
+
+	size_t bufferIndex = static_cast<size_t>(view->GetNumber("buffer", 0.0));
+	if(bufferIndex >= gltf.Buffers.size()) {
+		std::cerr << "Buffer view refers to missing buffer " << bufferIndex << "\n";
+		return false;
+	}
+
+	uint32_t componentType = static_cast<uint32_t>(accessor->GetNumber("componentType", 0.0));
+	size_t size = componentType == 5121 ? 1 : componentType == 5123 ? 2 : componentType == 5125 ? 4 : 0;
+	if(size == 0) {
+		std::cerr << "Index accessor " << index << " has component type " << componentType << "\n";
+		return false;
+	}
+
+	const std::vector<std::byte>& buffer = gltf.Buffers[bufferIndex];
+	size_t count = static_cast<size_t>(accessor->GetNumber("count", 0.0));
+	size_t stride = static_cast<size_t>(view->GetNumber("byteStride", static_cast<double>(size)));
+	size_t offset = static_cast<size_t>(view->GetNumber("byteOffset", 0.0) + accessor->GetNumber("byteOffset", 0.0));
+	size_t viewEnd = static_cast<size_t>(view->GetNumber("byteOffset", 0.0) + view->GetNumber("byteLength", 0.0));
+
+	if(count > 0 && (offset + (count - 1) * stride + size > viewEnd || viewEnd > buffer.size())) {
+		std::cerr << "Index accessor " << index << " reads past its buffer view\n";
+		return false;
+	}
+
+	out.resize(count);
+	for(size_t i = 0; i < count; i++) {
+		uint32_t value = 0;
+		std::memcpy(&value, buffer.data() + offset + i * stride, size);
+		out[i] = value;
+	}
+
+	return true;
+}
+
+// Column major 4x4
+using Matrix = std::array<float, 16>;
+
+static Matrix Multiply(const Matrix& a, const Matrix& b) {
+	Matrix result{};
+	for(int c = 0; c < 4; c++) {
+		for(int r = 0; r < 4; r++) {
+			for(int k = 0; k < 4; k++) result[c * 4 + r] += a[k * 4 + r] * b[c * 4 + k];
+		}
+	}
+	return result;
+}
+
+static Matrix NodeTransform(const JsonValue& node) {
+	Matrix matrix = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+
+	if(const JsonValue* values = node.Find("matrix"); values && values->Array.size() == 16) {
+		for(int i = 0; i < 16; i++) matrix[i] = static_cast<float>(values->Array[i].Number);
+		return matrix;
+	}
+
+	auto read = [&](const char* key, float* out, size_t count) {
+		const JsonValue* values = node.Find(key);
+		if(values && values->Array.size() == count) {
+			for(size_t i = 0; i < count; i++) out[i] = static_cast<float>(values->Array[i].Number);
+		}
+	};
+
+	float t[3] = { 0, 0, 0 };
+	float q[4] = { 0, 0, 0, 1 };
+	float s[3] = { 1, 1, 1 };
+	read("translation", t, 3);
+	read("rotation", q, 4);
+	read("scale", s, 3);
+
+	float x = q[0], y = q[1], z = q[2], w = q[3];
+	float rotation[9] = {
+		1 - 2 * (y * y + z * z), 2 * (x * y + w * z), 2 * (x * z - w * y),
+		2 * (x * y - w * z), 1 - 2 * (x * x + z * z), 2 * (y * z + w * x),
+		2 * (x * z + w * y), 2 * (y * z - w * x), 1 - 2 * (x * x + y * y)
+	};
+
+	for(int c = 0; c < 3; c++) {
+		for(int r = 0; r < 3; r++) matrix[c * 4 + r] = rotation[c * 3 + r] * s[c];
+		matrix[12 + c] = t[c];
+	}
+
+	return matrix;
+}
+
+static void Cross(const float* a, const float* b, float* out) {
+	out[0] = a[1] * b[2] - a[2] * b[1];
+	out[1] = a[2] * b[0] - a[0] * b[2];
+	out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+static bool AppendPrimitive(const GltfDocument& gltf, const JsonValue& primitive, const Matrix& transform, ImportedMesh& mesh) {
+	if(primitive.GetNumber("mode", 4.0) != 4.0) {
+		std::cerr << "Skipping a primitive that is not a triangle list\n";
+		return true;
+	}
+
+	const JsonValue* attributes = primitive.Find("attributes");
+	const JsonValue* position = attributes ? attributes->Find("POSITION") : nullptr;
+	if(!position) {
+		std::cerr << "Skipping a primitive without positions\n";
+		return true;
+	}
+
+	std::vector<float> positions, normals, texCoords;
+	if(!ReadAccessor(gltf, position->Number, 3, positions)) return false;
+
+	size_t vertexCount = positions.size() / 3;
+	if(const JsonValue* normal = attributes->Find("NORMAL")) {
+		if(!ReadAccessor(gltf, normal->Number, 3, normals)) return false;
+	} else {
+		mesh.HasNormals = false;
+	}
+	if(const JsonValue* texCoord = attributes->Find("TEXCOORD_0")) {
+		if(!ReadAccessor(gltf, texCoord->Number, 2, texCoords)) return false;
+	}
+	if((!normals.empty() && normals.size() != vertexCount * 3) || (!texCoords.empty() && texCoords.size() != vertexCount * 2)) {
+		std::cerr << "Primitive attributes differ in count\n";
+		return false;
+	}
+
+	std::vector<uint32_t> indices;
+	if(const JsonValue* accessor = primitive.Find("indices")) {
+		if(!ReadIndices(gltf, accessor->Number, indices)) return false;
+	} else {
+		indices.resize(vertexCount);
+		for(size_t i = 0; i < vertexCount; i++) indices[i] = static_cast<uint32_t>(i);
+	}
+
+	// Normals go through the cofactor matrix, which is the inverse transpose
+	// scaled by the determinant
+	const float* axes[3] = { &transform[0], &transform[4], &transform[8] };
+	float cofactor[3][3];
+	Cross(axes[1], axes[2], cofactor[0]);
+	Cross(axes[2], axes[0], cofactor[1]);
+	Cross(axes[0], axes[1], cofactor[2]);
+	float determinant = axes[0][0] * cofactor[0][0] + axes[0][1] * cofactor[0][1] + axes[0][2] * cofactor[0][2];
+	float sign = determinant < 0.0f ? -1.0f : 1.0f;
+
+	for(size_t i = 0; i + 2 < indices.size(); i += 3) {
+		// Mirroring transforms flip the winding back
+		uint32_t corners[3] = { indices[i], indices[i + 1], indices[i + 2] };
+		if(determinant < 0.0f) std::swap(corners[1], corners[2]);
+
+		for(uint32_t v : corners) {
+			if(v >= vertexCount) {
+				std::cerr << "Index " << v << " is out of range\n";
+				return false;
+			}
+
+			ImportedVertex vertex{};
+			const float* p = &positions[v * 3];
+			for(int r = 0; r < 3; r++) {
+				vertex.Position[r] = transform[r] * p[0] + transform[4 + r] * p[1] + transform[8 + r] * p[2] + transform[12 + r];
+			}
+
+			if(!normals.empty()) {
+				const float* n = &normals[v * 3];
+				float length = 0.0f;
+				for(int r = 0; r < 3; r++) {
+					vertex.Normal[r] = sign * (cofactor[0][r] * n[0] + cofactor[1][r] * n[1] + cofactor[2][r] * n[2]);
+					length += vertex.Normal[r] * vertex.Normal[r];
+				}
+				length = std::sqrt(length);
+				if(length > 0.0f) {
+					for(float& component : vertex.Normal) component /= length;
+				}
+			}
+
+			if(!texCoords.empty()) {
+				vertex.TexCoord[0] = texCoords[v * 2];
+				vertex.TexCoord[1] = texCoords[v * 2 + 1];
+			}
+
+			mesh.Vertices.push_back(vertex);
+		}
+	}
+
+	return true;
+}
+
+static bool AppendNode(const GltfDocument& gltf, double index, const Matrix& parent, ImportedMesh& mesh, int depth) {
+	const JsonValue* node = gltf.Root.At("nodes", index);
+	if(!node || depth > 64) {
+		std::cerr << "Bad node " << index << "\n";
+		return false;
+	}
+
+	Matrix transform = Multiply(parent, NodeTransform(*node));
+
+	if(node->Find("mesh")) {
+		const JsonValue* gltfMesh = gltf.Root.At("meshes", node->GetNumber("mesh", -1.0));
+		const JsonValue* primitives = gltfMesh ? gltfMesh->Find("primitives") : nullptr;
+		if(!primitives) {
+			std::cerr << "Node " << index << " refers to a bad mesh\n";
+			return false;
+		}
+		for(const JsonValue& primitive : primitives->Array) {
+			if(!AppendPrimitive(gltf, primitive, transform, mesh)) return false;
+		}
+	}
+
+	if(const JsonValue* children = node->Find("children")) {
+		for(const JsonValue& child : children->Array) {
+			if(!AppendNode(gltf, child.Number, transform, mesh, depth + 1)) return false;
+		}
+	}
+
+	return true;
+}
+
+static bool LoadGltf(const fs::path& path, ImportedMesh& mesh) {
+	GltfDocument gltf;
+	if(!LoadGltfDocument(path, gltf)) return false;
+
+	Matrix identity = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+
+	// Files without scenes are a library of meshes, take them all untransformed
+	const JsonValue* scene = gltf.Root.At("scenes", gltf.Root.GetNumber("scene", 0.0));
+	if(!scene) {
+		if(const JsonValue* meshes = gltf.Root.Find("meshes")) {
+			for(const JsonValue& gltfMesh : meshes->Array) {
+				const JsonValue* primitives = gltfMesh.Find("primitives");
+				if(!primitives) continue;
+				for(const JsonValue& primitive : primitives->Array) {
+					if(!AppendPrimitive(gltf, primitive, identity, mesh)) return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	if(const JsonValue* nodes = scene->Find("nodes")) {
+		for(const JsonValue& node : nodes->Array) {
+			if(!AppendNode(gltf, node.Number, identity, mesh, 0)) return false;
+		}
+	}
+
+	return true;
+}
+
+// ---- Processing ----
+
+// Merges identical vertices and drops triangles that collapse doing so
+static void WeldVertices(ImportedMesh& mesh) {
+	std::unordered_map<ImportedVertex, uint32_t, ImportedVertexHash> unique;
+	std::vector<ImportedVertex> vertices;
+	std::vector<uint32_t> indices;
+	indices.reserve(mesh.Vertices.size());
+
+	for(size_t i = 0; i + 2 < mesh.Vertices.size(); i += 3) {
+		uint32_t corners[3];
+		for(int c = 0; c < 3; c++) {
+			auto [it, inserted] = unique.try_emplace(mesh.Vertices[i + c], static_cast<uint32_t>(vertices.size()));
+			if(inserted) vertices.push_back(mesh.Vertices[i + c]);
+			corners[c] = it->second;
+		}
+
+		if(corners[0] != corners[1] && corners[1] != corners[2] && corners[0] != corners[2]) {
+			indices.insert(indices.end(), corners, corners + 3);
+		}
+	}
+
+	mesh.Vertices = std::move(vertices);
+	mesh.Indices = std::move(indices);
+}
+
+// Smooth normals, area weighted, shared by every vertex at the same position
+// so texture seams do not show up as creases
+static void GenerateNormals(ImportedMesh& mesh) {
+	struct PositionHash {
+		size_t operator()(const std::array<float, 3>& p) const {
+			uint32_t bits[3];
+			std::memcpy(bits, p.data(), sizeof(bits));
+			return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+		}
+	};
+
+	std::unordered_map<std::array<float, 3>, std::array<float, 3>, PositionHash> sums;
+	auto key = [&](uint32_t v) {
+		const float* p = mesh.Vertices[v].Position;
+		return std::array<float, 3>{ p[0], p[1], p[2] };
+	};
+
+	for(size_t i = 0; i < mesh.Indices.size(); i += 3) {
+		const float* a = mesh.Vertices[mesh.Indices[i]].Position;
+		const float* b = mesh.Vertices[mesh.Indices[i + 1]].Position;
+		const float* c = mesh.Vertices[mesh.Indices[i + 2]].Position;
+
+		float e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+		float e2[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+		float normal[3];
+		// Twice the area, which is the weight wanted
+		Cross(e1, e2, normal);
+
+		for(int corner = 0; corner < 3; corner++) {
+			std::array<float, 3>& sum = sums[key(mesh.Indices[i + corner])];
+			for(int k = 0; k < 3; k++) sum[k] += normal[k];
+		}
+	}
+
+	for(size_t v = 0; v < mesh.Vertices.size(); v++) {
+		const std::array<float, 3>& sum = sums[key(static_cast<uint32_t>(v))];
+		float length = std::sqrt(sum[0] * sum[0] + sum[1] * sum[1] + sum[2] * sum[2]);
+		for(int k = 0; k < 3; k++) mesh.Vertices[v].Normal[k] = length > 0.0f ? sum[k] / length : (k == 2 ? 1.0f : 0.0f);
+	}
+}
+
+static uint64_t AlignUp(uint64_t value) {
+	return (value + Rui::MESH_ALIGNMENT - 1) & ~(Rui::MESH_ALIGNMENT - 1);
+}
+
+static bool WriteMesh(const fs::path& path, const ImportedMesh& mesh) {
+	Rui::MeshHeader header{};
+	std::memcpy(header.Magic, Rui::MESH_MAGIC, sizeof(header.Magic));
+	header.Version = Rui::MESH_VERSION;
+	header.VertexCount = static_cast<uint32_t>(mesh.Vertices.size());
+	header.IndexCount = static_cast<uint32_t>(mesh.Indices.size());
+	header.IndexType = mesh.Vertices.size() <= 65536 ? Rui::MeshIndexType::Uint16 : Rui::MeshIndexType::Uint32;
+	header.LodCount = static_cast<uint32_t>(mesh.Lods.size());
+
+	for(int k = 0; k < 3; k++) {
+		header.BoundsMin[k] = INFINITY;
+		header.BoundsMax[k] = -INFINITY;
+	}
+	for(const ImportedVertex& vertex : mesh.Vertices) {
+		for(int k = 0; k < 3; k++) {
+			header.BoundsMin[k] = std::min(header.BoundsMin[k], vertex.Position[k]);
+			header.BoundsMax[k] = std::max(header.BoundsMax[k], vertex.Position[k]);
+		}
+	}
+
+	float center[3], halfExtent[3];
+	for(int k = 0; k < 3; k++) {
+		center[k] = (header.BoundsMin[k] + header.BoundsMax[k]) * 0.5f;
+		halfExtent[k] = (header.BoundsMax[k] - header.BoundsMin[k]) * 0.5f;
+	}
+
+	size_t indexSize = header.IndexType == Rui::MeshIndexType::Uint16 ? sizeof(uint16_t) : sizeof(uint32_t);
+	header.VertexOffset = AlignUp(sizeof(Rui::MeshHeader) + mesh.Lods.size() * sizeof(Rui::MeshLod));
+	header.IndexOffset = AlignUp(header.VertexOffset + mesh.Vertices.size() * sizeof(Rui::MeshVertex));
+	header.DataSize = header.IndexOffset + mesh.Indices.size() * indexSize - header.VertexOffset;
+
+	std::vector<std::byte> file(header.VertexOffset + header.DataSize);
+	std::memcpy(file.data(), &header, sizeof(header));
+	std::memcpy(file.data() + sizeof(header), mesh.Lods.data(), mesh.Lods.size() * sizeof(Rui::MeshLod));
+
+	Rui::MeshVertex* vertices = reinterpret_cast<Rui::MeshVertex*>(file.data() + header.VertexOffset);
+	for(size_t v = 0; v < mesh.Vertices.size(); v++) {
+		const ImportedVertex& source = mesh.Vertices[v];
+		Rui::MeshVertex& target = vertices[v];
+
+		for(int k = 0; k < 3; k++) {
+			target.Position[k] = halfExtent[k] > 0.0f ? Rui::QuantizeSnorm16((source.Position[k] - center[k]) / halfExtent[k]) : 0;
+		}
+		target.Position[3] = 0;
+		Rui::EncodeOctahedral(source.Normal, target.Normal);
+		target.TexCoord[0] = Rui::FloatToHalf(source.TexCoord[0]);
+		target.TexCoord[1] = Rui::FloatToHalf(source.TexCoord[1]);
+	}
+
+	std::byte* indices = file.data() + header.IndexOffset;
+	for(size_t i = 0; i < mesh.Indices.size(); i++) {
+		if(indexSize == sizeof(uint16_t)) {
+			uint16_t index = static_cast<uint16_t>(mesh.Indices[i]);
+			std::memcpy(indices + i * indexSize, &index, indexSize);
+		} else {
+			std::memcpy(indices + i * indexSize, &mesh.Indices[i], indexSize);
+		}
+	}
+
+	fs::path temporary = path;
+	temporary += ".tmp";
+	{
+		std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+		if(!out.write(reinterpret_cast<const char*>(file.data()), file.size())) {
+			std::cerr << "Could not write " << temporary << "\n";
+			return false;
+		}
+	}
+
+	std::error_code error;
+	fs::rename(temporary, path, error);
+	if(error) {
+		std::cerr << "Could not replace " << path << ": " << error.message() << "\n";
+		return false;
+	}
+
+	return true;
+}
+
+static bool ParseOptions(int argc, char** argv, MeshOptions& options) {
+	for(int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if(arg == "--no-overdraw") {
+			options.Overdraw = false;
+		} else if(arg == "--overdraw-threshold" && hasValue) {
+			options.OverdrawThreshold = std::stof(argv[++i]);
+		} else if(arg == "--lods" && hasValue) {
+			options.LodCount = std::clamp<uint32_t>(static_cast<uint32_t>(std::stoul(argv[++i])), 1, Rui::MESH_MAX_LODS);
+		} else if(arg == "--lod-ratio" && hasValue) {
+			options.LodRatio = std::clamp(std::stof(argv[++i]), 0.01f, 0.95f);
+		} else if(arg == "--lod-error" && hasValue) {
+			options.LodError = std::stof(argv[++i]);
+		} else if(arg.rfind("--", 0) == 0) {
+			std::cerr << "Unknown option " << arg << "\n";
+			return false;
+		} else if(options.Input.empty()) {
+			options.Input = arg;
+		} else if(options.Output.empty()) {
+			options.Output = arg;
+		} else {
+			return false;
+		}
+	}
+
+	return !options.Input.empty() && !options.Output.empty();
+}
+
+int main(int argc, char** argv) {
+	MeshOptions options;
+	if(!ParseOptions(argc, argv, options)) {
+		std::cerr << "Usage: RuiMesh [--no-overdraw] [--overdraw-threshold <f>] [--lods <n>] [--lod-ratio <f>] [--lod-error <f>]\n"
+					 "               <input.obj|.gltf|.glb> <output.rmesh>\n";
+		return 1;
+	}
+
+	std::string extension = options.Input.extension().string();
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+	ImportedMesh mesh;
+	if(extension == ".obj") {
+		if(!LoadObj(options.Input, mesh)) return 1;
+	} else if(extension == ".gltf" || extension == ".glb") {
+		if(!LoadGltf(options.Input, mesh)) return 1;
+	} else {
+		std::cerr << "Unsupported input " << options.Input << ", expected .obj, .gltf or .glb\n";
+		return 1;
+	}
+
+	size_t corners = mesh.Vertices.size();
+	bool hasNormals = mesh.HasNormals;
+	if(!hasNormals) {
+		// Welded without normals so GenerateNormals sees the shared vertices
+		for(ImportedVertex& vertex : mesh.Vertices) std::fill(std::begin(vertex.Normal), std::end(vertex.Normal), 0.0f);
+	}
+
+	WeldVertices(mesh);
+	if(mesh.Indices.empty()) {
+		std::cerr << options.Input << " has no triangles\n";
+		return 1;
+	}
+	if(!hasNormals) GenerateNormals(mesh);
+
+	size_t vertexCount = mesh.Vertices.size();
+	float acmrBefore = Rui::ComputeVertexCacheAcmr(mesh.Indices.data(), mesh.Indices.size(), vertexCount);
+
+	Rui::OptimizeVertexCache(mesh.Indices.data(), mesh.Indices.size(), vertexCount);
+	if(options.Overdraw) {
+		Rui::OptimizeOverdraw(mesh.Indices.data(), mesh.Indices.size(), mesh.Vertices[0].Position, vertexCount, sizeof(ImportedVertex), options.OverdrawThreshold);
+	}
+
+	float acmrAfter = Rui::ComputeVertexCacheAcmr(mesh.Indices.data(), mesh.Indices.size(), vertexCount);
+
+	// Levels of detail, each simplified from the full mesh so the error is
+	// measured against it rather than piling up level after level
+	float extent = 0.0f;
+	{
+		float low[3] = { INFINITY, INFINITY, INFINITY };
+		float high[3] = { -INFINITY, -INFINITY, -INFINITY };
+		for(const ImportedVertex& vertex : mesh.Vertices) {
+			for(int k = 0; k < 3; k++) {
+				low[k] = std::min(low[k], vertex.Position[k]);
+				high[k] = std::max(high[k], vertex.Position[k]);
+			}
+		}
+		for(int k = 0; k < 3; k++) extent = std::max(extent, high[k] - low[k]);
+	}
+
+	std::vector<uint32_t> full = mesh.Indices;
+	mesh.Lods.push_back({ 0, static_cast<uint32_t>(full.size()), 0.0f, 0 });
+
+	std::vector<uint32_t> simplified(full.size());
+	size_t previous = full.size();
+	for(uint32_t lod = 1; lod < options.LodCount; lod++) {
+		size_t target = static_cast<size_t>(previous / 3 * options.LodRatio) * 3;
+		float error = 0.0f;
+		size_t count = Rui::SimplifyMesh(simplified.data(), full.data(), full.size(), mesh.Vertices[0].Position, vertexCount, sizeof(ImportedVertex),
+										 target, options.LodError * extent, &error);
+
+		// The error limit was hit before the target; a level that barely
+		// drops would cost memory without saving much time
+		if(count == 0 || count > target) break;
+
+		Rui::OptimizeVertexCache(simplified.data(), count, vertexCount);
+		mesh.Lods.push_back({ static_cast<uint32_t>(mesh.Indices.size()), static_cast<uint32_t>(count), std::max(error, mesh.Lods.back().Error), 0 });
+		mesh.Indices.insert(mesh.Indices.end(), simplified.begin(), simplified.begin() + count);
+		previous = count;
+	}
+
+	// Coarser levels only use vertices of the full mesh, which comes first,
+	// so the vertex order follows it
+	std::vector<uint32_t> remap;
+	size_t used = Rui::OptimizeVertexFetch(mesh.Indices.data(), mesh.Indices.size(), vertexCount, remap);
+	std::vector<ImportedVertex> ordered(used);
+	for(size_t v = 0; v < vertexCount; v++) {
+		if(remap[v] != UINT32_MAX) ordered[remap[v]] = mesh.Vertices[v];
+	}
+	mesh.Vertices = std::move(ordered);
+
+	if(!WriteMesh(options.Output, mesh)) return 1;
+
+	size_t floatSize = mesh.Vertices.size() * sizeof(ImportedVertex);
+	size_t quantizedSize = mesh.Vertices.size() * sizeof(Rui::MeshVertex);
+	std::cout << "Converted " << options.Input.generic_string() << " to " << options.Output.generic_string() << "\n"
+		<< "  " << corners / 3 << " triangles in, " << mesh.Lods[0].IndexCount / 3 << " out, " << mesh.Vertices.size() << " vertices" << (hasNormals ? "" : ", normals generated") << "\n"
+		<< "  ACMR " << acmrBefore << " -> " << acmrAfter << "\n"
+		<< "  vertex data " << floatSize << " -> " << quantizedSize << " bytes\n";
+	for(size_t lod = 1; lod < mesh.Lods.size(); lod++) {
+		std::cout << "  LOD " << lod << ": " << mesh.Lods[lod].IndexCount / 3 << " triangles, error " << mesh.Lods[lod].Error << "\n";
+	}
+	return 0;
+}
@@ -0,0 +1,635 @@
+// Microbenchmarks for the engine's hot CPU paths
+//
+//     RuiMicroBench [--filter <substring>] [--threads <n,...>] [--scale <factor>]
+//                   [--no-window] [--csv <file>] [--json <file>]
+//
+// Every benchmark runs once per thread count. Benchmarks of main thread only
+// systems give each thread its own instance, so their numbers show how the
+// code scales on shared caches and the shared heap rather than contention on
+// one object. Reported per operation and thread: wall time, cycle counter
+// ticks, and heap allocations and bytes, counted by replacing the global
+// operator new. The cycle counter is the TSC on x86 and CNTVCT_EL0 on arm64;
+// elsewhere no ticks are reported.
+
+#include "Rui/Core/FrameArena.h"
+#include "Rui/Core/Input.h"
+#include "Rui/Core/Log.h"
+#include "Rui/Core/Scene.h"
+#include "Rui/Core/Window.h"
+#include "Rui/Events/ConcurrentEventQueue.h"
+#include "Rui/Events/EventBus.h"
+#include "Rui/Events/KeyEvent.h"
+#include "Rui/Events/MouseEvent.h"
+#include "Rui/Events/WindowEvent.h"
+#include "Rui/Math/TransformKernels.h"
+#include "Rui/Scene/SpatialIndex.h"
+#include "Rui/Scene/Transform.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <memory>
+#include <new>
+#include <thread>
+
+#if defined(_M_X64) || defined(_M_IX86)
+	#include <intrin.h>
+	#define RUI_BENCH_TSC
+#elif defined(__x86_64__) || defined(__i386__)
+	#include <x86intrin.h>
+	#define RUI_BENCH_TSC
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+#if defined(RUI_BENCH_TSC) || defined(__aarch64__)
+static constexpr bool HAS_CYCLE_COUNTER = true;
+#else
+static constexpr bool HAS_CYCLE_COUNTER = false;
+#endif
+
+// Zero where HAS_CYCLE_COUNTER is false
+static uint64_t ReadCycleCounter() {
+#if defined(RUI_BENCH_TSC)
+	return __rdtsc();
+#elif defined(__aarch64__)
+	// Ticks at a fixed frequency rather than the core clock, like an
+	// invariant TSC
+	uint64_t ticks;
+	asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+	return ticks;
+#else
+	return 0;
+#endif
+}
+
+static std::atomic<uint64_t> s_Allocations = 0;
+static std::atomic<uint64_t> s_AllocatedBytes = 0;
+
+void* operator new(size_t size) {
+	s_Allocations.fetch_add(1, std::memory_order_relaxed);
+	s_AllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+	if(void* memory = std::malloc(size ? size : 1)) return memory;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+	std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+	std::free(memory);
+}
+
+// Over-aligned types, the SIMD transforms among them, come through these
+void* operator new(size_t size, std::align_val_t alignment) {
+	s_Allocations.fetch_add(1, std::memory_order_relaxed);
+	s_AllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+	size_t align = static_cast<size_t>(alignment);
+#ifdef _MSC_VER
+	if(void* memory = _aligned_malloc(size ? size : 1, align)) return memory;
+#else
+	// aligned_alloc wants a multiple of the alignment
+	if(void* memory = std::aligned_alloc(align, (std::max<size_t>(size, 1) + align - 1) / align * align)) return memory;
+#endif
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+#ifdef _MSC_VER
+	_aligned_free(memory);
+#else
+	std::free(memory);
+#endif
+}
+
+void operator delete(void* memory, size_t, std::align_val_t alignment) noexcept {
+	operator delete(memory, alignment);
+}
+
+struct BenchOptions {
+	std::string Filter;
+	std::vector<uint32_t> Threads = { 1, 2, 4, 8 };
+	double Scale = 1.0;
+	bool Window = true;
+
+	std::string CsvPath;
+	std::string JsonPath;
+};
+
+struct BenchResult {
+	std::string Name;
+	uint32_t Threads = 0;
+	uint64_t OpsPerThread = 0;
+
+	double NsPerOp = 0.0;
+	// Left out of the output without a cycle counter
+	double CyclesPerOp = 0.0;
+	double AllocsPerOp = 0.0;
+	double BytesPerOp = 0.0;
+	// All threads together
+	double MopsPerSecond = 0.0;
+};
+
+// Runs `body(*state, thread, ops)` on `threads` threads released together
+// and measures from the release until the last one finished. Each thread
+// first builds its state with `setup(thread)`, which returns a pointer to
+// it; building and destroying the states is neither timed nor counted.
+template<typename S, typename F>
+static BenchResult Measure(const std::string& name, uint32_t threads, uint64_t ops, S&& setup, F&& body) {
+	std::vector<decltype(setup(0u))> states(threads);
+	std::atomic<uint32_t> ready = 0;
+	std::atomic<bool> go = false;
+
+	std::vector<std::thread> workers;
+	for(uint32_t t = 1; t < threads; t++) {
+		workers.emplace_back([&, t] {
+			states[t] = setup(t);
+			ready.fetch_add(1);
+			while(!go.load(std::memory_order_acquire)) std::this_thread::yield();
+			body(*states[t], t, ops);
+		});
+	}
+	states[0] = setup(0u);
+	while(ready.load() + 1 < threads) std::this_thread::yield();
+
+	uint64_t allocations = s_Allocations.load();
+	uint64_t bytes = s_AllocatedBytes.load();
+	auto start = Clock::now();
+	uint64_t cycles = ReadCycleCounter();
+
+	go.store(true, std::memory_order_release);
+	body(*states[0], 0u, ops);
+	for(std::thread& worker : workers) worker.join();
+
+	cycles = ReadCycleCounter() - cycles;
+	double ns = std::chrono::duration<double, std::nano>{ Clock::now() - start }.count();
+
+	BenchResult result;
+	result.Name = name;
+	result.Threads = threads;
+	result.OpsPerThread = ops;
+	result.NsPerOp = ns / ops;
+	result.CyclesPerOp = static_cast<double>(cycles) / ops;
+	result.AllocsPerOp = static_cast<double>(s_Allocations.load() - allocations) / (ops * threads);
+	result.BytesPerOp = static_cast<double>(s_AllocatedBytes.load() - bytes) / (ops * threads);
+	result.MopsPerSecond = ops * threads / ns * 1000.0;
+	return result;
+}
+
+// For benchmarks without state: runs `body(thread, ops)`
+template<typename F>
+static BenchResult Measure(const std::string& name, uint32_t threads, uint64_t ops, F&& body) {
+	struct NoState {};
+	return Measure(name, threads, ops, [](uint32_t) { return std::make_unique<NoState>(); },
+		[&](NoState&, uint32_t thread, uint64_t n) { body(thread, n); });
+}
+
+// Keeps the optimizer from dropping work whose result is unused
+template<typename T>
+static void DoNotOptimize(const T& value) {
+	static thread_local const void* volatile sink;
+	sink = &value;
+}
+
+// Application::OnEvent's dispatch chain, for an event matching the last entry
+static void BenchDispatcher(uint32_t, uint64_t ops) {
+	Rui::MouseMoveEvent event(1, 2);
+	uint64_t handled = 0;
+
+	for(uint64_t i = 0; i < ops; i++) {
+		event.Handled = false;
+		Rui::EventDispatcher dispatcher(event);
+		dispatcher.Dispatch<Rui::WindowClosedEvent>([&](Rui::WindowClosedEvent&) { return true; });
+		dispatcher.Dispatch<Rui::WindowResizedEvent>([&](Rui::WindowResizedEvent&) { return true; });
+		dispatcher.Dispatch<Rui::KeyPressedEvent>([&](Rui::KeyPressedEvent&) { return true; });
+		dispatcher.Dispatch<Rui::MouseMoveEvent>([&](Rui::MouseMoveEvent& e) { handled += e.GetX(); return false; });
+	}
+
+	DoNotOptimize(handled);
+}
+
+struct CountingListener {
+	uint64_t Count = 0;
+
+	bool OnAny(Rui::Event&) { return false; }
+	bool OnKey(Rui::KeyPressedEvent& e) { Count += e.GetKeyCode(); return false; }
+};
+
+// Posted in batches of a typical frame's input, then drained
+static void BenchBusPostDrain(uint32_t, uint64_t ops) {
+	static constexpr uint64_t BATCH = 64;
+
+	Rui::EventBus bus;
+	CountingListener listener;
+	bus.SubscribeAny<&CountingListener::OnAny>(&listener);
+	bus.Subscribe<Rui::KeyPressedEvent, &CountingListener::OnKey>(&listener);
+
+	for(uint64_t i = 0; i < ops; i += BATCH) {
+		for(uint64_t j = 0; j < BATCH; j++) {
+			bus.Post<Rui::KeyPressedEvent>(static_cast<int>(j), 1);
+		}
+		bus.Drain();
+	}
+
+	DoNotOptimize(listener.Count);
+}
+
+// Every thread but the first posts, the first drains into a bus as the
+// main thread does each frame. Single threaded it posts and drains itself.
+// The draining thread is counted like a producer in the per operation
+// numbers.
+struct ConcurrentQueueBench {
+	Rui::ConcurrentEventQueue Queue{ 4096 };
+	Rui::EventBus Bus;
+	CountingListener Listener;
+	std::atomic<uint32_t> Producing = 0;
+
+	ConcurrentQueueBench(uint32_t threads) {
+		Bus.Subscribe<Rui::KeyPressedEvent, &CountingListener::OnKey>(&Listener);
+		Producing = threads > 1 ? threads - 1 : 0;
+	}
+
+	void Run(uint32_t thread, uint64_t ops) {
+		if(Producing.load() == 0) {
+			for(uint64_t i = 0; i < ops; i++) {
+				if(!Queue.Post<Rui::KeyPressedEvent>(static_cast<int>(i), 1)) {
+					Queue.DrainInto(Bus);
+					Bus.Drain();
+				}
+			}
+		} else if(thread == 0) {
+			while(Producing.load(std::memory_order_acquire) > 0) {
+				Queue.DrainInto(Bus);
+				Bus.Drain();
+			}
+		} else {
+			for(uint64_t i = 0; i < ops; i++) {
+				while(!Queue.Post<Rui::KeyPressedEvent>(static_cast<int>(i), 1)) std::this_thread::yield();
+			}
+			Producing.fetch_sub(1, std::memory_order_release);
+		}
+
+		if(thread == 0) {
+			Queue.DrainInto(Bus);
+			Bus.Drain();
+		}
+	}
+};
+
+// SDL events through Window::OnUpdate into the input rings, then consumed
+// by a tick onto the bus as the application does
+static void BenchWindowPoll(Rui::Window& window, uint64_t ops) {
+	static constexpr uint64_t BATCH = 64;
+
+	Rui::EventBus bus;
+	Rui::Input input(bus);
+	CountingListener listener;
+	bus.Subscribe<Rui::KeyPressedEvent, &CountingListener::OnKey>(&listener);
+	window.SetEventBus(&bus);
+	window.SetInput(&input);
+
+	SDL_Event key = {};
+	key.type = SDL_KEYDOWN;
+	key.key.keysym.sym = SDLK_a;
+
+	for(uint64_t i = 0; i < ops; i += BATCH) {
+		for(uint64_t j = 0; j < BATCH; j++) {
+			SDL_PushEvent(&key);
+		}
+		window.OnUpdate();
+		input.BeginTick();
+		input.Consume(Clock::now());
+		bus.Drain();
+		input.OnSubmit();
+	}
+
+	window.SetInput(nullptr);
+	window.SetEventBus(nullptr);
+	DoNotOptimize(listener.Count);
+}
+
+// Run once at the logger's level and once below it, where only the level
+// check is left
+static void BenchLog(uint32_t thread, uint64_t ops) {
+	for(uint64_t i = 0; i < ops; i++) {
+		RUI_CORE_INFO("Bench message {0} from thread {1}", i, thread);
+	}
+}
+
+struct Position { float X, Y, Z; };
+struct Velocity { float X, Y, Z; };
+struct Health { int32_t Value; };
+
+class BenchScene : public Rui::Scene {
+public:
+	void OnLoad() override {}
+	void OnUnload() override {}
+	void OnUpdate(const Rui::Timestep& ts) override {}
+	void OnRender(const Rui::Timestep& ts) override {}
+	void OnEvent(Rui::Event& event) override {}
+};
+
+// Integrates positions over a view of entities of which every other one
+// also has a component the view skips. One operation is one entity visited.
+static constexpr uint32_t ECS_VIEW_ENTITIES = 16384;
+
+static std::unique_ptr<BenchScene> SetupEcsView(uint32_t) {
+	auto scene = std::make_unique<BenchScene>();
+	entt::registry& registry = scene->GetRegistry();
+	for(uint32_t i = 0; i < ECS_VIEW_ENTITIES; i++) {
+		auto entity = registry.create();
+		registry.emplace<Position>(entity, 0.0f, 0.0f, 0.0f);
+		registry.emplace<Velocity>(entity, 1.0f, static_cast<float>(i), 0.5f);
+		if(i % 2) registry.emplace<Health>(entity, 100);
+	}
+	return scene;
+}
+
+static void BenchEcsView(BenchScene& scene, uint32_t, uint64_t ops) {
+	entt::registry& registry = scene.GetRegistry();
+	auto view = registry.view<Position, const Velocity>();
+	for(uint64_t visited = 0; visited < ops; visited += ECS_VIEW_ENTITIES) {
+		view.each([](Position& position, const Velocity& velocity) {
+			position.X += velocity.X * 0.016f;
+			position.Y += velocity.Y * 0.016f;
+			position.Z += velocity.Z * 0.016f;
+		});
+	}
+
+	DoNotOptimize(registry.get<Position>(*view.begin()).X);
+}
+
+static void BenchEcsCreateDestroy(uint32_t, uint64_t ops) {
+	static constexpr uint64_t BATCH = 1024;
+
+	BenchScene scene;
+	entt::registry& registry = scene.GetRegistry();
+	std::vector<entt::entity> entities(BATCH);
+
+	for(uint64_t i = 0; i < ops; i += BATCH) {
+		for(entt::entity& entity : entities) {
+			entity = registry.create();
+			registry.emplace<Position>(entity, 0.0f, 0.0f, 0.0f);
+		}
+		for(entt::entity entity : entities) {
+			registry.destroy(entity);
+		}
+	}
+}
+
+// World transforms and bounds of 100k entities, the target scene size. One
+// operation is one entity updated.
+static constexpr uint32_t TRANSFORM_ENTITIES = 100000;
+
+struct TransformBench {
+	BenchScene Scene;
+	Rui::TransformSystem Transforms;
+};
+
+// Updated once, so the world components and the system's arrays exist and
+// the measurement sees a steady scene
+static std::unique_ptr<TransformBench> SetupTransformSystem(uint32_t) {
+	auto bench = std::make_unique<TransformBench>();
+	entt::registry& registry = bench->Scene.GetRegistry();
+	for(uint32_t i = 0; i < TRANSFORM_ENTITIES; i++) {
+		auto entity = registry.create();
+		float angle = static_cast<float>(i) * 0.001f;
+		registry.emplace<Rui::TransformComponent>(entity, glm::vec3(static_cast<float>(i % 100), 0.0f, static_cast<float>(i / 100)),
+			glm::quat(std::cos(angle), 0.0f, std::sin(angle), 0.0f), glm::vec3(1.0f));
+		registry.emplace<Rui::BoundsComponent>(entity, glm::vec3(-0.5f), glm::vec3(0.5f));
+	}
+	bench->Transforms.Update(registry);
+	return bench;
+}
+
+static void BenchTransformSystem(TransformBench& bench, uint32_t, uint64_t ops) {
+	entt::registry& registry = bench.Scene.GetRegistry();
+	for(uint64_t updated = 0; updated < ops; updated += TRANSFORM_ENTITIES) {
+		bench.Transforms.Update(registry);
+	}
+
+	DoNotOptimize(registry.get<Rui::WorldBoundsComponent>(*registry.view<Rui::WorldBoundsComponent>().begin()).Min.x);
+}
+
+// The kernel alone, without gathering from the registry
+static void BenchComposeTransforms(uint32_t, uint64_t ops) {
+	static constexpr uint32_t BATCH = 4096;
+
+	std::vector<float> planes(BATCH * 10, 0.0f);
+	std::fill(planes.begin() + BATCH * 6, planes.end(), 1.0f);
+	std::vector<glm::mat4> matrices(BATCH);
+	const float* p = planes.data();
+	Rui::TransformArrays transforms{ p, p + BATCH, p + BATCH * 2, p + BATCH * 3, p + BATCH * 4, p + BATCH * 5, p + BATCH * 6, p + BATCH * 7, p + BATCH * 8, p + BATCH * 9 };
+
+	for(uint64_t i = 0; i < ops; i += BATCH) {
+		Rui::ComposeTransforms(transforms, matrices.data(), BATCH);
+		DoNotOptimize(matrices[0][0][0]);
+	}
+}
+
+// Proximity queries against an index of 100k entities spread over a grid,
+// each finding about a dozen. One operation is one query.
+static std::unique_ptr<BenchScene> SetupSpatialQuery(uint32_t) {
+	static constexpr uint32_t ENTITIES = 100000;
+
+	auto scene = std::make_unique<BenchScene>();
+	entt::registry& registry = scene->GetRegistry();
+	for(uint32_t i = 0; i < ENTITIES; i++) {
+		auto entity = registry.create();
+		registry.emplace<Rui::TransformComponent>(entity, glm::vec3(static_cast<float>(i % 100), static_cast<float>(i / 10000), static_cast<float>(i / 100 % 100)),
+			glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(1.0f));
+		registry.emplace<Rui::BoundsComponent>(entity, glm::vec3(-0.5f), glm::vec3(0.5f));
+	}
+
+	// The scene's own, as its registry can only have one
+	Rui::TransformSystem transforms;
+	transforms.Update(registry);
+	scene->GetSpatialIndex().Update();
+	return scene;
+}
+
+static void BenchSpatialQuery(BenchScene& scene, uint32_t thread, uint64_t ops) {
+	const Rui::SpatialIndex& index = scene.GetSpatialIndex();
+
+	uint64_t found = 0;
+	uint32_t seed = thread * 7919u + 1u;
+	for(uint64_t i = 0; i < ops; i++) {
+		seed = seed * 1664525u + 1013904223u;
+		Rui::Sphere sphere{ glm::vec3(static_cast<float>(seed % 100), static_cast<float>(seed / 100 % 10), static_cast<float>(seed / 1000 % 100)), 1.2f };
+		index.GetBvh().Query(sphere, [&](uint32_t) { found++; });
+	}
+
+	DoNotOptimize(found);
+}
+
+// Event sized allocations released together, as the event bus does per frame
+static void BenchFrameArena(uint32_t, uint64_t ops) {
+	static constexpr uint64_t BATCH = 256;
+
+	Rui::FrameArena arena(BATCH * sizeof(Rui::KeyPressedEvent) * 2);
+	for(uint64_t i = 0; i < ops; i += BATCH) {
+		for(uint64_t j = 0; j < BATCH; j++) {
+			DoNotOptimize(arena.New<Rui::KeyPressedEvent>(static_cast<int>(j), 1));
+		}
+		arena.Reset();
+	}
+}
+
+// The same through the heap, for comparison
+static void BenchHeap(uint32_t, uint64_t ops) {
+	static constexpr uint64_t BATCH = 256;
+
+	std::vector<Rui::KeyPressedEvent*> events(BATCH);
+	for(uint64_t i = 0; i < ops; i += BATCH) {
+		for(uint64_t j = 0; j < BATCH; j++) {
+			events[j] = new Rui::KeyPressedEvent(static_cast<int>(j), 1);
+		}
+		for(Rui::KeyPressedEvent* event : events) {
+			delete event;
+		}
+	}
+}
+
+static bool ParseOptions(int argc, char** argv, BenchOptions& options) {
+	for(int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		try {
+			if(arg == "--filter" && hasValue) {
+				options.Filter = argv[++i];
+			} else if(arg == "--threads" && hasValue) {
+				options.Threads.clear();
+				std::stringstream stream(argv[++i]);
+				std::string item;
+				while(std::getline(stream, item, ',')) {
+					options.Threads.push_back(std::max(1u, static_cast<uint32_t>(std::stoul(item))));
+				}
+			} else if(arg == "--scale" && hasValue) {
+				options.Scale = std::stod(argv[++i]);
+			} else if(arg == "--no-window") {
+				options.Window = false;
+			} else if(arg == "--csv" && hasValue) {
+				options.CsvPath = argv[++i];
+			} else if(arg == "--json" && hasValue) {
+				options.JsonPath = argv[++i];
+			} else {
+				std::cerr << "Unknown option " << arg << "\n";
+				return false;
+			}
+		} catch(const std::exception&) {
+			std::cerr << "Invalid value for " << arg << "\n";
+			return false;
+		}
+	}
+
+	return !options.Threads.empty() && options.Scale > 0.0;
+}
+
+static void WriteCsv(std::ostream& out, const std::vector<BenchResult>& results) {
+	out << "name,threads,ops_per_thread,ns_per_op,cycles_per_op,allocs_per_op,bytes_per_op,mops_per_s\n";
+	out << std::fixed << std::setprecision(3);
+	for(const BenchResult& r : results) {
+		out << r.Name << ',' << r.Threads << ',' << r.OpsPerThread << ',' << r.NsPerOp << ',';
+		if(HAS_CYCLE_COUNTER) out << r.CyclesPerOp;
+		out << ',' << r.AllocsPerOp << ',' << r.BytesPerOp << ',' << r.MopsPerSecond << '\n';
+	}
+}
+
+static void WriteJson(std::ostream& out, const std::vector<BenchResult>& results) {
+	out << std::fixed << std::setprecision(3);
+	out << "{\n  \"benchmarks\": [";
+	for(size_t i = 0; i < results.size(); i++) {
+		const BenchResult& r = results[i];
+		out << (i ? ",\n" : "\n")
+			<< "    { \"name\": \"" << r.Name << "\", \"threads\": " << r.Threads << ", \"ops_per_thread\": " << r.OpsPerThread
+			<< ", \"ns_per_op\": " << r.NsPerOp << ", \"cycles_per_op\": ";
+		if(HAS_CYCLE_COUNTER) out << r.CyclesPerOp;
+		else out << "null";
+		out << ", \"allocs_per_op\": " << r.AllocsPerOp << ", \"bytes_per_op\": " << r.BytesPerOp
+			<< ", \"mops_per_s\": " << r.MopsPerSecond << " }";
+	}
+	out << "\n  ]\n}\n";
+}
+
+int main(int argc, char** argv) {
+	BenchOptions options;
+	if(!ParseOptions(argc, argv, options)) {
+		std::cerr << "Usage: RuiMicroBench [--filter <substring>] [--threads <n,...>] [--scale <factor>] [--no-window] [--csv <file>] [--json <file>]\n";
+		return 1;
+	}
+	std::cerr << "Math kernels: " << Rui::GetMathKernelPath() << "\n";
+
+	// Messages go through the async ring into the in-memory crash dump
+	// only, so the numbers do not depend on the console
+	Rui::LogSettings logSettings;
+	logSettings.Console = false;
+	Rui::Log::Init("RuiMicroBench", logSettings);
+
+	std::vector<BenchResult> results;
+	auto ops = [&](uint64_t base) { return std::max<uint64_t>(1, static_cast<uint64_t>(base * options.Scale)); };
+	auto enabled = [&](const char* name) { return options.Filter.empty() || std::string(name).find(options.Filter) != std::string::npos; };
+	auto report = [&](const BenchResult& r) {
+		results.push_back(r);
+		std::cerr << std::left << std::setw(24) << r.Name << " x" << r.Threads << ": " << std::fixed << std::setprecision(2)
+			<< r.NsPerOp << " ns/op, ";
+		if(HAS_CYCLE_COUNTER) std::cerr << r.CyclesPerOp << " cycles/op, ";
+		std::cerr << r.AllocsPerOp << " allocs/op\n";
+	};
+
+	for(uint32_t threads : options.Threads) {
+		if(enabled("event.dispatcher")) report(Measure("event.dispatcher", threads, ops(20000000), BenchDispatcher));
+		if(enabled("event.bus")) report(Measure("event.bus", threads, ops(5000000), BenchBusPostDrain));
+		if(enabled("event.concurrent")) {
+			ConcurrentQueueBench bench(threads);
+			report(Measure("event.concurrent", threads, ops(2000000), [&](uint32_t thread, uint64_t n) { bench.Run(thread, n); }));
+		}
+
+		if(enabled("log.enabled")) {
+			report(Measure("log.enabled", threads, ops(200000), BenchLog));
+			Rui::Log::Flush();
+		}
+		if(enabled("log.filtered")) {
+			auto level = Rui::Log::GetCoreLogger()->level();
+			Rui::Log::GetCoreLogger()->set_level(spdlog::level::warn);
+			report(Measure("log.filtered", threads, ops(20000000), BenchLog));
+			Rui::Log::GetCoreLogger()->set_level(level);
+		}
+
+		if(enabled("ecs.view")) report(Measure("ecs.view", threads, ops(50000000), SetupEcsView, BenchEcsView));
+		if(enabled("ecs.create_destroy")) report(Measure("ecs.create_destroy", threads, ops(2000000), BenchEcsCreateDestroy));
+
+		if(enabled("math.transform_system")) report(Measure("math.transform_system", threads, ops(10000000), SetupTransformSystem, BenchTransformSystem));
+		if(enabled("math.compose")) report(Measure("math.compose", threads, ops(50000000), BenchComposeTransforms));
+		if(enabled("scene.spatial_query")) report(Measure("scene.spatial_query", threads, ops(2000000), SetupSpatialQuery, BenchSpatialQuery));
+
+		if(enabled("alloc.frame_arena")) report(Measure("alloc.frame_arena", threads, ops(20000000), BenchFrameArena));
+		if(enabled("alloc.heap")) report(Measure("alloc.heap", threads, ops(5000000), BenchHeap));
+	}
+
+	// SDL's event queue belongs to the thread that created the window
+	if(options.Window && enabled("window.poll")) {
+		Rui::Window window("RuiMicroBench", 64, 64, false);
+		report(Measure("window.poll", 1, ops(1000000), [&](uint32_t, uint64_t n) { BenchWindowPoll(window, n); }));
+	}
+
+	if(!options.CsvPath.empty()) {
+		std::ofstream out(options.CsvPath, std::ios::trunc);
+		WriteCsv(out, results);
+	}
+	if(!options.JsonPath.empty()) {
+		std::ofstream out(options.JsonPath, std::ios::trunc);
+		WriteJson(out, results);
+	}
+	if(options.CsvPath.empty() && options.JsonPath.empty()) {
+		WriteCsv(std::cout, results);
+	}
+
+	Rui::Log::Shutdown();
+	return 0;
+}
@@ -0,0 +1,245 @@
+// Packs loose asset files into a Rui archive (.rpak), see Rui/Asset/ArchiveFormat.h
+//
+//     RuiPack [--root <dir>] [--ext <.ext>]... [--compress] <output.rpak> <file or directory>...
+//
+// Entries are named by their path relative to the root, which defaults to
+// the working directory, so they match what the engine passes to
+// AssetSystem::Load.
+
+#include "Rui/Asset/ArchiveFormat.h"
+#include "Rui/Asset/Compression.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+struct PackOptions {
+	fs::path Output;
+	fs::path Root = ".";
+	std::vector<fs::path> Inputs;
+	std::vector<std::string> Extensions;
+	bool Compress = false;
+};
+
+struct PackedFile {
+	std::string Name;
+	fs::path Source;
+	Rui::ArchiveEntry Entry{};
+	std::vector<std::byte> Payload;
+};
+
+static bool ReadWholeFile(const fs::path& path, std::vector<std::byte>& data) {
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if(!file.is_open()) return false;
+
+	data.resize(static_cast<size_t>(file.tellg()));
+	file.seekg(0);
+	return static_cast<bool>(file.read(reinterpret_cast<char*>(data.data()), data.size()));
+}
+
+// Compresses each block on its own so entries can be decoded block by block.
+// Returns false if compression does not save at least an eighth.
+static bool CompressPayload(const std::vector<std::byte>& data, PackedFile& file) {
+	uint32_t blockCount = static_cast<uint32_t>((data.size() + Rui::ARCHIVE_BLOCK_SIZE - 1) / Rui::ARCHIVE_BLOCK_SIZE);
+
+	std::vector<std::byte> payload(blockCount * sizeof(uint32_t));
+	std::vector<std::byte> block(Rui::LZCompressBound(Rui::ARCHIVE_BLOCK_SIZE));
+
+	for(uint32_t i = 0; i < blockCount; i++) {
+		size_t offset = static_cast<size_t>(i) * Rui::ARCHIVE_BLOCK_SIZE;
+		size_t size = std::min<size_t>(data.size() - offset, Rui::ARCHIVE_BLOCK_SIZE);
+
+		size_t compressed = Rui::LZCompress(data.data() + offset, size, block.data(), block.size());
+		// Blocks that do not shrink are stored as they are
+		const std::byte* stored = compressed && compressed < size ? block.data() : data.data() + offset;
+		uint32_t storedSize = static_cast<uint32_t>(compressed && compressed < size ? compressed : size);
+
+		std::memcpy(payload.data() + i * sizeof(uint32_t), &storedSize, sizeof(storedSize));
+		payload.insert(payload.end(), stored, stored + storedSize);
+	}
+
+	if(payload.size() > data.size() - data.size() / 8) return false;
+
+	file.Entry.Compression = Rui::ArchiveCompression::LZ;
+	file.Entry.BlockCount = blockCount;
+	file.Payload = std::move(payload);
+	return true;
+}
+
+static bool ParseOptions(int argc, char** argv, PackOptions& options) {
+	for(int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if(arg == "--root" && hasValue) {
+			options.Root = argv[++i];
+		} else if(arg == "--ext" && hasValue) {
+			options.Extensions.push_back(argv[++i]);
+		} else if(arg == "--compress") {
+			options.Compress = true;
+		} else if(arg.rfind("--", 0) == 0) {
+			std::cerr << "Unknown option " << arg << "\n";
+			return false;
+		} else if(options.Output.empty()) {
+			options.Output = arg;
+		} else {
+			options.Inputs.push_back(arg);
+		}
+	}
+
+	return !options.Output.empty() && !options.Inputs.empty();
+}
+
+static bool CollectFiles(const PackOptions& options, std::vector<PackedFile>& files) {
+	auto add = [&](const fs::path& source) {
+		if(!options.Extensions.empty() && std::find(options.Extensions.begin(), options.Extensions.end(), source.extension().string()) == options.Extensions.end()) {
+			return true;
+		}
+
+		std::string name = fs::relative(source, options.Root).lexically_normal().generic_string();
+		if(name.empty() || name.rfind("..", 0) == 0) {
+			std::cerr << source << " is outside of the root " << options.Root << "\n";
+			return false;
+		}
+
+		PackedFile file;
+		file.Name = name;
+		file.Source = source;
+		files.push_back(std::move(file));
+		return true;
+	};
+
+	for(const fs::path& input : options.Inputs) {
+		if(fs::is_directory(input)) {
+			for(const fs::directory_entry& entry : fs::recursive_directory_iterator(input)) {
+				if(entry.is_regular_file() && !add(entry.path())) return false;
+			}
+		} else if(fs::is_regular_file(input)) {
+			if(!add(input)) return false;
+		} else {
+			std::cerr << "No such file or directory " << input << "\n";
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static uint64_t AlignUp(uint64_t value) {
+	return (value + Rui::ARCHIVE_ALIGNMENT - 1) & ~(Rui::ARCHIVE_ALIGNMENT - 1);
+}
+
+static bool WriteArchive(const fs::path& path, std::vector<PackedFile>& files) {
+	// Sorted by hash for lookups, by name among colliding hashes so the
+	// output is reproducible
+	std::sort(files.begin(), files.end(), [](const PackedFile& a, const PackedFile& b) {
+		if(a.Entry.PathHash != b.Entry.PathHash) return a.Entry.PathHash < b.Entry.PathHash;
+		return a.Name < b.Name;
+	});
+
+	std::vector<std::byte> archive(sizeof(Rui::ArchiveHeader));
+	std::string names;
+
+	for(PackedFile& file : files) {
+		archive.resize(AlignUp(archive.size()));
+
+		file.Entry.Offset = archive.size();
+		file.Entry.StoredSize = file.Payload.size();
+		file.Entry.NameOffset = static_cast<uint32_t>(names.size());
+		file.Entry.NameLength = static_cast<uint32_t>(file.Name.size());
+
+		archive.insert(archive.end(), file.Payload.begin(), file.Payload.end());
+		names += file.Name;
+	}
+
+	Rui::ArchiveHeader header{};
+	std::memcpy(header.Magic, Rui::ARCHIVE_MAGIC, sizeof(header.Magic));
+	header.Version = Rui::ARCHIVE_VERSION;
+	header.EntryCount = static_cast<uint32_t>(files.size());
+
+	archive.resize(AlignUp(archive.size()));
+	header.TocOffset = archive.size();
+	for(const PackedFile& file : files) {
+		const std::byte* entry = reinterpret_cast<const std::byte*>(&file.Entry);
+		archive.insert(archive.end(), entry, entry + sizeof(Rui::ArchiveEntry));
+	}
+
+	header.NamesOffset = archive.size();
+	header.NamesSize = names.size();
+	const std::byte* nameBytes = reinterpret_cast<const std::byte*>(names.data());
+	archive.insert(archive.end(), nameBytes, nameBytes + names.size());
+
+	std::memcpy(archive.data(), &header, sizeof(header));
+
+	// Written next to the target and renamed, so a running engine never maps
+	// a half written archive
+	fs::path temporary = path;
+	temporary += ".tmp";
+	{
+		std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+		if(!out.write(reinterpret_cast<const char*>(archive.data()), archive.size())) {
+			std::cerr << "Could not write " << temporary << "\n";
+			return false;
+		}
+	}
+
+	std::error_code error;
+	fs::rename(temporary, path, error);
+	if(error) {
+		std::cerr << "Could not replace " << path << ": " << error.message() << "\n";
+		return false;
+	}
+
+	return true;
+}
+
+int main(int argc, char** argv) {
+	PackOptions options;
+	if(!ParseOptions(argc, argv, options)) {
+		std::cerr << "Usage: RuiPack [--root <dir>] [--ext <.ext>]... [--compress] <output.rpak> <file or directory>...\n";
+		return 1;
+	}
+
+	std::vector<PackedFile> files;
+	if(!CollectFiles(options, files)) return 1;
+
+	uint64_t totalSize = 0;
+	uint64_t storedSize = 0;
+	std::unordered_set<std::string> names;
+
+	for(PackedFile& file : files) {
+		if(!names.insert(file.Name).second) {
+			std::cerr << "Duplicate entry " << file.Name << "\n";
+			return 1;
+		}
+
+		std::vector<std::byte> data;
+		if(!ReadWholeFile(file.Source, data)) {
+			std::cerr << "Could not read " << file.Source << "\n";
+			return 1;
+		}
+
+		file.Entry.PathHash = Rui::HashAssetPath(file.Name);
+		file.Entry.Size = data.size();
+		file.Entry.Compression = Rui::ArchiveCompression::None;
+
+		if(!options.Compress || data.empty() || !CompressPayload(data, file)) {
+			file.Payload = std::move(data);
+		}
+
+		totalSize += file.Entry.Size;
+		storedSize += file.Payload.size();
+	}
+
+	if(!WriteArchive(options.Output, files)) return 1;
+
+	std::cout << "Packed " << files.size() << " files into " << options.Output.generic_string() << ", " << totalSize << " -> " << storedSize << " bytes\n";
+	return 0;
+}